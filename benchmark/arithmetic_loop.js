@@ -0,0 +1,54 @@
+// Speed of small integer arithmetic loops, and how many variables each one
+// allocates (using `allocs` from `process.memory`). Counters and sums that
+// stay small integers are updated in place in their names, so their loop
+// bodies should allocate little more than the empty loop does - floats are
+// included for comparison as they have to be boxed every time.
+//
+// Paste into the IDE and a line is printed for each loop with the time in
+// milliseconds and the number of variables allocated while it ran.
+var N = 1000;
+var a = [];
+for (var i=0;i<N;i++) a[i] = i&255;
+
+function time(name, fn) {
+  var m = process.memory(false);
+  var t = getTime();
+  fn();
+  t = getTime()-t;
+  var allocs = process.memory(false).allocs - m.allocs;
+  console.log(name+": "+Math.round(t*1000)+"ms, "+allocs+" vars allocated ("+(allocs/N).toFixed(2)+" per iteration)");
+}
+
+time("empty loop", function() {
+  for (var i=0;i<N;i++);
+});
+
+time("sum+=a[i]", function() {
+  var sum = 0;
+  for (var i=0;i<N;i++) sum+=a[i];
+});
+
+time("sum=sum+i*3", function() {
+  var sum = 0;
+  for (var i=0;i<N;i++) sum = sum+i*3;
+});
+
+time("x=(x*31+i)&0xFFFF", function() {
+  var x = 1;
+  for (var i=0;i<N;i++) x = (x*31+i)&0xFFFF;
+});
+
+time("bits|=, ^=", function() {
+  var b = 0, c = 0;
+  for (var i=0;i<N;i++) { b |= 1<<(i&7); c ^= i; }
+});
+
+time("o.count++", function() {
+  var o = {count:0};
+  for (var i=0;i<N;i++) o.count++;
+});
+
+time("f+=0.5", function() {
+  var f = 0;
+  for (var i=0;i<N;i++) f+=0.5;
+});
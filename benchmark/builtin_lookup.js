@@ -0,0 +1,52 @@
+// Speed of looking up builtin objects, functions and methods - global names
+// like `Math` and `Serial1`, static functions like `Math.sin`, and methods
+// found on prototypes like `"str".charCodeAt` and `[].indexOf`. Each loop does
+// a lookup or two per iteration, so compare against the empty loop to see
+// what the lookups themselves cost.
+//
+// Paste into the IDE and the time for each loop is printed in milliseconds.
+var N = 2000;
+var s = "Hello";
+var a = [1,2,3];
+
+function time(name, fn) {
+  var t = getTime();
+  fn();
+  console.log(name+": "+Math.round((getTime()-t)*1000)+"ms");
+}
+
+time("empty loop", function() {
+  for (var i=0;i<N;i++);
+});
+
+time("Math", function() {
+  for (var i=0;i<N;i++) Math;
+});
+
+time("Math.sin(i)", function() {
+  for (var i=0;i<N;i++) Math.sin(i);
+});
+
+time("Math.PI", function() {
+  for (var i=0;i<N;i++) Math.PI;
+});
+
+time("Serial1.available()", function() {
+  for (var i=0;i<N;i++) Serial1.available();
+});
+
+time("String.fromCharCode(65)", function() {
+  for (var i=0;i<N;i++) String.fromCharCode(65);
+});
+
+time("s.charCodeAt(0)", function() {
+  for (var i=0;i<N;i++) s.charCodeAt(0);
+});
+
+time("a.indexOf(3)", function() {
+  for (var i=0;i<N;i++) a.indexOf(3);
+});
+
+time("JSON, Date, Promise, console", function() {
+  for (var i=0;i<N;i++) { JSON; Date; Promise; console; }
+});
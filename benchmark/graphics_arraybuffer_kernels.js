@@ -0,0 +1,50 @@
+// Speed of drawing into ArrayBuffer Graphics of each pixel format: filled
+// rectangles, single pixels, reading pixels back, and scrolling.
+//
+// Paste into the IDE and a line is printed for each format with the time in
+// milliseconds for each operation. Compare against a firmware built without
+// GRAPHICS_FAST_PATHS to see what the per-format kernels save.
+var W = 128, H = 64;
+
+var FORMATS = [
+  { bpp:1, opts:{msb:true} },
+  { bpp:1, opts:{msb:false} },
+  { bpp:1, opts:{msb:true, vertical_byte:true} },
+  { bpp:2, opts:{msb:true} },
+  { bpp:4, opts:{msb:true} },
+  { bpp:4, opts:{msb:false} },
+  { bpp:8, opts:{} },
+  { bpp:16, opts:{msb:true} },
+  { bpp:16, opts:{msb:false} },
+  { bpp:24, opts:{msb:true} }
+];
+
+function time(fn) {
+  var t = getTime();
+  fn();
+  return Math.round((getTime()-t)*1000);
+}
+
+FORMATS.forEach(function(f) {
+  var g = Graphics.createArrayBuffer(W, H, f.bpp, f.opts);
+  var fill = time(function() {
+    for (var i=0;i<100;i++) {
+      g.setColor(i&1 ? -1 : 0);
+      g.fillRect(i&15, i&7, W-1-(i&15), H-1-(i&7));
+    }
+  });
+  var set = time(function() {
+    for (var y=0;y<H;y+=2)
+      for (var x=0;x<W;x++) g.setPixel(x, y, x^y);
+  });
+  var get = time(function() {
+    var s = 0;
+    for (var y=0;y<H;y+=2)
+      for (var x=0;x<W;x++) s += g.getPixel(x, y);
+  });
+  var scroll = time(function() {
+    for (var i=0;i<20;i++) g.scroll(i&1 ? 3 : -3, i&2 ? 2 : -2);
+  });
+  console.log(f.bpp+"bpp "+JSON.stringify(f.opts)+": fillRect x100 "+fill+"ms, setPixel x"+(W*H/2)+" "+set+
+              "ms, getPixel x"+(W*H/2)+" "+get+"ms, scroll x20 "+scroll+"ms");
+});
@@ -0,0 +1,35 @@
+// Size and decode speed of compressed (run-length encoded) images compared to
+// plain image strings, for a UI-like picture (flat areas, text and lines) at
+// several bit depths.
+//
+// Paste into the IDE and a line is printed for each bit depth with the size of
+// each kind of image and the time taken to draw it 10 times.
+var W = 176, H = 176;
+
+function makeImage(g) {
+  var max = (1<<g.getBPP())-1;
+  g.clear();
+  g.setColor(max>>1).fillRect(0, 0, W-1, 24);
+  g.setColor(max).setFont("6x8", 2).drawString("12:34", 4, 4);
+  g.setColor(max>>2).fillCircle(W/2, H/2, 50);
+  for (var i=0;i<10;i++) g.setColor(i%(max+1)).drawLine(0, 30+i*14, W-1, 40+i*14);
+}
+
+function time(fn) {
+  var t = getTime();
+  for (var i=0;i<10;i++) fn();
+  return Math.round((getTime()-t)*1000);
+}
+
+[1, 4, 8, 16].forEach(function(bpp) {
+  var src = Graphics.createArrayBuffer(W, H, bpp, {msb:true});
+  makeImage(src);
+  var plain = src.asImage("string");
+  var compressed = src.asImage("compressed");
+  var dst = Graphics.createArrayBuffer(W, H, bpp, {msb:true});
+  var tPlain = time(function() { dst.drawImage(plain, 0, 0); });
+  var tCompressed = time(function() { dst.drawImage(compressed, 0, 0); });
+  var tHalf = time(function() { dst.setClipRect(0, H/2, W-1, H-1).drawImage(compressed, 0, 0).setClipRect(0, 0, W-1, H-1); });
+  console.log(bpp+"bpp: string "+plain.length+" bytes, "+tPlain+"ms; compressed "+compressed.length+" bytes, "+
+              tCompressed+"ms ("+tHalf+"ms with the top half clipped off)");
+});
@@ -0,0 +1,44 @@
+// Speed of polygon filling: vector font glyphs (lots of small polygons), and
+// a 500 vertex star (one big polygon with many active edges on each row),
+// both plain and antialiased, and lots of small antialiased triangles.
+//
+// Paste into the IDE and the time for each test is printed in milliseconds.
+var g = Graphics.createArrayBuffer(240, 240, 16, {msb:true});
+
+function time(name, fn) {
+  var t = getTime();
+  fn();
+  console.log(name+": "+Math.round((getTime()-t)*1000)+"ms");
+}
+
+time("drawString, Vector 30, 10 x 26 glyphs", function() {
+  g.setFont("Vector", 30);
+  for (var i=0;i<10;i++) {
+    g.clear();
+    g.drawString("ABCDEFGHIJKLM", 0, 20);
+    g.drawString("NOPQRSTUVWXYZ", 0, 80);
+  }
+});
+
+var star = [];
+for (var i=0;i<500;i++) {
+  var a = i*Math.PI*2/500;
+  var r = (i&1) ? 115 : 60;
+  star.push(120+r*Math.sin(a), 120+r*Math.cos(a));
+}
+
+time("fillPoly, 500 vertices x 10", function() {
+  for (var i=0;i<10;i++) g.fillPoly(star);
+});
+
+if (g.fillPolyAA) time("fillPolyAA, 500 vertices x 10", function() {
+  for (var i=0;i<10;i++) g.fillPolyAA(star);
+});
+
+// small polygons on a big Graphics - only the columns each one covers should be looked at
+if (g.fillPolyAA) time("fillPolyAA, 500 small triangles", function() {
+  for (var i=0;i<500;i++) {
+    var x = (i*37)%230, y = (i*53)%230;
+    g.fillPolyAA([x,y, x+9.5,y+2.25, x+3.75,y+8.5]);
+  }
+});
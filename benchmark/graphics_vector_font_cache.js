@@ -0,0 +1,26 @@
+// Speed of drawing vector font text with and without the character cache, and
+// with a cache that's too small for everything (so characters keep getting
+// thrown away).
+//
+// Paste into the IDE and the time for each test is printed in milliseconds,
+// along with the cache's counters.
+var g = Graphics.createArrayBuffer(240, 160, 1);
+var TEXT = "The quick brown fox jumps over the lazy dog 0123456789";
+
+function time(name, cacheSize) {
+  Graphics.setVectorFontCache(cacheSize);
+  var t = getTime();
+  for (var i=0;i<10;i++) {
+    g.clear();
+    [12, 16, 20, 28].forEach(function(size, n) {
+      g.setFont("Vector", size).drawString(TEXT, 0, n*36);
+    });
+  }
+  console.log(name+": "+Math.round((getTime()-t)*1000)+"ms", JSON.stringify(Graphics.getVectorFontCache()));
+}
+
+time("no cache", 0);
+time("4096 byte cache", 4096);
+time("16384 byte cache", 16384);
+time("16384 byte cache, already full", 16384);
+Graphics.setVectorFontCache(4096);
@@ -0,0 +1,179 @@
+// Speed of the lexer over module source code. Each module is wrapped in a
+// function expression and evaluated, which lexes the whole body to find the
+// end of the function without running any of it - the same work done when a
+// module is loaded or a function is defined.
+//
+// Modules are every `.js` file in Storage, plus the example modules below
+// (taken with `toString`, so upload without minification to keep them as
+// written). Paste into the IDE and a line is printed for each module with
+// its size and throughput in KB/sec, followed by the overall throughput.
+var REPEAT = 5;
+
+function sensorModule() {
+  /* Driver for an I2C temperature/pressure sensor with calibration data */
+  var C = {
+    ADDR : 0x76,
+    REG_ID : 0xD0,
+    REG_RESET : 0xE0,
+    REG_CTRL : 0xF4,
+    REG_DATA : 0xF7,
+    REG_CALIB : 0x88
+  };
+  function Sensor(i2c, options) {
+    this.i2c = i2c;
+    this.addr = (options && options.addr) || C.ADDR;
+    if (this.read(C.REG_ID, 1)[0] != 0x58) throw new Error("Sensor not found");
+    this.write(C.REG_RESET, 0xB6);
+    var d = new DataView(this.read(C.REG_CALIB, 24).buffer);
+    this.T = [d.getUint16(0, 1), d.getInt16(2, 1), d.getInt16(4, 1)];
+    this.P = [];
+    for (var i=0;i<9;i++) this.P.push(i ? d.getInt16(6+i*2, 1) : d.getUint16(6, 1));
+    this.write(C.REG_CTRL, 0x27); // normal mode, 1x oversampling
+  }
+  Sensor.prototype.read = function(reg, count) {
+    this.i2c.writeTo(this.addr, reg);
+    return this.i2c.readFrom(this.addr, count);
+  };
+  Sensor.prototype.write = function(reg, value) {
+    this.i2c.writeTo(this.addr, [reg, value]);
+  };
+  Sensor.prototype.getData = function() {
+    var d = this.read(C.REG_DATA, 6);
+    var adcP = (d[0]<<12) | (d[1]<<4) | (d[2]>>4);
+    var adcT = (d[3]<<12) | (d[4]<<4) | (d[5]>>4);
+    var v1 = (adcT/16384 - this.T[0]/1024) * this.T[1];
+    var v2 = (adcT/131072 - this.T[0]/8192);
+    v2 = v2*v2*this.T[2];
+    var tFine = v1 + v2;
+    v1 = tFine/2 - 64000;
+    v2 = v1*v1*this.P[5]/32768 + v1*this.P[4]*2;
+    v2 = v2/4 + this.P[3]*65536;
+    v1 = (this.P[2]*v1*v1/524288 + this.P[1]*v1)/524288;
+    v1 = (1 + v1/32768)*this.P[0];
+    if (v1 === 0) return { temp : tFine/5120, pressure : undefined };
+    var p = (1048576 - adcP - v2/4096)*6250/v1;
+    v1 = this.P[8]*p*p/2147483648;
+    v2 = p*this.P[7]/32768;
+    return { temp : tFine/5120, pressure : (p + (v1 + v2 + this.P[6])/16)/100 };
+  };
+  exports.connect = function(i2c, options) {
+    return new Sensor(i2c, options);
+  };
+}
+
+function queueModule() {
+  // A queue of jobs that are run one at a time, with retries and timeouts
+  function Queue(options) {
+    options = options || {};
+    this.jobs = [];
+    this.busy = false;
+    this.retries = options.retries !== undefined ? options.retries : 3;
+    this.timeout = options.timeout || 1000;
+  }
+  Queue.prototype.add = function(fn, callback) {
+    this.jobs.push({ fn : fn, callback : callback, tries : 0 });
+    if (!this.busy) this.next();
+    return this;
+  };
+  Queue.prototype.next = function() {
+    var q = this;
+    var job = this.jobs.shift();
+    if (!job) {
+      this.busy = false;
+      return;
+    }
+    this.busy = true;
+    var finished = false;
+    var timer = setTimeout(function() {
+      done("Timeout");
+    }, this.timeout);
+    function done(err, result) {
+      if (finished) return;
+      finished = true;
+      clearTimeout(timer);
+      if (err && ++job.tries <= q.retries) {
+        q.jobs.unshift(job);
+      } else if (job.callback) {
+        try {
+          job.callback(err, result);
+        } catch (e) {
+          console.log("Queue callback error", e);
+        }
+      }
+      setTimeout(function() { q.next(); }, 0);
+    }
+    try {
+      job.fn(done);
+    } catch (e) {
+      done(e);
+    }
+  };
+  Queue.prototype.clear = function() {
+    this.jobs = [];
+  };
+  exports = Queue;
+}
+
+function layoutModule() {
+  // Word wrap text to fit a width, and lay out lines of it in columns
+  exports.wrap = function(g, text, width) {
+    var lines = [];
+    text.split("\n").forEach(function(para) {
+      var words = para.split(" ");
+      var line = "";
+      for (var i=0;i<words.length;i++) {
+        var w = words[i];
+        var next = line ? line+" "+w : w;
+        if (g.stringWidth(next) <= width || !line) {
+          line = next;
+        } else {
+          lines.push(line);
+          line = w;
+        }
+      }
+      lines.push(line);
+    });
+    return lines;
+  };
+  exports.draw = function(g, text, x, y, options) {
+    options = Object.assign({ width : g.getWidth()-x, columns : 1, gap : 4 }, options);
+    var colWidth = Math.floor((options.width - options.gap*(options.columns-1)) / options.columns);
+    var lines = exports.wrap(g, text, colWidth);
+    var h = g.getFontHeight();
+    var perColumn = Math.ceil(lines.length / options.columns);
+    lines.forEach(function(line, i) {
+      var col = Math.floor(i / perColumn);
+      var lx = x + col*(colWidth + options.gap);
+      var ly = y + (i % perColumn)*h;
+      switch (options.align) {
+        case "center": g.setFontAlign(0, -1); lx += colWidth/2; break;
+        case "right": g.setFontAlign(1, -1); lx += colWidth; break;
+        default: g.setFontAlign(-1, -1);
+      }
+      g.drawString(line, lx, ly);
+    });
+    return perColumn*h;
+  };
+}
+
+var modules = [
+  { name : "sensor", src : sensorModule.toString() },
+  { name : "queue", src : queueModule.toString() },
+  { name : "layout", src : layoutModule.toString() }
+];
+var storage = require("Storage");
+storage.list(/\.js$/).forEach(function(f) {
+  modules.push({ name : f, src : storage.read(f) });
+});
+
+var totalBytes = 0, totalTime = 0;
+modules.forEach(function(m) {
+  var code = "(function(){"+m.src+"\n})";
+  var t = getTime();
+  for (var i=0;i<REPEAT;i++) eval(code);
+  t = getTime()-t;
+  totalBytes += m.src.length*REPEAT;
+  totalTime += t;
+  console.log(m.name+": "+m.src.length+" bytes, "+Math.round(m.src.length*REPEAT/(t*1024))+" KB/sec");
+});
+console.log("Total: "+totalBytes+" bytes in "+Math.round(totalTime*1000)+"ms, "+Math.round(totalBytes/(totalTime*1024))+" KB/sec");
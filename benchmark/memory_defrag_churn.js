@@ -0,0 +1,33 @@
+// Long running memory churn: objects and strings of mixed sizes are created
+// and freed at random, with a Uint8Array (which is best stored in a Flat
+// String) made now and then. Fragmentation is printed every few seconds, so you can see the
+// largest free run recover as memory is compacted when idle, along with the
+// longest pause a single step of compaction has caused.
+//
+// Paste into the IDE and leave it running. Each line shows the seconds
+// elapsed, free blocks, how many separate free areas there are, the largest
+// free area, and the longest compaction pause so far in milliseconds.
+var SLOTS = 300;
+var slots = new Array(SLOTS);
+var start = getTime();
+
+function junk(n) {
+  var r = Math.random();
+  if (r<0.4) return { n:n, s:"item"+n, a:[n, n*2, n*3] };
+  if (r<0.8) return "string data "+n+" ....................".substr(0, n%20);
+  return [n, { x:n }, "y"+n];
+}
+
+setInterval(function() {
+  for (var i=0;i<50;i++) {
+    var n = Math.floor(Math.random()*100000);
+    slots[n%SLOTS] = junk(n);
+  }
+  slots[Math.floor(Math.random()*SLOTS)] = new Uint8Array(200+Math.floor(Math.random()*800));
+}, 50);
+
+setInterval(function() {
+  var m = process.memory();
+  console.log(Math.round(getTime()-start)+"s free "+m.free+", freeRuns "+m.freeRuns+
+              ", largestFree "+m.largestFree+", defragtime "+m.defragtime.toFixed(2)+"ms");
+}, 5000);
@@ -0,0 +1,23 @@
+// Building a string up with `s += ...` 1000, 10000 and 100000 times. With the
+// tail of the last appended string cached each append should take about the
+// same time however long the string is, so time per append should stay flat
+// rather than growing with the length.
+//
+// Paste into the IDE and a line is printed for each count with the total time
+// in milliseconds and the time per append in microseconds. Counts that won't
+// fit in free memory are skipped.
+var COUNTS = [1000, 10000, 100000];
+
+COUNTS.forEach(function(n) {
+  // each block of string data holds at least 10 characters
+  if (n > process.memory().free*10*0.8) {
+    console.log(n+" appends: not enough memory, skipped");
+    return;
+  }
+  var s = "";
+  var t = getTime();
+  for (var i=0;i<n;i++) s += "x";
+  t = getTime()-t;
+  console.log(n+" appends: "+Math.round(t*1000)+"ms, "+(t*1000000/n).toFixed(1)+"us each, length "+s.length);
+  s = undefined;
+});
@@ -0,0 +1,37 @@
+// WebSocket throughput over loopback: a client sends COUNT binary messages of
+// SIZE bytes to an echo server on the same device, and we time how long it
+// takes to get them all back.
+//
+// Paste into the IDE (WiFi must be connected so the network is up) and the
+// result is printed as bytes/sec in each direction.
+var http = require("http");
+
+var SIZE = 1024;
+var COUNT = 100;
+
+var data = new Uint8Array(SIZE);
+for (var i=0;i<SIZE;i++) data[i] = i;
+
+var server = http.createServer(function (req, res) {
+  var ws = req.upgrade();
+  ws.on('message', function(msg) { ws.send(msg); });
+}).listen(8092);
+
+var sent = 0, received = 0, bytes = 0, start;
+var ws = http.websocket("ws://localhost:8092/", function() {
+  start = getTime();
+  // keep a few messages in flight, so we measure the framing and not the round trip
+  for (var i=0;i<4;i++) { ws.send(data); sent++; }
+});
+ws.on('message', function(msg) {
+  received++;
+  bytes += msg.byteLength;
+  if (sent<COUNT) { ws.send(data); sent++; }
+  if (received==COUNT) {
+    var t = getTime()-start;
+    console.log(COUNT+" x "+SIZE+" bytes in "+t.toFixed(2)+"s = "+Math.round(bytes/t)+" bytes/sec");
+    ws.close();
+    server.close();
+  }
+});
+ws.on('error', function(e) { console.log("Error", e); });
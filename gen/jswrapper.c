@@ -37,6 +37,7 @@
 #include "../../../libs/math/jswrap_math.h"
 #include "../../../libs/network/jswrap_net.h"
 #include "../../../libs/network/http/jswrap_http.h"
+#include "../../../libs/network/mqtt/jswrap_mqtt.h"
 #include "../../../libs/network/js/jswrap_jsnetwork.h"
 #include "../../../libs/network/jswrap_wifi.h"
 #include "../../../libs/network/esp32/jswrap_esp32_network.h"
@@ -476,10 +477,18 @@ static JsVar* gen_jswrap_Graphics_drawPoly(JsVar *parent, JsVar* poly, bool clos
   return jswrap_graphics_drawPoly_X(parent, poly, closed, false);
 }
 
+static JsVar* gen_jswrap_Graphics_drawPolyAA(JsVar *parent, JsVar* poly, bool closed) {
+  return jswrap_graphics_drawPoly_X(parent, poly, closed, true);
+}
+
 static JsVar* gen_jswrap_Graphics_fillPoly(JsVar *parent, JsVar* poly) {
   return jswrap_graphics_fillPoly_X(parent, poly, false);;
 }
 
+static JsVar* gen_jswrap_Graphics_fillPolyAA(JsVar *parent, JsVar* poly) {
+  return jswrap_graphics_fillPoly_X(parent, poly, true);;
+}
+
 static JsVar* gen_jswrap_net_connect(JsVar* options, JsVar* callback) {
   return jswrap_net_connect(options, callback, ST_NORMAL);
 }
@@ -640,6 +649,18 @@ static JsVar* gen_jswrap_httpCRs_httpCRs() {
   return NULL;
 }
 
+static JsVar* gen_jswrap_WebSocket_WebSocket() {
+  return NULL;
+}
+
+static JsVar* gen_jswrap_MQTT_MQTT() {
+  return NULL;
+}
+
+static JsVar* gen_jswrap_MQTTClient_MQTTClient() {
+  return NULL;
+}
+
 static JsVar* gen_jswrap_NetworkJS_NetworkJS() {
   return NULL;
 }
@@ -665,6 +686,14 @@ static JsVar* gen_jswrap_AES_AES() {
 // -----------------------------------------------------------------------------------------
 
 
+/// Return the value of a symbol we have found
+static JsVar *jswGetSymbolValue(const JswSymPtr *sym, JsVar *parent) {
+  unsigned short functionSpec = READ_FLASH_UINT16(&sym->functionSpec);
+  if ((functionSpec & JSWAT_EXECUTE_IMMEDIATELY_MASK) == JSWAT_EXECUTE_IMMEDIATELY)
+    return jsnCallFunction(sym->functionPtr, functionSpec, parent, 0, 0);
+  return jsvNewNativeFunction(sym->functionPtr, functionSpec);
+}
+
 // Binary search coded to allow for JswSyms to be in flash on the esp8266 where they require
 // word accesses
 JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name) {
@@ -677,10 +706,7 @@ JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *
     unsigned short strOffset = READ_FLASH_UINT16(&sym->strOffset);
     int cmp = FLASH_STRCMP(name, &symbolsPtr->symbolChars[strOffset]);
     if (cmp==0) {
-      unsigned short functionSpec = READ_FLASH_UINT16(&sym->functionSpec);
-      if ((functionSpec & JSWAT_EXECUTE_IMMEDIATELY_MASK) == JSWAT_EXECUTE_IMMEDIATELY)
-        return jsnCallFunction(sym->functionPtr, functionSpec, parent, 0, 0);
-      return jsvNewNativeFunction(sym->functionPtr, functionSpec);
+      return jswGetSymbolValue(sym, parent);
     } else {
       if (cmp<0) {
         // searchMin is the same
@@ -694,6 +720,37 @@ JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *
   return 0;
 }
 
+/* The hash tables are made when this file is built. Each has a list of seeds
+ * (one per bucket of names), then a list of symbol indices. A name's hash picks
+ * its bucket, and the bucket's seed has been chosen so that every name in the
+ * bucket ends up at a different index to every other name in the table. So
+ * there's only ever one symbol that a name could be - we just check it matches. */
+#define JSW_HASH_NONE 255 // a symbol index for slots that no name hashes to
+
+unsigned int jswHashSymbol(const char *name) {
+  unsigned int hash = 2166136261u; // FNV-1a
+  while (*name) hash = (hash ^ (unsigned char)*(name++)) * 16777619u;
+  return hash;
+}
+
+/// Return the index of the only symbol in the hash table that could have this hash
+static unsigned char jswHashGetIndex(const unsigned char *hashTable, unsigned char buckets, unsigned char size, unsigned int hash) {
+  unsigned int seed = READ_FLASH_UINT8(&hashTable[hash % buckets]);
+  unsigned int slot = (((hash ^ (seed*0x9E3779B9u)) * 0x85EBCA6Bu) >> 16) % size;
+  return READ_FLASH_UINT8(&hashTable[buckets + slot]);
+}
+
+JsVar *jswHashSearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name, unsigned int hash) {
+  unsigned char buckets = READ_FLASH_UINT8(&symbolsPtr->hashBuckets);
+  if (!buckets) return 0; // no symbols
+  unsigned char idx = jswHashGetIndex(symbolsPtr->hashTable, buckets, READ_FLASH_UINT8(&symbolsPtr->hashSize), hash);
+  if (idx == JSW_HASH_NONE) return 0;
+  const JswSymPtr *sym = &symbolsPtr->symbols[idx];
+  unsigned short strOffset = READ_FLASH_UINT16(&sym->strOffset);
+  if (FLASH_STRCMP(name, &symbolsPtr->symbolChars[strOffset])!=0) return 0;
+  return jswGetSymbolValue(sym, parent);
+}
+
 
 // -----------------------------------------------------------------------------------------
 // -----------------------------------------------------------------------------------------
@@ -735,91 +792,93 @@ static const JswSymPtr jswSymbols_global[] FLASH_SECT = {
   {202, JSWAT_INT32 | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_LOW},
   {206, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_LoopbackA},
   {216, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_LoopbackB},
-  {226, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Math_Math},
-  {231, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Modules_Modules},
-  {239, JSWAT_JSVARFLOAT | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_NaN},
-  {243, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_number_constructor},
-  {250, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_object_constructor},
-  {257, JSWAT_JSVAR | (JSWAT_PIN << (JSWAT_BITS*1)), (void (*)(void))jswrap_onewire_constructor},
-  {265, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_pin_constructor},
-  {269, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_promise_constructor},
-  {277, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_referenceerror_constructor},
-  {292, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_regexp_constructor},
-  {299, JSWAT_JSVAR, (void (*)(void))jswrap_spi_constructor},
-  {303, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_SPI1},
-  {308, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_SPI2},
-  {313, JSWAT_JSVAR, (void (*)(void))jswrap_serial_constructor},
-  {320, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Serial1},
-  {328, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Serial2},
-  {336, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Serial3},
-  {344, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Server_Server},
-  {351, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Socket_Socket},
-  {358, JSWAT_JSVAR, (void (*)(void))gen_jswrap_StorageFile_StorageFile},
-  {370, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_string_constructor},
-  {377, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_syntaxerror_constructor},
-  {389, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Telnet},
-  {396, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_typeerror_constructor},
-  {406, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint16Array_Uint16Array},
-  {418, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint24Array_Uint24Array},
-  {430, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint32Array_Uint32Array},
-  {442, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint8Array_Uint8Array},
-  {453, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint8ClampedArray_Uint8ClampedArray},
-  {471, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_waveform_constructor},
-  {480, JSWAT_JSVARFLOAT | (JSWAT_PIN << (JSWAT_BITS*1)), (void (*)(void))jshPinAnalog},
-  {491, JSWAT_VOID | (JSWAT_PIN << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_analogWrite},
-  {503, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))jswrap_arguments},
-  {513, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_atob},
-  {518, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_btoa},
-  {523, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)), (void (*)(void))jswrap_interface_changeInterval},
-  {538, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_clearInterval},
-  {552, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_clearTimeout},
-  {565, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_clearWatch},
-  {576, JSWAT_JSVAR, (void (*)(void))gen_jswrap_console_console},
-  {584, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_decodeURIComponent},
-  {603, JSWAT_JSVAR, (void (*)(void))gen_jswrap_dgramSocket_dgramSocket},
-  {615, JSWAT_VOID | (JSWAT_PIN << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_digitalPulse},
-  {628, JSWAT_INT32 | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_io_digitalRead},
-  {640, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_io_digitalWrite},
-  {653, JSWAT_VOID, (void (*)(void))gen_jswrap_dump},
-  {658, JSWAT_VOID | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_echo},
-  {663, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_edit},
-  {668, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_encodeURIComponent},
-  {687, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_eval},
-  {692, JSWAT_JSVAR | (JSWAT_PIN << (JSWAT_BITS*1)), (void (*)(void))jswrap_io_getPinMode},
-  {703, JSWAT_JSVAR, (void (*)(void))jswrap_interface_getSerial},
-  {713, JSWAT_JSVARFLOAT, (void (*)(void))gen_jswrap_getTime},
-  {721, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_global},
-  {728, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpCRq_httpCRq},
-  {736, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpCRs_httpCRs},
-  {744, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpSRq_httpSRq},
-  {752, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpSRs_httpSRs},
-  {760, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpSrv_httpSrv},
-  {768, JSWAT_BOOL | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_isFinite},
-  {777, JSWAT_BOOL | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_isNaN},
-  {783, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_load},
-  {788, JSWAT_JSVARFLOAT | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_parseFloat},
-  {799, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_parseInt},
-  {808, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_peek16},
-  {815, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_peek32},
-  {822, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_peek8},
-  {828, JSWAT_VOID | (JSWAT_PIN << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_BOOL << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_pinMode},
-  {836, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_poke16},
-  {843, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_poke32},
-  {850, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_poke8},
-  {856, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_print},
-  {862, JSWAT_JSVAR, (void (*)(void))gen_jswrap_process_process},
-  {870, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_require},
-  {878, JSWAT_VOID | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_reset},
-  {884, JSWAT_VOID, (void (*)(void))gen_jswrap_save},
-  {889, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_setBusyIndicator},
-  {906, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*3)), (void (*)(void))jswrap_interface_setInterval},
-  {918, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_setSleepIndicator},
-  {936, JSWAT_VOID | (JSWAT_JSVARFLOAT << (JSWAT_BITS*1)), (void (*)(void))jswrap_interactive_setTime},
-  {944, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*3)), (void (*)(void))jswrap_interface_setTimeout},
-  {955, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_PIN << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_interface_setWatch},
-  {964, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_shiftOut},
-  {973, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_trace},
-  {979, JSWAT_JSVAR, (void (*)(void))gen_jswrap_url_url}
+  {226, JSWAT_JSVAR, (void (*)(void))gen_jswrap_MQTTClient_MQTTClient},
+  {237, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Math_Math},
+  {242, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Modules_Modules},
+  {250, JSWAT_JSVARFLOAT | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_NaN},
+  {254, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_number_constructor},
+  {261, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_object_constructor},
+  {268, JSWAT_JSVAR | (JSWAT_PIN << (JSWAT_BITS*1)), (void (*)(void))jswrap_onewire_constructor},
+  {276, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_pin_constructor},
+  {280, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_promise_constructor},
+  {288, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_referenceerror_constructor},
+  {303, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_regexp_constructor},
+  {310, JSWAT_JSVAR, (void (*)(void))jswrap_spi_constructor},
+  {314, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_SPI1},
+  {319, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_SPI2},
+  {324, JSWAT_JSVAR, (void (*)(void))jswrap_serial_constructor},
+  {331, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Serial1},
+  {339, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Serial2},
+  {347, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Serial3},
+  {355, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Server_Server},
+  {362, JSWAT_JSVAR, (void (*)(void))gen_jswrap_Socket_Socket},
+  {369, JSWAT_JSVAR, (void (*)(void))gen_jswrap_StorageFile_StorageFile},
+  {381, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_string_constructor},
+  {388, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_syntaxerror_constructor},
+  {400, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_Telnet},
+  {407, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_typeerror_constructor},
+  {417, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint16Array_Uint16Array},
+  {429, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint24Array_Uint24Array},
+  {441, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint32Array_Uint32Array},
+  {453, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint8Array_Uint8Array},
+  {464, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Uint8ClampedArray_Uint8ClampedArray},
+  {482, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_waveform_constructor},
+  {491, JSWAT_JSVAR, (void (*)(void))gen_jswrap_WebSocket_WebSocket},
+  {501, JSWAT_JSVARFLOAT | (JSWAT_PIN << (JSWAT_BITS*1)), (void (*)(void))jshPinAnalog},
+  {512, JSWAT_VOID | (JSWAT_PIN << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_analogWrite},
+  {524, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))jswrap_arguments},
+  {534, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_atob},
+  {539, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_btoa},
+  {544, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)), (void (*)(void))jswrap_interface_changeInterval},
+  {559, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_clearInterval},
+  {573, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_clearTimeout},
+  {586, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_clearWatch},
+  {597, JSWAT_JSVAR, (void (*)(void))gen_jswrap_console_console},
+  {605, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_decodeURIComponent},
+  {624, JSWAT_JSVAR, (void (*)(void))gen_jswrap_dgramSocket_dgramSocket},
+  {636, JSWAT_VOID | (JSWAT_PIN << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_digitalPulse},
+  {649, JSWAT_INT32 | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_io_digitalRead},
+  {661, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_io_digitalWrite},
+  {674, JSWAT_VOID, (void (*)(void))gen_jswrap_dump},
+  {679, JSWAT_VOID | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_echo},
+  {684, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_edit},
+  {689, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_encodeURIComponent},
+  {708, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_eval},
+  {713, JSWAT_JSVAR | (JSWAT_PIN << (JSWAT_BITS*1)), (void (*)(void))jswrap_io_getPinMode},
+  {724, JSWAT_JSVAR, (void (*)(void))jswrap_interface_getSerial},
+  {734, JSWAT_JSVARFLOAT, (void (*)(void))gen_jswrap_getTime},
+  {742, JSWAT_JSVAR | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))gen_jswrap_global},
+  {749, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpCRq_httpCRq},
+  {757, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpCRs_httpCRs},
+  {765, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpSRq_httpSRq},
+  {773, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpSRs_httpSRs},
+  {781, JSWAT_JSVAR, (void (*)(void))gen_jswrap_httpSrv_httpSrv},
+  {789, JSWAT_BOOL | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_isFinite},
+  {798, JSWAT_BOOL | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_isNaN},
+  {804, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_load},
+  {809, JSWAT_JSVARFLOAT | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_parseFloat},
+  {820, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_parseInt},
+  {829, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_peek16},
+  {836, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_peek32},
+  {843, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_peek8},
+  {849, JSWAT_VOID | (JSWAT_PIN << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_BOOL << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_pinMode},
+  {857, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_poke16},
+  {864, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_poke32},
+  {871, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_poke8},
+  {877, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_print},
+  {883, JSWAT_JSVAR, (void (*)(void))gen_jswrap_process_process},
+  {891, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_require},
+  {899, JSWAT_VOID | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_reset},
+  {905, JSWAT_VOID, (void (*)(void))gen_jswrap_save},
+  {910, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_setBusyIndicator},
+  {927, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*3)), (void (*)(void))jswrap_interface_setInterval},
+  {939, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_setSleepIndicator},
+  {957, JSWAT_VOID | (JSWAT_JSVARFLOAT << (JSWAT_BITS*1)), (void (*)(void))jswrap_interactive_setTime},
+  {965, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*3)), (void (*)(void))jswrap_interface_setTimeout},
+  {976, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_PIN << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_interface_setWatch},
+  {985, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_io_shiftOut},
+  {994, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_interface_trace},
+  {1000, JSWAT_JSVAR, (void (*)(void))gen_jswrap_url_url}
 };
 static const unsigned char jswSymbolIndex_global = 0;
 static const JswSymPtr jswSymbols_Array_proto[] FLASH_SECT = {
@@ -971,36 +1030,37 @@ static const JswSymPtr jswSymbols_E[] FLASH_SECT = {
   {186, JSWAT_JSVARFLOAT, (void (*)(void))gen_jswrap_E_getAnalogVRef},
   {200, JSWAT_JSVAR, (void (*)(void))jswrap_espruino_getConsole},
   {211, JSWAT_JSVAR, (void (*)(void))jswrap_espruino_getErrorFlags},
-  {225, JSWAT_JSVAR, (void (*)(void))jsfGetFlags},
-  {234, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_getSizeOf},
-  {244, JSWAT_JSVARFLOAT, (void (*)(void))jswrap_espruino_getTemperature},
-  {259, JSWAT_INT32, (void (*)(void))jshGetRandomNumber},
-  {266, JSWAT_VOID, (void (*)(void))jswrap_espruino_kickWatchdog},
-  {279, JSWAT_VOID, (void (*)(void))jswrap_espruino_lockConsole},
-  {291, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_BOOL << (JSWAT_BITS*3)), (void (*)(void))jswrap_espruino_lookupNoCase},
-  {304, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_espruino_mapInPlace},
-  {315, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_memoryArea},
-  {326, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_memoryMap},
-  {336, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_espruino_nativeCall},
-  {347, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_E_openFile},
-  {356, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_pipe},
-  {361, JSWAT_VOID, (void (*)(void))jswrap_espruino_reboot},
-  {368, JSWAT_INT32 | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_reverseByte},
-  {380, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_setBootCode},
-  {392, JSWAT_INT32 | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setClock},
-  {401, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_setConsole},
-  {412, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setDST},
-  {419, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jsfSetFlags},
-  {428, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setPassword},
-  {440, JSWAT_VOID | (JSWAT_JSVARFLOAT << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setTimeZone},
-  {452, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))srand},
-  {458, JSWAT_JSVARFLOAT | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_sum},
-  {462, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toArrayBuffer},
-  {476, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toJS},
-  {481, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toString},
-  {490, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toUint8Array},
-  {503, JSWAT_VOID, (void (*)(void))jswrap_E_unmountSD},
-  {513, JSWAT_JSVARFLOAT | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_variance}
+  {225, JSWAT_JSVAR, (void (*)(void))jswrap_espruino_getFieldCacheStats},
+  {244, JSWAT_JSVAR, (void (*)(void))jsfGetFlags},
+  {253, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_getSizeOf},
+  {263, JSWAT_JSVARFLOAT, (void (*)(void))jswrap_espruino_getTemperature},
+  {278, JSWAT_INT32, (void (*)(void))jshGetRandomNumber},
+  {285, JSWAT_VOID, (void (*)(void))jswrap_espruino_kickWatchdog},
+  {298, JSWAT_VOID, (void (*)(void))jswrap_espruino_lockConsole},
+  {310, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_BOOL << (JSWAT_BITS*3)), (void (*)(void))jswrap_espruino_lookupNoCase},
+  {323, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_espruino_mapInPlace},
+  {334, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_memoryArea},
+  {345, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_memoryMap},
+  {355, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_espruino_nativeCall},
+  {366, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_E_openFile},
+  {375, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_pipe},
+  {380, JSWAT_VOID, (void (*)(void))jswrap_espruino_reboot},
+  {387, JSWAT_INT32 | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_reverseByte},
+  {399, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_setBootCode},
+  {411, JSWAT_INT32 | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setClock},
+  {420, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_setConsole},
+  {431, JSWAT_VOID | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setDST},
+  {438, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jsfSetFlags},
+  {447, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setPassword},
+  {459, JSWAT_VOID | (JSWAT_JSVARFLOAT << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_setTimeZone},
+  {471, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))srand},
+  {477, JSWAT_JSVARFLOAT | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_sum},
+  {481, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toArrayBuffer},
+  {495, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toJS},
+  {500, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toString},
+  {509, JSWAT_JSVAR | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_espruino_toUint8Array},
+  {522, JSWAT_VOID, (void (*)(void))jswrap_E_unmountSD},
+  {532, JSWAT_JSVARFLOAT | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)), (void (*)(void))jswrap_espruino_variance}
 };
 static const unsigned char jswSymbolIndex_E = 13;
 static const JswSymPtr jswSymbols_Flash[] FLASH_SECT = {
@@ -1138,15 +1198,16 @@ static const JswSymPtr jswSymbols_Serial[] FLASH_SECT = {
 static const unsigned char jswSymbolIndex_Serial = 30;
 static const JswSymPtr jswSymbols_Serial_proto[] FLASH_SECT = {
   {0, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_stream_available},
-  {10, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_inject},
-  {17, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
-  {22, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_print},
-  {28, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_println},
-  {36, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read},
-  {41, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_setConsole},
-  {52, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_serial_setup},
-  {58, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_serial_unsetup},
-  {66, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_write}
+  {10, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_serial_getFramingInfo},
+  {25, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_inject},
+  {32, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
+  {37, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_print},
+  {43, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_println},
+  {51, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read},
+  {56, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_setConsole},
+  {67, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_serial_setup},
+  {73, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_serial_unsetup},
+  {81, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_serial_write}
 };
 static const unsigned char jswSymbolIndex_Serial_proto = 31;
 static const JswSymPtr jswSymbols_Storage[] FLASH_SECT = {
@@ -1183,7 +1244,7 @@ static const JswSymPtr jswSymbols_SPI_proto[] FLASH_SECT = {
   {5, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_PIN << (JSWAT_BITS*4)), (void (*)(void))jswrap_spi_send4bit},
   {14, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_PIN << (JSWAT_BITS*4)), (void (*)(void))jswrap_spi_send8bit},
   {23, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_spi_setup},
-  {29, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_spi_write}
+  {29, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*1)), (void (*)(void))jswrap_spi_write}
 };
 static const unsigned char jswSymbolIndex_SPI_proto = 35;
 static const JswSymPtr jswSymbols_I2C[] FLASH_SECT = {
@@ -1193,7 +1254,8 @@ static const unsigned char jswSymbolIndex_I2C = 36;
 static const JswSymPtr jswSymbols_I2C_proto[] FLASH_SECT = {
   {0, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_i2c_readFrom},
   {9, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_i2c_setup},
-  {15, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*2)), (void (*)(void))jswrap_i2c_writeTo}
+  {15, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_i2c_transfer},
+  {24, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*2)), (void (*)(void))jswrap_i2c_writeTo}
 };
 static const unsigned char jswSymbolIndex_I2C_proto = 37;
 static const JswSymPtr jswSymbols_String_proto[] FLASH_SECT = {
@@ -1288,61 +1350,74 @@ static const JswSymPtr jswSymbols_Graphics_proto[] FLASH_SECT = {
   {0, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_asBMP},
   {6, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_asImage},
   {14, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_asURL},
-  {20, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_blit},
-  {25, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_clear},
-  {31, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_clearRect},
-  {41, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_drawCircle},
-  {52, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawEllipse},
-  {64, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_JSVAR << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawImage},
-  {74, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawLine},
-  {83, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_Graphics_drawPoly},
-  {92, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawRect},
-  {101, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_BOOL << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawString},
-  {112, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_dump},
-  {117, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_fillCircle},
-  {128, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_fillEllipse},
-  {140, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))gen_jswrap_Graphics_fillPoly},
-  {149, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_fillRect},
-  {158, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getBPP},
-  {165, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getBgColor},
-  {176, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getColor},
-  {185, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getFont},
-  {193, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getFontHeight},
-  {207, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getFonts},
-  {216, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getHeight},
-  {226, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_getModified},
-  {238, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_getPixel},
-  {247, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getWidth},
-  {256, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_imageMetrics},
-  {269, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_lineTo},
-  {276, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_moveTo},
-  {283, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_quadraticBezier},
-  {299, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_reset},
-  {305, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_scroll},
-  {312, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Graphics_setBgColor},
-  {323, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_setClipRect},
-  {335, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Graphics_setColor},
-  {344, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_setFont},
-  {352, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_setFontAlign},
-  {365, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_setFontBitmap},
-  {379, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_setFontCustom},
-  {393, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))gen_jswrap_Graphics_setFontVector},
-  {407, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_setPixel},
-  {416, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_setRotation},
-  {428, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_setTheme},
-  {437, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_stringMetrics},
-  {451, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_stringWidth},
-  {463, JSWAT_JSVAR | JSWAT_THIS_ARG | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))jswrap_graphics_theme},
-  {469, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_toColor},
-  {477, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_transformVertices},
-  {495, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_wrapString}
+  {20, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_beginList},
+  {30, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_blendColor},
+  {41, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_blit},
+  {46, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_clear},
+  {52, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_clearRect},
+  {62, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_drawCircle},
+  {73, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_drawCircleAA},
+  {86, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawEllipse},
+  {98, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_JSVAR << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawImage},
+  {108, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_drawImages},
+  {119, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawLine},
+  {128, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVARFLOAT << (JSWAT_BITS*1)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*2)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*3)) | (JSWAT_JSVARFLOAT << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawLineAA},
+  {139, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_drawList},
+  {148, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_Graphics_drawPoly},
+  {157, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_Graphics_drawPolyAA},
+  {168, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawRect},
+  {177, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_BOOL << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_drawString},
+  {188, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_dump},
+  {193, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_endList},
+  {201, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_fillCircle},
+  {212, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_fillEllipse},
+  {224, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))gen_jswrap_Graphics_fillPoly},
+  {233, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))gen_jswrap_Graphics_fillPolyAA},
+  {244, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_fillRect},
+  {253, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_flipSPI},
+  {261, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getBPP},
+  {268, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getBgColor},
+  {279, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getColor},
+  {288, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_getFlipStats},
+  {301, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getFont},
+  {309, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getFontHeight},
+  {323, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_getFonts},
+  {332, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getHeight},
+  {342, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_BOOL << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_getModified},
+  {354, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_getPixel},
+  {363, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_getWidth},
+  {372, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_imageMetrics},
+  {385, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_lineTo},
+  {392, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_moveTo},
+  {399, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_quadraticBezier},
+  {415, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_graphics_reset},
+  {421, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_scroll},
+  {428, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Graphics_setBgColor},
+  {439, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_setClipRect},
+  {451, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))gen_jswrap_Graphics_setColor},
+  {460, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_setFont},
+  {468, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_setFontAlign},
+  {481, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))gen_jswrap_Graphics_setFontBitmap},
+  {495, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)) | (JSWAT_INT32 << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_setFontCustom},
+  {509, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))gen_jswrap_Graphics_setFontVector},
+  {523, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_setPixel},
+  {532, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_BOOL << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_setRotation},
+  {544, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_setTheme},
+  {553, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_stringMetrics},
+  {567, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_stringWidth},
+  {579, JSWAT_JSVAR | JSWAT_THIS_ARG | JSWAT_EXECUTE_IMMEDIATELY, (void (*)(void))jswrap_graphics_theme},
+  {585, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_graphics_toColor},
+  {593, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_transformVertices},
+  {611, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_graphics_wrapString}
 };
 static const unsigned char jswSymbolIndex_Graphics_proto = 45;
 static const JswSymPtr jswSymbols_Graphics[] FLASH_SECT = {
   {0, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_JSVAR << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_createArrayBuffer},
   {18, JSWAT_JSVAR | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_INT32 << (JSWAT_BITS*3)) | (JSWAT_JSVAR << (JSWAT_BITS*4)), (void (*)(void))jswrap_graphics_createCallback},
   {33, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_createImage},
-  {45, JSWAT_JSVAR, (void (*)(void))jswrap_graphics_getInstance}
+  {45, JSWAT_JSVAR, (void (*)(void))jswrap_graphics_getInstance},
+  {57, JSWAT_JSVAR, (void (*)(void))jswrap_graphics_getVectorFontCache},
+  {76, JSWAT_VOID | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_graphics_setVectorFontCache}
 };
 static const unsigned char jswSymbolIndex_Graphics = 46;
 static const JswSymPtr jswSymbols_url[] FLASH_SECT = {
@@ -1356,14 +1431,19 @@ static const unsigned char jswSymbolIndex_Socket = 48;
 static const JswSymPtr jswSymbols_Socket_proto[] FLASH_SECT = {
   {0, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_stream_available},
   {10, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_net_socket_end},
-  {14, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
-  {19, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read},
-  {24, JSWAT_BOOL | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_net_socket_write}
+  {14, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_net_socket_pause},
+  {20, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
+  {25, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read},
+  {30, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_net_socket_resume},
+  {37, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_net_socket_setHighWaterMark},
+  {54, JSWAT_BOOL | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_net_socket_write}
 };
 static const unsigned char jswSymbolIndex_Socket_proto = 49;
 static const JswSymPtr jswSymbols_net[] FLASH_SECT = {
   {0, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_net_connect},
-  {8, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_net_createServer}
+  {8, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_net_createServer},
+  {21, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_net_lookup},
+  {28, JSWAT_VOID | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_net_setDNSServer}
 };
 static const unsigned char jswSymbolIndex_net = 50;
 static const JswSymPtr jswSymbols_dgram[] FLASH_SECT = {
@@ -1374,7 +1454,8 @@ static const JswSymPtr jswSymbols_dgramSocket_proto[] FLASH_SECT = {
   {0, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_dgram_addMembership},
   {14, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_dgramSocket_bind},
   {19, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_dgram_close},
-  {25, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*4)), (void (*)(void))jswrap_dgram_socket_send}
+  {25, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)) | (JSWAT_ARGUMENT_ARRAY << (JSWAT_BITS*4)), (void (*)(void))jswrap_dgram_socket_send},
+  {30, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_dgram_socket_sendMany}
 };
 static const unsigned char jswSymbolIndex_dgramSocket_proto = 52;
 static const JswSymPtr jswSymbols_dgramSocket[] FLASH_SECT = {
@@ -1396,8 +1477,12 @@ static const JswSymPtr jswSymbols_httpSRq[] FLASH_SECT = {
 static const unsigned char jswSymbolIndex_httpSRq = 56;
 static const JswSymPtr jswSymbols_httpSRq_proto[] FLASH_SECT = {
   {0, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_stream_available},
-  {10, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
-  {15, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read}
+  {10, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_net_socket_pause},
+  {16, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
+  {21, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read},
+  {26, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_net_socket_resume},
+  {33, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_net_socket_setHighWaterMark},
+  {50, JSWAT_JSVAR | JSWAT_THIS_ARG, (void (*)(void))jswrap_httpSRq_upgrade}
 };
 static const unsigned char jswSymbolIndex_httpSRq_proto = 57;
 static const JswSymPtr jswSymbols_httpSRs[] FLASH_SECT = {
@@ -1414,14 +1499,18 @@ static const JswSymPtr jswSymbols_httpCRs[] FLASH_SECT = {
 static const unsigned char jswSymbolIndex_httpCRs = 60;
 static const JswSymPtr jswSymbols_httpCRs_proto[] FLASH_SECT = {
   {0, JSWAT_INT32 | JSWAT_THIS_ARG, (void (*)(void))jswrap_stream_available},
-  {10, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
-  {15, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read}
+  {10, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_net_socket_pause},
+  {16, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_pipe},
+  {21, JSWAT_JSVAR | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)), (void (*)(void))jswrap_stream_read},
+  {26, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_net_socket_resume},
+  {33, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_INT32 << (JSWAT_BITS*1)) | (JSWAT_INT32 << (JSWAT_BITS*2)), (void (*)(void))jswrap_net_socket_setHighWaterMark}
 };
 static const unsigned char jswSymbolIndex_httpCRs_proto = 61;
 static const JswSymPtr jswSymbols_http[] FLASH_SECT = {
   {0, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_http_createServer},
   {13, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_http_get},
-  {17, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_http_request}
+  {17, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))gen_jswrap_http_request},
+  {25, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_http_websocket}
 };
 static const unsigned char jswSymbolIndex_http = 62;
 static const JswSymPtr jswSymbols_httpSrv_proto[] FLASH_SECT = {
@@ -1485,9 +1574,35 @@ static const JswSymPtr jswSymbols_AES[] FLASH_SECT = {
   {8, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_crypto_AES_encrypt}
 };
 static const unsigned char jswSymbolIndex_AES = 70;
+static const JswSymPtr jswSymbols_WebSocket[] FLASH_SECT = {
+  
+};
+static const unsigned char jswSymbolIndex_WebSocket = 71;
+static const JswSymPtr jswSymbols_WebSocket_proto[] FLASH_SECT = {
+  {0, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_WebSocket_close},
+  {6, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_WebSocket_ping},
+  {11, JSWAT_VOID | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_WebSocket_send}
+};
+static const unsigned char jswSymbolIndex_WebSocket_proto = 72;
+static const JswSymPtr jswSymbols_MQTT[] FLASH_SECT = {
+  {0, JSWAT_JSVAR | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)), (void (*)(void))jswrap_mqtt_create}
+};
+static const unsigned char jswSymbolIndex_MQTT = 73;
+static const JswSymPtr jswSymbols_MQTTClient[] FLASH_SECT = {
+  
+};
+static const unsigned char jswSymbolIndex_MQTTClient = 74;
+static const JswSymPtr jswSymbols_MQTTClient_proto[] FLASH_SECT = {
+  {0, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_MQTTClient_connect},
+  {8, JSWAT_VOID | JSWAT_THIS_ARG, (void (*)(void))jswrap_MQTTClient_disconnect},
+  {19, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_MQTTClient_publish},
+  {27, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)) | (JSWAT_JSVAR << (JSWAT_BITS*2)) | (JSWAT_JSVAR << (JSWAT_BITS*3)), (void (*)(void))jswrap_MQTTClient_subscribe},
+  {37, JSWAT_INT32 | JSWAT_THIS_ARG | (JSWAT_JSVAR << (JSWAT_BITS*1)), (void (*)(void))jswrap_MQTTClient_unsubscribe}
+};
+static const unsigned char jswSymbolIndex_MQTTClient_proto = 75;
 
 
-FLASH_STR(jswSymbols_global_str, "AES\0Array\0ArrayBuffer\0ArrayBufferView\0Boolean\0DataView\0Date\0E\0ESP32\0Error\0File\0Float32Array\0Float64Array\0Function\0Graphics\0HIGH\0I2C\0I2C1\0I2C2\0Infinity\0Int16Array\0Int32Array\0Int8Array\0InternalError\0JSON\0LOW\0LoopbackA\0LoopbackB\0Math\0Modules\0NaN\0Number\0Object\0OneWire\0Pin\0Promise\0ReferenceError\0RegExp\0SPI\0SPI1\0SPI2\0Serial\0Serial1\0Serial2\0Serial3\0Server\0Socket\0StorageFile\0String\0SyntaxError\0Telnet\0TypeError\0Uint16Array\0Uint24Array\0Uint32Array\0Uint8Array\0Uint8ClampedArray\0Waveform\0analogRead\0analogWrite\0arguments\0atob\0btoa\0changeInterval\0clearInterval\0clearTimeout\0clearWatch\0console\0decodeURIComponent\0dgramSocket\0digitalPulse\0digitalRead\0digitalWrite\0dump\0echo\0edit\0encodeURIComponent\0eval\0getPinMode\0getSerial\0getTime\0global\0httpCRq\0httpCRs\0httpSRq\0httpSRs\0httpSrv\0isFinite\0isNaN\0load\0parseFloat\0parseInt\0peek16\0peek32\0peek8\0pinMode\0poke16\0poke32\0poke8\0print\0process\0require\0reset\0save\0setBusyIndicator\0setInterval\0setSleepIndicator\0setTime\0setTimeout\0setWatch\0shiftOut\0trace\0url\0");
+FLASH_STR(jswSymbols_global_str, "AES\0Array\0ArrayBuffer\0ArrayBufferView\0Boolean\0DataView\0Date\0E\0ESP32\0Error\0File\0Float32Array\0Float64Array\0Function\0Graphics\0HIGH\0I2C\0I2C1\0I2C2\0Infinity\0Int16Array\0Int32Array\0Int8Array\0InternalError\0JSON\0LOW\0LoopbackA\0LoopbackB\0MQTTClient\0Math\0Modules\0NaN\0Number\0Object\0OneWire\0Pin\0Promise\0ReferenceError\0RegExp\0SPI\0SPI1\0SPI2\0Serial\0Serial1\0Serial2\0Serial3\0Server\0Socket\0StorageFile\0String\0SyntaxError\0Telnet\0TypeError\0Uint16Array\0Uint24Array\0Uint32Array\0Uint8Array\0Uint8ClampedArray\0Waveform\0WebSocket\0analogRead\0analogWrite\0arguments\0atob\0btoa\0changeInterval\0clearInterval\0clearTimeout\0clearWatch\0console\0decodeURIComponent\0dgramSocket\0digitalPulse\0digitalRead\0digitalWrite\0dump\0echo\0edit\0encodeURIComponent\0eval\0getPinMode\0getSerial\0getTime\0global\0httpCRq\0httpCRs\0httpSRq\0httpSRs\0httpSrv\0isFinite\0isNaN\0load\0parseFloat\0parseInt\0peek16\0peek32\0peek8\0pinMode\0poke16\0poke32\0poke8\0print\0process\0require\0reset\0save\0setBusyIndicator\0setInterval\0setSleepIndicator\0setTime\0setTimeout\0setWatch\0shiftOut\0trace\0url\0");
 FLASH_STR(jswSymbols_Array_proto_str, "concat\0every\0fill\0filter\0find\0findIndex\0forEach\0includes\0indexOf\0join\0length\0map\0pop\0push\0reduce\0reverse\0shift\0slice\0some\0sort\0splice\0toString\0unshift\0");
 FLASH_STR(jswSymbols_Array_str, "isArray\0");
 FLASH_STR(jswSymbols_ArrayBuffer_proto_str, "byteLength\0");
@@ -1500,7 +1615,7 @@ FLASH_STR(jswSymbols_SyntaxError_proto_str, "toString\0");
 FLASH_STR(jswSymbols_TypeError_proto_str, "toString\0");
 FLASH_STR(jswSymbols_InternalError_proto_str, "toString\0");
 FLASH_STR(jswSymbols_ReferenceError_proto_str, "toString\0");
-FLASH_STR(jswSymbols_E_str, "CRC32\0FFT\0HSBtoRGB\0asm\0clip\0compiledC\0connectSDCard\0convolve\0decodeUTF8\0defrag\0dumpFragmentation\0dumpFreeList\0dumpLockedVars\0dumpStr\0dumpTimers\0dumpVariables\0enableWatchdog\0getAddressOf\0getAnalogVRef\0getConsole\0getErrorFlags\0getFlags\0getSizeOf\0getTemperature\0hwRand\0kickWatchdog\0lockConsole\0lookupNoCase\0mapInPlace\0memoryArea\0memoryMap\0nativeCall\0openFile\0pipe\0reboot\0reverseByte\0setBootCode\0setClock\0setConsole\0setDST\0setFlags\0setPassword\0setTimeZone\0srand\0sum\0toArrayBuffer\0toJS\0toString\0toUint8Array\0unmountSD\0variance\0");
+FLASH_STR(jswSymbols_E_str, "CRC32\0FFT\0HSBtoRGB\0asm\0clip\0compiledC\0connectSDCard\0convolve\0decodeUTF8\0defrag\0dumpFragmentation\0dumpFreeList\0dumpLockedVars\0dumpStr\0dumpTimers\0dumpVariables\0enableWatchdog\0getAddressOf\0getAnalogVRef\0getConsole\0getErrorFlags\0getFieldCacheStats\0getFlags\0getSizeOf\0getTemperature\0hwRand\0kickWatchdog\0lockConsole\0lookupNoCase\0mapInPlace\0memoryArea\0memoryMap\0nativeCall\0openFile\0pipe\0reboot\0reverseByte\0setBootCode\0setClock\0setConsole\0setDST\0setFlags\0setPassword\0setTimeZone\0srand\0sum\0toArrayBuffer\0toJS\0toString\0toUint8Array\0unmountSD\0variance\0");
 FLASH_STR(jswSymbols_Flash_str, "erasePage\0getFree\0getPage\0read\0write\0");
 FLASH_STR(jswSymbols_console_str, "log\0");
 FLASH_STR(jswSymbols_JSON_str, "parse\0stringify\0");
@@ -1518,13 +1633,13 @@ FLASH_STR(jswSymbols_Promise_str, "all\0reject\0resolve\0");
 FLASH_STR(jswSymbols_Promise_proto_str, "catch\0then\0");
 FLASH_STR(jswSymbols_RegExp_proto_str, "exec\0test\0");
 FLASH_STR(jswSymbols_Serial_str, "find\0");
-FLASH_STR(jswSymbols_Serial_proto_str, "available\0inject\0pipe\0print\0println\0read\0setConsole\0setup\0unsetup\0write\0");
+FLASH_STR(jswSymbols_Serial_proto_str, "available\0getFramingInfo\0inject\0pipe\0print\0println\0read\0setConsole\0setup\0unsetup\0write\0");
 FLASH_STR(jswSymbols_Storage_str, "compact\0erase\0eraseAll\0getFree\0getStats\0hash\0list\0open\0optimise\0read\0readArrayBuffer\0readJSON\0write\0writeJSON\0");
 FLASH_STR(jswSymbols_StorageFile_proto_str, "erase\0getLength\0read\0readLine\0write\0");
 FLASH_STR(jswSymbols_SPI_str, "find\0");
 FLASH_STR(jswSymbols_SPI_proto_str, "send\0send4bit\0send8bit\0setup\0write\0");
 FLASH_STR(jswSymbols_I2C_str, "find\0");
-FLASH_STR(jswSymbols_I2C_proto_str, "readFrom\0setup\0writeTo\0");
+FLASH_STR(jswSymbols_I2C_proto_str, "readFrom\0setup\0transfer\0writeTo\0");
 FLASH_STR(jswSymbols_String_proto_str, "charAt\0charCodeAt\0concat\0endsWith\0includes\0indexOf\0lastIndexOf\0length\0match\0padEnd\0padStart\0repeat\0replace\0slice\0split\0startsWith\0substr\0substring\0toLowerCase\0toUpperCase\0trim\0");
 FLASH_STR(jswSymbols_String_str, "fromCharCode\0");
 FLASH_STR(jswSymbols_Waveform_proto_str, "startInput\0startOutput\0stop\0");
@@ -1532,24 +1647,24 @@ FLASH_STR(jswSymbols_ESP32_str, "deepSleep\0enableWifi\0getState\0reboot\0setAtt
 FLASH_STR(jswSymbols_heatshrink_str, "compress\0decompress\0");
 FLASH_STR(jswSymbols_File_proto_str, "close\0pipe\0read\0seek\0skip\0write\0");
 FLASH_STR(jswSymbols_Math_str, "E\0LN10\0LN2\0LOG10E\0LOG2E\0PI\0SQRT1_2\0SQRT2\0abs\0acos\0asin\0atan\0atan2\0ceil\0clip\0cos\0exp\0floor\0log\0max\0min\0pow\0random\0round\0sign\0sin\0sqrt\0tan\0wrap\0");
-FLASH_STR(jswSymbols_Graphics_proto_str, "asBMP\0asImage\0asURL\0blit\0clear\0clearRect\0drawCircle\0drawEllipse\0drawImage\0drawLine\0drawPoly\0drawRect\0drawString\0dump\0fillCircle\0fillEllipse\0fillPoly\0fillRect\0getBPP\0getBgColor\0getColor\0getFont\0getFontHeight\0getFonts\0getHeight\0getModified\0getPixel\0getWidth\0imageMetrics\0lineTo\0moveTo\0quadraticBezier\0reset\0scroll\0setBgColor\0setClipRect\0setColor\0setFont\0setFontAlign\0setFontBitmap\0setFontCustom\0setFontVector\0setPixel\0setRotation\0setTheme\0stringMetrics\0stringWidth\0theme\0toColor\0transformVertices\0wrapString\0");
-FLASH_STR(jswSymbols_Graphics_str, "createArrayBuffer\0createCallback\0createImage\0getInstance\0");
+FLASH_STR(jswSymbols_Graphics_proto_str, "asBMP\0asImage\0asURL\0beginList\0blendColor\0blit\0clear\0clearRect\0drawCircle\0drawCircleAA\0drawEllipse\0drawImage\0drawImages\0drawLine\0drawLineAA\0drawList\0drawPoly\0drawPolyAA\0drawRect\0drawString\0dump\0endList\0fillCircle\0fillEllipse\0fillPoly\0fillPolyAA\0fillRect\0flipSPI\0getBPP\0getBgColor\0getColor\0getFlipStats\0getFont\0getFontHeight\0getFonts\0getHeight\0getModified\0getPixel\0getWidth\0imageMetrics\0lineTo\0moveTo\0quadraticBezier\0reset\0scroll\0setBgColor\0setClipRect\0setColor\0setFont\0setFontAlign\0setFontBitmap\0setFontCustom\0setFontVector\0setPixel\0setRotation\0setTheme\0stringMetrics\0stringWidth\0theme\0toColor\0transformVertices\0wrapString\0");
+FLASH_STR(jswSymbols_Graphics_str, "createArrayBuffer\0createCallback\0createImage\0getInstance\0getVectorFontCache\0setVectorFontCache\0");
 FLASH_STR(jswSymbols_url_str, "parse\0");
 FLASH_STR(jswSymbols_Socket_str, "");
-FLASH_STR(jswSymbols_Socket_proto_str, "available\0end\0pipe\0read\0write\0");
-FLASH_STR(jswSymbols_net_str, "connect\0createServer\0");
+FLASH_STR(jswSymbols_Socket_proto_str, "available\0end\0pause\0pipe\0read\0resume\0setHighWaterMark\0write\0");
+FLASH_STR(jswSymbols_net_str, "connect\0createServer\0lookup\0setDNSServer\0");
 FLASH_STR(jswSymbols_dgram_str, "createSocket\0");
-FLASH_STR(jswSymbols_dgramSocket_proto_str, "addMembership\0bind\0close\0send\0");
+FLASH_STR(jswSymbols_dgramSocket_proto_str, "addMembership\0bind\0close\0send\0sendMany\0");
 FLASH_STR(jswSymbols_dgramSocket_str, "");
 FLASH_STR(jswSymbols_tls_str, "connect\0");
 FLASH_STR(jswSymbols_Server_proto_str, "close\0listen\0");
 FLASH_STR(jswSymbols_httpSRq_str, "");
-FLASH_STR(jswSymbols_httpSRq_proto_str, "available\0pipe\0read\0");
+FLASH_STR(jswSymbols_httpSRq_proto_str, "available\0pause\0pipe\0read\0resume\0setHighWaterMark\0upgrade\0");
 FLASH_STR(jswSymbols_httpSRs_str, "");
 FLASH_STR(jswSymbols_httpCRq_str, "");
 FLASH_STR(jswSymbols_httpCRs_str, "");
-FLASH_STR(jswSymbols_httpCRs_proto_str, "available\0pipe\0read\0");
-FLASH_STR(jswSymbols_http_str, "createServer\0get\0request\0");
+FLASH_STR(jswSymbols_httpCRs_proto_str, "available\0pause\0pipe\0read\0resume\0setHighWaterMark\0");
+FLASH_STR(jswSymbols_http_str, "createServer\0get\0request\0websocket\0");
 FLASH_STR(jswSymbols_httpSrv_proto_str, "close\0listen\0");
 FLASH_STR(jswSymbols_httpSRs_proto_str, "end\0setHeader\0write\0writeHead\0");
 FLASH_STR(jswSymbols_httpCRq_proto_str, "end\0write\0");
@@ -1558,79 +1673,309 @@ FLASH_STR(jswSymbols_Wifi_str, "connect\0disconnect\0getAPDetails\0getAPIP\0getD
 FLASH_STR(jswSymbols_TelnetServer_str, "setOptions\0");
 FLASH_STR(jswSymbols_crypto_str, "AES\0PBKDF2\0SHA1\0SHA224\0SHA256\0SHA384\0SHA512\0");
 FLASH_STR(jswSymbols_AES_str, "decrypt\0encrypt\0");
+FLASH_STR(jswSymbols_WebSocket_str, "");
+FLASH_STR(jswSymbols_WebSocket_proto_str, "close\0ping\0send\0");
+FLASH_STR(jswSymbols_MQTT_str, "create\0");
+FLASH_STR(jswSymbols_MQTTClient_str, "");
+FLASH_STR(jswSymbols_MQTTClient_proto_str, "connect\0disconnect\0publish\0subscribe\0unsubscribe\0");
+
+static const unsigned char jswSymbols_global_hash[] FLASH_SECT = {
+  198,0,5,125,0,1,2,0,10,41,13,1,23,1,47,1,2,37,17,22,10,22,164,30,
+  0,49,112,1,0,94,44,89,72,83,65,31,37,26,59,7,3,28,70,111,12,41,50,90,
+  84,33,99,16,24,96,105,18,27,34,19,22,92,47,14,61,109,255,35,51,114,23,75,255,
+  87,56,53,40,103,78,20,69,82,13,0,108,113,25,5,255,45,80,73,100,57,79,54,52,
+  15,42,62,255,30,95,66,255,48,85,93,63,55,88,49,11,106,21,67,86,77,10,9,38,
+  101,102,112,8,2,104,43,46,97,74,60,81,110,255,1,4,6,255,68,58,64,98,76,17,
+  29,255,39,107,32,71,91,36
+};
+static const unsigned char jswSymbols_Array_proto_hash[] FLASH_SECT = {
+  52,0,32,2,35,27,15,14,12,18,20,8,0,9,21,6,11,1,5,7,16,19,3,13,
+  17,255,10,22,2,4
+};
+static const unsigned char jswSymbols_Array_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_ArrayBuffer_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_ArrayBufferView_proto_hash[] FLASH_SECT = {
+  18,0,128,1,0,13,12,6,14,1,9,17,10,11,3,15,2,4,0,8,7,16,5
+};
+static const unsigned char jswSymbols_DataView_proto_hash[] FLASH_SECT = {
+  29,0,57,105,10,2,3,13,7,15,8,6,1,4,12,9,11,5,0,14
+};
+static const unsigned char jswSymbols_Date_hash[] FLASH_SECT = {
+  4,1,0
+};
+static const unsigned char jswSymbols_Date_proto_hash[] FLASH_SECT = {
+  12,15,146,2,45,100,14,9,14,22,18,8,20,19,12,11,0,24,1,4,2,5,16,7,
+  3,13,10,21,15,23,17,6
+};
+static const unsigned char jswSymbols_Error_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_SyntaxError_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_TypeError_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_InternalError_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_ReferenceError_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_E_hash[] FLASH_SECT = {
+  3,0,165,0,34,53,9,0,3,72,16,55,36,31,29,34,21,1,23,12,17,8,49,44,
+  28,37,33,5,18,10,255,19,51,13,42,3,26,48,4,22,14,11,43,15,25,30,46,24,
+  41,35,32,38,9,39,7,255,50,0,16,45,36,6,47,255,40,20,27,2
+};
+static const unsigned char jswSymbols_Flash_hash[] FLASH_SECT = {
+  0,13,0,4,3,2,1
+};
+static const unsigned char jswSymbols_console_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_JSON_hash[] FLASH_SECT = {
+  0,1,0
+};
+static const unsigned char jswSymbols_Modules_hash[] FLASH_SECT = {
+  2,3,0,2,1
+};
+static const unsigned char jswSymbols_Pin_proto_hash[] FLASH_SECT = {
+  5,47,5,2,8,4,7,6,1,3,5,0
+};
+static const unsigned char jswSymbols_Number_hash[] FLASH_SECT = {
+  3,12,0,1,4,3,2
+};
+static const unsigned char jswSymbols_Number_proto_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_Object_proto_hash[] FLASH_SECT = {
+  1,0,74,4,8,6,2,0,1,3,7,5
+};
+static const unsigned char jswSymbols_Object_hash[] FLASH_SECT = {
+  1,2,73,3,1,8,6,7,4,5,9,0,10,2
+};
+static const unsigned char jswSymbols_Function_proto_hash[] FLASH_SECT = {
+  1,1,0,2,3
+};
+static const unsigned char jswSymbols_OneWire_proto_hash[] FLASH_SECT = {
+  2,17,2,5,0,1,3,4
+};
+static const unsigned char jswSymbols_fs_hash[] FLASH_SECT = {
+  1,15,174,17,4,11,3,8,7,12,5,1,2,0,10,9,6,13
+};
+static const unsigned char jswSymbols_process_hash[] FLASH_SECT = {
+  4,0,2,1
+};
+static const unsigned char jswSymbols_Promise_hash[] FLASH_SECT = {
+  0,0,2,1
+};
+static const unsigned char jswSymbols_Promise_proto_hash[] FLASH_SECT = {
+  0,1,0
+};
+static const unsigned char jswSymbols_RegExp_proto_hash[] FLASH_SECT = {
+  0,0,1
+};
+static const unsigned char jswSymbols_Serial_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_Serial_proto_hash[] FLASH_SECT = {
+  0,50,1,3,2,255,0,1,5,4,10,8,6,9,7
+};
+static const unsigned char jswSymbols_Storage_hash[] FLASH_SECT = {
+  5,1,98,64,6,8,4,9,2,0,5,10,13,1,11,3,7,12
+};
+static const unsigned char jswSymbols_StorageFile_proto_hash[] FLASH_SECT = {
+  2,5,0,2,3,1,4
+};
+static const unsigned char jswSymbols_SPI_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_SPI_proto_hash[] FLASH_SECT = {
+  7,9,4,1,3,2,0
+};
+static const unsigned char jswSymbols_I2C_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_I2C_proto_hash[] FLASH_SECT = {
+  21,1,0,3,2
+};
+static const unsigned char jswSymbols_String_proto_hash[] FLASH_SECT = {
+  18,21,13,1,26,7,1,12,18,5,2,14,7,4,20,8,6,3,11,17,13,15,9,10,
+  16,19,0
+};
+static const unsigned char jswSymbols_String_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_Waveform_proto_hash[] FLASH_SECT = {
+  1,0,2,1
+};
+static const unsigned char jswSymbols_ESP32_hash[] FLASH_SECT = {
+  0,0,4,1,2,3,0
+};
+static const unsigned char jswSymbols_heatshrink_hash[] FLASH_SECT = {
+  0,1,0
+};
+static const unsigned char jswSymbols_File_proto_hash[] FLASH_SECT = {
+  17,28,5,1,0,3,4,2
+};
+static const unsigned char jswSymbols_Math_hash[] FLASH_SECT = {
+  0,28,28,12,37,28,123,0,7,2,23,18,16,11,12,8,28,1,26,9,15,4,13,3,
+  6,19,14,20,25,10,27,22,5,0,21,24,17
+};
+static const unsigned char jswSymbols_Graphics_proto_hash[] FLASH_SECT = {
+  61,10,0,0,3,120,0,2,1,48,10,1,13,6,5,204,24,49,35,56,19,12,6,29,
+  59,25,45,10,44,42,2,46,54,30,255,11,27,17,55,32,33,23,20,31,51,18,15,43,
+  41,52,57,58,48,3,26,255,34,16,14,5,39,61,8,53,40,4,38,22,50,7,37,36,
+  60,28,21,47,9,0,13,1
+};
+static const unsigned char jswSymbols_Graphics_hash[] FLASH_SECT = {
+  2,2,3,0,5,2,1,4
+};
+static const unsigned char jswSymbols_url_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_Socket_proto_hash[] FLASH_SECT = {
+  0,15,0,1,2,4,3,6,5,7
+};
+static const unsigned char jswSymbols_net_hash[] FLASH_SECT = {
+  0,2,0,3,1
+};
+static const unsigned char jswSymbols_dgram_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_dgramSocket_proto_hash[] FLASH_SECT = {
+  1,14,0,3,1,2,4
+};
+static const unsigned char jswSymbols_tls_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_Server_proto_hash[] FLASH_SECT = {
+  0,0,1
+};
+static const unsigned char jswSymbols_httpSRq_proto_hash[] FLASH_SECT = {
+  41,12,6,4,0,1,5,3,2
+};
+static const unsigned char jswSymbols_httpCRs_proto_hash[] FLASH_SECT = {
+  16,6,5,4,3,1,0,2
+};
+static const unsigned char jswSymbols_http_hash[] FLASH_SECT = {
+  12,1,0,3,2
+};
+static const unsigned char jswSymbols_httpSrv_proto_hash[] FLASH_SECT = {
+  0,0,1
+};
+static const unsigned char jswSymbols_httpSRs_proto_hash[] FLASH_SECT = {
+  8,1,3,2,0
+};
+static const unsigned char jswSymbols_httpCRq_proto_hash[] FLASH_SECT = {
+  1,0,1
+};
+static const unsigned char jswSymbols_NetworkJS_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_Wifi_hash[] FLASH_SECT = {
+  8,11,2,10,0,14,4,7,12,1,0,2,9,8,15,3,10,255,13,11,17,6,5,16
+};
+static const unsigned char jswSymbols_TelnetServer_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_crypto_hash[] FLASH_SECT = {
+  7,43,1,4,6,2,3,5,0
+};
+static const unsigned char jswSymbols_AES_hash[] FLASH_SECT = {
+  4,1,0
+};
+static const unsigned char jswSymbols_WebSocket_proto_hash[] FLASH_SECT = {
+  3,1,2,0
+};
+static const unsigned char jswSymbols_MQTT_hash[] FLASH_SECT = {
+  0,0
+};
+static const unsigned char jswSymbols_MQTTClient_proto_hash[] FLASH_SECT = {
+  7,1,4,2,1,0,3
+};
 
 const JswSymList jswSymbolTables[] FLASH_SECT = {
-  {jswSymbols_global, jswSymbols_global_str, 113},
-  {jswSymbols_Array_proto, jswSymbols_Array_proto_str, 23},
-  {jswSymbols_Array, jswSymbols_Array_str, 1},
-  {jswSymbols_ArrayBuffer_proto, jswSymbols_ArrayBuffer_proto_str, 1},
-  {jswSymbols_ArrayBufferView_proto, jswSymbols_ArrayBufferView_proto_str, 18},
-  {jswSymbols_DataView_proto, jswSymbols_DataView_proto_str, 16},
-  {jswSymbols_Date, jswSymbols_Date_str, 2},
-  {jswSymbols_Date_proto, jswSymbols_Date_proto_str, 25},
-  {jswSymbols_Error_proto, jswSymbols_Error_proto_str, 1},
-  {jswSymbols_SyntaxError_proto, jswSymbols_SyntaxError_proto_str, 1},
-  {jswSymbols_TypeError_proto, jswSymbols_TypeError_proto_str, 1},
-  {jswSymbols_InternalError_proto, jswSymbols_InternalError_proto_str, 1},
-  {jswSymbols_ReferenceError_proto, jswSymbols_ReferenceError_proto_str, 1},
-  {jswSymbols_E, jswSymbols_E_str, 51},
-  {jswSymbols_Flash, jswSymbols_Flash_str, 5},
-  {jswSymbols_console, jswSymbols_console_str, 1},
-  {jswSymbols_JSON, jswSymbols_JSON_str, 2},
-  {jswSymbols_Modules, jswSymbols_Modules_str, 4},
-  {jswSymbols_Pin_proto, jswSymbols_Pin_proto_str, 9},
-  {jswSymbols_Number, jswSymbols_Number_str, 5},
-  {jswSymbols_Number_proto, jswSymbols_Number_proto_str, 1},
-  {jswSymbols_Object_proto, jswSymbols_Object_proto_str, 9},
-  {jswSymbols_Object, jswSymbols_Object_str, 11},
-  {jswSymbols_Function_proto, jswSymbols_Function_proto_str, 4},
-  {jswSymbols_OneWire_proto, jswSymbols_OneWire_proto_str, 6},
-  {jswSymbols_fs, jswSymbols_fs_str, 14},
-  {jswSymbols_process, jswSymbols_process_str, 3},
-  {jswSymbols_Promise, jswSymbols_Promise_str, 3},
-  {jswSymbols_Promise_proto, jswSymbols_Promise_proto_str, 2},
-  {jswSymbols_RegExp_proto, jswSymbols_RegExp_proto_str, 2},
-  {jswSymbols_Serial, jswSymbols_Serial_str, 1},
-  {jswSymbols_Serial_proto, jswSymbols_Serial_proto_str, 10},
-  {jswSymbols_Storage, jswSymbols_Storage_str, 14},
-  {jswSymbols_StorageFile_proto, jswSymbols_StorageFile_proto_str, 5},
-  {jswSymbols_SPI, jswSymbols_SPI_str, 1},
-  {jswSymbols_SPI_proto, jswSymbols_SPI_proto_str, 5},
-  {jswSymbols_I2C, jswSymbols_I2C_str, 1},
-  {jswSymbols_I2C_proto, jswSymbols_I2C_proto_str, 3},
-  {jswSymbols_String_proto, jswSymbols_String_proto_str, 21},
-  {jswSymbols_String, jswSymbols_String_str, 1},
-  {jswSymbols_Waveform_proto, jswSymbols_Waveform_proto_str, 3},
-  {jswSymbols_ESP32, jswSymbols_ESP32_str, 5},
-  {jswSymbols_heatshrink, jswSymbols_heatshrink_str, 2},
-  {jswSymbols_File_proto, jswSymbols_File_proto_str, 6},
-  {jswSymbols_Math, jswSymbols_Math_str, 29},
-  {jswSymbols_Graphics_proto, jswSymbols_Graphics_proto_str, 51},
-  {jswSymbols_Graphics, jswSymbols_Graphics_str, 4},
-  {jswSymbols_url, jswSymbols_url_str, 1},
-  {jswSymbols_Socket, jswSymbols_Socket_str, 0},
-  {jswSymbols_Socket_proto, jswSymbols_Socket_proto_str, 5},
-  {jswSymbols_net, jswSymbols_net_str, 2},
-  {jswSymbols_dgram, jswSymbols_dgram_str, 1},
-  {jswSymbols_dgramSocket_proto, jswSymbols_dgramSocket_proto_str, 4},
-  {jswSymbols_dgramSocket, jswSymbols_dgramSocket_str, 0},
-  {jswSymbols_tls, jswSymbols_tls_str, 1},
-  {jswSymbols_Server_proto, jswSymbols_Server_proto_str, 2},
-  {jswSymbols_httpSRq, jswSymbols_httpSRq_str, 0},
-  {jswSymbols_httpSRq_proto, jswSymbols_httpSRq_proto_str, 3},
-  {jswSymbols_httpSRs, jswSymbols_httpSRs_str, 0},
-  {jswSymbols_httpCRq, jswSymbols_httpCRq_str, 0},
-  {jswSymbols_httpCRs, jswSymbols_httpCRs_str, 0},
-  {jswSymbols_httpCRs_proto, jswSymbols_httpCRs_proto_str, 3},
-  {jswSymbols_http, jswSymbols_http_str, 3},
-  {jswSymbols_httpSrv_proto, jswSymbols_httpSrv_proto_str, 2},
-  {jswSymbols_httpSRs_proto, jswSymbols_httpSRs_proto_str, 4},
-  {jswSymbols_httpCRq_proto, jswSymbols_httpCRq_proto_str, 2},
-  {jswSymbols_NetworkJS, jswSymbols_NetworkJS_str, 1},
-  {jswSymbols_Wifi, jswSymbols_Wifi_str, 18},
-  {jswSymbols_TelnetServer, jswSymbols_TelnetServer_str, 1},
-  {jswSymbols_crypto, jswSymbols_crypto_str, 7},
-  {jswSymbols_AES, jswSymbols_AES_str, 2},
+  {jswSymbols_global, jswSymbols_global_str, 115, jswSymbols_global_hash, 29, 123},
+  {jswSymbols_Array_proto, jswSymbols_Array_proto_str, 23, jswSymbols_Array_proto_hash, 6, 24},
+  {jswSymbols_Array, jswSymbols_Array_str, 1, jswSymbols_Array_hash, 1, 1},
+  {jswSymbols_ArrayBuffer_proto, jswSymbols_ArrayBuffer_proto_str, 1, jswSymbols_ArrayBuffer_proto_hash, 1, 1},
+  {jswSymbols_ArrayBufferView_proto, jswSymbols_ArrayBufferView_proto_str, 18, jswSymbols_ArrayBufferView_proto_hash, 5, 18},
+  {jswSymbols_DataView_proto, jswSymbols_DataView_proto_str, 16, jswSymbols_DataView_proto_hash, 4, 16},
+  {jswSymbols_Date, jswSymbols_Date_str, 2, jswSymbols_Date_hash, 1, 2},
+  {jswSymbols_Date_proto, jswSymbols_Date_proto_str, 25, jswSymbols_Date_proto_hash, 7, 25},
+  {jswSymbols_Error_proto, jswSymbols_Error_proto_str, 1, jswSymbols_Error_proto_hash, 1, 1},
+  {jswSymbols_SyntaxError_proto, jswSymbols_SyntaxError_proto_str, 1, jswSymbols_SyntaxError_proto_hash, 1, 1},
+  {jswSymbols_TypeError_proto, jswSymbols_TypeError_proto_str, 1, jswSymbols_TypeError_proto_hash, 1, 1},
+  {jswSymbols_InternalError_proto, jswSymbols_InternalError_proto_str, 1, jswSymbols_InternalError_proto_hash, 1, 1},
+  {jswSymbols_ReferenceError_proto, jswSymbols_ReferenceError_proto_str, 1, jswSymbols_ReferenceError_proto_hash, 1, 1},
+  {jswSymbols_E, jswSymbols_E_str, 52, jswSymbols_E_hash, 13, 55},
+  {jswSymbols_Flash, jswSymbols_Flash_str, 5, jswSymbols_Flash_hash, 2, 5},
+  {jswSymbols_console, jswSymbols_console_str, 1, jswSymbols_console_hash, 1, 1},
+  {jswSymbols_JSON, jswSymbols_JSON_str, 2, jswSymbols_JSON_hash, 1, 2},
+  {jswSymbols_Modules, jswSymbols_Modules_str, 4, jswSymbols_Modules_hash, 1, 4},
+  {jswSymbols_Pin_proto, jswSymbols_Pin_proto_str, 9, jswSymbols_Pin_proto_hash, 3, 9},
+  {jswSymbols_Number, jswSymbols_Number_str, 5, jswSymbols_Number_hash, 2, 5},
+  {jswSymbols_Number_proto, jswSymbols_Number_proto_str, 1, jswSymbols_Number_proto_hash, 1, 1},
+  {jswSymbols_Object_proto, jswSymbols_Object_proto_str, 9, jswSymbols_Object_proto_hash, 3, 9},
+  {jswSymbols_Object, jswSymbols_Object_str, 11, jswSymbols_Object_hash, 3, 11},
+  {jswSymbols_Function_proto, jswSymbols_Function_proto_str, 4, jswSymbols_Function_proto_hash, 1, 4},
+  {jswSymbols_OneWire_proto, jswSymbols_OneWire_proto_str, 6, jswSymbols_OneWire_proto_hash, 2, 6},
+  {jswSymbols_fs, jswSymbols_fs_str, 14, jswSymbols_fs_hash, 4, 14},
+  {jswSymbols_process, jswSymbols_process_str, 3, jswSymbols_process_hash, 1, 3},
+  {jswSymbols_Promise, jswSymbols_Promise_str, 3, jswSymbols_Promise_hash, 1, 3},
+  {jswSymbols_Promise_proto, jswSymbols_Promise_proto_str, 2, jswSymbols_Promise_proto_hash, 1, 2},
+  {jswSymbols_RegExp_proto, jswSymbols_RegExp_proto_str, 2, jswSymbols_RegExp_proto_hash, 1, 2},
+  {jswSymbols_Serial, jswSymbols_Serial_str, 1, jswSymbols_Serial_hash, 1, 1},
+  {jswSymbols_Serial_proto, jswSymbols_Serial_proto_str, 11, jswSymbols_Serial_proto_hash, 3, 12},
+  {jswSymbols_Storage, jswSymbols_Storage_str, 14, jswSymbols_Storage_hash, 4, 14},
+  {jswSymbols_StorageFile_proto, jswSymbols_StorageFile_proto_str, 5, jswSymbols_StorageFile_proto_hash, 2, 5},
+  {jswSymbols_SPI, jswSymbols_SPI_str, 1, jswSymbols_SPI_hash, 1, 1},
+  {jswSymbols_SPI_proto, jswSymbols_SPI_proto_str, 5, jswSymbols_SPI_proto_hash, 2, 5},
+  {jswSymbols_I2C, jswSymbols_I2C_str, 1, jswSymbols_I2C_hash, 1, 1},
+  {jswSymbols_I2C_proto, jswSymbols_I2C_proto_str, 4, jswSymbols_I2C_proto_hash, 1, 4},
+  {jswSymbols_String_proto, jswSymbols_String_proto_str, 21, jswSymbols_String_proto_hash, 6, 21},
+  {jswSymbols_String, jswSymbols_String_str, 1, jswSymbols_String_hash, 1, 1},
+  {jswSymbols_Waveform_proto, jswSymbols_Waveform_proto_str, 3, jswSymbols_Waveform_proto_hash, 1, 3},
+  {jswSymbols_ESP32, jswSymbols_ESP32_str, 5, jswSymbols_ESP32_hash, 2, 5},
+  {jswSymbols_heatshrink, jswSymbols_heatshrink_str, 2, jswSymbols_heatshrink_hash, 1, 2},
+  {jswSymbols_File_proto, jswSymbols_File_proto_str, 6, jswSymbols_File_proto_hash, 2, 6},
+  {jswSymbols_Math, jswSymbols_Math_str, 29, jswSymbols_Math_hash, 8, 29},
+  {jswSymbols_Graphics_proto, jswSymbols_Graphics_proto_str, 62, jswSymbols_Graphics_proto_hash, 16, 64},
+  {jswSymbols_Graphics, jswSymbols_Graphics_str, 6, jswSymbols_Graphics_hash, 2, 6},
+  {jswSymbols_url, jswSymbols_url_str, 1, jswSymbols_url_hash, 1, 1},
+  {jswSymbols_Socket, jswSymbols_Socket_str, 0, 0, 0, 0},
+  {jswSymbols_Socket_proto, jswSymbols_Socket_proto_str, 8, jswSymbols_Socket_proto_hash, 2, 8},
+  {jswSymbols_net, jswSymbols_net_str, 4, jswSymbols_net_hash, 1, 4},
+  {jswSymbols_dgram, jswSymbols_dgram_str, 1, jswSymbols_dgram_hash, 1, 1},
+  {jswSymbols_dgramSocket_proto, jswSymbols_dgramSocket_proto_str, 5, jswSymbols_dgramSocket_proto_hash, 2, 5},
+  {jswSymbols_dgramSocket, jswSymbols_dgramSocket_str, 0, 0, 0, 0},
+  {jswSymbols_tls, jswSymbols_tls_str, 1, jswSymbols_tls_hash, 1, 1},
+  {jswSymbols_Server_proto, jswSymbols_Server_proto_str, 2, jswSymbols_Server_proto_hash, 1, 2},
+  {jswSymbols_httpSRq, jswSymbols_httpSRq_str, 0, 0, 0, 0},
+  {jswSymbols_httpSRq_proto, jswSymbols_httpSRq_proto_str, 7, jswSymbols_httpSRq_proto_hash, 2, 7},
+  {jswSymbols_httpSRs, jswSymbols_httpSRs_str, 0, 0, 0, 0},
+  {jswSymbols_httpCRq, jswSymbols_httpCRq_str, 0, 0, 0, 0},
+  {jswSymbols_httpCRs, jswSymbols_httpCRs_str, 0, 0, 0, 0},
+  {jswSymbols_httpCRs_proto, jswSymbols_httpCRs_proto_str, 6, jswSymbols_httpCRs_proto_hash, 2, 6},
+  {jswSymbols_http, jswSymbols_http_str, 4, jswSymbols_http_hash, 1, 4},
+  {jswSymbols_httpSrv_proto, jswSymbols_httpSrv_proto_str, 2, jswSymbols_httpSrv_proto_hash, 1, 2},
+  {jswSymbols_httpSRs_proto, jswSymbols_httpSRs_proto_str, 4, jswSymbols_httpSRs_proto_hash, 1, 4},
+  {jswSymbols_httpCRq_proto, jswSymbols_httpCRq_proto_str, 2, jswSymbols_httpCRq_proto_hash, 1, 2},
+  {jswSymbols_NetworkJS, jswSymbols_NetworkJS_str, 1, jswSymbols_NetworkJS_hash, 1, 1},
+  {jswSymbols_Wifi, jswSymbols_Wifi_str, 18, jswSymbols_Wifi_hash, 5, 19},
+  {jswSymbols_TelnetServer, jswSymbols_TelnetServer_str, 1, jswSymbols_TelnetServer_hash, 1, 1},
+  {jswSymbols_crypto, jswSymbols_crypto_str, 7, jswSymbols_crypto_hash, 2, 7},
+  {jswSymbols_AES, jswSymbols_AES_str, 2, jswSymbols_AES_hash, 1, 2},
+  {jswSymbols_WebSocket, jswSymbols_WebSocket_str, 0, 0, 0, 0},
+  {jswSymbols_WebSocket_proto, jswSymbols_WebSocket_proto_str, 3, jswSymbols_WebSocket_proto_hash, 1, 3},
+  {jswSymbols_MQTT, jswSymbols_MQTT_str, 1, jswSymbols_MQTT_hash, 1, 1},
+  {jswSymbols_MQTTClient, jswSymbols_MQTTClient_str, 0, 0, 0, 0},
+  {jswSymbols_MQTTClient_proto, jswSymbols_MQTTClient_proto_str, 5, jswSymbols_MQTTClient_proto_hash, 2, 5},
 };
 
 
@@ -1661,47 +2006,50 @@ const JswSymList *jswGetSymbolListForConstructorProto(JsVar *constructor) {
   if (constructorPtr==(void*)gen_jswrap_httpSrv_httpSrv) return &jswSymbolTables[jswSymbolIndex_httpSrv_proto];
   if (constructorPtr==(void*)gen_jswrap_httpSRs_httpSRs) return &jswSymbolTables[jswSymbolIndex_httpSRs_proto];
   if (constructorPtr==(void*)gen_jswrap_httpCRq_httpCRq) return &jswSymbolTables[jswSymbolIndex_httpCRq_proto];
+  if (constructorPtr==(void*)gen_jswrap_WebSocket_WebSocket) return &jswSymbolTables[jswSymbolIndex_WebSocket_proto];
+  if (constructorPtr==(void*)gen_jswrap_MQTTClient_MQTTClient) return &jswSymbolTables[jswSymbolIndex_MQTTClient_proto];
   return 0;
 }
 
 
 JsVar *jswFindBuiltInFunction(JsVar *parent, const char *name) {
   JsVar *v;
+  unsigned int hash = jswHashSymbol(name);
   if (parent && !jsvIsRoot(parent)) {
     // ------------------------------------------ INSTANCE + STATIC METHODS
     if (jsvIsNativeFunction(parent)) {
       const JswSymList *l = jswGetSymbolListForObject(parent);
       if (l) {
-        v = jswBinarySearch(l, parent, name);
+        v = jswHashSearch(l, parent, name, hash);
         if (v) return v;
       }
     }
     if (jsvIsArray(parent)) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_Array_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_Array_proto], parent, name, hash);
       if (v) return v;
     }
     if (jsvIsArrayBuffer(parent) && parent->varData.arraybuffer.type==ARRAYBUFFERVIEW_ARRAYBUFFER) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_ArrayBuffer_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_ArrayBuffer_proto], parent, name, hash);
       if (v) return v;
     }
     if (jsvIsArrayBuffer(parent) && parent->varData.arraybuffer.type!=ARRAYBUFFERVIEW_ARRAYBUFFER) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_ArrayBufferView_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_ArrayBufferView_proto], parent, name, hash);
       if (v) return v;
     }
     if (jsvIsPin(parent)) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_Pin_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_Pin_proto], parent, name, hash);
       if (v) return v;
     }
     if (jsvIsNumeric(parent)) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_Number_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_Number_proto], parent, name, hash);
       if (v) return v;
     }
     if (jsvIsFunction(parent)) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_Function_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_Function_proto], parent, name, hash);
       if (v) return v;
     }
     if (jsvIsString(parent)) {
-      v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_String_proto], parent, name);
+      v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_String_proto], parent, name, hash);
       if (v) return v;
     }
     // ------------------------------------------ INSTANCE METHODS WE MUST CHECK CONSTRUCTOR FOR
@@ -1712,14 +2060,14 @@ JsVar *jswFindBuiltInFunction(JsVar *parent, const char *name) {
       const JswSymList *l = jswGetSymbolListForConstructorProto(constructor);
       jsvUnLock(constructor);
       if (l) {
-        v = jswBinarySearch(l, parent, name);
+        v = jswHashSearch(l, parent, name, hash);
         if (v) return v;
       }
     } else {
       jsvUnLock(constructor);
     }
     // ------------------------------------------ METHODS ON OBJECT
-    v = jswBinarySearch(&jswSymbolTables[jswSymbolIndex_Object_proto], parent, name);
+    v = jswHashSearch(&jswSymbolTables[jswSymbolIndex_Object_proto], parent, name, hash);
     if (v) return v;
   } else { /* if (!parent) */
     // ------------------------------------------ FUNCTIONS
@@ -1728,7 +2076,7 @@ JsVar *jswFindBuiltInFunction(JsVar *parent, const char *name) {
     if (pin != PIN_UNDEFINED) {
       return jsvNewFromPin(pin);
     }
-    return jswBinarySearch(&jswSymbolTables[jswSymbolIndex_global], parent, name);
+    return jswHashSearch(&jswSymbolTables[jswSymbolIndex_global], parent, name, hash);
   }
   return 0;
 }
@@ -1768,6 +2116,9 @@ const JswSymList *jswGetSymbolListForObject(JsVar *parent) {
     if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_httpCRq_httpCRq) return &jswSymbolTables[jswSymbolIndex_httpCRq];
     if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_httpCRs_httpCRs) return &jswSymbolTables[jswSymbolIndex_httpCRs];
     if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_http_http) return &jswSymbolTables[jswSymbolIndex_http];
+    if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_WebSocket_WebSocket) return &jswSymbolTables[jswSymbolIndex_WebSocket];
+    if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_MQTT_MQTT) return &jswSymbolTables[jswSymbolIndex_MQTT];
+    if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_MQTTClient_MQTTClient) return &jswSymbolTables[jswSymbolIndex_MQTTClient];
     if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_NetworkJS_NetworkJS) return &jswSymbolTables[jswSymbolIndex_NetworkJS];
     if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_Wifi_Wifi) return &jswSymbolTables[jswSymbolIndex_Wifi];
     if ((void*)parent->varData.native.ptr==(void*)gen_jswrap_TelnetServer_TelnetServer) return &jswSymbolTables[jswSymbolIndex_TelnetServer];
@@ -1806,61 +2157,22 @@ const JswSymList *jswGetSymbolListForObjectProto(JsVar *parent) {
 }
 
 
+FLASH_STR(jswBuiltInObjects_str, "Array\0ArrayBuffer\0ArrayBufferView\0Uint8Array\0Uint8ClampedArray\0Int8Array\0Uint16Array\0Int16Array\0Uint24Array\0Uint32Array\0Int32Array\0Float32Array\0Float64Array\0DataView\0Date\0Error\0SyntaxError\0TypeError\0InternalError\0ReferenceError\0E\0Function\0console\0JSON\0Modules\0Pin\0Number\0Object\0Boolean\0OneWire\0process\0Promise\0RegExp\0Serial\0StorageFile\0SPI\0I2C\0String\0Waveform\0ESP32\0File\0Math\0Graphics\0url\0Server\0Socket\0dgramSocket\0httpSrv\0httpSRq\0httpSRs\0httpCRq\0httpCRs\0WebSocket\0MQTTClient\0AES\0");
+static const unsigned short jswBuiltInObjects_offsets[] FLASH_SECT = {
+  0,6,18,34,45,63,73,85,96,108,120,131,144,157,166,171,177,189,199,213,228,230,239,247,
+  252,260,264,271,278,286,294,302,310,317,324,336,340,344,351,360,366,371,376,385,389,396,403,415,
+  423,431,439,447,455,465,476
+};
+static const unsigned char jswBuiltInObjects_hash[] FLASH_SECT = {
+  0,11,14,15,3,8,0,172,0,137,26,81,6,32,4,31,23,3,51,13,12,30,53,15,
+  1,2,14,9,41,47,46,21,16,0,43,28,24,54,52,17,22,39,18,32,25,27,29,6,
+  11,19,48,33,7,255,37,8,20,34,35,45,42,40,5,36,49,44,50,38,26,10
+};
+
 bool jswIsBuiltInObject(const char *name) {
-  return
-strcmp(name, "Array")==0 ||
-    strcmp(name, "ArrayBuffer")==0 ||
-    strcmp(name, "ArrayBufferView")==0 ||
-    strcmp(name, "Uint8Array")==0 ||
-    strcmp(name, "Uint8ClampedArray")==0 ||
-    strcmp(name, "Int8Array")==0 ||
-    strcmp(name, "Uint16Array")==0 ||
-    strcmp(name, "Int16Array")==0 ||
-    strcmp(name, "Uint24Array")==0 ||
-    strcmp(name, "Uint32Array")==0 ||
-    strcmp(name, "Int32Array")==0 ||
-    strcmp(name, "Float32Array")==0 ||
-    strcmp(name, "Float64Array")==0 ||
-    strcmp(name, "DataView")==0 ||
-    strcmp(name, "Date")==0 ||
-    strcmp(name, "Error")==0 ||
-    strcmp(name, "SyntaxError")==0 ||
-    strcmp(name, "TypeError")==0 ||
-    strcmp(name, "InternalError")==0 ||
-    strcmp(name, "ReferenceError")==0 ||
-    strcmp(name, "E")==0 ||
-    strcmp(name, "Function")==0 ||
-    strcmp(name, "console")==0 ||
-    strcmp(name, "JSON")==0 ||
-    strcmp(name, "Modules")==0 ||
-    strcmp(name, "Pin")==0 ||
-    strcmp(name, "Number")==0 ||
-    strcmp(name, "Object")==0 ||
-    strcmp(name, "Boolean")==0 ||
-    strcmp(name, "OneWire")==0 ||
-    strcmp(name, "process")==0 ||
-    strcmp(name, "Promise")==0 ||
-    strcmp(name, "RegExp")==0 ||
-    strcmp(name, "Serial")==0 ||
-    strcmp(name, "StorageFile")==0 ||
-    strcmp(name, "SPI")==0 ||
-    strcmp(name, "I2C")==0 ||
-    strcmp(name, "String")==0 ||
-    strcmp(name, "Waveform")==0 ||
-    strcmp(name, "ESP32")==0 ||
-    strcmp(name, "File")==0 ||
-    strcmp(name, "Math")==0 ||
-    strcmp(name, "Graphics")==0 ||
-    strcmp(name, "url")==0 ||
-    strcmp(name, "Server")==0 ||
-    strcmp(name, "Socket")==0 ||
-    strcmp(name, "dgramSocket")==0 ||
-    strcmp(name, "httpSrv")==0 ||
-    strcmp(name, "httpSRq")==0 ||
-    strcmp(name, "httpSRs")==0 ||
-    strcmp(name, "httpCRq")==0 ||
-    strcmp(name, "httpCRs")==0 ||
-    strcmp(name, "AES")==0;
+  unsigned char idx = jswHashGetIndex(jswBuiltInObjects_hash, 14, 56, jswHashSymbol(name));
+  return idx!=JSW_HASH_NONE &&
+         FLASH_STRCMP(name, &jswBuiltInObjects_str[READ_FLASH_UINT16(&jswBuiltInObjects_offsets[idx])])==0;
 }
 
 
@@ -1873,6 +2185,7 @@ void *jswGetBuiltInLibrary(const char *name) {
   if (strcmp(name, "dgram")==0) return (void*)gen_jswrap_dgram_dgram;
   if (strcmp(name, "tls")==0) return (void*)gen_jswrap_tls_tls;
   if (strcmp(name, "http")==0) return (void*)gen_jswrap_http_http;
+  if (strcmp(name, "MQTT")==0) return (void*)gen_jswrap_MQTT_MQTT;
   if (strcmp(name, "NetworkJS")==0) return (void*)gen_jswrap_NetworkJS_NetworkJS;
   if (strcmp(name, "Wifi")==0) return (void*)gen_jswrap_Wifi_Wifi;
   if (strcmp(name, "TelnetServer")==0) return (void*)gen_jswrap_TelnetServer_TelnetServer;
@@ -1925,6 +2238,7 @@ const char *jswGetBasicObjectPrototypeName(const char *objectName) {
 /** Tasks to run on Idle. Returns true if either one of the tasks returned true (eg. they're doing something and want to avoid sleeping) */
 bool jswIdle() {
   bool wasBusy = false;
+  if (jswrap_io_idle()) wasBusy = true;
   if (jswrap_pipe_idle()) wasBusy = true;
   if (jswrap_serial_idle()) wasBusy = true;
   if (jswrap_waveform_idle()) wasBusy = true;
@@ -1942,6 +2256,7 @@ void jswHWInit() {
 
 /** Tasks to run on Initialisation (eg boot/load/reset/after save/etc) */
 void jswInit() {
+  jswrap_io_init();
   jswrap_graphics_init();
   jswrap_net_init();
   jswrap_esp32_wifi_soft_init();
@@ -1951,6 +2266,8 @@ void jswInit() {
 
 /** Tasks to run on Deinitialisation (eg before save/reset/etc) */
 void jswKill() {
+  jswrap_io_kill();
+  jswrap_graphics_kill();
   jswrap_pipe_kill();
   jswrap_waveform_kill();
   jswrap_file_kill();
@@ -1968,7 +2285,7 @@ const char *jswGetBuiltInJSLibrary(const char *name) {
 
 
 const char *jswGetBuiltInLibraryNames() {
-  return "Flash,Storage,heatshrink,fs,net,dgram,tls,http,NetworkJS,Wifi,TelnetServer,crypto";
+  return "Flash,Storage,heatshrink,fs,net,dgram,tls,http,MQTT,NetworkJS,Wifi,TelnetServer,crypto";
 }
 #ifdef USE_CALLFUNCTION_HACK
 // on Emscripten and i386 we cant easily hack around function calls with floats/etc, plus we have enough
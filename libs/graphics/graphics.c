@@ -22,6 +22,7 @@
 
 #include "lcd_arraybuffer.h"
 #include "lcd_js.h"
+#include "lcd_displaylist.h"
 #ifdef USE_LCD_SDL
 #include "lcd_sdl.h"
 #endif
@@ -149,12 +150,14 @@ void graphicsStructInit(JsGraphics *gfx, int width, int height, int bpp) {
   gfx->data.height = (unsigned short)height;
   gfx->data.bpp = (unsigned char)bpp;
   graphicsStructResetState(gfx);
-#ifndef NO_MODIFIED_AREA
-  gfx->data.modMaxX = -32768;
-  gfx->data.modMaxY = -32768;
-  gfx->data.modMinX = 32767;
-  gfx->data.modMinY = 32767;
+#ifdef GRAPHICS_MODIFIED_TILES
+  // choose the smallest tiles that still let the whole display fit in the grid
+  unsigned char shiftX = 0, shiftY = 0;
+  while (((width-1)>>shiftX) >= GRAPHICS_MODIFIED_TILES_X) shiftX++;
+  while (((height-1)>>shiftY) >= GRAPHICS_MODIFIED_TILES_Y) shiftY++;
+  gfx->data.modTileShift = (unsigned char)(shiftX | (shiftY<<4));
 #endif
+  graphicsResetModified(gfx);
 }
 
 /// Set up the callbacks for this graphics instance (usually done by graphicsGetFromVar)
@@ -201,6 +204,10 @@ bool graphicsSetCallbacks(JsGraphics *gfx) {
     assert(0);
     return false;
   }
+#ifndef SAVE_ON_FLASH
+  if (gfx->data.flags & JSGRAPHICSFLAGS_RECORDING)
+    lcdSetCallbacks_DisplayList(gfx);
+#endif
 
   return true;
 }
@@ -300,6 +307,23 @@ unsigned short graphicsGetHeight(const JsGraphics *gfx) {
   return (gfx->data.flags & JSGRAPHICSFLAGS_SWAP_XY) ? gfx->data.width : gfx->data.height;
 }
 
+#ifdef GRAPHICS_MODIFIED_TILES
+/// Mark all tiles touching the given area (inclusive, device coordinates) as modified
+static void graphicsSetModifiedTiles(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
+  if (x1<0) x1=0;
+  if (y1<0) y1=0;
+  if (x2<x1 || y2<y1) return;
+  int tx1 = x1>>(gfx->data.modTileShift&15), tx2 = x2>>(gfx->data.modTileShift&15);
+  int ty1 = y1>>(gfx->data.modTileShift>>4), ty2 = y2>>(gfx->data.modTileShift>>4);
+  if (tx2>=GRAPHICS_MODIFIED_TILES_X) tx2 = GRAPHICS_MODIFIED_TILES_X-1;
+  if (ty2>=GRAPHICS_MODIFIED_TILES_Y) ty2 = GRAPHICS_MODIFIED_TILES_Y-1;
+  if (tx2<tx1) return;
+  unsigned short mask = (unsigned short)(((2U<<tx2)-1) & ~((1U<<tx1)-1));
+  for (int ty=ty1;ty<=ty2;ty++)
+    gfx->data.modTiles[ty] |= mask;
+}
+#endif
+
 // Set the area modified by a draw command and also clip to the screen/clipping bounds
 bool graphicsSetModifiedAndClip(JsGraphics *gfx, int *x1, int *y1, int *x2, int *y2) {
   bool modified = false;
@@ -312,6 +336,9 @@ bool graphicsSetModifiedAndClip(JsGraphics *gfx, int *x1, int *y1, int *x2, int
   if (*x2 > gfx->data.modMaxX) { gfx->data.modMaxX=(short)*x2; modified = true; }
   if (*y1 < gfx->data.modMinY) { gfx->data.modMinY=(short)*y1; modified = true; }
   if (*y2 > gfx->data.modMaxY) { gfx->data.modMaxY=(short)*y2; modified = true; }
+#ifdef GRAPHICS_MODIFIED_TILES
+  graphicsSetModifiedTiles(gfx, *x1, *y1, *x2, *y2);
+#endif
 #else
   if (*x1<0) { *x1 = 0; modified = true; }
   if (*y1<0) { *y1 = 0; modified = true; }
@@ -329,8 +356,78 @@ void graphicsSetModified(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
   if (y1 < gfx->data.modMinY) { gfx->data.modMinY=(short)y1; }
   if (y2 > gfx->data.modMaxY) { gfx->data.modMaxY=(short)y2; }
 #endif
+#ifdef GRAPHICS_MODIFIED_TILES
+  graphicsSetModifiedTiles(gfx, x1, y1, x2, y2);
+#endif
+}
+
+/// Mark the whole Graphics as unmodified
+void graphicsResetModified(JsGraphics *gfx) {
+#ifndef NO_MODIFIED_AREA
+  gfx->data.modMaxX = -32768;
+  gfx->data.modMaxY = -32768;
+  gfx->data.modMinX = 32767;
+  gfx->data.modMinY = 32767;
+#endif
+#ifdef GRAPHICS_MODIFIED_TILES
+  memset(gfx->data.modTiles, 0, sizeof(gfx->data.modTiles));
+#endif
 }
 
+#ifdef GRAPHICS_MODIFIED_TILES
+/** Merge the modified tiles into as few rectangles as we can (inclusive, device coordinates), and return
+ * how many there are. If there would be more than maxRects, the whole modified area is returned instead */
+int graphicsGetModifiedRects(JsGraphics *gfx, JsGraphicsClipRect *rects, int maxRects) {
+  if (gfx->data.modMinX > gfx->data.modMaxX || maxRects<1) return 0;
+  int shiftX = gfx->data.modTileShift&15, shiftY = gfx->data.modTileShift>>4;
+  int count = 0;
+  // Work in tile coordinates first. Each row of tiles is split into runs of modified tiles,
+  // and a run that exactly matches one in the row above just extends that rectangle down
+  for (int ty=0;ty<GRAPHICS_MODIFIED_TILES_Y;ty++) {
+    unsigned int row = gfx->data.modTiles[ty];
+    int tx = 0;
+    while (row) {
+      while (!(row&1)) { row>>=1; tx++; }
+      int tx1 = tx;
+      while (row&1) { row>>=1; tx++; }
+      int tx2 = tx-1;
+      int i;
+      for (i=0;i<count;i++)
+        if (rects[i].x1==tx1 && rects[i].x2==tx2 && rects[i].y2==ty-1) break;
+      if (i<count) {
+        rects[i].y2 = (unsigned short)ty;
+      } else if (count<maxRects) {
+        rects[count].x1 = (unsigned short)tx1;
+        rects[count].y1 = (unsigned short)ty;
+        rects[count].x2 = (unsigned short)tx2;
+        rects[count].y2 = (unsigned short)ty;
+        count++;
+      } else { // too many - just use the modified area
+        rects[0].x1 = (unsigned short)gfx->data.modMinX;
+        rects[0].y1 = (unsigned short)gfx->data.modMinY;
+        rects[0].x2 = (unsigned short)gfx->data.modMaxX;
+        rects[0].y2 = (unsigned short)gfx->data.modMaxY;
+        return 1;
+      }
+    }
+  }
+  // Now convert to pixels, and crop to the modified area since tiles may overhang it
+  for (int i=0;i<count;i++) {
+    int x1 = rects[i].x1<<shiftX, y1 = rects[i].y1<<shiftY;
+    int x2 = ((rects[i].x2+1)<<shiftX)-1, y2 = ((rects[i].y2+1)<<shiftY)-1;
+    if (x1 < gfx->data.modMinX) x1 = gfx->data.modMinX;
+    if (y1 < gfx->data.modMinY) y1 = gfx->data.modMinY;
+    if (x2 > gfx->data.modMaxX) x2 = gfx->data.modMaxX;
+    if (y2 > gfx->data.modMaxY) y2 = gfx->data.modMaxY;
+    rects[i].x1 = (unsigned short)x1;
+    rects[i].y1 = (unsigned short)y1;
+    rects[i].x2 = (unsigned short)x2;
+    rects[i].y2 = (unsigned short)y2;
+  }
+  return count;
+}
+#endif
+
 /// Get a setPixel function (assuming coordinates already clipped with graphicsSetModifiedAndClip) - if all is ok it can choose a faster draw function
 JsGraphicsSetPixelFn graphicsGetSetPixelFn(JsGraphics *gfx) {
   if (gfx->data.flags & JSGRAPHICSFLAGS_MAPPEDXY)
@@ -418,6 +515,10 @@ static void graphicsSetPixelDevice(JsGraphics *gfx, int x, int y, unsigned int c
   if (x > gfx->data.modMaxX) gfx->data.modMaxX=(short)x;
   if (y < gfx->data.modMinY) gfx->data.modMinY=(short)y;
   if (y > gfx->data.modMaxY) gfx->data.modMaxY=(short)y;
+#ifdef GRAPHICS_MODIFIED_TILES
+  // x/y are inside the clip rect, so always inside the tile grid
+  gfx->data.modTiles[y>>(gfx->data.modTileShift>>4)] |= (unsigned short)(1U<<(x>>(gfx->data.modTileShift&15)));
+#endif
 #else
   if (x<0 || y<0 || x>=gfx->data.width || y>=gfx->data.height) return;
 #endif
@@ -464,6 +565,9 @@ void graphicsFillRectDevice(JsGraphics *gfx, int x1, int y1, int x2, int y2, uns
   if (x2 > gfx->data.modMaxX) gfx->data.modMaxX=(short)x2;
   if (y1 < gfx->data.modMinY) gfx->data.modMinY=(short)y1;
   if (y2 > gfx->data.modMaxY) gfx->data.modMaxY=(short)y2;
+#endif
+#ifdef GRAPHICS_MODIFIED_TILES
+  graphicsSetModifiedTiles(gfx, x1, y1, x2, y2);
 #endif
   if (x1==x2 && y1==y2) {
     gfx->setPixel(gfx,(int)x1,(int)y1,col);
@@ -626,7 +730,17 @@ void graphicsFillAnnulus(JsGraphics *gfx, int x0, int y0, int r1, int r2, unsign
 void graphicsDrawLine(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
   graphicsToDeviceCoordinates(gfx, &x1, &y1);
   graphicsToDeviceCoordinates(gfx, &x2, &y2);
+  graphicsDrawLineDevice(gfx, x1, y1, x2, y2);
+}
 
+/// Draw a line in the foreground colour between two points in device coordinates
+void graphicsDrawLineDevice(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
+#ifndef SAVE_ON_FLASH
+  if (gfx->data.flags & JSGRAPHICSFLAGS_RECORDING) {
+    lcdDrawLine_DisplayList(gfx, x1, y1, x2, y2);
+    return;
+  }
+#endif
   int xl = x2-x1;
   int yl = y2-y1;
   if (xl<0) xl=-xl; else if (xl==0) xl=1;
@@ -769,23 +883,99 @@ void graphicsDrawCircleAA(JsGraphics *gfx, int x0, int y0, int r){
 
 #endif
 
-// Fill poly - each member of vertices is 1/16th pixel
-void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices) {
+/// An edge of a polygon being filled by graphicsFillPolyDevice. All values are in 1/16th pixels
+typedef struct {
+  int x;        ///< X where the edge crosses the current scanline
+  int err;      ///< Remainder of x, 0..dy-1
+  int stepX;    ///< Whole amount x changes by each scanline
+  int stepErr;  ///< Remainder of the change in x each scanline
+  int dy;       ///< Height of the edge
+  short yStart; ///< First scanline that this edge crosses
+  short yEnd;   ///< The edge crosses scanlines < yEnd
+  signed char dir; ///< +1 if the edge goes down, -1 if up (for the nonzero winding rule)
+} GraphicsPolyEdge;
+
+static int graphicsFloorDiv(int a, int b) { // b>0
+  return (a>=0) ? a/b : -((b-1-a)/b);
+}
+
+#ifdef GRAPHICS_ANTIALIAS
+/// Add coverage for a span of a sub-scanline (x1..x2-1 in 1/16th pixels), and widen covX1..covX2 (pixels) to include it
+static void graphicsFillPolyAddCoverage(unsigned char *coverage, int clipX1, int clipX2, int x1, int x2, int *covX1, int *covX2) {
+  if (x1 < clipX1<<4) x1 = clipX1<<4;
+  if (x2 > (clipX2+1)<<4) x2 = (clipX2+1)<<4;
+  if (x2<=x1) return;
+  int p1 = x1>>4, p2 = (x2-1)>>4;
+  if (p1 < *covX1) *covX1 = p1;
+  if (p2 > *covX2) *covX2 = p2;
+  if (p1==p2) {
+    coverage[p1-clipX1] += (unsigned char)(x2-x1);
+    return;
+  }
+  coverage[p1-clipX1] += (unsigned char)(16-(x1&15));
+  for (int p=p1+1;p<p2;p++)
+    coverage[p-clipX1] += 16;
+  coverage[p2-clipX1] += (unsigned char)(x2-(p2<<4));
+}
+
+/// Draw pixels covX1..covX2 of a row from the coverage buffer (64 = fully covered), and clear them
+static void graphicsFillPolyDrawCoverage(JsGraphics *gfx, unsigned char *coverage, int clipX1, int covX1, int covX2, int y) {
+  int x = covX1;
+  while (x<=covX2) {
+    int c = coverage[x-clipX1];
+    if (c>=64) { // draw solid runs with fillRect
+      int x2 = x;
+      while (x2<covX2 && coverage[x2+1-clipX1]>=64) x2++;
+      graphicsFillRectDevice(gfx, x, y, x2, y, gfx->data.fgColor);
+      memset(&coverage[x-clipX1], 0, (size_t)(1+x2-x));
+      x = x2+1;
+    } else {
+      if (c) {
+        graphicsSetPixelDeviceBlended(gfx, x, y, c*4);
+        coverage[x-clipX1] = 0;
+      }
+      x++;
+    }
+  }
+}
+#endif
+
+/// Convert vertices (1/16th pixel) to device coordinates in place, and fill the polygon
+static void graphicsFillPolyInternal(JsGraphics *gfx, int points, short *vertices, bool antiAlias) {
   typedef struct {
     short x,y;
   } VertXY;
   VertXY *v = (VertXY*)vertices;
-
-  int i,j,y;
-  int miny = (int)(gfx->data.height-1);
-  int maxy = 0;
-  for (i=0;i<points;i++) {
+  for (int i=0;i<points;i++) {
     // convert into device coordinates...
     int vx = v[i].x;
     int vy = v[i].y;
     graphicsToDeviceCoordinates16x(gfx, &vx, &vy);
     v[i].x = (short)vx;
     v[i].y = (short)vy;
+  }
+  graphicsFillPolyDevice(gfx, points, vertices, antiAlias);
+}
+
+/* Fill a polygon using a sorted edge table and a list of active edges. Each member
+of vertices is 1/16th pixel, in device coordinates. If antiAlias, each scanline is
+sampled 4 times and partially covered pixels are blended */
+void graphicsFillPolyDevice(JsGraphics *gfx, int points, short *vertices, bool antiAlias) {
+#ifndef SAVE_ON_FLASH
+  if (gfx->data.flags & JSGRAPHICSFLAGS_RECORDING) {
+    lcdFillPoly_DisplayList(gfx, points, vertices, antiAlias);
+    return;
+  }
+#endif
+  typedef struct {
+    short x,y;
+  } VertXY;
+  VertXY *v = (VertXY*)vertices;
+
+  int i,j,y;
+  int miny = (int)(gfx->data.height-1);
+  int maxy = 0;
+  for (i=0;i<points;i++) {
     // work out min and max
     short y = v[i].y>>4;
     if (y<miny) miny=y;
@@ -798,59 +988,147 @@ void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices) {
   if (miny<0) miny=0;
   if (maxy>=gfx->data.height) maxy=(int)(gfx->data.height-1);
 #endif
+  if (miny>maxy || points<3) return;
+  // Scanlines are at the top of each pixel, or 4 per pixel (at 2,6,10,14) for antialiasing
+  int yFirst = antiAlias ? (miny<<4)+2 : (miny<<4);
+  int yLast = maxy<<4 | 15;
+  int yStep = antiAlias ? 4 : 16;
+
+  size_t memRequired = (size_t)points*(sizeof(GraphicsPolyEdge)+sizeof(GraphicsPolyEdge*));
+#ifdef GRAPHICS_ANTIALIAS
+#ifndef SAVE_ON_FLASH
+  int clipX1 = gfx->data.clipRect.x1, clipX2 = gfx->data.clipRect.x2;
+#else
+  int clipX1 = 0, clipX2 = gfx->data.width-1;
+#endif
+  if (antiAlias) memRequired += (size_t)(1+clipX2-clipX1);
+#endif
+  if (jsuGetFreeStack() < 256+memRequired) {
+    jsExceptionHere(JSET_ERROR, "Not enough stack to fill polygon");
+    return;
+  }
+  GraphicsPolyEdge *edges = (GraphicsPolyEdge*)alloca((size_t)points*sizeof(GraphicsPolyEdge));
+  GraphicsPolyEdge **active = (GraphicsPolyEdge**)alloca((size_t)points*sizeof(GraphicsPolyEdge*));
+#ifdef GRAPHICS_ANTIALIAS
+  unsigned char *coverage = 0;
+  if (antiAlias) {
+    coverage = (unsigned char*)alloca((size_t)(1+clipX2-clipX1));
+    memset(coverage, 0, (size_t)(1+clipX2-clipX1));
+  }
+  // the columns that have coverage in the current row of pixels, so we only look at those
+  int covX1 = clipX2+1, covX2 = clipX1-1;
+#endif
 
-  const int MAX_CROSSES = 64;
-
-  // for each scanline
-  for (y=miny<<4;y<=maxy<<4;y+=16) {
-    int yl = y>>4;
-    short cross[MAX_CROSSES];
-    bool slopes[MAX_CROSSES];
-    int crosscnt = 0;
-    // work out all the times lines cross the scanline
-    j = points-1;
-    for (i=0;i<points;i++) {
-      if ((v[i].y<=y && v[j].y>y) || (v[j].y<=y && v[i].y>y)) {
-        if (crosscnt < MAX_CROSSES) {
-          int l = v[j].y - v[i].y;
-          if (l) { // don't do horiz lines - rely on the ends of the lines that join onto them
-            cross[crosscnt] = (short)(v[i].x + ((y - v[i].y) * (v[j].x-v[i].x)) / l);
-            slopes[crosscnt] = (l>1)?1:0;
-            crosscnt++;
-          }
+  // Build the edge table, ignoring horizontal edges and ones that miss every scanline
+  int edgeCount = 0;
+  j = points-1;
+  for (i=0;i<points;i++) {
+    VertXY *a = &v[j], *b = &v[i];
+    j = i;
+    if (a->y == b->y) continue; // rely on the ends of the lines that join onto them
+    signed char dir = 1;
+    if (a->y > b->y) { // make sure a is the top
+      VertXY *t = a; a = b; b = t;
+      dir = -1;
+    }
+    int ys = (a->y > yFirst) ? a->y : yFirst;
+    ys = yFirst + graphicsFloorDiv(ys - yFirst + yStep - 1, yStep)*yStep; // first scanline at or below the top
+    int ye = (b->y < yLast+1) ? b->y : yLast+1;
+    if (ys >= ye) continue;
+    GraphicsPolyEdge *e = &edges[edgeCount++];
+    int dx = b->x - a->x;
+    e->dy = b->y - a->y;
+    e->x = a->x + graphicsFloorDiv((ys - a->y)*dx, e->dy);
+    e->err = (ys - a->y)*dx - (e->x - a->x)*e->dy;
+    e->stepX = graphicsFloorDiv(yStep*dx, e->dy);
+    e->stepErr = yStep*dx - e->stepX*e->dy;
+    e->yStart = (short)ys;
+    e->yEnd = (short)ye;
+    e->dir = dir;
+    // insertion sort by yStart - polygons usually have edges in order, so this is quick
+    int k = edgeCount-1;
+    while (k>0 && edges[k-1].yStart > edges[k].yStart) {
+      GraphicsPolyEdge t = edges[k-1];
+      edges[k-1] = edges[k];
+      edges[k] = t;
+      k--;
+    }
+  }
+
+  int nextEdge = 0, activeCount = 0;
+  for (y=yFirst;y<=yLast && (activeCount || nextEdge<edgeCount);y+=yStep) {
+    // add edges that start here, and remove ones that have ended
+    while (nextEdge<edgeCount && edges[nextEdge].yStart<=y)
+      active[activeCount++] = &edges[nextEdge++];
+    for (i=0;i<activeCount;) {
+      if (active[i]->yEnd <= y) active[i] = active[--activeCount];
+      else i++;
+    }
+    // sort by X - the order hardly changes between scanlines, so insertion sort
+    for (i=1;i<activeCount;i++) {
+      GraphicsPolyEdge *e = active[i];
+      j = i;
+      while (j>0 && active[j-1]->x > e->x) {
+        active[j] = active[j-1];
+        j--;
+      }
+      active[j] = e;
+    }
+    //  Fill the pixels between edges, using the nonzero winding rule
+    int x = 0, s = 0;
+    for (i=0;i<activeCount;i++) {
+      if (s==0) x = active[i]->x;
+      s += active[i]->dir;
+      if (!s || i==activeCount-1) {
+#ifdef GRAPHICS_ANTIALIAS
+        if (antiAlias) {
+          graphicsFillPolyAddCoverage(coverage, clipX1, clipX2, x, active[i]->x, &covX1, &covX2);
+        } else
+#endif
+        {
+          int x1 = (x+15)>>4;
+          int x2 = (active[i]->x+15)>>4;
+          if (x2>x1) graphicsFillRectDevice(gfx,x1,y>>4,x2-1,y>>4,gfx->data.fgColor);
         }
       }
-      j = i;
     }
-
-    // bubble sort
-    for (i=0;i<crosscnt-1;) {
-      if (cross[i]>cross[i+1]) {
-        short t=cross[i];
-        cross[i]=cross[i+1];
-        cross[i+1]=t;
-        bool ts=slopes[i];
-        slopes[i]=slopes[i+1];
-        slopes[i+1]=ts;
-        if (i) i--;
-      } else i++;
+#ifdef GRAPHICS_ANTIALIAS
+    if (antiAlias && ((y+yStep)>>4)!=(y>>4)) { // last sample for this row of pixels
+      graphicsFillPolyDrawCoverage(gfx, coverage, clipX1, covX1, covX2, y>>4);
+      covX1 = clipX2+1;
+      covX2 = clipX1-1;
     }
-
-    //  Fill the pixels between node pairs.
-    int x = 0,s = 0;
-    for (i=0;i<crosscnt;i++) {
-      if (s==0) x=cross[i];
-      if (slopes[i]) s++; else s--;
-      if (!s || i==crosscnt-1) {
-        int x1 = (x+15)>>4;
-        int x2 = (cross[i]+15)>>4;
-        if (x2>x1) graphicsFillRectDevice(gfx,x1,yl,x2-1,yl,gfx->data.fgColor);
+#endif
+    // step every edge on to the next scanline
+    for (i=0;i<activeCount;i++) {
+      GraphicsPolyEdge *e = active[i];
+      e->x += e->stepX;
+      e->err += e->stepErr;
+      if (e->err >= e->dy) {
+        e->err -= e->dy;
+        e->x++;
       }
-      if (jspIsInterrupted()) break;
     }
+    if (jspIsInterrupted()) break;
   }
+#ifdef GRAPHICS_ANTIALIAS
+  if (antiAlias && y<=yLast && (y&15)!=2) // we stopped part way through a row of pixels
+    graphicsFillPolyDrawCoverage(gfx, coverage, clipX1, covX1, covX2, y>>4);
+#endif
 }
 
+// Fill poly - each member of vertices is 1/16th pixel
+void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices) {
+  graphicsFillPolyInternal(gfx, points, vertices, false);
+}
+
+#ifdef GRAPHICS_ANTIALIAS
+// Fill poly with antialiased edges - each member of vertices is 1/16th pixel
+void graphicsFillPolyAA(JsGraphics *gfx, int points, short *vertices) {
+  graphicsFillPolyInternal(gfx, points, vertices, true);
+}
+#endif
+
 /// Draw a simple 1bpp image in foreground colour
 void graphicsDrawImage1bpp(JsGraphics *gfx, int x1, int y1, int width, int height, const unsigned char *pixelData) {
   int pixel = 256|*(pixelData++);
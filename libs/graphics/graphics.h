@@ -30,7 +30,14 @@
 #endif
 #endif
 
-#if defined(LINUX) || defined(BANGLEJS)
+#if defined(ESP32) && !defined(NO_MODIFIED_AREA)
+#define GRAPHICS_MODIFIED_TILES // As well as the modified area, keep a grid of which tiles were modified (for g.flipSPI)
+#endif
+#define GRAPHICS_MODIFIED_TILES_X 16 // columns of tiles - bits in each modTiles entry
+#define GRAPHICS_MODIFIED_TILES_Y 16 // rows of tiles
+#define GRAPHICS_MODIFIED_RECTS_MAX 16 // most rectangles graphicsGetModifiedRects will return
+
+#if defined(LINUX) || defined(BANGLEJS) || defined(ESP32)
 #define GRAPHICS_FAST_PATHS // execute more optimised code when no rotation/etc
 #endif
 
@@ -63,6 +70,7 @@ typedef enum {
   JSGRAPHICSFLAGS_COLOR_GRB = JSGRAPHICSFLAGS_COLOR_BASE*4, //< All devices: color order is GRB
   JSGRAPHICSFLAGS_COLOR_RBG = JSGRAPHICSFLAGS_COLOR_BASE*5, //< All devices: color order is RBG
   JSGRAPHICSFLAGS_COLOR_MASK = JSGRAPHICSFLAGS_COLOR_BASE*7, //< All devices: color order is BRG
+  JSGRAPHICSFLAGS_RECORDING = 1024, //< All devices: drawing is recorded into a display list rather than drawn
 
   /// If any bits here are set, X and Y get modified before being used
   JSGRAPHICSFLAGS_MAPPEDXY = JSGRAPHICSFLAGS_SWAP_XY|JSGRAPHICSFLAGS_INVERT_X|JSGRAPHICSFLAGS_INVERT_Y,
@@ -120,6 +128,10 @@ typedef struct {
   JsGraphicsClipRect clipRect;
   short modMinX, modMinY, modMaxX, modMaxY; ///< area that has been modified
 #endif
+#ifdef GRAPHICS_MODIFIED_TILES
+  unsigned char modTileShift; ///< tiles are 1<<(modTileShift&15) pixels wide and 1<<(modTileShift>>4) high
+  unsigned short modTiles[GRAPHICS_MODIFIED_TILES_Y]; ///< one bit per modified tile, bit 0 is the leftmost
+#endif
 } PACKED_FLAGS JsGraphicsData;
 
 typedef struct JsGraphics {
@@ -194,6 +206,13 @@ unsigned short graphicsGetHeight(const JsGraphics *gfx);
 bool graphicsSetModifiedAndClip(JsGraphics *gfx, int *x1, int *y1, int *x2, int *y2);
 // Set the area modified by a draw command
 void graphicsSetModified(JsGraphics *gfx, int x1, int y1, int x2, int y2);
+/// Mark the whole Graphics as unmodified
+void graphicsResetModified(JsGraphics *gfx);
+#ifdef GRAPHICS_MODIFIED_TILES
+/** Merge the modified tiles into as few rectangles as we can (inclusive, device coordinates), and return
+ * how many there are. If there would be more than maxRects, the whole modified area is returned instead */
+int graphicsGetModifiedRects(JsGraphics *gfx, JsGraphicsClipRect *rects, int maxRects);
+#endif
 /// Get a setPixel function (assuming coordinates already clipped with graphicsSetModifiedAndClip) - if all is ok it can choose a faster draw function
 JsGraphicsSetPixelFn graphicsGetSetPixelFn(JsGraphics *gfx);
 /// Get a setPixel function and set modified area (assuming no clipping) (inclusive of x2,y2) - if all is ok it can choose a faster draw function
@@ -216,9 +235,14 @@ void graphicsDrawEllipse(JsGraphics *gfx, int x, int y, int x2, int y2);
 void graphicsFillEllipse(JsGraphics *gfx, int x, int y, int x2, int y2);
 void graphicsFillAnnulus(JsGraphics *gfx, int x, int y, int r1, int r2, unsigned short quadrants);
 void graphicsDrawLine(JsGraphics *gfx, int x1, int y1, int x2, int y2);
+void graphicsDrawLineDevice(JsGraphics *gfx, int x1, int y1, int x2, int y2); ///< drawline in device coordinates
 void graphicsDrawLineAA(JsGraphics *gfx, int ix1, int iy1, int ix2, int iy2); ///< antialiased drawline. each pixel is 1/16th
 void graphicsDrawCircleAA(JsGraphics *gfx, int x, int y, int r);
 void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices); ///< each pixel is 1/16th a pixel may overwrite vertices...
+void graphicsFillPolyDevice(JsGraphics *gfx, int points, short *vertices, bool antiAlias); ///< each pixel is 1/16th a pixel, in device coordinates
+#ifdef GRAPHICS_ANTIALIAS
+void graphicsFillPolyAA(JsGraphics *gfx, int points, short *vertices); ///< each pixel is 1/16th a pixel may overwrite vertices...
+#endif
 /// Draw a simple 1bpp image in foreground colour
 void graphicsDrawImage1bpp(JsGraphics *gfx, int x1, int y1, int width, int height, const unsigned char *pixelData);
 /// Scroll the graphics device (in user coords). X>0 = to right, Y >0 = down
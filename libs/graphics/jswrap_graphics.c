@@ -19,6 +19,7 @@
 
 #include "lcd_arraybuffer.h"
 #include "lcd_js.h"
+#include "lcd_displaylist.h"
 #ifdef USE_LCD_SDL
 #include "lcd_sdl.h"
 #endif
@@ -31,10 +32,12 @@
 
 #include "jswrap_functions.h" // for asURL
 #include "jswrap_object.h" // for getFonts
+#include "jsspi.h" // for flipSPI
 
 #include "bitmap_font_4x6.h"
 #include "bitmap_font_6x8.h"
 #include "vector_font.h"
+#include "vector_font_cache.h"
 
 #ifdef GRAPHICS_PALETTED_IMAGES
 #if defined(ESPR_GRAPHICS_12BIT)
@@ -86,6 +89,26 @@ void _jswrap_graphics_freeImageInfo(GfxDrawImageInfo *info) {
   jsvUnLock(info->buffer);
 }
 
+#ifndef SAVE_ON_FLASH
+/// Walk the rows of the compressed image at info->bitmapOffset to set info->bitmapLength. Returns false if the data is too short
+static bool _jswrap_graphics_getCompressedImageLength(GfxDrawImageInfo *info) {
+  size_t stringLength = jsvGetStringLength(info->buffer);
+  size_t idx = info->bitmapOffset;
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, info->buffer, idx);
+  int y;
+  for (y=0;y<info->height && idx+2<=stringLength;y++) {
+    unsigned int rowLength = (unsigned char)jsvStringIteratorGetCharAndNext(&it);
+    rowLength |= ((unsigned char)jsvStringIteratorGetCharAndNext(&it))<<8;
+    idx += 2+rowLength;
+    jsvStringIteratorGoto(&it, info->buffer, idx);
+  }
+  jsvStringIteratorFree(&it);
+  info->bitmapLength = (uint32_t)(idx - info->bitmapOffset);
+  return y==info->height && idx<=stringLength;
+}
+#endif
+
 /** Parse an image into GfxDrawImageInfo. See drawImage for image format docs. Returns true on success.
  * if 'image' is a string or ArrayBuffer, imageOffset is the offset within that (usually 0)
  */
@@ -145,16 +168,28 @@ bool _jswrap_graphics_parseImage(JsGraphics *gfx, JsVar *image, unsigned int ima
       info->buffer = jsvLockAgain(image);
     }
     info->width = (unsigned char)jsvGetCharInString(info->buffer,imageOffset);
-    info->height = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+1);
-    info->bpp = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+2);
+    unsigned short headerOffset = 0; // extra header bytes before 'bpp'
+#ifndef SAVE_ON_FLASH
+    if (info->width==0 && jsvGetCharInString(info->buffer,imageOffset+1)==GRAPHICS_IMAGE_FORMAT_RLE) {
+      // compressed: 0, format, width(16 bit LE), height(16 bit LE), bpp, ...
+      info->compressed = true;
+      info->width = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+2) |
+                    ((unsigned char)jsvGetCharInString(info->buffer,imageOffset+3)<<8);
+      info->height = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+4) |
+                     ((unsigned char)jsvGetCharInString(info->buffer,imageOffset+5)<<8);
+      headerOffset = 4;
+    } else
+#endif
+      info->height = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+1);
+    info->bpp = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+headerOffset+2);
     info->bitmapOffset += imageOffset;
     if (info->bpp & 128) {
       info->bpp = info->bpp&127;
       info->isTransparent = true;
-      info->transparentCol = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+3);
-      info->headerLength = 4;
+      info->transparentCol = (unsigned char)jsvGetCharInString(info->buffer,imageOffset+headerOffset+3);
+      info->headerLength = headerOffset+4;
     } else {
-      info->headerLength = 3;
+      info->headerLength = headerOffset+3;
     }
     info->bitmapOffset += info->headerLength;
     if (info->bpp & 64) { // included palette data
@@ -177,7 +212,7 @@ bool _jswrap_graphics_parseImage(JsGraphics *gfx, JsVar *image, unsigned int ima
         char *dataPtr = jsvGetDataPointer(info->buffer, &dataLen);
         if (info->bpp<=8 && dataPtr && imgStart<dataLen) {
           info->paletteMask = (uint32_t)(paletteEntries-1);
-          info->palettePtr = (uint16_t*)&dataPtr[info->bitmapOffset+info->headerLength];
+          info->palettePtr = (uint16_t*)&dataPtr[info->bitmapOffset];
         }
       }
       // could allocate a flat string and copy data in here
@@ -235,8 +270,19 @@ bool _jswrap_graphics_parseImage(JsGraphics *gfx, JsVar *image, unsigned int ima
     _jswrap_graphics_freeImageInfo(info);
     return false;
   }
-  info->bitMask = (unsigned int)((1L<<info->bpp)-1L);
+  info->bitMask = (unsigned int)((1ULL<<info->bpp)-1ULL);
   info->pixelsPerByteMask = (unsigned int)((info->bpp<8)?(8/info->bpp)-1:0);
+#ifndef SAVE_ON_FLASH
+  if (info->compressed) {
+    info->stride = 0; // rows are different lengths
+    if (!_jswrap_graphics_getCompressedImageLength(info)) {
+      jsExceptionHere(JSET_ERROR, "Compressed image data is truncated");
+      _jswrap_graphics_freeImageInfo(info);
+      return false;
+    }
+    return true;
+  }
+#endif
   info->stride = (info->width*info->bpp + 7)>>3;
   info->bitmapLength = (info->width*info->height*info->bpp + 7)>>3;
   return true;
@@ -350,6 +396,12 @@ NO_INLINE void _jswrap_drawImageLayerNextY(GfxDrawImageLayer *l) {
 }
 
 NO_INLINE void _jswrap_drawImageSimple(JsGraphics *gfx, int xPos, int yPos, GfxDrawImageInfo *img, JsvStringIterator *it) {
+#ifndef SAVE_ON_FLASH
+  if (img->compressed) {
+    _jswrap_drawImageCompressed(gfx, xPos, yPos, 1, img, it);
+    return;
+  }
+#endif
   int bits=0, colData=0;
   JsGraphicsSetPixelFn setPixel = graphicsGetSetPixelUnclippedFn(gfx, xPos, yPos, xPos+img->width-1, yPos+img->height-1);
   for (int y=yPos;y<yPos+img->height;y++) {
@@ -371,6 +423,92 @@ NO_INLINE void _jswrap_drawImageSimple(JsGraphics *gfx, int xPos, int yPos, GfxD
   }
 }
 
+#ifndef SAVE_ON_FLASH
+/* Compressed rows are a 16 bit (LE) byte count followed by packets, each starting with a byte 'c':
+ *  c<128  : c+1 pixels follow, packed MSB first at 'bpp' bits and padded to a whole byte
+ *  c>=128 : c-126 pixels of one colour, which follows in (bpp+7)/8 bytes (MSB first)
+ */
+void _jswrap_graphics_decodeImageRow(GfxDrawImageInfo *img, JsvStringIterator *it, unsigned int *row) {
+  size_t rowStart = jsvStringIteratorGetIndex(it);
+  unsigned int rowLength = (unsigned char)jsvStringIteratorGetCharAndNext(it);
+  rowLength |= ((unsigned char)jsvStringIteratorGetCharAndNext(it))<<8;
+  int colBytes = (img->bpp+7)>>3;
+  int x = 0;
+  while (x<img->width) {
+    unsigned char c = (unsigned char)jsvStringIteratorGetCharAndNext(it);
+    if (c&128) { // run of one colour
+      int n = c-126;
+      unsigned int col = 0;
+      for (int i=0;i<colBytes;i++)
+        col = (col<<8) | (unsigned char)jsvStringIteratorGetCharAndNext(it);
+      col &= img->bitMask;
+      while (n-- && x<img->width) row[x++] = col;
+    } else { // literal pixels
+      int n = c+1, bits = 0;
+      uint64_t colData = 0; // may hold 7 leftover bits plus a 32 bit pixel
+      while (n--) {
+        while (bits < img->bpp) {
+          colData = (colData<<8) | ((unsigned char)jsvStringIteratorGetCharAndNext(it));
+          bits += 8;
+        }
+        unsigned int col = (unsigned int)(colData>>(bits-img->bpp))&img->bitMask;
+        bits -= img->bpp;
+        if (x<img->width) row[x++] = col;
+      }
+    }
+  }
+  // always go by the byte count, so a bad row can't throw us out for the rest of the image
+  jsvStringIteratorGoto(it, img->buffer, rowStart+2+rowLength);
+}
+
+/// Skip over one row of a compressed image
+static void _jswrap_graphics_skipImageRow(GfxDrawImageInfo *img, JsvStringIterator *it) {
+  size_t rowStart = jsvStringIteratorGetIndex(it);
+  unsigned int rowLength = (unsigned char)jsvStringIteratorGetCharAndNext(it);
+  rowLength |= ((unsigned char)jsvStringIteratorGetCharAndNext(it))<<8;
+  jsvStringIteratorGoto(it, img->buffer, rowStart+2+rowLength);
+}
+
+/* Decode each row into a buffer and draw each run of identical pixels with one fillRect, so
+ * only one row of the image is ever held in RAM. Rows that are clipped off aren't decoded. */
+NO_INLINE void _jswrap_drawImageCompressed(JsGraphics *gfx, int xPos, int yPos, int scale, GfxDrawImageInfo *img, JsvStringIterator *it) {
+  if (scale<1) scale=1;
+  if (jsuGetFreeStack() < 256+sizeof(unsigned int)*(size_t)img->width) {
+    jsExceptionHere(JSET_ERROR, "Not enough stack to decode image");
+    return;
+  }
+  unsigned int *row = (unsigned int*)alloca(sizeof(unsigned int)*(size_t)img->width);
+  int clipY1 = -32768, clipY2 = 32767;
+#ifndef NO_MODIFIED_AREA
+  if (!(gfx->data.flags & JSGRAPHICSFLAGS_MAPPEDXY)) { // we can only skip rows if user and device Y are the same
+    clipY1 = gfx->data.clipRect.y1;
+    clipY2 = gfx->data.clipRect.y2;
+  }
+#endif
+  for (int y=0;y<img->height;y++) {
+    int yp = yPos + y*scale;
+    if (yp > clipY2) break; // nothing more to draw
+    if (yp+scale-1 < clipY1) {
+      _jswrap_graphics_skipImageRow(img, it);
+      continue;
+    }
+    _jswrap_graphics_decodeImageRow(img, it, row);
+    int x = 0;
+    while (x<img->width) {
+      unsigned int col = row[x];
+      int runStart = x;
+      while (x<img->width && row[x]==col) x++;
+      if (col!=img->transparentCol) {
+        if (img->palettePtr) col = img->palettePtr[col&img->paletteMask];
+        graphicsFillRect(gfx, xPos+runStart*scale, yp, xPos+x*scale-1, yp+scale-1, col);
+      }
+    }
+  }
+  // leave the iterator just after the image, like _jswrap_drawImageSimple does
+  jsvStringIteratorGoto(it, img->buffer, img->bitmapOffset+img->bitmapLength);
+}
+#endif
+
 // ==========================================================================================
 
 
@@ -504,6 +642,85 @@ JsVar *jswrap_graphics_getInstance() {
   return jsvObjectGetChild(execInfo.hiddenRoot, JS_GRAPHICS_VAR, 0);
 }
 
+/*JSON{
+  "type" : "kill",
+  "generate" : "jswrap_graphics_kill",
+  "ifndef" : "SAVE_ON_FLASH"
+}*/
+void jswrap_graphics_kill() {
+#ifdef VECTOR_FONT_CACHE
+  vfCacheKill();
+#endif
+  // Graphics created from JS go when their vars are freed, but the built-in one
+  // may be kept, so make sure it's not left recording
+  JsVar *parent = jswrap_graphics_getInstance();
+  JsGraphics gfx;
+  if (parent && graphicsGetFromVar(&gfx, parent) &&
+      (gfx.data.flags & JSGRAPHICSFLAGS_RECORDING)) {
+    lcdKill_DisplayList(&gfx);
+    graphicsSetVar(&gfx);
+  }
+  jsvUnLock(parent);
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Graphics",
+  "name" : "setVectorFontCache",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_setVectorFontCache",
+  "params" : [
+    ["bytes","int32","The most memory (in bytes) to use for cached characters, or 0 to disable the cache"]
+  ],
+  "typescript" : "setVectorFontCache(bytes: number): void"
+}
+Drawing characters with the vector font is slow, so the first time each
+character is drawn at a given size it is rasterised and stored, and after that
+the stored bitmap is drawn instead. The least recently used characters are
+removed to keep the cache within `bytes` (4096 by default).
+
+Memory used by the cache comes from Espruino's variable store. It is kept in
+one block, which grows as characters are added (up to `bytes`), so may not be
+able to grow if memory is very fragmented.
+*/
+void jswrap_graphics_setVectorFontCache(int bytes) {
+#ifdef VECTOR_FONT_CACHE
+  vfCacheSetSize((unsigned int)((bytes<0) ? 0 : bytes));
+#else
+  NOT_USED(bytes);
+#endif
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Graphics",
+  "name" : "getVectorFontCache",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_getVectorFontCache",
+  "return" : ["JsVar","An object describing the vector font cache"],
+  "typescript" : "getVectorFontCache(): { size: number, used: number, glyphs: number, hits: number, misses: number }"
+}
+Return information about the cache of rasterised vector font characters (see
+`Graphics.setVectorFontCache`):
+
+```
+{
+  size : 4096,  // the most bytes the cache may use
+  used : 1230,  // bytes currently used
+  glyphs : 12,  // characters currently cached
+  hits : 52,    // characters drawn from the cache
+  misses : 12   // characters that had to be rasterised
+}
+```
+*/
+JsVar *jswrap_graphics_getVectorFontCache() {
+#ifdef VECTOR_FONT_CACHE
+  return vfCacheGetInfo();
+#else
+  return 0;
+#endif
+}
+
 static bool isValidBPP(int bpp) {
   return bpp==1 || bpp==2 || bpp==4 || bpp==8 || bpp==16 || bpp==24 || bpp==32; // currently one colour can't ever be spread across multiple bytes
 }
@@ -2374,7 +2591,11 @@ JsVar *jswrap_graphics_drawString(JsVar *parent, JsVar *var, int x, int y, bool
       if (x>minX-w && x<maxX  && y>minY-fontHeight && y<=maxY) {
         if (solidBackground)
           graphicsFillRect(&gfx,x,y,x+w-1,y+fontHeight-1, gfx.data.bgColor);
+#ifdef VECTOR_FONT_CACHE
+        graphicsFillVectorCharCached(&gfx, x, y, info.scalex, info.scaley, ch);
+#else
         graphicsFillVectorChar(&gfx, x, y, info.scalex, info.scaley, ch);
+#endif
       }
       x+=w;
 #endif
@@ -2679,8 +2900,6 @@ This fills from the top left hand side of the polygon (low X, low Y) *down to
 but not including* the bottom right. When placed together polygons will align
 perfectly without overdraw - but this will not fill the same pixels as
 `drawPoly` (drawing a line around the edge of the polygon).
-
-**Note:** there is a limit of 64 points (128 XY elements) for polygons
 */
 /*JSON{
   "type" : "method",
@@ -2712,13 +2931,18 @@ but not including* the bottom right. When placed together polygons will align
 perfectly without overdraw - but this will not fill the same pixels as
 `drawPoly` (drawing a line around the edge of the polygon).
 
-**Note:** there is a limit of 64 points (128 XY elements) for polygons
+Edges are antialiased by sampling each row of pixels 4 times, and blending
+pixels that are only partly covered with the background.
 */
 JsVar *jswrap_graphics_fillPoly_X(JsVar *parent, JsVar *poly, bool antiAlias) {
   JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
   if (!jsvIsIterable(poly)) return 0;
-  const int maxVerts = 128;
-  short verts[maxVerts];
+  int maxVerts = (int)jsvGetLength(poly);
+  if (jsuGetFreeStack() < 512+sizeof(short)*(size_t)maxVerts) {
+    jsExceptionHere(JSET_ERROR, "Not enough stack for %d points in fillPoly", maxVerts/2);
+    return 0;
+  }
+  short *verts = (short*)alloca(sizeof(short)*(size_t)maxVerts);
   int idx = 0;
   JsvIterator it;
   jsvIteratorNew(&it, poly, JSIF_EVERY_ARRAY_ELEMENT);
@@ -2726,25 +2950,13 @@ JsVar *jswrap_graphics_fillPoly_X(JsVar *parent, JsVar *poly, bool antiAlias) {
     verts[idx++] = (short)(0.5 + jsvIteratorGetFloatValue(&it)*16);
     jsvIteratorNext(&it);
   }
-  if (jsvIteratorHasElement(&it))
-    jsExceptionHere(JSET_ERROR, "Maximum number of points (%d) exceeded for fillPoly", maxVerts/2);
   jsvIteratorFree(&it);
 #ifdef GRAPHICS_ANTIALIAS
-  // For antialiased fillPoly the easiest solution is just to draw AA lines
-  // around the edge first, then fill solidly
-  if (antiAlias) {
-    int lx = verts[idx-2];
-    int ly = verts[idx-1];
-    for (int i=0;i<idx;i+=2) {
-      int vx = verts[i];
-      int vy = verts[i+1];
-      graphicsDrawLineAA(&gfx, vx,vy, lx,ly);
-      lx = vx;
-      ly = vy;
-    }
-  }
+  if (antiAlias)
+    graphicsFillPolyAA(&gfx, idx/2, verts);
+  else
 #endif
-  graphicsFillPoly(&gfx, idx/2, verts);
+    graphicsFillPoly(&gfx, idx/2, verts);
 
   graphicsSetVar(&gfx); // gfx data changed because modified area
   return jsvLockAgain(parent);
@@ -2828,7 +3040,7 @@ JsVar *jswrap_graphics_imageMetrics(JsVar *parent, JsVar *var) {
     jsvObjectSetChildAndUnLock(o, "height", jsvNewFromInteger(img.height));
     jsvObjectSetChildAndUnLock(o, "bpp", jsvNewFromInteger(img.bpp));
     jsvObjectSetChildAndUnLock(o, "transparent", jsvNewFromBool(img.isTransparent));
-    int frames = bufferLen / img.bitmapLength;
+    int frames = img.compressed ? 1 : bufferLen / img.bitmapLength; // compressed frames vary in length
     if (frames>1) jsvObjectSetChildAndUnLock(o, "frames", jsvNewFromInteger(frames));
   }
   return o;
@@ -2862,6 +3074,11 @@ Image can be:
   specified the top bit of `bpp` should be set.
 * An ArrayBuffer Graphics object (if `bpp<8`, `msb:true` must be set) - this is
   disabled on devices without much flash memory available
+* A compressed String (from `Graphics.asImage("compressed")`) starting with
+  `0,1,width(16 bit),height(16 bit),bpp,[transparent,][palette]`, then for each
+  row a 16 bit byte count followed by run-length encoded pixels. These are
+  decoded one row at a time straight to the display, so need very little RAM,
+  but can't be rotated or used with `drawImages`
 
 Draw an image at the specified position.
 
@@ -2911,6 +3128,18 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
   if (jsvIsObject(options)) {
     // support for multi-frame rendering
     int frame = jsvGetIntegerAndUnLock(jsvObjectGetChild(options,"frame",0));
+#ifndef SAVE_ON_FLASH
+    if (img.compressed) { // frames are different lengths, so walk through them
+      while (frame-- > 0) {
+        img.bitmapOffset += img.bitmapLength;
+        if (!_jswrap_graphics_getCompressedImageLength(&img)) {
+          jsExceptionHere(JSET_ERROR, "Frame not found in compressed image");
+          _jswrap_graphics_freeImageInfo(&img);
+          return 0;
+        }
+      }
+    } else
+#endif
     if (frame>0)
       img.bitmapOffset += img.bitmapLength * frame;
     // rotate, scale
@@ -2936,6 +3165,15 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
         !img.isTransparent; // not transparent
 #endif
 
+#ifndef SAVE_ON_FLASH
+  if (img.compressed) {
+    // compressed images are decoded a row at a time, so can't be rotated
+    if (centerImage || (scale-floor(scale))!=0)
+      jsExceptionHere(JSET_ERROR,"Compressed images can only be drawn at whole number scales with no rotation");
+    else
+      _jswrap_drawImageCompressed(&gfx, xPos, yPos, (int)scale, &img, &it);
+  } else
+#endif
   if (scale==1 && rotate==0 && !centerImage) {
     // Standard 1:1 blitting
 #ifdef USE_LCD_ST7789_8BIT // can we blit directly to the display?
@@ -3066,18 +3304,18 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
   "type" : "method",
   "class" : "Graphics",
   "name" : "drawImages",
-  "#if" : "defined(BANGLEJS) || defined(LINUX)",
+  "#if" : "defined(BANGLEJS) || defined(LINUX) || defined(ESP32)",
   "generate" : "jswrap_graphics_drawImages",
   "params" : [
-    ["layers","JsVar","An array of objects {x,y,image,scale,rotate,center} (up to 3)"],
+    ["layers","JsVar","An array of objects {x,y,image,scale,rotate,center,alpha,transparent} (up to 6)"],
     ["options","JsVar","options for rendering - see below"]
   ],
   "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
   "return_object" : "Graphics",
-  "typescript" : "drawImages(layers: { x: number, y: number, image: Image, scale?: number, rotate?: number, center?: boolean, repeat?: boolean, nobounds?: boolean }[], options?: { x: number, y: number, width: number, height: number }): Graphics;"
+  "typescript" : "drawImages(layers: { x: number, y: number, image: Image, scale?: number, rotate?: number, center?: boolean, repeat?: boolean, nobounds?: boolean, alpha?: number, transparent?: number }[], options?: { x: number, y: number, width: number, height: number }): Graphics;"
 }
 Draws multiple images *at once* - which avoids flicker on unbuffered systems
-like Bangle.js. Maximum layer count right now is 4.
+like Bangle.js. Maximum layer count right now is 6.
 
 ```
 layers = [ {
@@ -3089,6 +3327,8 @@ layers = [ {
    center : bool // center on x,y? default is top left
    repeat : should this image be repeated (tiled?)
    nobounds : bool // if true, the bounds of the image are not used to work out the default area to draw
+   alpha : float // opacity of this layer, 0..1 (default 1)
+   transparent : int // image colour to treat as transparent (overrides the image's own)
   }
 ]
 options = { // the area to render. Defaults to rendering just enough to cover what's requested
@@ -3096,9 +3336,15 @@ options = { // the area to render. Defaults to rendering just enough to cover wh
  width,height
 }
 ```
+
+Layers are composited a row at a time, with later layers drawn over earlier
+ones. Where a layer with `alpha<1` has nothing beneath it, it is blended with
+what is already on the screen. Layers that aren't rotated or scaled are read a
+whole row at a time, and can also be compressed images (see
+`Graphics.drawImage`).
 */
 JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *options) {
-  const int MAXIMAGES = 4;
+  const int MAXIMAGES = 6;
   JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
   GfxDrawImageLayer layers[MAXIMAGES];
   int i,layerCount;
@@ -3110,10 +3356,12 @@ JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *option
   int x=10000,y=10000;
   int width=10000;
   int height=10000;
+  size_t rowBufferSize = 0; // for decoding compressed layers
   // now run through all layers getting stuff ready and checking
   bool ok = true;
   for (i=0;i<layerCount;i++) {
     JsVar *layer = jsvGetArrayItem(layersVar, i);
+    layers[i].img.buffer = 0;
     if (jsvIsObject(layer)) {
       JsVar *image = jsvObjectGetChild(layer,"image",0);
       if (_jswrap_graphics_parseImage(&gfx, image, 0, &layers[i].img)) {
@@ -3127,6 +3375,28 @@ JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *option
         if (!isfinite(layers[i].rotate)) layers[i].rotate=0;
         layers[i].center = jsvGetBoolAndUnLock(jsvObjectGetChild(layer,"center",0));
         layers[i].repeat = jsvGetBoolAndUnLock(jsvObjectGetChild(layer,"repeat",0));
+        JsVar *v = jsvObjectGetChild(layer,"alpha",0);
+        layers[i].alpha = v ? (int)(jsvGetFloat(v)*256 + 0.5) : 256;
+        jsvUnLock(v);
+        if (layers[i].alpha<0) layers[i].alpha=0;
+        if (layers[i].alpha>256) layers[i].alpha=256;
+        v = jsvObjectGetChild(layer,"transparent",0);
+        if (v) {
+          layers[i].img.isTransparent = true;
+          layers[i].img.transparentCol = (unsigned int)jsvGetInteger(v);
+          jsvUnLock(v);
+        }
+        layers[i].unscaled = layers[i].rotate==0 && layers[i].scale==1 && !layers[i].repeat;
+        layers[i].row = 0;
+        layers[i].nextRow = 0;
+        if (layers[i].img.compressed) {
+          if (layers[i].unscaled) {
+            rowBufferSize += sizeof(unsigned int)*(size_t)layers[i].img.width;
+          } else {
+            jsExceptionHere(JSET_ERROR, "Compressed image layers can't be rotated, scaled or repeated");
+            ok = false;
+          }
+        }
         _jswrap_drawImageLayerInit(&layers[i]);
         // add the calculated bounds to our default bounds
         if (!jsvGetBoolAndUnLock(jsvObjectGetChild(layer,"nobounds",0))) {
@@ -3152,35 +3422,114 @@ JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *option
   int x2 = x+width-1, y2 = y+height-1;
   graphicsSetModifiedAndClip(&gfx, &x, &y, &x2, &y2);
   JsGraphicsSetPixelFn setPixel = graphicsGetSetPixelFn(&gfx);
+  bool mapped = (gfx.data.flags & JSGRAPHICSFLAGS_MAPPEDXY)!=0;
+  int rowWidth = x2+1-x;
+  if (ok && rowWidth>0 &&
+      jsuGetFreeStack() < 256+rowBufferSize+(sizeof(unsigned int)+1)*(size_t)rowWidth) {
+    jsExceptionHere(JSET_ERROR, "Not enough stack to draw %d pixel wide images", rowWidth);
+    ok = false;
+  }
 
   // If all good, start rendering!
-  if (ok) {
+  if (ok && rowWidth>0 && y<=y2) {
+    // the colour of each pixel in the row, and whether anything has been drawn there
+    unsigned int *rowCol = (unsigned int*)alloca(sizeof(unsigned int)*(size_t)rowWidth);
+    unsigned char *rowSet = (unsigned char*)alloca((size_t)rowWidth);
     for (i=0;i<layerCount;i++) {
       jsvStringIteratorNew(&layers[i].it, layers[i].img.buffer, (size_t)layers[i].img.bitmapOffset);
       _jswrap_drawImageLayerSetStart(&layers[i], x, y);
+      if (layers[i].img.compressed)
+        layers[i].row = (unsigned int*)alloca(sizeof(unsigned int)*(size_t)layers[i].img.width);
     }
-    // scan across image
     for (int yi = y; yi <= y2; yi++) {
-      for (i=0;i<layerCount;i++)
-        _jswrap_drawImageLayerStartX(&layers[i]);
-      for (int xi = x; xi <= x2 ; xi++) {
-        // scan backwards until we hit a 'solid' pixel
-        bool solid = false;
+      memset(rowSet, 0, (size_t)rowWidth);
+      // Draw each layer into the row, bottom first
+      for (i=0;i<layerCount;i++) {
+        GfxDrawImageLayer *l = &layers[i];
+        if (!l->alpha) continue;
+        // only draw the part of the row the layer can cover
+        int lx1 = x, lx2 = x2;
+        if (!l->repeat) {
+          if (yi<l->y1 || yi>=l->y2) continue;
+          if (l->x1>lx1) lx1 = l->x1;
+          if (l->x2-1<lx2) lx2 = l->x2-1;
+          if (lx1>lx2) continue;
+        }
+        int bits = 0;
         unsigned int colData = 0;
-        for (i=layerCount-1;i>=0;i--) {
-          if (_jswrap_drawImageLayerGetPixel(&layers[i], &colData)) {
-            solid = true;
-            break;
+        int imagey = yi - l->y1;
+        if (l->unscaled) { // 1:1, so we can just read pixels in order
+#ifndef SAVE_ON_FLASH
+          if (l->img.compressed) {
+            while (l->nextRow < imagey) {
+              _jswrap_graphics_skipImageRow(&l->img, &l->it);
+              l->nextRow++;
+            }
+            if (l->nextRow == imagey) {
+              _jswrap_graphics_decodeImageRow(&l->img, &l->it, l->row);
+              l->nextRow++;
+            }
+          } else
+#endif
+          {
+            int bitOffset = ((lx1 - l->x1) + imagey*l->img.width)*l->img.bpp;
+            jsvStringIteratorGoto(&l->it, l->img.buffer, (size_t)(l->img.bitmapOffset+(bitOffset>>3)));
+            bits = -(bitOffset&7); // skip bits we don't want in the first byte
           }
+        } else {
+          _jswrap_drawImageLayerStartX(l);
+          if (!l->repeat) { // skip to the start of the layer
+            l->qx += l->sx*(lx1-x);
+            l->qy -= l->sy*(lx1-x);
+          }
+        }
+        for (int xi = lx1; xi <= lx2; xi++) {
+          unsigned int col;
+          bool solid;
+          if (l->unscaled) {
+            if (l->img.compressed) {
+              col = l->row[xi - l->x1];
+            } else {
+              while (bits < l->img.bpp) {
+                colData = (colData<<8) | ((unsigned char)jsvStringIteratorGetCharAndNext(&l->it));
+                bits += 8;
+              }
+              col = (colData>>(bits-l->img.bpp))&l->img.bitMask;
+              bits -= l->img.bpp;
+            }
+            solid = col!=l->img.transparentCol;
+            if (solid && l->img.palettePtr) col = l->img.palettePtr[col&l->img.paletteMask];
+          } else {
+            solid = _jswrap_drawImageLayerGetPixel(l, &col);
+            _jswrap_drawImageLayerNextX(l);
+            _jswrap_drawImageLayerNextXRepeat(l);
+          }
+          if (!solid) continue;
+          int idx = xi - x;
+          if (l->alpha<256) { // blend with what's below, or the screen if nothing is
+            unsigned int bg = rowSet[idx] ? rowCol[idx] : graphicsGetPixel(&gfx, xi, yi);
+            col = graphicsBlendColor(&gfx, col, bg, l->alpha);
+          }
+          rowCol[idx] = col;
+          rowSet[idx] = 1;
         }
-        // if nontransparent, draw it!
-        if (solid)
-          setPixel(&gfx, xi, yi, colData);
-        // next in layers!
-        for (i=0;i<layerCount;i++) {
-          _jswrap_drawImageLayerNextX(&layers[i]);
-          _jswrap_drawImageLayerNextXRepeat(&layers[i]);
+      }
+      // Output the row, with one call for each run of the same colour
+      int idx = 0;
+      while (idx < rowWidth) {
+        if (!rowSet[idx]) {
+          idx++;
+          continue;
         }
+        unsigned int col = rowCol[idx];
+        int runStart = idx;
+        while (idx<rowWidth && rowSet[idx] && rowCol[idx]==col) idx++;
+        if (idx-runStart == 1)
+          setPixel(&gfx, x+runStart, yi, col);
+        else if (mapped)
+          graphicsFillRect(&gfx, x+runStart, yi, x+idx-1, yi, col);
+        else // already clipped
+          gfx.fillRect(&gfx, x+runStart, yi, x+idx-1, yi, col);
       }
       for (i=0;i<layerCount;i++)
         _jswrap_drawImageLayerNextY(&layers[i]);
@@ -3192,10 +3541,176 @@ JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *option
   for (i=0;i<layerCount;i++) {
     jsvUnLock(layers[i].img.buffer);
   }
+  graphicsSetVar(&gfx); // gfx data changed because modified area
   return jsvLockAgain(parent);
 }
 
 
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "beginList",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_beginList",
+  "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
+  "return_object" : "Graphics",
+  "typescript" : "beginList(): Graphics;"
+}
+Start recording a display list. Until `Graphics.endList` is called nothing is
+drawn - instead every pixel and rectangle that would have been drawn is
+recorded, so it can be redrawn quickly and without running any JavaScript
+with `Graphics.drawList`.
+
+```
+g.beginList();
+g.setColor(1,0,0).fillRect(0,0,99,19);
+g.setColor(-1).setFont("6x8").drawString("Hello",4,6);
+var button = g.endList();
+// later...
+g.drawList(button, 50, 100);
+```
+
+Lines and polygons (including Vector font characters) are recorded whole and
+clipped when the list is drawn, but everything else is clipped as it is
+recorded, so it's best to record at the top left of the screen. Each Graphics
+instance can record one display list at a time, and `scroll` and `blit` are
+ignored while recording.
+*/
+JsVar *jswrap_graphics_beginList(JsVar *parent) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  if (gfx.data.flags & JSGRAPHICSFLAGS_RECORDING) {
+    jsExceptionHere(JSET_ERROR, "Already recording a display list");
+    return 0;
+  }
+  if (!lcdBegin_DisplayList(&gfx)) return 0;
+  graphicsSetVar(&gfx);
+  return jsvLockAgain(parent);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "endList",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_endList",
+  "return" : ["JsVar","A display list that can be drawn with `Graphics.drawList`"],
+  "typescript" : "endList(): { buffer: string, time: number };"
+}
+Stop recording a display list (see `Graphics.beginList`) and return it.
+
+The list is an object containing a compact binary `buffer` of what was drawn,
+and `time`, which is set to the number of milliseconds the list took to draw
+each time `Graphics.drawList` is called.
+*/
+JsVar *jswrap_graphics_endList(JsVar *parent) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  JsVar *list = lcdEnd_DisplayList(&gfx);
+  graphicsSetVar(&gfx);
+  return list;
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "drawList",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_drawList",
+  "params" : [
+    ["list","JsVar","A display list from `Graphics.endList`"],
+    ["x","int32","The X offset to draw the list at"],
+    ["y","int32","The Y offset to draw the list at"]
+  ],
+  "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
+  "return_object" : "Graphics",
+  "typescript" : "drawList(list: { buffer: string, time: number }, x: number, y: number): Graphics;"
+}
+Draw a display list recorded with `Graphics.beginList`/`Graphics.endList`,
+moved right by `x` and down by `y`, and clipped to the current clip rect.
+
+The display list is stored in device coordinates, so the Graphics' rotation
+should be the same as when it was recorded.
+*/
+JsVar *jswrap_graphics_drawList(JsVar *parent, JsVar *list, int x, int y) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  lcdDraw_DisplayList(&gfx, list, x, y);
+  graphicsSetVar(&gfx); // gfx data changed because modified area
+  return jsvLockAgain(parent);
+}
+
+#ifndef SAVE_ON_FLASH
+/// Encode one row of pixels as RLE packets (see _jswrap_graphics_decodeImageRow). Returns the number of bytes used
+static int _jswrap_graphics_encodeImageRow(const unsigned int *row, int width, int bpp, unsigned char *out) {
+  const int MINRUN = 3; // shorter runs are cheaper as literals
+  int colBytes = (bpp+7)>>3;
+  int n = 0, x = 0;
+  while (x<width) {
+    int run = 1;
+    while (x+run<width && run<129 && row[x+run]==row[x]) run++;
+    if (run>=MINRUN) {
+      out[n++] = (unsigned char)(126+run);
+      for (int i=colBytes-1;i>=0;i--)
+        out[n++] = (unsigned char)(row[x]>>(i*8));
+      x += run;
+      continue;
+    }
+    // literal pixels, up to where the next run starts
+    int start = x;
+    while (x<width && x-start<128) {
+      run = 1;
+      while (x+run<width && run<MINRUN && row[x+run]==row[x]) run++;
+      if (run>=MINRUN) break;
+      x++;
+    }
+    out[n++] = (unsigned char)(x-start-1);
+    uint64_t bits = 0; // 64 bits so there's room for 7 leftover bits plus a 32 bit pixel
+    unsigned int bitCnt = 0;
+    for (int i=start;i<x;i++) {
+      bits = (bits<<bpp) | row[i];
+      bitCnt += (unsigned)bpp;
+      while (bitCnt>=8) {
+        out[n++] = (unsigned char)(bits>>(bitCnt-8));
+        bitCnt -= 8;
+      }
+    }
+    if (bitCnt) out[n++] = (unsigned char)(bits<<(8-bitCnt));
+  }
+  return n;
+}
+
+/// Return the contents of a Graphics as a compressed image String
+static JsVar *_jswrap_graphics_asCompressedImage(JsVar *parent, JsGraphics *gfx) {
+  int w = jswrap_graphics_getWidthOrHeight(parent,false);
+  int h = jswrap_graphics_getWidthOrHeight(parent,true);
+  int bpp = gfx->data.bpp;
+  // worst case is a packet for every pixel
+  size_t rowBytes = (size_t)w*(1+(size_t)((bpp+7)>>3)) + 2;
+  if (jsuGetFreeStack() < 256+rowBytes+sizeof(unsigned int)*(size_t)w) {
+    jsExceptionHere(JSET_ERROR, "Not enough stack to compress image");
+    return 0;
+  }
+  unsigned int *row = (unsigned int*)alloca(sizeof(unsigned int)*(size_t)w);
+  unsigned char *out = (unsigned char*)alloca(rowBytes);
+  JsVar *img = jsvNewFromEmptyString();
+  if (!img) return 0;
+  unsigned char header[7] = { 0, GRAPHICS_IMAGE_FORMAT_RLE,
+      (unsigned char)w, (unsigned char)(w>>8), (unsigned char)h, (unsigned char)(h>>8), (unsigned char)bpp };
+  jsvAppendStringBuf(img, (char*)header, sizeof(header));
+  for (int y=0;y<h;y++) {
+    for (int x=0;x<w;x++)
+      row[x] = graphicsGetPixel(gfx, x, y);
+    int n = _jswrap_graphics_encodeImageRow(row, w, bpp, &out[2]);
+    out[0] = (unsigned char)n;
+    out[1] = (unsigned char)(n>>8);
+    jsvAppendStringBuf(img, (char*)out, (size_t)n+2);
+  }
+  if (jsvGetStringLength(img) < sizeof(header)+(size_t)h*2) { // ran out of memory while appending
+    jsvUnLock(img);
+    return 0;
+  }
+  return img;
+}
+#endif
+
 /*JSON{
   "type" : "method",
   "class" : "Graphics",
@@ -3203,12 +3718,12 @@ JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *option
   "ifndef" : "SAVE_ON_FLASH",
   "generate" : "jswrap_graphics_asImage",
   "params" : [
-    ["type","JsVar","The type of image to return. Either `object`/undefined to return an image object, or `string` to return an image string"]
+    ["type","JsVar","The type of image to return. Either `object`/undefined to return an image object, `string` to return an image string, or `compressed` to return a compressed image string"]
   ],
   "return" : ["JsVar","An Image that can be used with `Graphics.drawImage`"],
   "typescript" : [
     "asImage(type?: \"object\"): ImageObject;",
-    "asImage(type: \"string\"): string;"
+    "asImage(type: \"string\" | \"compressed\"): string;"
   ]
 }
 Return this Graphics object as an Image that can be used with
@@ -3226,6 +3741,11 @@ The image data itself will be referenced rather than copied if:
 * No other format options (zigzag/etc) were given
 
 Otherwise data will be copied, which takes up more space and may be quite slow.
+
+`compressed` images are run-length encoded a row at a time (see
+`Graphics.drawImage`), which is usually much smaller for UI graphics with large
+areas of flat colour. Run this on a PC (eg. the Linux build of Espruino) to
+prepare images to save to Storage.
 */
 JsVar *jswrap_graphics_asImage(JsVar *parent, JsVar *imgType) {
   JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
@@ -3234,6 +3754,10 @@ JsVar *jswrap_graphics_asImage(JsVar *parent, JsVar *imgType) {
     isObject = true;
   else if (jsvIsStringEqual(imgType,"string")) {
     isObject = false;
+#ifndef SAVE_ON_FLASH
+  } else if (jsvIsStringEqual(imgType,"compressed")) {
+    return _jswrap_graphics_asCompressedImage(parent, &gfx);
+#endif
   } else {
     jsExceptionHere(JSET_ERROR, "Unknown image type %j", imgType);
     return 0;
@@ -3340,10 +3864,7 @@ JsVar *jswrap_graphics_getModified(JsVar *parent, bool reset) {
     }
   }
   if (reset) {
-    gfx.data.modMaxX = -32768;
-    gfx.data.modMaxY = -32768;
-    gfx.data.modMinX = 32767;
-    gfx.data.modMinY = 32767;
+    graphicsResetModified(&gfx);
     graphicsSetVar(&gfx);
   }
   return obj;
@@ -3352,6 +3873,279 @@ JsVar *jswrap_graphics_getModified(JsVar *parent, bool reset) {
 #endif
 }
 
+#define GRAPHICS_FLIP_STATS JS_HIDDEN_CHAR_STR"fSt" // object of counters for flipSPI
+#ifdef GRAPHICS_MODIFIED_TILES
+#define GRAPHICS_FLIP_CHUNK 512 // bytes in each of the two buffers used to stream pixels out
+
+// Giving jshSPISendMany a callback lets it return before the transfer has completed
+static void jswrap_graphics_flipSPIAsync() {
+}
+
+// Send a command byte with DC low, then any parameters with DC high
+static void jswrap_graphics_flipSPICommand(spi_sender spiSend, spi_sender_data *spiSendData, IOEventFlags device, Pin dc, unsigned char cmd, unsigned char *data, unsigned int len) {
+  if (DEVICE_IS_SPI(device)) jshSPIWait(device);
+  jshPinOutput(dc, 0);
+  spiSend(&cmd, NULL, 1, spiSendData);
+  if (DEVICE_IS_SPI(device)) jshSPIWait(device);
+  jshPinOutput(dc, 1);
+  if (len) spiSend(data, NULL, len, spiSendData);
+}
+
+// Send a window command (CASET/RASET) with the given start and end (inclusive)
+static void jswrap_graphics_flipSPIWindow(spi_sender spiSend, spi_sender_data *spiSendData, IOEventFlags device, Pin dc, unsigned char cmd, int a, int b) {
+  unsigned char data[4] = { (unsigned char)(a>>8), (unsigned char)a, (unsigned char)(b>>8), (unsigned char)b };
+  jswrap_graphics_flipSPICommand(spiSend, spiSendData, device, dc, cmd, data, sizeof(data));
+}
+
+/* Convert n pixels starting at x,y into big-endian 16 bit colors in 'out'. If 'pixels'
+is set it's the Graphics' flat buffer in plain row order, and we read from it directly */
+static void jswrap_graphics_flipSPIRow(JsGraphics *gfx, const uint8_t *pixels, int x, int y, int n, const uint16_t *pal, unsigned char *out) {
+  if (!pixels) {
+    for (int i=0;i<n;i++) {
+      unsigned int c = gfx->getPixel(gfx, x+i, y);
+      if (pal) c = pal[c&255];
+      *(out++) = (unsigned char)(c>>8);
+      *(out++) = (unsigned char)c;
+    }
+    return;
+  }
+  unsigned int bpp = gfx->data.bpp;
+  bool msb = (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_MSB)!=0;
+  unsigned int p = (unsigned int)(x + y*gfx->data.width)*bpp; // bit offset of the first pixel
+  const uint8_t *src = &pixels[p>>3];
+  if (bpp==16) {
+    if (msb && !pal) { // already in the byte order the display wants
+      memcpy(out, src, (size_t)n*2);
+      return;
+    }
+    for (int i=0;i<n;i++,src+=2) {
+      unsigned int c = msb ? ((unsigned)src[0]<<8 | src[1]) : ((unsigned)src[1]<<8 | src[0]);
+      if (pal) c = pal[c&255];
+      *(out++) = (unsigned char)(c>>8);
+      *(out++) = (unsigned char)c;
+    }
+  } else if (bpp==8) { // we always have a palette for 8 bits or fewer
+    for (int i=0;i<n;i++) {
+      unsigned int c = pal[*(src++)];
+      *(out++) = (unsigned char)(c>>8);
+      *(out++) = (unsigned char)c;
+    }
+  } else {
+    unsigned int mask = (1U<<bpp)-1;
+    for (int i=0;i<n;i++,p+=bpp) {
+      unsigned int c = pal[(pixels[p>>3] >> (msb ? 8-bpp-(p&7) : (p&7))) & mask];
+      *(out++) = (unsigned char)(c>>8);
+      *(out++) = (unsigned char)c;
+    }
+  }
+}
+
+static void jswrap_graphics_flipSPIAddStat(JsVar *stats, const char *name, JsVarInt amount) {
+  jsvObjectSetChildAndUnLock(stats, name, jsvNewFromInteger(jsvGetIntegerAndUnLock(jsvObjectGetChild(stats, name, 0)) + amount));
+}
+#endif
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "flipSPI",
+  "#if" : "defined(ESP32) && !defined(SAVE_ON_FLASH)",
+  "generate" : "jswrap_graphics_flipSPI",
+  "params" : [
+    ["spi","JsVar","The SPI device the display is connected to"],
+    ["options","JsVar",[
+      "An object `{ dc : pin, cs : pin, xOffset : 0, yOffset : 0, all : false, palette : undefined }`",
+      "`dc` = the display's data/command pin (required)",
+      "`cs` = [optional] the display's chip select pin",
+      "`xOffset`/`yOffset` = [optional] offset of the Graphics on the display's memory",
+      "`all` = [optional] if `true`, send the whole Graphics, not just what has changed",
+      "`palette` = [optional] for Graphics of 8 bits or fewer, an array of 16 bit colors to send for each pixel value"
+    ]]
+  ],
+  "return" : ["int","The number of bytes sent over SPI"],
+  "typescript" : "flipSPI(spi: SPI, options: { dc: Pin, cs?: Pin, xOffset?: number, yOffset?: number, all?: boolean, palette?: number[] | Uint16Array }): number;"
+}
+Send the areas of an ArrayBuffer Graphics that have been modified since the
+last flip to an ST7735/ST7789/ILI9341-style SPI display (using the `CASET`,
+`RASET` and `RAMWR` commands, with 16 bit pixels).
+
+Modified areas are tracked in a grid of up to 16x16 tiles, and neighbouring
+modified tiles are merged into rectangles, so drawing a clock in one corner
+and an icon in the other only sends those two areas. On hardware SPI, pixels
+are streamed from two buffers so one is filled while the other is sent.
+
+Usually you'd use this to implement `g.flip()`:
+
+```
+g = Graphics.createArrayBuffer(160, 128, 4);
+g.flip = function() {
+  g.flipSPI(SPI1, { dc : D2, cs : D5, palette : new Uint16Array([0,0xF800,0x07E0,0x001F,0xFFFF]) });
+};
+```
+
+See `Graphics.getFlipStats` to find out how much data has been sent.
+*/
+int jswrap_graphics_flipSPI(JsVar *parent, JsVar *spi, JsVar *options) {
+#ifdef GRAPHICS_MODIFIED_TILES
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  Pin dc = PIN_UNDEFINED, cs = PIN_UNDEFINED;
+  JsVarInt xOffset = 0, yOffset = 0;
+  bool all = false;
+  JsVar *palette = 0;
+  jsvConfigObject configs[] = {
+      {"dc", JSV_PIN, &dc},
+      {"cs", JSV_PIN, &cs},
+      {"xOffset", JSV_INTEGER, &xOffset},
+      {"yOffset", JSV_INTEGER, &yOffset},
+      {"all", JSV_BOOLEAN, &all},
+      {"palette", JSV_OBJECT, &palette}
+  };
+  if (!jsvReadConfigObject(options, configs, sizeof(configs) / sizeof(jsvConfigObject))) {
+    jsvUnLock(palette);
+    return 0;
+  }
+  if (!jshIsPinValid(dc)) {
+    jsvUnLock(palette);
+    jsExceptionHere(JSET_ERROR, "Expecting a valid 'dc' pin");
+    return 0;
+  }
+  if (gfx.data.type!=JSGRAPHICSTYPE_ARRAYBUFFER ||
+      (gfx.data.bpp!=16 && (gfx.data.bpp>8 || !palette))) {
+    jsvUnLock(palette);
+    jsExceptionHere(JSET_ERROR, "flipSPI needs a 16 bit ArrayBuffer Graphics, or a palette for 8 bits or fewer");
+    return 0;
+  }
+  spi_sender spiSend;
+  spi_sender_data spiSendData;
+  if (!jsspiGetSendFunction(spi, &spiSend, &spiSendData)) {
+    jsvUnLock(palette);
+    jsExceptionHere(JSET_ERROR, "Expecting an SPI device, got %t", spi);
+    return 0;
+  }
+  IOEventFlags device = jsiGetDeviceFromClass(spi);
+  // read the palette
+  uint16_t pal[256];
+  bool usePalette = palette!=0;
+  if (usePalette) {
+    memset(pal, 0, sizeof(pal));
+    JsvIterator it;
+    jsvIteratorNew(&it, palette, JSIF_EVERY_ARRAY_ELEMENT);
+    int i = 0;
+    while (i<256 && jsvIteratorHasElement(&it)) {
+      pal[i++] = (uint16_t)jsvIteratorGetIntegerValue(&it);
+      jsvIteratorNext(&it);
+    }
+    jsvIteratorFree(&it);
+    jsvUnLock(palette);
+  }
+  // if the buffer is flat and in plain row order, we can read rows straight from it
+  const uint8_t *pixels = 0;
+  if (!(gfx.data.flags & (JSGRAPHICSFLAGS_ARRAYBUFFER_ZIGZAG|JSGRAPHICSFLAGS_ARRAYBUFFER_INTERLEAVEX|JSGRAPHICSFLAGS_ARRAYBUFFER_VERTICAL_BYTE))) {
+    JsVar *buf = jsvObjectGetChild(parent, "buffer", 0);
+    size_t bufLen = 0;
+    pixels = (const uint8_t*)jsvGetDataPointer(buf, &bufLen);
+    jsvUnLock(buf);
+    if (bufLen<graphicsGetMemoryRequired(&gfx)) pixels = 0;
+  }
+  // work out what to send
+  JsGraphicsClipRect rects[GRAPHICS_MODIFIED_RECTS_MAX];
+  int rectCount;
+  if (all) {
+    rects[0].x1 = 0;
+    rects[0].y1 = 0;
+    rects[0].x2 = (unsigned short)(gfx.data.width-1);
+    rects[0].y2 = (unsigned short)(gfx.data.height-1);
+    rectCount = 1;
+  } else
+    rectCount = graphicsGetModifiedRects(&gfx, rects, GRAPHICS_MODIFIED_RECTS_MAX);
+  // send it
+  uint32_t bufs[2][GRAPHICS_FLIP_CHUNK/4]; // 32 bit aligned for DMA
+  int bufIdx = 0;
+  unsigned int bytes = 0;
+  if (rectCount && jshIsPinValid(cs)) jshPinOutput(cs, 0);
+  for (int r=0;r<rectCount && !jspIsInterrupted();r++) {
+    jswrap_graphics_flipSPIWindow(spiSend, &spiSendData, device, dc, 0x2A/*CASET*/, rects[r].x1+(int)xOffset, rects[r].x2+(int)xOffset);
+    jswrap_graphics_flipSPIWindow(spiSend, &spiSendData, device, dc, 0x2B/*RASET*/, rects[r].y1+(int)yOffset, rects[r].y2+(int)yOffset);
+    jswrap_graphics_flipSPICommand(spiSend, &spiSendData, device, dc, 0x2C/*RAMWR*/, NULL, 0);
+    bytes += 11;
+    unsigned char *buf = (unsigned char*)bufs[bufIdx];
+    unsigned int len = 0;
+    for (int y=rects[r].y1;y<=rects[r].y2;y++) {
+      int x = rects[r].x1;
+      while (x<=rects[r].x2) {
+        // as much of the row as will fit in the buffer
+        int n = 1+rects[r].x2-x;
+        if (n > (int)(GRAPHICS_FLIP_CHUNK-len)/2) n = (int)(GRAPHICS_FLIP_CHUNK-len)/2;
+        jswrap_graphics_flipSPIRow(&gfx, pixels, x, y, n, usePalette ? pal : NULL, &buf[len]);
+        x += n;
+        len += (unsigned int)n*2;
+        if (len==GRAPHICS_FLIP_CHUNK) {
+          /* On hardware SPI this returns once the other buffer has been sent and
+          this one is queued, so we can go on to fill the other buffer */
+          if (DEVICE_IS_SPI(device))
+            jshSPISendMany(device, buf, NULL, len, jswrap_graphics_flipSPIAsync);
+          else
+            spiSend(buf, NULL, len, &spiSendData);
+          bytes += len;
+          bufIdx = !bufIdx;
+          buf = (unsigned char*)bufs[bufIdx];
+          len = 0;
+        }
+      }
+    }
+    if (len) {
+      if (DEVICE_IS_SPI(device))
+        jshSPISendMany(device, buf, NULL, len, jswrap_graphics_flipSPIAsync);
+      else
+        spiSend(buf, NULL, len, &spiSendData);
+      bytes += len;
+      bufIdx = !bufIdx;
+    }
+  }
+  // the buffers are on the stack, so we must wait until they're sent
+  if (DEVICE_IS_SPI(device)) jshSPIWait(device);
+  if (rectCount && jshIsPinValid(cs)) jshPinOutput(cs, 1);
+  graphicsResetModified(&gfx);
+  graphicsSetVar(&gfx);
+  // update counters
+  JsVar *stats = jsvObjectGetChild(parent, GRAPHICS_FLIP_STATS, JSV_OBJECT);
+  if (stats) {
+    jswrap_graphics_flipSPIAddStat(stats, "frames", 1);
+    jswrap_graphics_flipSPIAddStat(stats, "rects", rectCount);
+    jswrap_graphics_flipSPIAddStat(stats, "bytes", bytes);
+    jsvObjectSetChildAndUnLock(stats, "lastRects", jsvNewFromInteger(rectCount));
+    jsvObjectSetChildAndUnLock(stats, "lastBytes", jsvNewFromInteger(bytes));
+    jsvUnLock(stats);
+  }
+  return (int)bytes;
+#else
+  return 0;
+#endif
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "getFlipStats",
+  "#if" : "defined(ESP32) && !defined(SAVE_ON_FLASH)",
+  "generate" : "jswrap_graphics_getFlipStats",
+  "params" : [
+    ["reset","bool","Whether to reset the counters or not"]
+  ],
+  "return" : ["JsVar","An object `{frames, rects, bytes, lastRects, lastBytes}`, or undefined if `flipSPI` hasn't been called"],
+  "typescript" : "getFlipStats(reset?: boolean): { frames: number, rects: number, bytes: number, lastRects: number, lastBytes: number } | undefined;"
+}
+Return counters for `Graphics.flipSPI` - how many times it has been called
+(`frames`), and the total number of rectangles and bytes sent. `lastRects`
+and `lastBytes` are for the most recent call.
+*/
+JsVar *jswrap_graphics_getFlipStats(JsVar *parent, bool reset) {
+  JsVar *stats = jsvObjectGetChild(parent, GRAPHICS_FLIP_STATS, 0);
+  if (stats && reset)
+    jsvObjectRemoveChild(parent, GRAPHICS_FLIP_STATS);
+  return stats;
+}
+
 /*JSON{
   "type" : "method",
   "class" : "Graphics",
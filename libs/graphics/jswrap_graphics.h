@@ -27,6 +27,9 @@ bool jswrap_graphics_idle();
 void jswrap_graphics_init();
 
 JsVar *jswrap_graphics_getInstance();
+void jswrap_graphics_kill();
+void jswrap_graphics_setVectorFontCache(int bytes);
+JsVar *jswrap_graphics_getVectorFontCache();
 // For creating graphics classes
 JsVar *jswrap_graphics_createArrayBuffer(int width, int height, int bpp,  JsVar *options);
 JsVar *jswrap_graphics_createCallback(int width, int height, int bpp, JsVar *callback);
@@ -77,7 +80,12 @@ JsVar *jswrap_graphics_imageMetrics(JsVar *parent, JsVar *var);
 JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos, JsVar *options);
 JsVar *jswrap_graphics_drawImages(JsVar *parent, JsVar *layersVar, JsVar *options);
 JsVar *jswrap_graphics_asImage(JsVar *parent, JsVar *imgType);
+JsVar *jswrap_graphics_beginList(JsVar *parent);
+JsVar *jswrap_graphics_endList(JsVar *parent);
+JsVar *jswrap_graphics_drawList(JsVar *parent, JsVar *list, int x, int y);
 JsVar *jswrap_graphics_getModified(JsVar *parent, bool reset);
+int jswrap_graphics_flipSPI(JsVar *parent, JsVar *spi, JsVar *options);
+JsVar *jswrap_graphics_getFlipStats(JsVar *parent, bool reset);
 JsVar *jswrap_graphics_scroll(JsVar *parent, int x, int y);
 JsVar *jswrap_graphics_blit(JsVar *parent, JsVar *options);
 JsVar *jswrap_graphics_asBMP(JsVar *parent);
@@ -89,10 +97,14 @@ JsVar *jswrap_graphics_theme();
 JsVar *jswrap_graphics_setTheme(JsVar *parent, JsVar *theme);
 
 
+/// Format byte of an image String that starts with a 0 width byte. Each row is a 16 bit length then RLE packets
+#define GRAPHICS_IMAGE_FORMAT_RLE 1
+
 /// Info about an image to be used for rendering
 typedef struct {
   int width, height, bpp;
   bool isTransparent;
+  bool compressed; ///< bitmap is stored as GRAPHICS_IMAGE_FORMAT_RLE rows
   unsigned int transparentCol;
   JsVar *buffer; // must be unlocked!
   uint32_t bitmapOffset; // start offset in imageBuffer
@@ -102,7 +114,7 @@ typedef struct {
   unsigned int pixelsPerByteMask;
   int stride; ///< bytes per line
   unsigned short headerLength; ///< size of header (inc palette)
-  unsigned short bitmapLength; ///< size of data (excl header)
+  uint32_t bitmapLength; ///< size of data (excl header)
 
   uint16_t _simplePalette[16]; // used when a palette is created for rendering
 } GfxDrawImageInfo;
@@ -129,6 +141,11 @@ typedef struct {
   int sx,sy; //< iterator X increment
   int px,py; //< y iterator position
   int qx,qy; //< x iterator position
+  // for drawImages
+  int alpha; ///< 0..256
+  bool unscaled; ///< not rotated, scaled or repeated, so pixels can be read a row at a time
+  int nextRow; ///< compressed images: the image row 'it' points to
+  unsigned int *row; ///< compressed images: the decoded pixels of the current row
 } GfxDrawImageLayer;
 
 bool _jswrap_drawImageLayerGetPixel(GfxDrawImageLayer *l, unsigned int *result);
@@ -139,3 +156,7 @@ void _jswrap_drawImageLayerNextX(GfxDrawImageLayer *l);
 void _jswrap_drawImageLayerNextXRepeat(GfxDrawImageLayer *l);
 void _jswrap_drawImageLayerNextY(GfxDrawImageLayer *l);
 void _jswrap_drawImageSimple(JsGraphics *gfx, int xPos, int yPos, GfxDrawImageInfo *img, JsvStringIterator *it);
+/// Decode one row of a compressed image into 'row' (img->width raw pixel values), leaving 'it' at the next row
+void _jswrap_graphics_decodeImageRow(GfxDrawImageInfo *img, JsvStringIterator *it, unsigned int *row);
+/// Draw a compressed image a row at a time, scaled up by 'scale'
+void _jswrap_drawImageCompressed(JsGraphics *gfx, int xPos, int yPos, int scale, GfxDrawImageInfo *img, JsvStringIterator *it);
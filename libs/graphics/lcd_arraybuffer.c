@@ -239,23 +239,6 @@ void  lcdFillRect_ArrayBuffer_flat(struct JsGraphics *gfx, int x1, int y1, int x
 }
 
 #ifdef GRAPHICS_FAST_PATHS
-void lcdSetPixel_ArrayBuffer_flat1(JsGraphics *gfx, int x, int y, unsigned int col) {
-  int p = x + y*gfx->data.width;
-  if (col) ((uint8_t*)gfx->backendData)[p>>3] |= (uint8_t)(0x80 >> (p&7));
-  else ((uint8_t*)gfx->backendData)[p>>3] &= (uint8_t)(0xFF7F >> (p&7));
-}
-
-void lcdFillRect_ArrayBuffer_flat1(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
-  for (int y=y1;y<=y2;y++) {
-    int p = x1 + y*gfx->data.width;
-    for (int x=x1;x<=x2;x++) {
-      if (col) ((uint8_t*)gfx->backendData)[p>>3] |= (uint8_t)(0x80 >> (p&7));
-      else ((uint8_t*)gfx->backendData)[p>>3] &= (uint8_t)(0xFF7F >> (p&7));
-      p++;
-    }
-  }
-}
-
 void lcdSetPixel_ArrayBuffer_flat8(JsGraphics *gfx, int x, int y, unsigned int col) {
   ((uint8_t*)gfx->backendData)[x + y*gfx->data.width] = (uint8_t)col;
 }
@@ -265,27 +248,232 @@ unsigned int lcdGetPixel_ArrayBuffer_flat8(struct JsGraphics *gfx, int x, int y)
 }
 
 void lcdFillRect_ArrayBuffer_flat8(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
-  for (int y=y1;y<=y2;y++) {
-    uint8_t *p = &((uint8_t*)gfx->backendData)[x1 + y*gfx->data.width];
-    for (int x=x1;x<=x2;x++)
-      *(p++) = (uint8_t)col;
+  for (int y=y1;y<=y2;y++)
+    memset(&((uint8_t*)gfx->backendData)[x1 + y*gfx->data.width], (uint8_t)col, (size_t)(1+x2-x1));
+}
+
+// ------------------------------------------------------------------------ Kernels for each pixel format
+// These are only used for flat, linear buffers (no zigzag/interleavex)
+
+// Mask for bits s..e-1 of a byte, where bit 0 is the MSB or the LSB
+static ALWAYS_INLINE uint8_t lcdBitMask_ArrayBuffer(unsigned int s, unsigned int e, bool msb) {
+  return msb ? (uint8_t)((0xFFU>>s) & ~(0xFFU>>e)) : (uint8_t)(((1U<<e)-1) & ~((1U<<s)-1));
+}
+
+// Set bits p..pEnd-1 of buf to the bits in 'fill', using memset for all the whole bytes
+static ALWAYS_INLINE void lcdFillBits_ArrayBuffer(uint8_t *buf, unsigned int p, unsigned int pEnd, uint8_t fill, bool msb) {
+  uint8_t *ptr = &buf[p>>3];
+  uint8_t *end = &buf[pEnd>>3];
+  unsigned int s = p&7, e = pEnd&7;
+  if (ptr==end) { // all in one byte
+    uint8_t mask = lcdBitMask_ArrayBuffer(s, e, msb);
+    *ptr = (uint8_t)((*ptr & ~mask) | (fill & mask));
+    return;
+  }
+  if (s) {
+    uint8_t mask = lcdBitMask_ArrayBuffer(s, 8, msb);
+    *ptr = (uint8_t)((*ptr & ~mask) | (fill & mask));
+    ptr++;
+  }
+  memset(ptr, fill, (size_t)(end-ptr));
+  if (e) {
+    uint8_t mask = lcdBitMask_ArrayBuffer(0, e, msb);
+    *end = (uint8_t)((*end & ~mask) | (fill & mask));
   }
 }
 
-void lcdScroll_ArrayBuffer_flat8(JsGraphics *gfx, int xdir, int ydir, int x1, int y1, int x2, int y2) {
-  int clipWidth = x2 - x1;
-  int clipHeight = y2 - y1;
-  int pixels = -(xdir + ydir*clipWidth);
-  int startPixel = gfx->data.width * (y1 - ydir) + x1;
-  int row;
-  for (row=0; row<(clipHeight+ydir); row++) {
-    if (pixels<0) {
-      memcpy(&((uint8_t*)gfx->backendData)[startPixel-pixels],&((uint8_t*)gfx->backendData)[startPixel],(size_t)(clipWidth+xdir));
-    } else {
-      memcpy(&((uint8_t*)gfx->backendData)[startPixel],&((uint8_t*)gfx->backendData)[startPixel+pixels],(size_t)(clipWidth-xdir));
-    }
-    startPixel += gfx->data.width;
+// Fill len bytes at p by repeating the first 'size' bytes (which are already set), doubling the amount copied each time
+static void lcdFillRepeat_ArrayBuffer(uint8_t *p, size_t size, size_t len) {
+  for (size_t done=size; done<len; done<<=1)
+    memcpy(p+done, p, (done < len-done) ? done : len-done);
+}
+
+// 1, 2 and 4 bits, pixels packed along each row
+#define LCD_ARRAYBUFFER_SUBBYTE_KERNELS(NAME, BPP, MSB) \
+static void lcdSetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y, unsigned int col) { \
+  unsigned int p = (unsigned int)(x + y*gfx->data.width)*BPP; \
+  unsigned int shift = MSB ? (8-BPP-(p&7)) : (p&7); \
+  uint8_t *ptr = &((uint8_t*)gfx->backendData)[p>>3]; \
+  *ptr = (uint8_t)((*ptr & ~(((1U<<BPP)-1)<<shift)) | ((col&((1U<<BPP)-1))<<shift)); \
+} \
+static unsigned int lcdGetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y) { \
+  unsigned int p = (unsigned int)(x + y*gfx->data.width)*BPP; \
+  unsigned int shift = MSB ? (8-BPP-(p&7)) : (p&7); \
+  return (((uint8_t*)gfx->backendData)[p>>3] >> shift) & ((1U<<BPP)-1); \
+} \
+static void lcdFillRect_ArrayBuffer_##NAME(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) { \
+  uint8_t fill = (uint8_t)(col&((1U<<BPP)-1)); \
+  for (int b=BPP;b<8;b<<=1) fill |= (uint8_t)(fill<<b); /* same color in every pixel of the byte */ \
+  unsigned int stride = (unsigned int)gfx->data.width*BPP; \
+  unsigned int len = (unsigned int)(1+x2-x1)*BPP; \
+  unsigned int p = (unsigned int)(x1 + y1*gfx->data.width)*BPP; \
+  for (int y=y1;y<=y2;y++,p+=stride) \
+    lcdFillBits_ArrayBuffer((uint8_t*)gfx->backendData, p, p+len, fill, MSB); \
+}
+
+// 1 bit, with each byte being 8 pixels stacked vertically
+#define LCD_ARRAYBUFFER_VERTICAL_KERNELS(NAME, MSB) \
+static void lcdSetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y, unsigned int col) { \
+  uint8_t *p = &((uint8_t*)gfx->backendData)[x + (y>>3)*gfx->data.width]; \
+  uint8_t bit = (uint8_t)(MSB ? (0x80>>(y&7)) : (1<<(y&7))); \
+  if (col&1) *p |= bit; \
+  else *p &= (uint8_t)~bit; \
+} \
+static unsigned int lcdGetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y) { \
+  uint8_t bit = (uint8_t)(MSB ? (0x80>>(y&7)) : (1<<(y&7))); \
+  return (((uint8_t*)gfx->backendData)[x + (y>>3)*gfx->data.width] & bit) ? 1 : 0; \
+} \
+static void lcdFillRect_ArrayBuffer_##NAME(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) { \
+  uint8_t fill = (col&1) ? 0xFF : 0; \
+  int y = y1; \
+  while (y<=y2) { /* one row of bytes at a time */ \
+    int yEnd = ((y|7) < y2) ? (y|7) : y2; \
+    uint8_t mask = lcdBitMask_ArrayBuffer((unsigned)(y&7), (unsigned)(yEnd&7)+1, MSB); \
+    uint8_t *p = &((uint8_t*)gfx->backendData)[x1 + (y>>3)*gfx->data.width]; \
+    if (mask==0xFF) memset(p, fill, (size_t)(1+x2-x1)); \
+    else for (int x=x1;x<=x2;x++,p++) *p = (uint8_t)((*p & ~mask) | (fill & mask)); \
+    y = yEnd+1; \
+  } \
+}
+
+// 16 bits. We only use these if the buffer is 32 bit aligned and we're little-endian, so we can write whole pixels/words
+#define LCD_ARRAYBUFFER_SWAP16(c) ((uint16_t)((((c)>>8)&0xFF) | (((c)&0xFF)<<8)))
+#define LCD_ARRAYBUFFER_16BIT_KERNELS(NAME, MSB) \
+static void lcdSetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y, unsigned int col) { \
+  ((uint16_t*)gfx->backendData)[x + y*gfx->data.width] = MSB ? LCD_ARRAYBUFFER_SWAP16(col) : (uint16_t)col; \
+} \
+static unsigned int lcdGetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y) { \
+  unsigned int c = ((uint16_t*)gfx->backendData)[x + y*gfx->data.width]; \
+  return MSB ? LCD_ARRAYBUFFER_SWAP16(c) : c; \
+} \
+static void lcdFillRect_ArrayBuffer_##NAME(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) { \
+  uint16_t c = MSB ? LCD_ARRAYBUFFER_SWAP16(col) : (uint16_t)col; \
+  uint32_t cc = c | ((uint32_t)c<<16); \
+  for (int y=y1;y<=y2;y++) { \
+    uint16_t *p = &((uint16_t*)gfx->backendData)[x1 + y*gfx->data.width]; \
+    int n = 1+x2-x1; \
+    if ((size_t)p & 2) { *(p++) = c; n--; } /* get word aligned */ \
+    uint32_t *w = (uint32_t*)p; \
+    for (;n>=2;n-=2) *(w++) = cc; \
+    if (n) *(uint16_t*)w = c; \
+  } \
+}
+
+// 24 bits
+#define LCD_ARRAYBUFFER_24BIT_KERNELS(NAME, MSB) \
+static void lcdSetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y, unsigned int col) { \
+  uint8_t *p = &((uint8_t*)gfx->backendData)[(x + y*gfx->data.width)*3]; \
+  p[0] = (uint8_t)(MSB ? (col>>16) : col); \
+  p[1] = (uint8_t)(col>>8); \
+  p[2] = (uint8_t)(MSB ? col : (col>>16)); \
+} \
+static unsigned int lcdGetPixel_ArrayBuffer_##NAME(JsGraphics *gfx, int x, int y) { \
+  uint8_t *p = &((uint8_t*)gfx->backendData)[(x + y*gfx->data.width)*3]; \
+  return MSB ? ((unsigned)p[0]<<16 | (unsigned)p[1]<<8 | p[2]) : ((unsigned)p[2]<<16 | (unsigned)p[1]<<8 | p[0]); \
+} \
+static void lcdFillRect_ArrayBuffer_##NAME(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) { \
+  for (int y=y1;y<=y2;y++) { \
+    lcdSetPixel_ArrayBuffer_##NAME(gfx, x1, y, col); \
+    lcdFillRepeat_ArrayBuffer(&((uint8_t*)gfx->backendData)[(x1 + y*gfx->data.width)*3], 3, (size_t)(1+x2-x1)*3); \
+  } \
+}
+
+LCD_ARRAYBUFFER_SUBBYTE_KERNELS(flat1msb, 1, true)
+LCD_ARRAYBUFFER_SUBBYTE_KERNELS(flat1lsb, 1, false)
+LCD_ARRAYBUFFER_SUBBYTE_KERNELS(flat2msb, 2, true)
+LCD_ARRAYBUFFER_SUBBYTE_KERNELS(flat2lsb, 2, false)
+LCD_ARRAYBUFFER_SUBBYTE_KERNELS(flat4msb, 4, true)
+LCD_ARRAYBUFFER_SUBBYTE_KERNELS(flat4lsb, 4, false)
+LCD_ARRAYBUFFER_VERTICAL_KERNELS(vert1msb, true)
+LCD_ARRAYBUFFER_VERTICAL_KERNELS(vert1lsb, false)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+#define LCD_ARRAYBUFFER_16BIT
+LCD_ARRAYBUFFER_16BIT_KERNELS(flat16msb, true)
+LCD_ARRAYBUFFER_16BIT_KERNELS(flat16lsb, false)
+#endif
+LCD_ARRAYBUFFER_24BIT_KERNELS(flat24msb, true)
+LCD_ARRAYBUFFER_24BIT_KERNELS(flat24lsb, false)
+
+// Blit for formats with a whole number of bytes per pixel. Areas may overlap
+static void lcdBlit_ArrayBuffer_bytes(JsGraphics *gfx, int x1, int y1, int w, int h, int x2, int y2) {
+  int bytesPerPixel = gfx->data.bpp>>3;
+  int stride = gfx->data.width*bytesPerPixel;
+  uint8_t *src = &((uint8_t*)gfx->backendData)[(x1 + y1*gfx->data.width)*bytesPerPixel];
+  uint8_t *dst = &((uint8_t*)gfx->backendData)[(x2 + y2*gfx->data.width)*bytesPerPixel];
+  if (y2>y1) { // copying down - start at the bottom so we don't overwrite rows before they're copied
+    src += stride*(h-1);
+    dst += stride*(h-1);
+    stride = -stride;
+  }
+  for (int y=0;y<h;y++) {
+    memmove(dst, src, (size_t)(w*bytesPerPixel));
+    src += stride;
+    dst += stride;
+  }
+}
+
+static void lcdScroll_ArrayBuffer_bytes(JsGraphics *gfx, int xdir, int ydir, int x1, int y1, int x2, int y2) {
+  int w = 1+x2-x1 - ((xdir<0) ? -xdir : xdir);
+  int h = 1+y2-y1 - ((ydir<0) ? -ydir : ydir);
+  if (w<=0 || h<=0) return;
+  lcdBlit_ArrayBuffer_bytes(gfx,
+      (xdir<0) ? x1-xdir : x1, (ydir<0) ? y1-ydir : y1, w, h,
+      (xdir>0) ? x1+xdir : x1, (ydir>0) ? y1+ydir : y1);
+}
+
+#define LCD_ARRAYBUFFER_USE_KERNELS(NAME) { \
+  gfx->setPixel = lcdSetPixel_ArrayBuffer_##NAME; \
+  gfx->getPixel = lcdGetPixel_ArrayBuffer_##NAME; \
+  gfx->fillRect = lcdFillRect_ArrayBuffer_##NAME; \
+}
+
+/// Choose kernels for the format of this flat ArrayBuffer. Returns false if there are none
+static bool lcdSetKernels_ArrayBuffer(JsGraphics *gfx, bool wordAligned) {
+  bool msb = (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_MSB)!=0;
+  if (gfx->data.flags & (JSGRAPHICSFLAGS_ARRAYBUFFER_ZIGZAG|JSGRAPHICSFLAGS_ARRAYBUFFER_INTERLEAVEX))
+    return false;
+  if (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_VERTICAL_BYTE) {
+    if (gfx->data.bpp!=1) return false;
+    if (msb) LCD_ARRAYBUFFER_USE_KERNELS(vert1msb)
+    else LCD_ARRAYBUFFER_USE_KERNELS(vert1lsb)
+    return true;
   }
+  switch (gfx->data.bpp) {
+    case 1:
+      if (msb) LCD_ARRAYBUFFER_USE_KERNELS(flat1msb)
+      else LCD_ARRAYBUFFER_USE_KERNELS(flat1lsb)
+      return true;
+    case 2:
+      if (msb) LCD_ARRAYBUFFER_USE_KERNELS(flat2msb)
+      else LCD_ARRAYBUFFER_USE_KERNELS(flat2lsb)
+      return true;
+    case 4:
+      if (msb) LCD_ARRAYBUFFER_USE_KERNELS(flat4msb)
+      else LCD_ARRAYBUFFER_USE_KERNELS(flat4lsb)
+      return true;
+    case 8:
+      gfx->setPixel = lcdSetPixel_ArrayBuffer_flat8;
+      gfx->getPixel = lcdGetPixel_ArrayBuffer_flat8;
+      gfx->fillRect = lcdFillRect_ArrayBuffer_flat8;
+      break;
+#ifdef LCD_ARRAYBUFFER_16BIT
+    case 16:
+      if (!wordAligned) return false;
+      if (msb) LCD_ARRAYBUFFER_USE_KERNELS(flat16msb)
+      else LCD_ARRAYBUFFER_USE_KERNELS(flat16lsb)
+      break;
+#endif
+    case 24:
+      if (msb) LCD_ARRAYBUFFER_USE_KERNELS(flat24msb)
+      else LCD_ARRAYBUFFER_USE_KERNELS(flat24lsb)
+      break;
+    default:
+      return false;
+  }
+  // whole bytes per pixel, so we can blit and scroll with memmove
+  gfx->blit = lcdBlit_ArrayBuffer_bytes;
+  gfx->scroll = lcdScroll_ArrayBuffer_bytes;
+  return true;
 }
 #endif
 
@@ -310,20 +498,8 @@ void lcdSetCallbacks_ArrayBuffer(JsGraphics *gfx) {
   if (dataPtr && len>=graphicsGetMemoryRequired(gfx) && !(gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_ZIGZAG)) {
     gfx->backendData = dataPtr;
 #ifdef GRAPHICS_FAST_PATHS
-    if (gfx->data.bpp==1 &&
-        (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_MSB) &&
-        !(gfx->data.flags & JSGRAPHICSFLAGS_NONLINEAR)
-        ) { // super fast path for 1 bit
-      gfx->setPixel = lcdSetPixel_ArrayBuffer_flat1;
-      gfx->getPixel = lcdGetPixel_ArrayBuffer_flat;
-      gfx->fillRect = lcdFillRect_ArrayBuffer_flat1;
-    } else if (gfx->data.bpp==8 &&
-               !(gfx->data.flags & JSGRAPHICSFLAGS_NONLINEAR)
-        ) { // super fast path for 8 bits
-      gfx->setPixel = lcdSetPixel_ArrayBuffer_flat8;
-      gfx->getPixel = lcdGetPixel_ArrayBuffer_flat8;
-      gfx->fillRect = lcdFillRect_ArrayBuffer_flat8;
-      gfx->scroll = lcdScroll_ArrayBuffer_flat8;
+    if (lcdSetKernels_ArrayBuffer(gfx, ((size_t)dataPtr&3)==0)) {
+      // super fast path specialised for this pixel format
     } else
 #endif
     {
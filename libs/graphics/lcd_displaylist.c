@@ -0,0 +1,338 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Graphics Backend for recording drawing into a display list
+ *
+ * While JSGRAPHICSFLAGS_RECORDING is set, setPixel/fillRect are replaced with
+ * functions that append to a String instead of drawing, and lines and polygons
+ * are recorded whole (in device coordinates) by graphicsDrawLineDevice and
+ * graphicsFillPolyDevice. Replaying a list never calls back into JS or parses
+ * fonts. Adjacent pixels/rects of the same colour are merged as they are recorded.
+ *
+ * Each op is a byte followed by numbers stored 7 bits per byte, low bits first,
+ * with the top bit set if more bytes follow. Signed numbers are zigzag encoded
+ * (0,-1,1,-2,... => 0,1,2,3,...) so small negative numbers are short too.
+ *
+ * All the recording state is kept in a flat string in the Graphics instance, so
+ * more than one Graphics can record at once.
+ * ----------------------------------------------------------------------------
+ */
+#include "lcd_displaylist.h"
+#include "jsvar.h"
+#include "jsparse.h"
+#include "jshardware.h"
+
+#define DL_BUFFER_NAME JS_HIDDEN_CHAR_STR"dl" // hidden child of the Graphics being recorded: the ops so far
+#define DL_STATE_NAME JS_HIDDEN_CHAR_STR"dlS" // hidden child of the Graphics being recorded: flat string of DlState
+
+#define DL_OP_COLOR 1 // colour
+#define DL_OP_RECT 2 // x1, y1, x2-x1, y2-y1 - device coordinates, inclusive
+#define DL_OP_LINE 3 // x1, y1 (signed), x2-x1, y2-y1 (signed) - device coordinates
+#define DL_OP_POLY 4 // number of points, then x, y of each (signed, 1/16th pixel) as the difference from the last
+#define DL_OP_POLY_AA 5 // as DL_OP_POLY, but antialiased
+
+#define DL_PENDING_SIZE 32 // bytes of ops we keep before appending them to the String
+
+typedef struct {
+  unsigned int color; ///< last colour written
+  short rect[4]; ///< rect that's not written yet (so can still be extended)
+  bool hasColor; ///< have we written a colour yet?
+  bool hasRect; ///< is there a rect that's not written yet?
+  unsigned char pendingLen;
+  unsigned char pending[DL_PENDING_SIZE]; ///< ops not yet appended to the String
+#ifndef NO_MODIFIED_AREA
+  short modified[4]; ///< modified area before recording, as recording shouldn't change it
+#ifdef GRAPHICS_MODIFIED_TILES
+  unsigned short modTiles[GRAPHICS_MODIFIED_TILES_Y];
+#endif
+#endif
+} DlState;
+
+/// Append any pending ops to the String
+static void dlFlushPending(JsGraphics *gfx, DlState *s) {
+  if (!s->pendingLen) return;
+  JsVar *buf = jsvObjectGetChild(gfx->graphicsVar, DL_BUFFER_NAME, 0);
+  if (buf) {
+    jsvAppendStringBuf(buf, (const char *)s->pending, s->pendingLen);
+    jsvUnLock(buf);
+  }
+  s->pendingLen = 0;
+}
+
+static void dlWriteByte(JsGraphics *gfx, DlState *s, unsigned char b) {
+  if (s->pendingLen >= DL_PENDING_SIZE) dlFlushPending(gfx, s);
+  s->pending[s->pendingLen++] = b;
+}
+
+static void dlWriteUInt(JsGraphics *gfx, DlState *s, unsigned int v) {
+  while (v>=128) {
+    dlWriteByte(gfx, s, (unsigned char)(v|128));
+    v >>= 7;
+  }
+  dlWriteByte(gfx, s, (unsigned char)v);
+}
+
+static void dlWriteInt(JsGraphics *gfx, DlState *s, int v) {
+  dlWriteUInt(gfx, s, ((unsigned int)v<<1) ^ (unsigned int)(v>>31));
+}
+
+static unsigned int dlReadUInt(JsvStringIterator *it) {
+  unsigned int v = 0;
+  int shift = 0;
+  unsigned char c;
+  do {
+    c = (unsigned char)jsvStringIteratorGetCharAndNext(it);
+    v |= (unsigned int)(c&127) << shift;
+    shift += 7;
+  } while ((c&128) && shift<32);
+  return v;
+}
+
+static int dlReadInt(JsvStringIterator *it) {
+  unsigned int v = dlReadUInt(it);
+  return (int)(v>>1) ^ -(int)(v&1);
+}
+
+/// Write any rect we were still extending
+static void dlFlushRect(JsGraphics *gfx, DlState *s) {
+  if (!s->hasRect) return;
+  dlWriteByte(gfx, s, DL_OP_RECT);
+  dlWriteUInt(gfx, s, (unsigned short)s->rect[0]);
+  dlWriteUInt(gfx, s, (unsigned short)s->rect[1]);
+  dlWriteUInt(gfx, s, (unsigned int)(s->rect[2]-s->rect[0]));
+  dlWriteUInt(gfx, s, (unsigned int)(s->rect[3]-s->rect[1]));
+  s->hasRect = false;
+}
+
+/// Write any rect we were extending, then the colour if it has changed
+static void dlSetColor(JsGraphics *gfx, DlState *s, unsigned int col) {
+  dlFlushRect(gfx, s);
+  if (!s->hasColor || col!=s->color) {
+    dlWriteByte(gfx, s, DL_OP_COLOR);
+    dlWriteUInt(gfx, s, col);
+    s->hasColor = true;
+    s->color = col;
+  }
+}
+
+static void dlFillRect(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
+  DlState *s = (DlState*)gfx->backendData;
+  if (!s) return;
+  if (s->hasRect && col==s->color) {
+    // next span along on the same line?
+    if (y1==y2 && s->rect[1]==y1 && s->rect[3]==y2 && x1==s->rect[2]+1) {
+      s->rect[2] = (short)x2;
+      return;
+    }
+    // same width, directly below?
+    if (x1==s->rect[0] && x2==s->rect[2] && y1==s->rect[3]+1) {
+      s->rect[3] = (short)y2;
+      return;
+    }
+  }
+  dlSetColor(gfx, s, col);
+  s->rect[0] = (short)x1;
+  s->rect[1] = (short)y1;
+  s->rect[2] = (short)x2;
+  s->rect[3] = (short)y2;
+  s->hasRect = true;
+}
+
+static void dlSetPixel(JsGraphics *gfx, int x, int y, unsigned int col) {
+  dlFillRect(gfx, x, y, x, y, col);
+}
+
+// Nothing is drawn while recording, so blending (eg. antialiasing) is with the background colour
+static unsigned int dlGetPixel(JsGraphics *gfx, int x, int y) {
+  NOT_USED(x);NOT_USED(y);
+  return gfx->data.bgColor;
+}
+
+// Nothing is drawn while recording, so don't move anything around either
+static void dlBlit(JsGraphics *gfx, int x1, int y1, int w, int h, int x2, int y2) {
+  NOT_USED(gfx);NOT_USED(x1);NOT_USED(y1);NOT_USED(w);NOT_USED(h);NOT_USED(x2);NOT_USED(y2);
+}
+static void dlScroll(JsGraphics *gfx, int xdir, int ydir, int x1, int y1, int x2, int y2) {
+  NOT_USED(gfx);NOT_USED(xdir);NOT_USED(ydir);NOT_USED(x1);NOT_USED(y1);NOT_USED(x2);NOT_USED(y2);
+}
+
+/// Record a line in the foreground colour (device coordinates)
+void lcdDrawLine_DisplayList(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
+  DlState *s = (DlState*)gfx->backendData;
+  if (!s) return;
+  dlSetColor(gfx, s, gfx->data.fgColor);
+  dlWriteByte(gfx, s, DL_OP_LINE);
+  dlWriteInt(gfx, s, x1);
+  dlWriteInt(gfx, s, y1);
+  dlWriteInt(gfx, s, x2-x1);
+  dlWriteInt(gfx, s, y2-y1);
+}
+
+/// Record a filled polygon in the foreground colour (device coordinates, 1/16th pixel)
+void lcdFillPoly_DisplayList(JsGraphics *gfx, int points, const short *vertices, bool antiAlias) {
+  DlState *s = (DlState*)gfx->backendData;
+  if (!s || points<3) return;
+  dlSetColor(gfx, s, gfx->data.fgColor);
+  dlWriteByte(gfx, s, antiAlias ? DL_OP_POLY_AA : DL_OP_POLY);
+  dlWriteUInt(gfx, s, (unsigned int)points);
+  int lx = 0, ly = 0;
+  for (int i=0;i<points;i++) {
+    dlWriteInt(gfx, s, vertices[i*2]-lx);
+    dlWriteInt(gfx, s, vertices[i*2+1]-ly);
+    lx = vertices[i*2];
+    ly = vertices[i*2+1];
+  }
+}
+
+/// Start recording everything drawn to this Graphics instance. Returns false on error
+bool lcdBegin_DisplayList(JsGraphics *gfx) {
+  JsVar *buf = jsvNewFromEmptyString();
+  JsVar *stateVar = jsvNewFlatStringOfLength(sizeof(DlState));
+  if (!buf || !stateVar) {
+    jsvUnLock2(buf, stateVar);
+    return false;
+  }
+  DlState *s = (DlState*)jsvGetFlatStringPointer(stateVar);
+  memset(s, 0, sizeof(DlState));
+#ifndef NO_MODIFIED_AREA
+  s->modified[0] = gfx->data.modMinX;
+  s->modified[1] = gfx->data.modMinY;
+  s->modified[2] = gfx->data.modMaxX;
+  s->modified[3] = gfx->data.modMaxY;
+#ifdef GRAPHICS_MODIFIED_TILES
+  memcpy(s->modTiles, gfx->data.modTiles, sizeof(s->modTiles));
+#endif
+#endif
+  jsvObjectSetChildAndUnLock(gfx->graphicsVar, DL_BUFFER_NAME, buf);
+  jsvObjectSetChildAndUnLock(gfx->graphicsVar, DL_STATE_NAME, stateVar);
+  gfx->data.flags |= JSGRAPHICSFLAGS_RECORDING;
+  lcdSetCallbacks_DisplayList(gfx);
+  return true;
+}
+
+/// Stop recording, put back the modified area from before, and return the ops recorded (or 0)
+static JsVar *dlStop(JsGraphics *gfx) {
+  DlState *s = (DlState*)gfx->backendData;
+  if (s) {
+    dlFlushRect(gfx, s);
+    dlFlushPending(gfx, s);
+#ifndef NO_MODIFIED_AREA
+    gfx->data.modMinX = s->modified[0];
+    gfx->data.modMinY = s->modified[1];
+    gfx->data.modMaxX = s->modified[2];
+    gfx->data.modMaxY = s->modified[3];
+#ifdef GRAPHICS_MODIFIED_TILES
+    memcpy(gfx->data.modTiles, s->modTiles, sizeof(s->modTiles));
+#endif
+#endif
+  }
+  gfx->data.flags &= ~JSGRAPHICSFLAGS_RECORDING;
+  JsVar *buf = jsvObjectGetChild(gfx->graphicsVar, DL_BUFFER_NAME, 0);
+  jsvObjectRemoveChild(gfx->graphicsVar, DL_BUFFER_NAME);
+  jsvObjectRemoveChild(gfx->graphicsVar, DL_STATE_NAME);
+  graphicsSetCallbacks(gfx);
+  return buf;
+}
+
+/// Stop recording and return the display list
+JsVar *lcdEnd_DisplayList(JsGraphics *gfx) {
+  if (!(gfx->data.flags & JSGRAPHICSFLAGS_RECORDING)) {
+    jsExceptionHere(JSET_ERROR, "Not recording a display list");
+    return 0;
+  }
+  JsVar *buf = dlStop(gfx);
+  if (!buf) return 0;
+  JsVar *list = jsvNewObject();
+  if (list) {
+    jsvObjectSetChild(list, "buffer", buf);
+    jsvObjectSetChildAndUnLock(list, "time", jsvNewFromFloat(0));
+  }
+  jsvUnLock(buf);
+  return list;
+}
+
+/// Replay a display list with its top-left moved by x,y (user coordinates)
+void lcdDraw_DisplayList(JsGraphics *gfx, JsVar *list, int x, int y) {
+  JsVar *buf = jsvObjectGetChild(list, "buffer", 0);
+  if (!jsvIsString(buf)) {
+    jsExceptionHere(JSET_ERROR, "Expecting a display list from Graphics.endList, got %t", list);
+    jsvUnLock(buf);
+    return;
+  }
+  JsSysTime startTime = jshGetSystemTime();
+  // the list is in device coordinates, so work out how far x,y moves us on the device
+  int ox = 0, oy = 0;
+  graphicsToDeviceCoordinates(gfx, &ox, &oy);
+  graphicsToDeviceCoordinates(gfx, &x, &y);
+  x -= ox;
+  y -= oy;
+  unsigned int oldColor = gfx->data.fgColor;
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, buf, 0);
+  while (jsvStringIteratorHasChar(&it)) {
+    char op = jsvStringIteratorGetCharAndNext(&it);
+    if (op==DL_OP_COLOR) {
+      gfx->data.fgColor = dlReadUInt(&it);
+    } else if (op==DL_OP_RECT) {
+      int x1 = (int)dlReadUInt(&it) + x;
+      int y1 = (int)dlReadUInt(&it) + y;
+      int x2 = x1 + (int)dlReadUInt(&it);
+      int y2 = y1 + (int)dlReadUInt(&it);
+      graphicsFillRectDevice(gfx, x1, y1, x2, y2, gfx->data.fgColor);
+    } else if (op==DL_OP_LINE) {
+      int x1 = dlReadInt(&it) + x;
+      int y1 = dlReadInt(&it) + y;
+      int x2 = x1 + dlReadInt(&it);
+      int y2 = y1 + dlReadInt(&it);
+      graphicsDrawLineDevice(gfx, x1, y1, x2, y2);
+    } else if (op==DL_OP_POLY || op==DL_OP_POLY_AA) {
+      int points = (int)dlReadUInt(&it);
+      if (points<3 || jsuGetFreeStack() < 256+sizeof(short)*2*(size_t)points) {
+        jsExceptionHere(JSET_ERROR, "Not enough stack to draw display list");
+        break;
+      }
+      short *vertices = (short*)alloca(sizeof(short)*2*(size_t)points);
+      int vx = 0, vy = 0;
+      for (int i=0;i<points;i++) {
+        vx += dlReadInt(&it);
+        vy += dlReadInt(&it);
+        vertices[i*2] = (short)(vx + x*16);
+        vertices[i*2+1] = (short)(vy + y*16);
+      }
+      graphicsFillPolyDevice(gfx, points, vertices, op==DL_OP_POLY_AA);
+    } else {
+      jsExceptionHere(JSET_ERROR, "Corrupt display list");
+      break;
+    }
+  }
+  jsvStringIteratorFree(&it);
+  jsvUnLock(buf);
+  gfx->data.fgColor = oldColor;
+  jsvObjectSetChildAndUnLock(list, "time", jsvNewFromFloat(jshGetMillisecondsFromTime(jshGetSystemTime()-startTime)));
+}
+
+void lcdSetCallbacks_DisplayList(JsGraphics *gfx) {
+  /* NOTE: This is nasty as the state isn't locked. HOWEVER we know that
+   gfx->graphicsVar IS locked, so it isn't going anywhere, and flat strings never move */
+  JsVar *stateVar = jsvObjectGetChild(gfx->graphicsVar, DL_STATE_NAME, 0);
+  gfx->backendData = jsvIsFlatString(stateVar) ? jsvGetFlatStringPointer(stateVar) : 0;
+  jsvUnLock(stateVar);
+  gfx->setPixel = dlSetPixel;
+  gfx->getPixel = dlGetPixel;
+  gfx->fillRect = dlFillRect;
+  gfx->blit = dlBlit;
+  gfx->scroll = dlScroll;
+}
+
+/// Stop any recording on this Graphics, throwing away what was recorded
+void lcdKill_DisplayList(JsGraphics *gfx) {
+  if (gfx->data.flags & JSGRAPHICSFLAGS_RECORDING)
+    jsvUnLock(dlStop(gfx));
+}
@@ -0,0 +1,28 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Graphics Backend for recording drawing into a display list
+ * ----------------------------------------------------------------------------
+ */
+#include "graphics.h"
+
+/// Start recording everything drawn to this Graphics instance. Returns false on error
+bool lcdBegin_DisplayList(JsGraphics *gfx);
+/// Stop recording and return the display list
+JsVar *lcdEnd_DisplayList(JsGraphics *gfx);
+/// Replay a display list with its top-left moved by x,y (user coordinates)
+void lcdDraw_DisplayList(JsGraphics *gfx, JsVar *list, int x, int y);
+void lcdSetCallbacks_DisplayList(JsGraphics *gfx);
+/// Record a line in the foreground colour (device coordinates)
+void lcdDrawLine_DisplayList(JsGraphics *gfx, int x1, int y1, int x2, int y2);
+/// Record a filled polygon in the foreground colour (device coordinates, 1/16th pixel)
+void lcdFillPoly_DisplayList(JsGraphics *gfx, int points, const short *vertices, bool antiAlias);
+/// Stop any recording on this Graphics, throwing away what was recorded
+void lcdKill_DisplayList(JsGraphics *gfx);
@@ -0,0 +1,307 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Cache of rasterised vector font characters
+ *
+ * Filling the polygons of a vector font character is slow, so the first time
+ * a character is drawn at a given size we rasterise it into a 1bpp bitmap,
+ * and after that just draw the bitmap. All the characters are kept back to
+ * back in one flat string, which grows as needed up to a memory budget - after
+ * that the least recently used characters are thrown away. A small table of
+ * hashes means we can usually find a character without looking through them all.
+ * Bitmaps are in user coordinates, so rotation is applied when they're drawn.
+ * ----------------------------------------------------------------------------
+ */
+#include "vector_font_cache.h"
+#include "vector_font.h"
+#include "jsparse.h"
+
+#ifdef VECTOR_FONT_CACHE
+
+#define VF_CACHE_NAME "VFc" // hidden root flat string of characters, one after the other
+#define VF_CACHE_HINTS 32 // entries in vfCacheHint
+#define VF_CACHE_MIN_ALLOC 256 // smallest flat string we allocate for the cache
+
+typedef struct {
+  unsigned int lastUsed; ///< vfCacheCounter when this was last drawn, for LRU
+  unsigned short sizex, sizey;
+  short x, y; ///< offset of the bitmap from where the character is drawn
+  unsigned short width, height; ///< size of the bitmap
+  unsigned short advance; ///< what graphicsFillVectorChar returned
+  char ch;
+} PACKED_FLAGS VfCacheGlyph; // followed by a 1bpp bitmap, MSB first, each row a whole number of bytes
+
+static unsigned int vfCacheSize = VF_CACHE_DEFAULT_SIZE;
+static unsigned int vfCacheUsed = 0; ///< bytes of VfCacheGlyph+bitmap currently cached
+static unsigned int vfCacheGlyphs = 0; ///< number of characters currently cached
+static unsigned int vfCacheHint[VF_CACHE_HINTS]; ///< 1 + offset of the last character found with each hash, or 0
+static unsigned int vfCacheCounter = 0;
+static unsigned int vfCacheHits = 0;
+static unsigned int vfCacheMisses = 0;
+static bool vfCacheDrawing = false; ///< set while drawing from the cache, as JS Graphics could draw text from inside fillRect
+
+static size_t vfCacheGlyphSize(int width, int height) {
+  return sizeof(VfCacheGlyph) + (size_t)(((width+7)>>3)*height);
+}
+
+// fillRect for the Graphics we rasterise into - just work out the bounds
+static void vfCacheBoundsFillRect(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
+  NOT_USED(col);
+  if (x1 < gfx->data.modMinX) gfx->data.modMinX = (short)x1;
+  if (y1 < gfx->data.modMinY) gfx->data.modMinY = (short)y1;
+  if (x2 > gfx->data.modMaxX) gfx->data.modMaxX = (short)x2;
+  if (y2 > gfx->data.modMaxY) gfx->data.modMaxY = (short)y2;
+}
+static void vfCacheBoundsSetPixel(JsGraphics *gfx, int x, int y, unsigned int col) {
+  vfCacheBoundsFillRect(gfx, x, y, x, y, col);
+}
+
+// fillRect for the Graphics we rasterise into - set bits in the bitmap
+static void vfCacheBitmapFillRect(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
+  NOT_USED(col);
+  int stride = (gfx->data.width+7)>>3;
+  for (int y=y1;y<=y2;y++) {
+    unsigned char *row = &((unsigned char*)gfx->backendData)[y*stride];
+    for (int x=x1;x<=x2;x++)
+      row[x>>3] |= (unsigned char)(0x80>>(x&7));
+  }
+}
+static void vfCacheBitmapSetPixel(JsGraphics *gfx, int x, int y, unsigned int col) {
+  vfCacheBitmapFillRect(gfx, x, y, x, y, col);
+}
+
+/// Set up a Graphics that only calls our own fillRect/setPixel, with no clipping near the character
+static void vfCacheInitGraphics(JsGraphics *gfx, int width, int height) {
+  memset(gfx, 0, sizeof(JsGraphics));
+  gfx->data.type = JSGRAPHICSTYPE_ARRAYBUFFER;
+  graphicsStructInit(gfx, width, height, 1);
+}
+
+/// Draw a cached character
+static void vfCacheDrawGlyph(JsGraphics *gfx, int x1, int y1, VfCacheGlyph *glyph) {
+  unsigned char *bitmap = (unsigned char*)&glyph[1];
+  int stride = (glyph->width+7)>>3;
+  x1 += glyph->x;
+  y1 += glyph->y;
+  for (int y=0;y<glyph->height;y++) {
+    unsigned char *row = &bitmap[y*stride];
+    int x = 0;
+    while (x<glyph->width) { // draw each run of set pixels with fillRect
+      if (!(row[x>>3] & (0x80>>(x&7)))) {
+        x++;
+        continue;
+      }
+      int start = x;
+      while (x<glyph->width && (row[x>>3] & (0x80>>(x&7)))) x++;
+      graphicsFillRect(gfx, x1+start, y1+y, x1+x-1, y1+y, gfx->data.fgColor);
+    }
+  }
+}
+
+static unsigned int vfCacheHash(int sizex, int sizey, char ch) {
+  return ((unsigned int)(unsigned char)ch*31 + (unsigned int)sizex*7 + (unsigned int)sizey) % VF_CACHE_HINTS;
+}
+
+static VfCacheGlyph *vfCacheGlyphAt(char *data, unsigned int offset) {
+  return (VfCacheGlyph*)&data[offset];
+}
+
+/// Forget all cached characters
+static void vfCacheClear() {
+  jsvObjectRemoveChild(execInfo.hiddenRoot, VF_CACHE_NAME);
+  vfCacheUsed = 0;
+  vfCacheGlyphs = 0;
+  memset(vfCacheHint, 0, sizeof(vfCacheHint));
+}
+
+/// Get the (locked) flat string of cached characters, or 0 if there isn't one
+static JsVar *vfCacheGetPool() {
+  JsVar *pool = jsvObjectGetChild(execInfo.hiddenRoot, VF_CACHE_NAME, 0);
+  if (!pool && vfCacheUsed) vfCacheClear(); // it was removed without us knowing
+  return pool;
+}
+
+/// Find a character in the cache, or return 0
+static VfCacheGlyph *vfCacheFind(char *data, int sizex, int sizey, char ch) {
+  unsigned int hash = vfCacheHash(sizex, sizey, ch);
+  VfCacheGlyph *glyph;
+  if (vfCacheHint[hash] && vfCacheHint[hash]<=vfCacheUsed) {
+    glyph = vfCacheGlyphAt(data, vfCacheHint[hash]-1);
+    if (glyph->ch==ch && glyph->sizex==sizex && glyph->sizey==sizey)
+      return glyph;
+  }
+  // not where we last saw something with this hash, so look through them all
+  unsigned int offset = 0;
+  while (offset<vfCacheUsed) {
+    glyph = vfCacheGlyphAt(data, offset);
+    if (glyph->ch==ch && glyph->sizex==sizex && glyph->sizey==sizey) {
+      vfCacheHint[hash] = offset+1;
+      return glyph;
+    }
+    offset += (unsigned int)vfCacheGlyphSize(glyph->width, glyph->height);
+  }
+  return 0;
+}
+
+/// Remove the least recently used character, moving the ones after it down. Returns false if there are none
+static bool vfCacheRemoveOldest(char *data) {
+  if (!vfCacheUsed) return false;
+  unsigned int oldest = 0, offset = 0;
+  while (offset<vfCacheUsed) {
+    VfCacheGlyph *glyph = vfCacheGlyphAt(data, offset);
+    if ((int)(glyph->lastUsed - vfCacheGlyphAt(data, oldest)->lastUsed) < 0)
+      oldest = offset;
+    offset += (unsigned int)vfCacheGlyphSize(glyph->width, glyph->height);
+  }
+  VfCacheGlyph *glyph = vfCacheGlyphAt(data, oldest);
+  unsigned int size = (unsigned int)vfCacheGlyphSize(glyph->width, glyph->height);
+  memmove(&data[oldest], &data[oldest+size], vfCacheUsed-(oldest+size));
+  vfCacheUsed -= size;
+  vfCacheGlyphs--;
+  for (int i=0;i<VF_CACHE_HINTS;i++) {
+    if (vfCacheHint[i]==oldest+1) vfCacheHint[i] = 0;
+    else if (vfCacheHint[i]>oldest+1) vfCacheHint[i] -= size;
+  }
+  return true;
+}
+
+/// Copy the cached characters into a new flat string of 'capacity' bytes and use that. Returns it (locked), or 0 if it couldn't be allocated
+static JsVar *vfCacheResize(JsVar *pool, unsigned int capacity) {
+  JsVar *newPool = jsvNewFlatStringOfLength(capacity);
+  if (!newPool) return 0;
+  if (pool) memcpy(jsvGetFlatStringPointer(newPool), jsvGetFlatStringPointer(pool), vfCacheUsed);
+  jsvObjectSetChild(execInfo.hiddenRoot, VF_CACHE_NAME, newPool);
+  return newPool;
+}
+
+/// Make room for another 'bytes', by growing the pool (up to vfCacheSize) or removing the least recently used characters. Returns false if we can't
+static bool vfCacheMakeSpace(JsVar **pool, unsigned int bytes) {
+  unsigned int capacity = *pool ? (unsigned int)jsvGetCharactersInVar(*pool) : 0;
+  if (vfCacheUsed + bytes > capacity && capacity < vfCacheSize) {
+    unsigned int newCapacity = capacity*2;
+    if (newCapacity < vfCacheUsed + bytes) newCapacity = vfCacheUsed + bytes;
+    if (newCapacity < VF_CACHE_MIN_ALLOC) newCapacity = VF_CACHE_MIN_ALLOC;
+    if (newCapacity > vfCacheSize) newCapacity = vfCacheSize;
+    JsVar *newPool = vfCacheResize(*pool, newCapacity);
+    if (newPool) { // if not, just make do with what we have
+      jsvUnLock(*pool);
+      *pool = newPool;
+      capacity = newCapacity;
+    }
+  }
+  if (!*pool) return false;
+  char *data = jsvGetFlatStringPointer(*pool);
+  while (vfCacheUsed + bytes > capacity)
+    if (!vfCacheRemoveOldest(data)) return false;
+  return true;
+}
+
+/// Rasterise a character and add it to the cache, which may replace 'pool'. Returns the glyph, or 0 if it can't be cached
+static VfCacheGlyph *vfCacheAddGlyph(JsVar **pool, int sizex, int sizey, char ch) {
+  // Work out where the character's pixels are, relative to where it's drawn. We don't
+  // know the font's bounds, so leave plenty of room around it
+  JsGraphics bounds;
+  int ox = 16 + sizex/2, oy = 16 + sizey/2;
+  vfCacheInitGraphics(&bounds, 32767, 32767);
+  bounds.fillRect = vfCacheBoundsFillRect;
+  bounds.setPixel = vfCacheBoundsSetPixel;
+  unsigned int advance = graphicsFillVectorChar(&bounds, ox, oy, sizex, sizey, ch);
+  if (bounds.data.modMinX > bounds.data.modMaxX) return 0; // no pixels
+  int width = 1 + bounds.data.modMaxX - bounds.data.modMinX;
+  int height = 1 + bounds.data.modMaxY - bounds.data.modMinY;
+  size_t size = vfCacheGlyphSize(width, height);
+  if (size > vfCacheSize || width>0xFFFF || height>0xFFFF) return 0;
+  if (!vfCacheMakeSpace(pool, (unsigned int)size)) return 0;
+  unsigned int offset = vfCacheUsed;
+  VfCacheGlyph *glyph = vfCacheGlyphAt(jsvGetFlatStringPointer(*pool), offset);
+  memset(glyph, 0, size);
+  glyph->sizex = (unsigned short)sizex;
+  glyph->sizey = (unsigned short)sizey;
+  glyph->ch = ch;
+  glyph->x = (short)(bounds.data.modMinX - ox);
+  glyph->y = (short)(bounds.data.modMinY - oy);
+  glyph->width = (unsigned short)width;
+  glyph->height = (unsigned short)height;
+  glyph->advance = (unsigned short)advance;
+  // Now rasterise it again, into the bitmap
+  JsGraphics bitmap;
+  vfCacheInitGraphics(&bitmap, width, height);
+  bitmap.fillRect = vfCacheBitmapFillRect;
+  bitmap.setPixel = vfCacheBitmapSetPixel;
+  bitmap.backendData = &glyph[1];
+  graphicsFillVectorChar(&bitmap, -glyph->x, -glyph->y, sizex, sizey, ch);
+  vfCacheUsed += (unsigned int)size;
+  vfCacheGlyphs++;
+  vfCacheHint[vfCacheHash(sizex, sizey, ch)] = offset+1;
+  return glyph;
+}
+
+// prints character, returns width
+unsigned int graphicsFillVectorCharCached(JsGraphics *gfx, int x1, int y1, int sizex, int sizey, char ch) {
+  if (!vfCacheSize || vfCacheDrawing || sizex<=0 || sizey<=0 || sizex>0xFFFF || sizey>0xFFFF)
+    return graphicsFillVectorChar(gfx, x1, y1, sizex, sizey, ch);
+  JsVar *pool = vfCacheGetPool();
+  VfCacheGlyph *glyph = pool ? vfCacheFind(jsvGetFlatStringPointer(pool), sizex, sizey, ch) : 0;
+  if (glyph) {
+    vfCacheHits++;
+  } else {
+    vfCacheMisses++;
+    glyph = vfCacheAddGlyph(&pool, sizex, sizey, ch);
+  }
+  if (!glyph) { // couldn't cache it
+    jsvUnLock(pool);
+    return graphicsFillVectorChar(gfx, x1, y1, sizex, sizey, ch);
+  }
+  glyph->lastUsed = ++vfCacheCounter;
+  vfCacheDrawing = true;
+  vfCacheDrawGlyph(gfx, x1, y1, glyph);
+  vfCacheDrawing = false;
+  unsigned int advance = glyph->advance;
+  jsvUnLock(pool);
+  return advance;
+}
+
+/// Set the most memory (in bytes) the cache may use, removing characters if needed. 0 disables the cache
+void vfCacheSetSize(unsigned int bytes) {
+  vfCacheSize = bytes;
+  JsVar *pool = vfCacheGetPool();
+  if (!pool) return;
+  char *data = jsvGetFlatStringPointer(pool);
+  while (vfCacheUsed > bytes && vfCacheRemoveOldest(data));
+  if (jsvGetCharactersInVar(pool) > bytes) { // give back the memory we can't use any more
+    JsVar *newPool = vfCacheUsed ? vfCacheResize(pool, vfCacheUsed) : 0;
+    if (newPool) jsvUnLock(newPool);
+    else vfCacheClear();
+  }
+  jsvUnLock(pool);
+}
+
+/// Return an object describing the cache: {size, used, glyphs, hits, misses}
+JsVar *vfCacheGetInfo() {
+  JsVar *info = jsvNewObject();
+  if (!info) return 0;
+  jsvUnLock(vfCacheGetPool()); // make sure our counts are right
+  jsvObjectSetChildAndUnLock(info, "size", jsvNewFromInteger(vfCacheSize));
+  jsvObjectSetChildAndUnLock(info, "used", jsvNewFromInteger(vfCacheUsed));
+  jsvObjectSetChildAndUnLock(info, "glyphs", jsvNewFromInteger(vfCacheGlyphs));
+  jsvObjectSetChildAndUnLock(info, "hits", jsvNewFromInteger(vfCacheHits));
+  jsvObjectSetChildAndUnLock(info, "misses", jsvNewFromInteger(vfCacheMisses));
+  return info;
+}
+
+/// Free all cached characters and reset the counters
+void vfCacheKill() {
+  vfCacheClear();
+  vfCacheCounter = 0;
+  vfCacheHits = 0;
+  vfCacheMisses = 0;
+}
+
+#endif // VECTOR_FONT_CACHE
@@ -0,0 +1,34 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Cache of rasterised vector font characters
+ * ----------------------------------------------------------------------------
+ */
+#ifndef VECTOR_FONT_CACHE_H
+#define VECTOR_FONT_CACHE_H
+
+#include "graphics.h"
+
+#if !defined(SAVE_ON_FLASH) && !defined(NO_VECTOR_FONT) && !defined(NO_MODIFIED_AREA)
+#define VECTOR_FONT_CACHE
+
+#define VF_CACHE_DEFAULT_SIZE 4096 // bytes of glyph bitmaps we keep by default
+
+/// Like graphicsFillVectorChar, but draw from (and add to) the cache of rasterised characters. Returns width
+unsigned int graphicsFillVectorCharCached(JsGraphics *gfx, int x1, int y1, int sizex, int sizey, char ch);
+/// Set the most memory (in bytes) the cache may use, removing characters if needed. 0 disables the cache
+void vfCacheSetSize(unsigned int bytes);
+/// Return an object describing the cache: {size, used, glyphs, hits, misses}
+JsVar *vfCacheGetInfo();
+/// Free all cached characters and reset the counters
+void vfCacheKill();
+#endif
+
+#endif // VECTOR_FONT_CACHE_H
@@ -0,0 +1,375 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Non-blocking DNS resolver with a small cache, running over the JsNetwork UDP API
+ *
+ * Queries for 'A' records are sent from one UDP socket, and answers are
+ * picked up from the idle loop. Answers (and failures) are kept in a fixed
+ * size table until their TTL runs out, so connections that poll dnsResolve
+ * just see DNS_RESOLVING until the answer arrives.
+ * ----------------------------------------------------------------------------
+ */
+#include "dns.h"
+#include "socketerrors.h"
+#include "jsinteractive.h"
+#include "jshardware.h"
+#ifdef ESP32
+#include "lwip/dns.h"
+#endif
+
+#define DNS_ARRAY_LOOKUPS "DnsL" // pending calls to net.lookup
+#define DNS_DEFAULT_SERVER 0x08080808 // 8.8.8.8
+#define DNS_HEADER_LEN 12
+#define DNS_MAX_PACKET 512
+
+typedef enum {
+  DNS_FREE,
+  DNS_PENDING,   ///< query sent, waiting for an answer
+  DNS_FOUND,     ///< 'addr' is valid until 'time'
+  DNS_NOT_FOUND, ///< the name doesn't exist (remembered until 'time')
+} PACKED_FLAGS DnsEntryState;
+
+typedef struct {
+  char name[DNS_MAX_NAME_LENGTH];
+  uint32_t addr;
+  JsSysTime time;  ///< PENDING: when the query was last sent, otherwise when this entry expires
+  uint16_t id;     ///< id of the query we sent
+  DnsEntryState state;
+  uint8_t retries;
+} DnsEntry;
+
+static DnsEntry dnsCache[DNS_CACHE_SIZE];
+static int dnsSocket = -1;
+static uint32_t dnsServer = 0; // 0 = use the network's default
+static unsigned short dnsServerPort = DNS_PORT;
+
+// -----------------------------
+
+static uint32_t dnsGetServer() {
+  if (dnsServer) return dnsServer;
+#ifdef ESP32
+  const ip_addr_t *ip = dns_getserver(0);
+  if (ip && ip4_addr_get_u32(ip_2_ip4(ip)))
+    return ip4_addr_get_u32(ip_2_ip4(ip));
+#endif
+  return DNS_DEFAULT_SERVER;
+}
+
+static DnsEntry *dnsFind(const char *hostName) {
+  for (int i=0;i<DNS_CACHE_SIZE;i++)
+    if (dnsCache[i].state!=DNS_FREE && !strcmp(dnsCache[i].name, hostName))
+      return &dnsCache[i];
+  return 0;
+}
+
+/// Get a free entry, or the one that expires soonest. Entries that are still pending are never reused
+static DnsEntry *dnsAllocate() {
+  DnsEntry *best = 0;
+  for (int i=0;i<DNS_CACHE_SIZE;i++) {
+    DnsEntry *e = &dnsCache[i];
+    if (e->state==DNS_FREE) return e;
+    if (e->state!=DNS_PENDING && (!best || e->time < best->time))
+      best = e;
+  }
+  return best;
+}
+
+/// Get a random id for a query, that isn't the same as any other query we're waiting on
+static uint16_t dnsNewId() {
+  uint16_t id;
+  bool used;
+  do {
+    id = (uint16_t)jshGetRandomNumber();
+    used = false;
+    for (int i=0;i<DNS_CACHE_SIZE;i++)
+      if (dnsCache[i].state==DNS_PENDING && dnsCache[i].id==id)
+        used = true;
+  } while (used);
+  return id;
+}
+
+static bool dnsExpired(DnsEntry *e) {
+  return e->state!=DNS_PENDING && jshGetSystemTime() >= e->time;
+}
+
+static void dnsSetAnswer(DnsEntry *e, uint32_t addr, uint32_t ttl) {
+  if (ttl < DNS_MIN_TTL) ttl = DNS_MIN_TTL;
+  if (ttl > DNS_MAX_TTL) ttl = DNS_MAX_TTL;
+  e->addr = addr;
+  e->state = addr ? DNS_FOUND : DNS_NOT_FOUND;
+  e->time = jshGetSystemTime() + jshGetTimeFromMilliseconds(ttl*1000.0);
+}
+
+// -----------------------------
+
+/** Write 'name' into 'q' as a series of length-prefixed labels. Returns the
+ * number of bytes written, or 0 if the name can't be sent (empty labels,
+ * labels over 63 bytes, or over 255 bytes in total). 'q' must have space
+ * for strlen(name)+2 bytes */
+static size_t dnsEncodeName(unsigned char *q, const char *name) {
+  size_t len = 0;
+  const char *label = name;
+  while (*label) {
+    const char *dot = strchr(label, '.');
+    size_t labelLen = dot ? (size_t)(dot-label) : strlen(label);
+    if (labelLen<1 || labelLen>63) return 0;
+    q[len++] = (unsigned char)labelLen;
+    memcpy(&q[len], label, labelLen);
+    len += labelLen;
+    label += labelLen;
+    if (*label=='.') label++;
+  }
+  q[len++] = 0;
+  if (len<2 || len>255) return 0;
+  return len;
+}
+
+/// Send (or resend) the query for this entry
+static void dnsSendQuery(JsNetwork *net, DnsEntry *e) {
+  unsigned char buf[sizeof(JsNetUDPPacketHeader) + DNS_HEADER_LEN + DNS_MAX_NAME_LENGTH + 6];
+  unsigned char *q = &buf[sizeof(JsNetUDPPacketHeader)];
+  // the name, as a series of length-prefixed labels
+  size_t nameLen = dnsEncodeName(&q[DNS_HEADER_LEN], e->name);
+  if (!nameLen) {
+    dnsSetAnswer(e, 0, DNS_MIN_TTL); // not a name we can look up
+    return;
+  }
+  if (dnsSocket<0) {
+    dnsSocket = netCreateSocket(net, ST_UDP, dnsGetServer(), dnsServerPort, NULL);
+    if (dnsSocket<0) {
+      dnsSetAnswer(e, 0, DNS_MIN_TTL);
+      return;
+    }
+  }
+  memset(q, 0, DNS_HEADER_LEN);
+  q[0] = (unsigned char)(e->id>>8);
+  q[1] = (unsigned char)e->id;
+  q[2] = 0x01; // recursion desired
+  q[5] = 1; // one question
+  size_t len = DNS_HEADER_LEN + nameLen;
+  q[len++] = 0; q[len++] = 1; // type A
+  q[len++] = 0; q[len++] = 1; // class IN
+
+  JsNetUDPPacketHeader *header = (JsNetUDPPacketHeader*)buf;
+  uint32_t server = dnsGetServer();
+  memcpy(header->host, &server, sizeof(header->host));
+  header->port = dnsServerPort;
+  header->length = (uint16_t)len;
+  netSend(net, ST_UDP, dnsSocket, buf, sizeof(JsNetUDPPacketHeader)+len);
+  e->time = jshGetSystemTime();
+}
+
+/** Is the question in packet 'p' (which has 'len' bytes) the one we asked
+ * for 'e'? Returns the offset after it, or 0 if not. The name's case may
+ * differ, but it must otherwise be identical - we never compress it */
+static size_t dnsCheckQuestion(const unsigned char *p, size_t len, DnsEntry *e) {
+  if (((p[4]<<8) | p[5]) != 1) return 0; // we only ever ask one question
+  unsigned char name[DNS_MAX_NAME_LENGTH+2];
+  size_t nameLen = dnsEncodeName(name, e->name);
+  size_t i = DNS_HEADER_LEN;
+  if (!nameLen || i+nameLen+4 > len) return 0;
+  for (size_t j=0;j<nameLen;j++)
+    if (charToLowerCase((char)p[i+j]) != charToLowerCase((char)name[j])) return 0;
+  i += nameLen;
+  if (p[i]!=0 || p[i+1]!=1 || p[i+2]!=0 || p[i+3]!=1) return 0; // type A, class IN
+  return i+4;
+}
+
+/// Skip over a (possibly compressed) name in a DNS packet. Returns the new offset, or 0 if invalid
+static size_t dnsSkipName(const unsigned char *p, size_t len, size_t i) {
+  while (i<len) {
+    if (p[i]==0) return i+1;
+    if ((p[i]&0xC0)==0xC0) return i+2; // pointer to a name elsewhere
+    i += (size_t)p[i]+1;
+  }
+  return 0;
+}
+
+/** Handle a packet sent to our socket. To make spoofed answers hard to get
+ * accepted, it must come from the server we asked, have the (random) id of a
+ * query we're waiting on, and repeat that query's question */
+static void dnsHandleResponse(const unsigned char *p, size_t len, JsNetUDPPacketHeader *from) {
+  if (len<DNS_HEADER_LEN || !(p[2]&0x80)) return; // not a response
+  uint32_t server = dnsGetServer();
+  if (memcmp(from->host, &server, sizeof(from->host)) || from->port!=dnsServerPort)
+    return; // not from our server
+  uint16_t id = (uint16_t)((p[0]<<8) | p[1]);
+  DnsEntry *e = 0;
+  for (int i=0;i<DNS_CACHE_SIZE;i++)
+    if (dnsCache[i].state==DNS_PENDING && dnsCache[i].id==id)
+      e = &dnsCache[i];
+  if (!e) return; // an answer we didn't ask for (or already had)
+  size_t i = dnsCheckQuestion(p, len, e);
+  if (!i) return; // not an answer to the question we asked
+  int rcode = p[3]&15;
+  if (rcode) { // eg. NXDOMAIN
+    dnsSetAnswer(e, 0, DNS_MIN_TTL);
+    return;
+  }
+  int answers = (p[6]<<8) | p[7];
+  // look for the first A record (any CNAMEs come before it)
+  while (answers-- && i && i<len) {
+    i = dnsSkipName(p, len, i);
+    if (!i || i+10>len) break;
+    int type = (p[i]<<8) | p[i+1];
+    int cls = (p[i+2]<<8) | p[i+3];
+    uint32_t ttl = ((uint32_t)p[i+4]<<24) | ((uint32_t)p[i+5]<<16) | ((uint32_t)p[i+6]<<8) | p[i+7];
+    size_t dataLen = (size_t)((p[i+8]<<8) | p[i+9]);
+    i += 10;
+    if (i+dataLen>len) break;
+    if (type==1 && cls==1 && dataLen==4) {
+      uint32_t addr;
+      memcpy(&addr, &p[i], 4); // addresses are stored in network order
+      dnsSetAnswer(e, addr, ttl);
+      return;
+    }
+    i += dataLen;
+  }
+  dnsSetAnswer(e, 0, DNS_MIN_TTL); // no address in the answer
+}
+
+// -----------------------------
+
+uint32_t dnsGetCached(const char *hostName) {
+  uint32_t addr = networkParseIPAddress(hostName);
+  if (addr) return addr;
+  DnsEntry *e = dnsFind(hostName);
+  if (e && e->state==DNS_FOUND && !dnsExpired(e)) return e->addr;
+  return 0;
+}
+
+uint32_t dnsResolve(JsNetwork *net, const char *hostName) {
+  uint32_t addr = networkParseIPAddress(hostName);
+  if (addr) return addr;
+  DnsEntry *e = dnsFind(hostName);
+  if (e && !dnsExpired(e)) {
+    if (e->state==DNS_PENDING) return DNS_RESOLVING;
+    return e->addr; // 0 for DNS_NOT_FOUND
+  }
+  if (strlen(hostName)>=DNS_MAX_NAME_LENGTH) return 0; // too long to look up
+  if (!e) e = dnsAllocate();
+  if (!e) return DNS_RESOLVING; // every entry has a query pending - try again when one finishes
+  strncpy(e->name, hostName, DNS_MAX_NAME_LENGTH);
+  e->state = DNS_PENDING;
+  e->id = dnsNewId();
+  e->retries = 0;
+  e->addr = 0;
+  dnsSendQuery(net, e);
+  return (e->state==DNS_PENDING) ? DNS_RESOLVING : e->addr;
+}
+
+void dnsLookup(JsNetwork *net, JsVar *hostName, JsVar *callback) {
+  JsVar *arr = jsvObjectGetChild(execInfo.hiddenRoot, DNS_ARRAY_LOOKUPS, JSV_ARRAY);
+  JsVar *lookup = jsvNewObject();
+  if (arr && lookup) {
+    JsVar *host = jsvAsString(hostName);
+    jsvObjectSetChild(lookup, "host", host);
+    jsvObjectSetChild(lookup, "cb", callback);
+    jsvArrayPush(arr, lookup);
+    // start the query now - the callback happens from dnsIdle, even if we already know the answer
+    if (jsvGetStringLength(host) < DNS_MAX_NAME_LENGTH) {
+      char name[DNS_MAX_NAME_LENGTH];
+      jsvGetString(host, name, sizeof(name));
+      dnsResolve(net, name);
+    }
+    jsvUnLock(host);
+  }
+  jsvUnLock2(arr, lookup);
+}
+
+void dnsSetServer(uint32_t server, unsigned short port) {
+  dnsServer = server;
+  dnsServerPort = port ? port : DNS_PORT;
+  for (int i=0;i<DNS_CACHE_SIZE;i++)
+    if (dnsCache[i].state!=DNS_PENDING)
+      dnsCache[i].state = DNS_FREE;
+}
+
+/// Call back any net.lookup calls that have finished
+static void dnsCheckLookups(JsNetwork *net) {
+  JsVar *arr = jsvObjectGetChild(execInfo.hiddenRoot, DNS_ARRAY_LOOKUPS, 0);
+  if (!arr) return;
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, arr);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *lookup = jsvObjectIteratorGetValue(&it);
+    char name[DNS_MAX_NAME_LENGTH];
+    JsVar *host = jsvObjectGetChild(lookup, "host", 0);
+    uint32_t addr = 0; // names too long to fit are never found
+    if (jsvGetStringLength(host) < DNS_MAX_NAME_LENGTH) {
+      jsvGetString(host, name, sizeof(name));
+      addr = dnsResolve(net, name);
+    }
+    jsvUnLock(host);
+    if (addr != DNS_RESOLVING) {
+      JsVar *args[3] = { 0, 0, 0 };
+      if (addr) {
+        args[0] = jsvNewNull();
+        args[1] = networkGetAddressAsString((unsigned char*)&addr, 4, 10, '.');
+        args[2] = jsvNewFromInteger(4);
+      } else {
+        args[0] = jsvNewObject();
+        if (args[0]) {
+          jsvObjectSetChildAndUnLock(args[0], "code", jsvNewFromInteger(SOCKET_ERR_NOT_FOUND));
+          jsvObjectSetChildAndUnLock(args[0], "message", jsvNewFromString(socketErrorString(SOCKET_ERR_NOT_FOUND)));
+        }
+      }
+      JsVar *callback = jsvObjectGetChild(lookup, "cb", 0);
+      jsiQueueEvents(0, callback, args, 3);
+      jsvUnLock(callback);
+      jsvUnLockMany(3, args);
+      JsVar *key = jsvObjectIteratorGetKey(&it);
+      jsvObjectIteratorNext(&it);
+      jsvRemoveChild(arr, key);
+      jsvUnLock(key);
+    } else
+      jsvObjectIteratorNext(&it);
+    jsvUnLock(lookup);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(arr);
+}
+
+bool dnsIdle(JsNetwork *net) {
+  bool pending = false;
+  if (dnsSocket>=0) {
+    unsigned char buf[sizeof(JsNetUDPPacketHeader) + DNS_MAX_PACKET];
+    int num;
+    while ((num = netRecv(net, ST_UDP, dnsSocket, buf, sizeof(buf))) > (int)sizeof(JsNetUDPPacketHeader)) {
+      JsNetUDPPacketHeader *header = (JsNetUDPPacketHeader*)buf;
+      size_t len = header->length;
+      if (len > (size_t)num-sizeof(JsNetUDPPacketHeader)) len = (size_t)num-sizeof(JsNetUDPPacketHeader);
+      dnsHandleResponse(&buf[sizeof(JsNetUDPPacketHeader)], len, header);
+    }
+  }
+  JsSysTime retryTime = jshGetTimeFromMilliseconds(DNS_RETRY_MS);
+  for (int i=0;i<DNS_CACHE_SIZE;i++) {
+    DnsEntry *e = &dnsCache[i];
+    if (e->state!=DNS_PENDING) continue;
+    if (jshGetSystemTime() >= e->time + retryTime) {
+      if (++e->retries > DNS_RETRIES) {
+        dnsSetAnswer(e, 0, DNS_MIN_TTL); // timed out
+        continue;
+      }
+      dnsSendQuery(net, e);
+    }
+    pending = true;
+  }
+  dnsCheckLookups(net);
+  return pending;
+}
+
+void dnsKill(JsNetwork *net) {
+  if (dnsSocket>=0 && net)
+    netCloseSocket(net, ST_UDP, dnsSocket);
+  dnsSocket = -1;
+  memset(dnsCache, 0, sizeof(dnsCache));
+  jsvObjectRemoveChild(execInfo.hiddenRoot, DNS_ARRAY_LOOKUPS);
+}
@@ -0,0 +1,47 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Non-blocking DNS resolver with a small cache, running over the JsNetwork UDP API
+ * ----------------------------------------------------------------------------
+ */
+#ifndef DNS_H
+#define DNS_H
+
+#include "jsutils.h"
+#include "jsvar.h"
+#include "network.h"
+
+#define DNS_RESOLVING 0xFFFFFFFF // returned by dnsResolve when the answer isn't here yet
+#define DNS_PORT 53
+#define DNS_CACHE_SIZE 8         // how many names we remember (including ones being looked up)
+#define DNS_MAX_NAME_LENGTH 128  // longer names fail to resolve
+#define DNS_MIN_TTL 2            // seconds - so connections waiting on an answer get to see it
+#define DNS_MAX_TTL 86400        // seconds
+#define DNS_RETRY_MS 1000        // resend a query if we haven't had an answer after this long
+#define DNS_RETRIES 3            // ... this many times, then give up
+
+/** Get the address for a host name. IP addresses are parsed directly, then the
+ * cache is checked, and if neither works a query is started. Returns the
+ * address, 0 if the name couldn't be found, or DNS_RESOLVING if a query is still
+ * in progress (call again later) */
+uint32_t dnsResolve(JsNetwork *net, const char *hostName);
+/// Only get an address if it's an IP or is in the cache, otherwise return 0
+uint32_t dnsGetCached(const char *hostName);
+/// Call 'callback(err, address, family)' once the host name has been resolved
+void dnsLookup(JsNetwork *net, JsVar *hostName, JsVar *callback);
+/// Set the server to send queries to (0 uses the network's default), and empty the cache
+void dnsSetServer(uint32_t server, unsigned short port);
+
+/// Send/receive queries, and call back any finished lookups. Returns true if anything is pending
+bool dnsIdle(JsNetwork *net);
+/// Close the socket used for DNS and clear all state
+void dnsKill(JsNetwork *net);
+
+#endif // DNS_H
@@ -71,8 +71,8 @@ bool net_esp32_checkError(JsNetwork *net) {
 
 /// if host=0, creates a server otherwise creates a client (and automatically connects). Returns >=0 on success
 int net_esp32_createsocket(JsNetwork *net, SocketType socketType, uint32_t host, unsigned short port, JsVar *options) {
-  int ippProto = socketType & ST_UDP ? IPPROTO_UDP : IPPROTO_TCP;
-  int scktType = socketType & ST_UDP ? SOCK_DGRAM : SOCK_STREAM;
+  int ippProto = (socketType&ST_TYPE_MASK)==ST_UDP ? IPPROTO_UDP : IPPROTO_TCP;
+  int scktType = (socketType&ST_TYPE_MASK)==ST_UDP ? SOCK_DGRAM : SOCK_STREAM;
   int sckt = -1;
 
   if (host!=0) { // ------------------------------------------------- host (=client)
@@ -247,7 +247,7 @@ int net_esp32_recv(JsNetwork *net, SocketType socketType, int sckt, void *buf, s
     return -1;
   } else if (n>0) {
     // receive data
-    if (socketType & ST_UDP) {
+    if ((socketType&ST_TYPE_MASK)==ST_UDP) {
       num = (int)recvfrom(sckt,buf+sizeof(JsNetUDPPacketHeader),len-sizeof(JsNetUDPPacketHeader),0,&fromAddr,&fromAddrLen);
 
       JsNetUDPPacketHeader *header = (JsNetUDPPacketHeader*)buf;
@@ -285,7 +285,7 @@ int net_esp32_send(JsNetwork *net, SocketType socketType, int sckt, const void *
 #if !defined(SO_NOSIGPIPE) && defined(MSG_NOSIGNAL)
     flags |= MSG_NOSIGNAL;
 #endif
-    if (socketType & ST_UDP) {
+    if ((socketType&ST_TYPE_MASK)==ST_UDP) {
       JsNetUDPPacketHeader *header = (JsNetUDPPacketHeader*)buf;
       sockaddr_in sin;
       sin.sin_family = AF_INET;
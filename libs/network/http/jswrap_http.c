@@ -137,6 +137,62 @@ Return a string containing characters that have been received
 }
 Pipe this to a stream (an object with a 'write' method)
 */
+/*JSON{
+  "type" : "method",
+  "class" : "httpSRq",
+  "name" : "pause",
+  "generate" : "jswrap_net_socket_pause"
+}
+Stop reading data. No more `data` events are fired and incoming data is left in
+the network stack until `httpSRq.resume` is called - see `Socket.pause`
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "httpSRq",
+  "name" : "resume",
+  "generate" : "jswrap_net_socket_resume"
+}
+Start reading data again after `httpSRq.pause`
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "httpSRq",
+  "name" : "setHighWaterMark",
+  "generate" : "jswrap_net_socket_setHighWaterMark",
+  "params" : [
+    ["bytes","int","How many bytes may be buffered before we stop reading (or 0 for the default of 2048)"],
+    ["minFree","int","Stop reading if less than this percentage of variables are free (or 0 for the default of 10)"]
+  ]
+}
+Set how much received data can be buffered before Espruino stops reading from
+the network - see `Socket.setHighWaterMark`
+*/
+
+/*JSON{
+  "type" : "method",
+  "class" : "httpSRq",
+  "name" : "upgrade",
+  "generate" : "jswrap_httpSRq_upgrade",
+  "return" : ["JsVar","A WebSocket, or undefined if the connection was already closed"],
+  "return_object" : "WebSocket"
+}
+Accept a WebSocket upgrade request (one with an `Upgrade: websocket` header).
+The `101 Switching Protocols` response is sent automatically, and the returned
+`WebSocket` is used to exchange messages from then on. The request and its
+response object can't be used after this is called.
+
+```
+require("http").createServer(function (req, res) {
+  if (req.headers.Upgrade=="websocket") {
+    var ws = req.upgrade();
+    ws.on('message', function(msg) { ws.send("Echo: "+msg); });
+  } else res.end("Hello");
+}).listen(80);
+```
+*/
+JsVar *jswrap_httpSRq_upgrade(JsVar *parent) {
+  return serverRequestUpgrade(parent);
+}
 
 /*JSON{
   "type" : "class",
@@ -296,6 +352,36 @@ Return a string containing characters that have been received
 }
 Pipe this to a stream (an object with a 'write' method)
 */
+/*JSON{
+  "type" : "method",
+  "class" : "httpCRs",
+  "name" : "pause",
+  "generate" : "jswrap_net_socket_pause"
+}
+Stop reading data. No more `data` events are fired and incoming data is left in
+the network stack until `httpCRs.resume` is called - see `Socket.pause`
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "httpCRs",
+  "name" : "resume",
+  "generate" : "jswrap_net_socket_resume"
+}
+Start reading data again after `httpCRs.pause`
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "httpCRs",
+  "name" : "setHighWaterMark",
+  "generate" : "jswrap_net_socket_setHighWaterMark",
+  "params" : [
+    ["bytes","int","How many bytes may be buffered before we stop reading (or 0 for the default of 2048)"],
+    ["minFree","int","Stop reading if less than this percentage of variables are free (or 0 for the default of 10)"]
+  ]
+}
+Set how much received data can be buffered before Espruino stops reading from
+the network - see `Socket.setHighWaterMark`
+*/
 
 
 
@@ -492,7 +578,7 @@ The default contents are:
   "params" : [
     ["data","JsVar","A string containing data to send"]
   ],
-  "return" : ["bool","For node.js compatibility, returns the boolean false. When the send buffer is empty, a `drain` event will be sent"]
+  "return" : ["bool","`false` if more data is waiting to be sent than the high water mark (see `Socket.setHighWaterMark`), or `true` otherwise (older firmwares always returned `false`). When the send buffer is empty, a `drain` event will be sent"]
 }
 This function writes the `data` argument as a string. Data that is passed in
 (including arrays) will be converted to a string with the normal JavaScript
@@ -501,7 +587,7 @@ This function writes the `data` argument as a string. Data that is passed in
 */
 bool jswrap_httpSRs_write(JsVar *parent, JsVar *data) {
   serverResponseWrite(parent, data);
-  return false;
+  return socketCanWrite(parent);
 }
 
 /*JSON{
@@ -573,7 +659,7 @@ void jswrap_httpSRs_setHeader(JsVar *parent, JsVar *name, JsVar *value) {
   "params" : [
     ["data","JsVar","A string containing data to send"]
   ],
-  "return" : ["bool","For node.js compatibility, returns the boolean false. When the send buffer is empty, a `drain` event will be sent"]
+  "return" : ["bool","`false` if more data is waiting to be sent than the high water mark (see `Socket.setHighWaterMark`), or `true` otherwise (older firmwares always returned `false`). When the send buffer is empty, a `drain` event will be sent"]
 }
 This function writes the `data` argument as a string. Data that is passed in
 (including arrays) will be converted to a string with the normal JavaScript
@@ -598,3 +684,163 @@ See `Socket.write` for more information about the data argument
 // Re-use existing
 
 
+// ---------------------------------------------------------------------------------
+// ---------------------------------------------------------------------------------
+// ---------------------------------------------------------------------------------
+// ---------------------------------------------------------------------------------
+/*JSON{
+  "type" : "class",
+  "library" : "http",
+  "class" : "WebSocket"
+}
+A WebSocket connection, created with `require('http').websocket` or
+`httpSRq.upgrade`. Framing, masking, ping/pong and the closing handshake
+are all handled natively.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "WebSocket",
+  "name" : "open"
+}
+Called when the WebSocket handshake has completed (client only)
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "WebSocket",
+  "name" : "message",
+  "params" : [
+    ["data","JsVar","A String for text messages, or an ArrayBuffer for binary messages"]
+  ]
+}
+Called when a complete message has been received. Fragmented messages are
+reassembled before this is called.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "WebSocket",
+  "name" : "ping",
+  "params" : [
+    ["data","JsVar","A String containing the ping's payload"]
+  ]
+}
+Called when a ping has been received. The pong is sent back automatically.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "WebSocket",
+  "name" : "pong",
+  "params" : [
+    ["data","JsVar","A String containing the pong's payload"]
+  ]
+}
+Called when a pong has been received (usually in response to `WebSocket.ping`)
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "WebSocket",
+  "name" : "close",
+  "params" : [
+    ["had_error","JsVar","A boolean indicating whether the connection had an error (use an error event handler to get error details)."]
+  ]
+}
+Called when the connection closes.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "WebSocket",
+  "name" : "error",
+  "params" : [
+    ["details","JsVar","An error object with an error code (a negative integer) and a message."]
+  ]
+}
+An event that is fired if there is an error on the connection, or if the
+WebSocket handshake fails.
+*/
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "http",
+  "name" : "websocket",
+  "generate" : "jswrap_http_websocket",
+  "params" : [
+    ["options","JsVar","A URL like `ws://host:port/path` (or `wss://` for TLS), or an object containing host,port,path,protocol,headers fields"],
+    ["callback","JsVar","A function(ws) that will be called when the WebSocket is open"]
+  ],
+  "return" : ["JsVar","Returns a new WebSocket object"],
+  "return_object" : "WebSocket"
+}
+Connect to a WebSocket server
+
+```
+var ws = require("http").websocket("ws://192.168.1.10:8080/", function(ws) {
+  ws.send("Hello");
+});
+ws.on('message', function(msg) { console.log(msg); });
+```
+
+**Note:** `wss://` URLs use TLS, in which case options can have `ca`, `key` and
+`cert` fields. See `tls.connect` for more information about these.
+*/
+JsVar *jswrap_http_websocket(JsVar *options, JsVar *callback) {
+  JsNetwork net;
+  if (!networkGetFromVarIfOnline(&net)) return 0;
+
+  JsVar *ws = jswrap_net_connect(options, callback, ST_WS);
+  if (ws) clientRequestWebSocket(&net, ws);
+  networkFree(&net);
+  return ws;
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "WebSocket",
+  "name" : "send",
+  "generate" : "jswrap_WebSocket_send",
+  "params" : [
+    ["data","JsVar","The data to send"]
+  ]
+}
+Send a message. ArrayBuffers, typed arrays and arrays are sent as binary
+messages - anything else is converted to a String and sent as a text message.
+*/
+void jswrap_WebSocket_send(JsVar *parent, JsVar *data) {
+  if (jsvIsArrayBuffer(data) || jsvIsArray(data)) {
+    webSocketSend(parent, WS_OPCODE_BINARY, data);
+  } else {
+    JsVar *s = jsvAsString(data);
+    if (s) webSocketSend(parent, WS_OPCODE_TEXT, s);
+    jsvUnLock(s);
+  }
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "WebSocket",
+  "name" : "ping",
+  "generate" : "jswrap_WebSocket_ping",
+  "params" : [
+    ["data","JsVar","[optional] Data to send with the ping (125 bytes max)"]
+  ]
+}
+Send a ping. The other end should respond with a pong, which fires a `pong`
+event.
+*/
+void jswrap_WebSocket_ping(JsVar *parent, JsVar *data) {
+  webSocketSend(parent, WS_OPCODE_PING, jsvIsUndefined(data) ? 0 : data);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "WebSocket",
+  "name" : "close",
+  "generate" : "jswrap_WebSocket_close",
+  "params" : [
+    ["code","JsVar","[optional] The status code to send (default 1000 - normal closure)"]
+  ]
+}
+Start the closing handshake. The connection is closed once the close frame
+has been sent, and a `close` event is fired.
+*/
+void jswrap_WebSocket_close(JsVar *parent, JsVar *code) {
+  webSocketClose(parent, jsvIsUndefined(code) ? 1000 : jsvGetInteger(code));
+}
@@ -17,6 +17,7 @@ JsVar *jswrap_http_createServer(JsVar *callback);
 
 JsVar *jswrap_http_request(JsVar *options, JsVar *callback);
 JsVar *jswrap_http_get(JsVar *options, JsVar *callback);
+JsVar *jswrap_http_websocket(JsVar *options, JsVar *callback);
 
 // for HTTP
 void jswrap_httpSRs_setHeader(JsVar *parent, JsVar *name, JsVar *value);
@@ -27,6 +28,12 @@ void jswrap_httpSRs_end(JsVar *parent, JsVar *data);
 bool jswrap_httpCRq_write(JsVar *parent, JsVar *data);
 void jswrap_httpCRq_end(JsVar *parent, JsVar *data);
 
+// for WebSockets
+JsVar *jswrap_httpSRq_upgrade(JsVar *parent);
+void jswrap_WebSocket_send(JsVar *parent, JsVar *data);
+void jswrap_WebSocket_ping(JsVar *parent, JsVar *data);
+void jswrap_WebSocket_close(JsVar *parent, JsVar *code);
+
 
 
 
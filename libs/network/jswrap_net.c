@@ -18,6 +18,7 @@
 #include "jsinteractive.h"
 #include "jsparse.h"
 #include "socketserver.h"
+#include "dns.h"
 #include "network.h"
 
 /*JSON{
@@ -289,6 +290,11 @@ event is always followed by a close event. The error codes are:
 * -12: bad argument
 * -13: SSL handshake failed
 * -14: invalid SSL data
+* -15: no response
+* -16: WebSocket handshake failed
+* -17: invalid WebSocket frame
+* -18: MQTT connection refused
+* -19: invalid MQTT packet
 
 */
 /*JSON{
@@ -335,6 +341,58 @@ An event that is fired when the buffer is empty and it can accept more data to
 send.
 */
 
+/*JSON{
+  "type" : "method",
+  "class" : "Socket",
+  "name" : "pause",
+  "generate" : "jswrap_net_socket_pause"
+}
+Stop reading data from this socket. No more `data` events are fired and
+incoming data is left in the network stack (so the other end is slowed down)
+until `Socket.resume` is called.
+
+This is called automatically when the socket is piped to a stream that can't
+keep up.
+*/
+void jswrap_net_socket_pause(JsVar *parent) {
+  socketSetPaused(parent, true);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Socket",
+  "name" : "resume",
+  "generate" : "jswrap_net_socket_resume"
+}
+Start reading data from this socket again after `Socket.pause`
+*/
+void jswrap_net_socket_resume(JsVar *parent) {
+  socketSetPaused(parent, false);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Socket",
+  "name" : "setHighWaterMark",
+  "generate" : "jswrap_net_socket_setHighWaterMark",
+  "params" : [
+    ["bytes","int","How many bytes may be buffered before we stop reading (or 0 for the default of 2048)"],
+    ["minFree","int","Stop reading if less than this percentage of variables are free (or 0 to not check - the default)"]
+  ]
+}
+Set how much received data can be buffered (waiting to be read, or for a `data`
+handler to be run) before Espruino stops reading from the network. The same
+number of bytes is used as the limit for `write` - after which it returns
+`false` and a `drain` event should be waited for.
+
+If `minFree` is set, this socket also stops reading while memory is low. Use it
+with care: a socket that isn't reading won't notice the other end closing until
+memory has been freed.
+*/
+void jswrap_net_socket_setHighWaterMark(JsVar *parent, int bytes, int minFree) {
+  socketSetHighWaterMark(parent, bytes, minFree);
+}
+
 
 
 // ---------------------------------------------------------------------------------
@@ -397,9 +455,9 @@ JsVar *jswrap_net_connect(JsVar *options, JsVar *callback, SocketType socketType
     return 0;
   }
 #ifdef USE_TLS
-  if ((socketType&ST_TYPE_MASK) == ST_HTTP) {
+  if ((socketType&ST_TYPE_MASK) == ST_HTTP || (socketType&ST_TYPE_MASK) == ST_WS) {
     JsVar *protocol = jsvObjectGetChild(options, "protocol", 0);
-    if (protocol && jsvIsStringEqual(protocol, "https:")) {
+    if (protocol && (jsvIsStringEqual(protocol, "https:") || jsvIsStringEqual(protocol, "wss:"))) {
       socketType |= ST_TLS;
     }
     jsvUnLock(protocol);
@@ -438,6 +496,69 @@ JsVar *jswrap_net_connect(JsVar *options, JsVar *callback, SocketType socketType
   return rq;
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "net",
+  "name" : "lookup",
+  "generate" : "jswrap_net_lookup",
+  "params" : [
+    ["hostname","JsVar","The host name to look up, eg. `\"www.espruino.com\"`"],
+    ["callback","JsVar","A `function(err, address, family)` that is called with the IP address as a String (and `family=4`), or an error object with `code` and `message` fields"]
+  ]
+}
+Look up the IP address of a host name without blocking. This uses the same
+resolver and cache as the network connections, so answers are remembered for
+as long as their DNS 'time to live' says.
+
+```
+require("net").lookup("www.espruino.com", function(err, address) {
+  if (err) print("Not found");
+  else print(address);
+});
+```
+*/
+void jswrap_net_lookup(JsVar *hostname, JsVar *callback) {
+  if (!jsvIsString(hostname)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting a String hostname, got %t", hostname);
+    return;
+  }
+  if (!jsvIsFunction(callback)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting Callback Function but got %t", callback);
+    return;
+  }
+  JsNetwork net;
+  if (!networkGetFromVarIfOnline(&net)) return;
+  dnsLookup(&net, hostname, callback);
+  networkFree(&net);
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "net",
+  "name" : "setDNSServer",
+  "generate" : "jswrap_net_setDNSServer",
+  "params" : [
+    ["address","JsVar","The IP address of the DNS server as a String, or undefined to use the network's default"],
+    ["port","int","The port number, or 0 for the default of 53"]
+  ]
+}
+Set the DNS server used to look up host names. This also empties the cache of
+host names that have already been looked up.
+*/
+void jswrap_net_setDNSServer(JsVar *address, int port) {
+  uint32_t server = 0;
+  if (!jsvIsUndefined(address)) {
+    char ipStr[20];
+    jsvGetString(address, ipStr, sizeof(ipStr));
+    server = networkParseIPAddress(ipStr);
+    if (!server) {
+      jsExceptionHere(JSET_ERROR, "Invalid IP address %q", address);
+      return;
+    }
+  }
+  dnsSetServer(server, (unsigned short)port);
+}
+
 /*JSON{
   "type" : "library",
   "class" : "dgram"
@@ -457,13 +578,18 @@ page for more information on how to use it.
   "name" : "createSocket",
   "generate_full" : "jswrap_dgram_createSocket(type, callback)",
   "params" : [
-    ["type","JsVar","Socket type to create e.g. 'udp4'. Or options object { type: 'udp4', reuseAddr: true, recvBufferSize: 1024 }"],
+    ["type","JsVar","Socket type to create e.g. 'udp4'. Or options object { type: 'udp4', reuseAddr: true, recvBufferSize: 1024, batch: 16 }"],
     ["callback","JsVar","A `function(sckt)` that will be called  with the socket when a connection is made. You can then call `sckt.send(...)` to send data, and `sckt.on('message', function(data) { ... })` and `sckt.on('close', function() { ... })` to deal with the response."]
   ],
   "return" : ["JsVar","Returns a new dgram.Socket object"],
   "return_object" : "dgramSocket"
 }
 Create a UDP socket
+
+If `batch` is set in the options, received datagrams aren't delivered one at a
+time with a `message` event. Instead every datagram that is waiting (up to
+`batch`, max 64) is copied into a buffer that is allocated once, and they're
+all delivered in a single `messages` event.
 */
 JsVar *jswrap_dgram_createSocket(JsVar *type, JsVar *callback) {
   NOT_USED(type);
@@ -529,6 +655,36 @@ void jswrap_dgram_socket_send(JsVar *parent, JsVar *buffer, JsVar *offset, JsVar
   networkFree(&net);
 }
 
+/*JSON{
+  "type" : "method",
+  "class" : "dgramSocket",
+  "name" : "sendMany",
+  "generate" : "jswrap_dgram_socket_sendMany",
+  "params" : [
+    ["messages","JsVar","An array of Strings, ArrayBuffers or Typed Arrays - one for each datagram"],
+    ["port","int","Destination port number"],
+    ["address","JsVar","Destination hostname or IP address string"]
+  ]
+}
+Send several datagrams to the same destination. The address is only looked up
+once, and as many of the datagrams as possible are sent each time around the
+idle loop.
+
+```
+sock.sendMany([new Uint8Array([1,2,3]), "Hello"], 1234, "192.168.1.10");
+```
+*/
+void jswrap_dgram_socket_sendMany(JsVar *parent, JsVar *messages, int port, JsVar *address) {
+  if (!jsvIsIterable(messages)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting an array of messages, got %t", messages);
+    return;
+  }
+  JsNetwork net;
+  if (!networkGetFromVarIfOnline(&net)) return;
+  clientRequestWriteUDPMany(&net, parent, messages, address, (unsigned short)port);
+  networkFree(&net);
+}
+
 /*JSON{
   "type" : "event",
   "class" : "dgramSocket",
@@ -542,6 +698,33 @@ The 'message' event is called when a datagram message is received. If a handler
 is defined with `X.on('message', function(msg) { ... })` then it will be called`
 */
 
+/*JSON{
+  "type" : "event",
+  "class" : "dgramSocket",
+  "name" : "messages",
+  "params" : [
+    ["msgs","JsVar","An array of `Uint8Array`, one for each datagram"],
+    ["info","JsVar","A `DataView` with 8 bytes per datagram - the 4 address bytes, then the port and size as little-endian 16 bit values"]
+  ]
+}
+Called instead of `message` when the socket was created with the `batch` option.
+All the datagrams that were waiting are delivered at once, for example:
+
+```
+sock.on('messages', function(msgs, info) {
+  msgs.forEach(function(msg, i) {
+    var port = info.getUint16(i*8 + 4, true);
+    // ...
+  });
+});
+```
+
+Datagrams are received into one of two buffers that are used alternately. A
+buffer is only reused once nothing references the views into it, so `msgs` and
+`info` can be kept - but it's better to copy what you need (eg. with `new
+Uint8Array(msg)`) so a new buffer doesn't have to be allocated for each batch.
+*/
+
 /*JSON{
   "type" : "method",
   "class" : "dgramSocket",
@@ -729,7 +912,7 @@ void jswrap_net_server_close(JsVar *parent) {
   "params" : [
     ["data","JsVar","A string containing data to send"]
   ],
-  "return" : ["bool","For node.js compatibility, returns the boolean false. When the send buffer is empty, a `drain` event will be sent"]
+  "return" : ["bool","`false` if more data is waiting to be sent than the high water mark (see `Socket.setHighWaterMark`), or `true` otherwise (older firmwares always returned `false`). When the send buffer is empty, a `drain` event will be sent"]
 }
 This function writes the `data` argument as a string. Data that is passed in
 (including arrays) will be converted to a string with the normal JavaScript
@@ -759,7 +942,7 @@ bool jswrap_net_socket_write(JsVar *parent, JsVar *data) {
   if (!networkGetFromVarIfOnline(&net)) return false;
   clientRequestWrite(&net, parent, data, NULL, 0);
   networkFree(&net);
-  return false;
+  return socketCanWrite(parent);
 }
 
 /*JSON{
@@ -28,11 +28,17 @@ JsVar *jswrap_net_connect(JsVar *options, JsVar *callback, SocketType socketType
 JsVar *jswrap_net_server_listen(JsVar *parent, int port, SocketType socketType);
 void jswrap_net_server_close(JsVar *parent);
 
+void jswrap_net_socket_pause(JsVar *parent);
+void jswrap_net_socket_resume(JsVar *parent);
+void jswrap_net_socket_setHighWaterMark(JsVar *parent, int bytes, int minFree);
 bool jswrap_net_socket_write(JsVar *parent, JsVar *data);
 void jswrap_net_socket_end(JsVar *parent, JsVar *data);
 
+void jswrap_net_lookup(JsVar *hostname, JsVar *callback);
+void jswrap_net_setDNSServer(JsVar *address, int port);
 JsVar *jswrap_dgram_createSocket(JsVar *type, JsVar *callback);
 JsVar *jswrap_dgramSocket_bind(JsVar *parent, unsigned short port, JsVar *callback);
 void jswrap_dgram_close(JsVar *parent);
 void jswrap_dgram_addMembership(JsVar *parent, JsVar *group, JsVar *ip);
 void jswrap_dgram_socket_send(JsVar *parent, JsVar *buffer, JsVar *offset, JsVar *length, JsVar *args);
+void jswrap_dgram_socket_sendMany(JsVar *parent, JsVar *messages, int port, JsVar *address);
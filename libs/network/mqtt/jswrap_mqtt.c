@@ -0,0 +1,263 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * This file is designed to be parsed during the build process
+ *
+ * Contains JavaScript MQTT Functions
+ * ----------------------------------------------------------------------------
+ */
+#include "jswrap_mqtt.h"
+#include "jsvariterator.h"
+#include "socketserver.h"
+#include "mqtt.h"
+
+#include "../network.h"
+
+/*JSON{
+  "type" : "library",
+  "class" : "MQTT",
+  "ifdef" : "USE_MQTT"
+}
+A native MQTT 3.1.1 client. Packets are encoded and decoded in C, and
+keepalive pings are handled without running any JavaScript.
+
+This is mostly compatible with the `MQTT` module - so existing code using
+`require("MQTT").create(...)` will use it instead of the module.
+
+```
+var mqtt = require("MQTT").create("192.168.1.10", { client_id : "espruino" });
+mqtt.on('connected', function() {
+  mqtt.subscribe("home/+/temperature", { qos : 1 }, function(msg) {
+    console.log(msg.topic, msg.message);
+  });
+  mqtt.publish("home/status", "online", { qos : 1 });
+});
+mqtt.connect();
+```
+*/
+/*JSON{
+  "type" : "class",
+  "library" : "MQTT",
+  "class" : "MQTTClient",
+  "ifdef" : "USE_MQTT"
+}
+An MQTT client connection created with `require('MQTT').create`
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "connected",
+  "ifdef" : "USE_MQTT"
+}
+Called when the broker has accepted the connection (CONNACK). Any QoS 1
+messages that weren't acknowledged, or that are in the Storage outbox, are sent
+before this, and all subscriptions are renewed.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "publish",
+  "params" : [
+    ["msg","JsVar","An object containing `topic`, `message`, `qos`, `retain` and `dup` fields"]
+  ],
+  "ifdef" : "USE_MQTT"
+}
+Called when a message is received on any subscribed topic
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "published",
+  "params" : [
+    ["id","int","The packet id returned by `MQTTClient.publish`"]
+  ],
+  "ifdef" : "USE_MQTT"
+}
+Called when a QoS 1 message has been acknowledged by the broker
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "subscribed",
+  "params" : [
+    ["id","int","The packet id returned by `MQTTClient.subscribe`"],
+    ["qos","int","The QoS granted, or 128 on failure"]
+  ],
+  "ifdef" : "USE_MQTT"
+}
+Called when the broker acknowledges a subscription
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "unsubscribed",
+  "params" : [
+    ["id","int","The packet id returned by `MQTTClient.unsubscribe`"]
+  ],
+  "ifdef" : "USE_MQTT"
+}
+Called when the broker acknowledges an unsubscribe
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "close",
+  "params" : [
+    ["had_error","JsVar","A boolean indicating whether the connection had an error (use an error event handler to get error details)."]
+  ],
+  "ifdef" : "USE_MQTT"
+}
+Called when the connection closes. Call `MQTTClient.connect` to reconnect.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "MQTTClient",
+  "name" : "error",
+  "params" : [
+    ["details","JsVar","An error object with an error code (a negative integer) and a message."]
+  ],
+  "ifdef" : "USE_MQTT"
+}
+An event that is fired if there is an error on the connection - including the
+broker refusing the connection, or not responding to a keepalive ping.
+*/
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "MQTT",
+  "name" : "create",
+  "generate" : "jswrap_mqtt_create",
+  "params" : [
+    ["server","JsVar","The host name or IP address of the broker"],
+    ["options","JsVar",["[optional] An object containing:","`port` - the port to connect to (default 1883, or 8883 with TLS)","`client_id` - the client id (default is random)","`keep_alive` - keepalive in seconds (default 60, 0 disables)","`clean_session` - default true","`username`, `password` - for authentication","`tls` - if true, connect with TLS","`outbox` - a Storage file name (26 characters max). QoS 1 messages published while disconnected are saved in Storage, one file per message (named from this), and sent on the next connect"]]
+  ],
+  "return" : ["JsVar","A new MQTTClient (call `connect` on it to connect)"],
+  "return_object" : "MQTTClient",
+  "ifdef" : "USE_MQTT"
+}
+Create an MQTT client for the given broker
+*/
+JsVar *jswrap_mqtt_create(JsVar *server, JsVar *options) {
+  if (!jsvIsString(server)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting server to be a String, got %t", server);
+    return 0;
+  }
+  if (!jsvIsUndefined(options) && !jsvIsObject(options)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting options to be an Object, got %t", options);
+    return 0;
+  }
+  return mqttNew(server, options);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "MQTTClient",
+  "name" : "connect",
+  "generate" : "jswrap_MQTTClient_connect",
+  "ifdef" : "USE_MQTT"
+}
+Connect (or reconnect) to the broker. A `connected` event is fired when the
+broker accepts the connection.
+*/
+void jswrap_MQTTClient_connect(JsVar *parent) {
+  JsNetwork net;
+  if (!networkGetFromVarIfOnline(&net)) return;
+  mqttConnect(&net, parent);
+  networkFree(&net);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "MQTTClient",
+  "name" : "disconnect",
+  "generate" : "jswrap_MQTTClient_disconnect",
+  "ifdef" : "USE_MQTT"
+}
+Disconnect from the broker
+*/
+void jswrap_MQTTClient_disconnect(JsVar *parent) {
+  JsNetwork net;
+  if (!networkGetFromVar(&net)) return;
+  mqttDisconnect(&net, parent);
+  networkFree(&net);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "MQTTClient",
+  "name" : "publish",
+  "generate" : "jswrap_MQTTClient_publish",
+  "params" : [
+    ["topic","JsVar","The topic to publish to"],
+    ["message","JsVar","The message - a String, or an ArrayBuffer/Array for binary data"],
+    ["options","JsVar","[optional] An object `{ qos : 0/1, retain : bool }`"]
+  ],
+  "return" : ["int","The packet id for a QoS 1 message (see the `published` event), or 0"],
+  "ifdef" : "USE_MQTT"
+}
+Publish a message. QoS 1 messages are kept until the broker acknowledges them,
+and are sent again after a reconnect if needed. If not connected and an
+`outbox` was given to `create`, QoS 1 messages are saved to Storage (otherwise
+an exception is thrown). QoS 0 messages published while not connected are
+dropped.
+*/
+int jswrap_MQTTClient_publish(JsVar *parent, JsVar *topic, JsVar *message, JsVar *options) {
+  int qos = 0;
+  bool retain = false;
+  if (jsvIsObject(options)) {
+    qos = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "qos", 0));
+    retain = jsvGetBoolAndUnLock(jsvObjectGetChild(options, "retain", 0));
+  }
+  return mqttPublish(parent, topic, message, qos, retain);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "MQTTClient",
+  "name" : "subscribe",
+  "generate" : "jswrap_MQTTClient_subscribe",
+  "params" : [
+    ["topic","JsVar","The topic filter, which may contain `+` and `#` wildcards"],
+    ["options","JsVar","[optional] An object `{ qos : 0/1/2 }`"],
+    ["callback","JsVar","[optional] A `function(msg)` called for messages that match this filter"]
+  ],
+  "return" : ["int","The packet id (see the `subscribed` event), or 0 if not yet connected"],
+  "ifdef" : "USE_MQTT"
+}
+Subscribe to a topic filter. Subscriptions are remembered and renewed
+each time the client connects. Every message also fires a `publish` event.
+*/
+int jswrap_MQTTClient_subscribe(JsVar *parent, JsVar *topic, JsVar *options, JsVar *callback) {
+  if (jsvIsFunction(options)) {
+    callback = options;
+    options = 0;
+  }
+  int qos = 0;
+  if (jsvIsObject(options))
+    qos = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "qos", 0));
+  return mqttSubscribe(parent, topic, qos, callback);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "MQTTClient",
+  "name" : "unsubscribe",
+  "generate" : "jswrap_MQTTClient_unsubscribe",
+  "params" : [
+    ["topic","JsVar","The topic filter that was passed to `subscribe`"]
+  ],
+  "return" : ["int","The packet id (see the `unsubscribed` event), or 0 if not connected"],
+  "ifdef" : "USE_MQTT"
+}
+Unsubscribe from a topic filter
+*/
+int jswrap_MQTTClient_unsubscribe(JsVar *parent, JsVar *topic) {
+  return mqttUnsubscribe(parent, topic);
+}
@@ -0,0 +1,22 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Contains JavaScript MQTT Functions
+ * ----------------------------------------------------------------------------
+ */
+#include "jsvar.h"
+
+JsVar *jswrap_mqtt_create(JsVar *server, JsVar *options);
+
+void jswrap_MQTTClient_connect(JsVar *parent);
+void jswrap_MQTTClient_disconnect(JsVar *parent);
+int jswrap_MQTTClient_publish(JsVar *parent, JsVar *topic, JsVar *message, JsVar *options);
+int jswrap_MQTTClient_subscribe(JsVar *parent, JsVar *topic, JsVar *options, JsVar *callback);
+int jswrap_MQTTClient_unsubscribe(JsVar *parent, JsVar *topic);
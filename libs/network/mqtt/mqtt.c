@@ -0,0 +1,701 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Native MQTT 3.1.1 client, running on top of socketserver connections
+ *
+ * Packets are encoded straight into the connection's send buffer and decoded
+ * from its receive buffer, so the interpreter is only involved when there is
+ * a message (or event) to deliver. Keepalive pings are sent from the idle loop.
+ * ----------------------------------------------------------------------------
+ */
+#include "mqtt.h"
+#include "socketserver.h"
+#include "socketerrors.h"
+#include "jsinteractive.h"
+#include "jsvariterator.h"
+#include "jshardware.h"
+#include "jsflash.h"
+
+#define MQTT_NAME_STATE JS_HIDDEN_CHAR_STR"mqS" // MqttState
+#define MQTT_NAME_INFLIGHT JS_HIDDEN_CHAR_STR"mqI" // QoS 1 PUBLISH packets waiting for PUBACK, indexed by packet id
+#define MQTT_NAME_FILTERS JS_HIDDEN_CHAR_STR"mqF" // topic filter -> QoS, (re)subscribed on every connect
+#define MQTT_NAME_TRIE JS_HIDDEN_CHAR_STR"mqT" // trie of topic levels, for subscription callbacks
+#define MQTT_TRIE_HANDLER JS_HIDDEN_CHAR_STR"cb" // callback on a trie node - can't clash with a (UTF-8) topic level
+#define MQTT_NAME_ON_CONNECTED JS_EVENT_PREFIX"connected"
+#define MQTT_NAME_ON_PUBLISH JS_EVENT_PREFIX"publish"
+#define MQTT_NAME_ON_PUBLISHED JS_EVENT_PREFIX"published"
+#define MQTT_NAME_ON_SUBSCRIBED JS_EVENT_PREFIX"subscribed"
+#define MQTT_NAME_ON_UNSUBSCRIBED JS_EVENT_PREFIX"unsubscribed"
+
+#define MQTT_MAX_HEADER_LEN 5 // type byte + up to 4 bytes of length
+#define MQTT_MAX_OUTBOX_NAME_LENGTH (sizeof(JsfFileName)-2) // the last 2 chars of an outbox file name are the record number
+
+typedef struct {
+  uint32_t keepAlive; ///< keepalive period in ms, or 0 for none
+  uint32_t lastTx; ///< time (ms) we last queued a packet to send
+  uint32_t pingTime; ///< time (ms) we sent PINGREQ
+  uint16_t nextId; ///< next packet id to use
+  uint16_t outboxNext; ///< number of the next outbox record to write, or 0 if we haven't looked in Storage yet
+  bool connected; ///< we've had a CONNACK
+  bool pingSent; ///< we're waiting for a PINGRESP
+} PACKED_FLAGS MqttState;
+
+static uint32_t mqttGetTime() {
+  return (uint32_t)(long long)jshGetMillisecondsFromTime(jshGetSystemTime());
+}
+
+static bool mqttGetState(JsVar *client, MqttState *st) {
+  JsVar *data = jsvObjectGetChild(client, MQTT_NAME_STATE, 0);
+  bool ok = jsvIsString(data) && jsvGetStringChars(data, 0, (char*)st, sizeof(MqttState))==sizeof(MqttState);
+  jsvUnLock(data);
+  if (!ok) memset(st, 0, sizeof(MqttState));
+  return ok;
+}
+
+static void mqttSetState(JsVar *client, MqttState *st) {
+  JsVar *data = jsvObjectGetChild(client, MQTT_NAME_STATE, 0);
+  if (jsvIsString(data) && jsvGetStringLength(data)==sizeof(MqttState)) // overwrite - this happens for every packet
+    jsvSetString(data, (char*)st, sizeof(MqttState));
+  else
+    jsvObjectSetChildAndUnLock(client, MQTT_NAME_STATE, jsvNewStringOfLength(sizeof(MqttState), (char*)st));
+  jsvUnLock(data);
+}
+
+/// Are we connected to the broker (CONNACK received and the socket not closing)?
+static bool mqttIsConnected(JsVar *client, MqttState *st) {
+  return st->connected && _socketConnectionOpen(client);
+}
+
+static uint16_t mqttGetNextId(MqttState *st) {
+  if (st->nextId==0) st->nextId = 1;
+  return st->nextId++;
+}
+
+/// Encode a fixed header into buf, returning its length
+static size_t mqttEncodeHeader(unsigned char *buf, unsigned char typeAndFlags, size_t remaining) {
+  size_t n = 0;
+  buf[n++] = typeAndFlags;
+  do {
+    unsigned char b = (unsigned char)(remaining & 127);
+    remaining >>= 7;
+    if (remaining) b |= 128;
+    buf[n++] = b;
+  } while (remaining);
+  return n;
+}
+
+/// Decode a fixed header, returning its length. Returns 0 if we need more data, or -1 if it's invalid
+static int mqttDecodeHeader(const unsigned char *buf, size_t bufLen, size_t *remaining) {
+  size_t value = 0;
+  int i;
+  for (i=1;i<MQTT_MAX_HEADER_LEN;i++) {
+    if ((size_t)i >= bufLen) return 0;
+    value |= (size_t)(buf[i]&127) << (7*(i-1));
+    if (!(buf[i]&128)) {
+      *remaining = value;
+      return i+1;
+    }
+  }
+  return -1;
+}
+
+static void mqttAppendShort(JsVar *packet, int value) {
+  char buf[2] = { (char)(value>>8), (char)value };
+  jsvAppendStringBuf(packet, buf, 2);
+}
+
+/// Append a length-prefixed string
+static void mqttAppendString(JsVar *packet, JsVar *str) {
+  mqttAppendShort(packet, (int)jsvGetStringLength(str));
+  jsvAppendStringVarComplete(packet, str);
+}
+
+/// Queue a complete packet to be sent
+static void mqttSend(JsVar *client, JsVar *packet) {
+  JsVar *sendData = socketGetSendData(client);
+  if (!sendData) return; // out of memory
+  jsvAppendStringVarComplete(sendData, packet);
+  jsvUnLock(sendData);
+  MqttState st;
+  mqttGetState(client, &st);
+  st.lastTx = mqttGetTime();
+  mqttSetState(client, &st);
+}
+
+/// Queue a packet that is just a fixed header and an optional packet id (if id>=0)
+static void mqttSendSimple(JsVar *client, unsigned char typeAndFlags, int packetId) {
+  unsigned char buf[4];
+  buf[0] = typeAndFlags;
+  buf[1] = (packetId>=0) ? 2 : 0;
+  buf[2] = (unsigned char)(packetId>>8);
+  buf[3] = (unsigned char)packetId;
+  JsVar *packet = jsvNewStringOfLength(packetId>=0 ? 4 : 2, (char*)buf);
+  if (packet) mqttSend(client, packet);
+  jsvUnLock(packet);
+}
+
+/// Create a PUBLISH packet. Payload is a String or ArrayBuffer
+static JsVar *mqttNewPublish(JsVar *topic, JsVar *payload, int qos, bool retain, int packetId) {
+  JSV_GET_AS_CHAR_ARRAY(payloadPtr, payloadLen, payload);
+  if (payload && !payloadPtr && payloadLen) return 0;
+  size_t remaining = 2 + jsvGetStringLength(topic) + (qos ? 2 : 0) + payloadLen;
+  unsigned char hdr[MQTT_MAX_HEADER_LEN];
+  size_t hdrLen = mqttEncodeHeader(hdr, (unsigned char)((MQTT_PUBLISH<<4) | (qos<<1) | (retain?1:0)), remaining);
+  JsVar *packet = jsvNewStringOfLength((unsigned int)hdrLen, (char*)hdr);
+  if (!packet) return 0;
+  mqttAppendString(packet, topic);
+  if (qos) mqttAppendShort(packet, packetId);
+  if (payloadLen) jsvAppendStringBuf(packet, payloadPtr, payloadLen);
+  return packet;
+}
+
+/// Offset of the packet id within a PUBLISH packet (QoS>0 only)
+static size_t mqttGetPublishIdOffset(JsVar *packet) {
+  unsigned char buf[MQTT_MAX_HEADER_LEN+2];
+  size_t len = jsvGetStringChars(packet, 0, (char*)buf, sizeof(buf));
+  size_t remaining;
+  int hdrLen = mqttDecodeHeader(buf, len, &remaining);
+  if (hdrLen<=0) return 0;
+  char topicLen[2];
+  jsvGetStringChars(packet, (size_t)hdrLen, topicLen, 2);
+  return (size_t)hdrLen + 2 + (((unsigned char)topicLen[0]<<8) | (unsigned char)topicLen[1]);
+}
+
+static void mqttSetPublishId(JsVar *packet, int packetId) {
+  size_t idx = mqttGetPublishIdOffset(packet);
+  if (!idx) return;
+  jsvSetCharInString(packet, idx, (char)(packetId>>8), false);
+  jsvSetCharInString(packet, idx+1, (char)packetId, false);
+}
+
+static void mqttInflightRemove(JsVar *client, int packetId) {
+  JsVar *inflight = jsvObjectGetChild(client, MQTT_NAME_INFLIGHT, 0);
+  if (!inflight) return;
+  JsVar *idx = jsvNewFromInteger(packetId);
+  JsVar *name = jsvFindChildFromVar(inflight, idx, false);
+  if (name) jsvRemoveChild(inflight, name);
+  jsvUnLock3(name, idx, inflight);
+}
+
+/// Add a QoS 1 PUBLISH to the inflight list and send it
+static void mqttSendInflight(JsVar *client, int packetId, JsVar *packet) {
+  JsVar *inflight = jsvObjectGetChild(client, MQTT_NAME_INFLIGHT, JSV_ARRAY);
+  if (inflight) jsvSetArrayItem(inflight, packetId, packet);
+  jsvUnLock(inflight);
+  mqttSend(client, packet);
+}
+
+/** Get the Storage file name of outbox record 'n' (from 1). Each record is
+ * its own file, named like a StorageFile chunk but with a 16 bit number, so
+ * appending never has to rewrite what is already there. Returns false if
+ * there's no outbox */
+static bool mqttOutboxGetName(JsVar *client, int n, JsfFileName *name) {
+  JsVar *options = socketGetOptions(client);
+  JsVar *outbox = jsvObjectGetChild(options, "outbox", 0);
+  jsvUnLock(options);
+  bool ok = jsvIsString(outbox) && jsvGetStringLength(outbox) <= MQTT_MAX_OUTBOX_NAME_LENGTH;
+  if (ok) {
+    *name = jsfNameFromVar(outbox);
+    name->c[sizeof(JsfFileName)-2] = (char)(n>>8);
+    name->c[sizeof(JsfFileName)-1] = (char)n;
+  }
+  jsvUnLock(outbox);
+  return ok;
+}
+
+/// Save a QoS 1 PUBLISH (with no packet id yet) as the next record in the Storage outbox
+static bool mqttOutboxAppend(JsVar *client, JsVar *packet) {
+  MqttState st;
+  mqttGetState(client, &st);
+  JsfFileName name;
+  if (!st.outboxNext) { // find the end of anything left from before a reset
+    st.outboxNext = 1;
+    while (mqttOutboxGetName(client, st.outboxNext, &name) && jsfFindFile(name, 0))
+      st.outboxNext++;
+  }
+  if (!st.outboxNext || !mqttOutboxGetName(client, st.outboxNext, &name)) // full (or no outbox)
+    return false;
+  if (!jsfWriteFile(name, packet, JSFF_NONE, 0, 0))
+    return false;
+  st.outboxNext++;
+  mqttSetState(client, &st);
+  return true;
+}
+
+/// Send every record in the Storage outbox, and remove them
+static void mqttOutboxFlush(JsVar *client, MqttState *st) {
+  JsfFileName name;
+  int n;
+  for (n=1; n<=0xFFFF && mqttOutboxGetName(client, n, &name); n++) {
+    JsVar *contents = jsfReadFile(name, 0, 0);
+    if (!contents) break; // that's all of them
+    // copy out of flash, as the packet id is filled in
+    JsVar *packet = jsvNewFromStringVar(contents, 0, JSVAPPENDSTRINGVAR_MAXLENGTH);
+    jsvUnLock(contents);
+    jsfEraseFile(name);
+    if (!packet) continue; // out of memory - drop it
+    int packetId = mqttGetNextId(st);
+    mqttSetPublishId(packet, packetId);
+    mqttSetState(client, st);
+    mqttSendInflight(client, packetId, packet);
+    mqttGetState(client, st);
+    jsvUnLock(packet);
+  }
+  st->outboxNext = 1;
+  mqttSetState(client, st);
+}
+
+/// Send SUBSCRIBE for the given filter, or all known filters if filter==0
+static int mqttSendSubscribe(JsVar *client, MqttState *st, JsVar *filter, int qos) {
+  JsVar *packet = jsvNewFromEmptyString();
+  if (!packet) return 0;
+  size_t count = 0;
+  if (filter) {
+    mqttAppendString(packet, filter);
+    char q = (char)qos;
+    jsvAppendStringBuf(packet, &q, 1);
+    count++;
+  } else {
+    JsVar *filters = jsvObjectGetChild(client, MQTT_NAME_FILTERS, 0);
+    if (filters) {
+      JsvObjectIterator it;
+      jsvObjectIteratorNew(&it, filters);
+      while (jsvObjectIteratorHasValue(&it)) {
+        JsVar *key = jsvObjectIteratorGetKey(&it);
+        JsVar *f = jsvAsString(key);
+        mqttAppendString(packet, f);
+        char q = (char)jsvGetIntegerAndUnLock(jsvObjectIteratorGetValue(&it));
+        jsvAppendStringBuf(packet, &q, 1);
+        jsvUnLock2(f, key);
+        count++;
+        jsvObjectIteratorNext(&it);
+      }
+      jsvObjectIteratorFree(&it);
+      jsvUnLock(filters);
+    }
+  }
+  int packetId = 0;
+  if (count) {
+    packetId = mqttGetNextId(st);
+    unsigned char hdr[MQTT_MAX_HEADER_LEN+2];
+    size_t hdrLen = mqttEncodeHeader(hdr, (MQTT_SUBSCRIBE<<4) | 2, 2+jsvGetStringLength(packet));
+    hdr[hdrLen++] = (unsigned char)(packetId>>8);
+    hdr[hdrLen++] = (unsigned char)packetId;
+    JsVar *full = jsvNewStringOfLength((unsigned int)hdrLen, (char*)hdr);
+    if (full) {
+      jsvAppendStringVarComplete(full, packet);
+      mqttSetState(client, st);
+      mqttSend(client, full);
+      mqttGetState(client, st);
+    }
+    jsvUnLock(full);
+  }
+  jsvUnLock(packet);
+  return packetId;
+}
+
+// -----------------------------
+
+/// Call the callbacks on a trie node (if any)
+static void mqttTrieFire(JsVar *client, JsVar *node, JsVar *msg) {
+  JsVar *callback = jsvObjectGetChild(node, MQTT_TRIE_HANDLER, 0);
+  if (callback) jsiQueueEvents(client, callback, &msg, 1);
+  jsvUnLock(callback);
+}
+
+/** Fire the callbacks for every filter that matches a topic. 'level' points
+ * to the current level of the topic, and levels are separated by '\0' */
+static void mqttTrieMatch(JsVar *client, JsVar *node, const char *level, const char *end, JsVar *msg, bool isRoot) {
+  // topics beginning with '$' don't match wildcards at the first level
+  bool wildcards = !(isRoot && level<end && level[0]=='$');
+  JsVar *child;
+  if (wildcards) {
+    // '#' matches this level and everything below it
+    child = jsvObjectGetChild(node, "#", 0);
+    if (child) mqttTrieFire(client, child, msg);
+    jsvUnLock(child);
+  }
+  if (level > end) { // we've matched all levels
+    mqttTrieFire(client, node, msg);
+    return;
+  }
+  const char *next = level + strlen(level) + 1;
+  child = jsvObjectGetChild(node, level, 0);
+  if (child) mqttTrieMatch(client, child, next, end, msg, false);
+  jsvUnLock(child);
+  if (wildcards) {
+    child = jsvObjectGetChild(node, "+", 0);
+    if (child) mqttTrieMatch(client, child, next, end, msg, false);
+    jsvUnLock(child);
+  }
+}
+
+/** Get the trie node for a filter (creating it if needed), or 0. Returns the
+ * filter as a C string in 'buf' */
+static JsVar *mqttTrieGetNode(JsVar *client, JsVar *filter, char *buf, bool create) {
+  size_t len = jsvGetString(filter, buf, MQTT_MAX_TOPIC_LENGTH);
+  if (len >= MQTT_MAX_TOPIC_LENGTH-1) {
+    jsExceptionHere(JSET_ERROR, "Topic filter too long");
+    return 0;
+  }
+  JsVar *node = jsvObjectGetChild(client, MQTT_NAME_TRIE, create ? JSV_OBJECT : 0);
+  char level[MQTT_MAX_TOPIC_LENGTH];
+  size_t i = 0, l = 0;
+  while (node) {
+    if (i==len || buf[i]=='/') {
+      level[l] = 0;
+      JsVar *child = jsvObjectGetChild(node, level, create ? JSV_OBJECT : 0);
+      jsvUnLock(node);
+      node = child;
+      l = 0;
+      if (i==len) break;
+    } else {
+      level[l++] = buf[i];
+    }
+    i++;
+  }
+  return node;
+}
+
+// -----------------------------
+
+int mqttReceived(JsVar *client, JsVar **receiveData) {
+  MqttState st;
+  mqttGetState(client, &st);
+  size_t len = jsvGetStringLength(*receiveData);
+  size_t pos = 0;
+  int error = 0;
+  while (!error && pos < len) {
+    unsigned char hdr[MQTT_MAX_HEADER_LEN+2];
+    size_t hdrAvail = jsvGetStringChars(*receiveData, pos, (char*)hdr, sizeof(hdr));
+    size_t remaining;
+    int hdrLen = mqttDecodeHeader(hdr, hdrAvail, &remaining);
+    if (hdrLen<0) {
+      error = SOCKET_ERR_MQTT_INVALID;
+      break;
+    }
+    if (hdrLen==0 || len-pos < (size_t)hdrLen+remaining) break; // wait for the rest of the packet
+    size_t body = pos + (size_t)hdrLen;
+    pos = body + remaining;
+    MqttPacketType type = (MqttPacketType)(hdr[0]>>4);
+    // packet id, for the packets that have one
+    int packetId = (remaining>=2 && hdrAvail>=(size_t)hdrLen+2) ? ((hdr[hdrLen]<<8) | hdr[hdrLen+1]) : 0;
+    switch (type) {
+    case MQTT_CONNACK:
+      if (remaining<2 || hdrAvail<(size_t)hdrLen+2) {
+        error = SOCKET_ERR_MQTT_INVALID;
+      } else if (hdr[hdrLen+1]) { // return code
+        error = SOCKET_ERR_MQTT_REFUSED;
+      } else {
+        st.connected = true;
+        st.pingSent = false;
+        mqttSetState(client, &st);
+        // resend anything that wasn't acknowledged before we disconnected
+        JsVar *inflight = jsvObjectGetChild(client, MQTT_NAME_INFLIGHT, 0);
+        if (inflight) {
+          JsvObjectIterator it;
+          jsvObjectIteratorNew(&it, inflight);
+          while (jsvObjectIteratorHasValue(&it)) {
+            JsVar *packet = jsvObjectIteratorGetValue(&it);
+            jsvSetCharInString(packet, 0, 0x08, true); // DUP
+            mqttSend(client, packet);
+            jsvUnLock(packet);
+            jsvObjectIteratorNext(&it);
+          }
+          jsvObjectIteratorFree(&it);
+          jsvUnLock(inflight);
+        }
+        mqttGetState(client, &st);
+        mqttOutboxFlush(client, &st);
+        mqttSendSubscribe(client, &st, 0, 0);
+        jsiQueueObjectCallbacks(client, MQTT_NAME_ON_CONNECTED, &client, 1);
+      }
+      break;
+    case MQTT_PUBLISH: {
+      int qos = (hdr[0]>>1)&3;
+      if (remaining<2 || qos==3) {
+        error = SOCKET_ERR_MQTT_INVALID;
+        break;
+      }
+      size_t topicLen = (size_t)packetId; // first 2 bytes are the topic length
+      size_t p = body+2+topicLen;
+      if (qos) {
+        char id[2];
+        jsvGetStringChars(*receiveData, p, id, 2);
+        packetId = ((unsigned char)id[0]<<8) | (unsigned char)id[1];
+        p += 2;
+      }
+      if (p > pos) {
+        error = SOCKET_ERR_MQTT_INVALID;
+        break;
+      }
+      JsVar *topic = jsvNewFromStringVar(*receiveData, body+2, topicLen);
+      JsVar *message = jsvNewFromStringVar(*receiveData, p, pos-p);
+      JsVar *msg = jsvNewObject();
+      if (msg && topic && message) {
+        jsvObjectSetChild(msg, "topic", topic);
+        jsvObjectSetChild(msg, "message", message);
+        jsvObjectSetChildAndUnLock(msg, "dup", jsvNewFromBool((hdr[0]&0x08)!=0));
+        jsvObjectSetChildAndUnLock(msg, "qos", jsvNewFromInteger(qos));
+        jsvObjectSetChildAndUnLock(msg, "retain", jsvNewFromBool((hdr[0]&0x01)!=0));
+        jsiQueueObjectCallbacks(client, MQTT_NAME_ON_PUBLISH, &msg, 1);
+        // dispatch to subscription callbacks
+        JsVar *trie = jsvObjectGetChild(client, MQTT_NAME_TRIE, 0);
+        if (trie && topicLen < MQTT_MAX_TOPIC_LENGTH) {
+          char buf[MQTT_MAX_TOPIC_LENGTH];
+          jsvGetString(topic, buf, sizeof(buf));
+          size_t i;
+          for (i=0;i<topicLen;i++)
+            if (buf[i]=='/') buf[i]=0;
+          mqttTrieMatch(client, trie, buf, &buf[topicLen], msg, true);
+        }
+        jsvUnLock(trie);
+      } else
+        error = SOCKET_ERR_MEM;
+      jsvUnLock3(msg, topic, message);
+      if (qos==1) mqttSendSimple(client, MQTT_PUBACK<<4, packetId);
+      if (qos==2) mqttSendSimple(client, MQTT_PUBREC<<4, packetId);
+      mqttGetState(client, &st);
+      break;
+    }
+    case MQTT_PUBACK: {
+      mqttInflightRemove(client, packetId);
+      JsVar *id = jsvNewFromInteger(packetId);
+      jsiQueueObjectCallbacks(client, MQTT_NAME_ON_PUBLISHED, &id, 1);
+      jsvUnLock(id);
+      break;
+    }
+    case MQTT_PUBREL:
+      mqttSendSimple(client, MQTT_PUBCOMP<<4, packetId);
+      mqttGetState(client, &st);
+      break;
+    case MQTT_SUBACK: {
+      char granted = 0;
+      if (remaining>2) jsvGetStringChars(*receiveData, body+2, &granted, 1);
+      JsVar *params[2] = { jsvNewFromInteger(packetId), jsvNewFromInteger((unsigned char)granted) };
+      jsiQueueObjectCallbacks(client, MQTT_NAME_ON_SUBSCRIBED, params, 2);
+      jsvUnLockMany(2, params);
+      break;
+    }
+    case MQTT_UNSUBACK: {
+      JsVar *id = jsvNewFromInteger(packetId);
+      jsiQueueObjectCallbacks(client, MQTT_NAME_ON_UNSUBSCRIBED, &id, 1);
+      jsvUnLock(id);
+      break;
+    }
+    case MQTT_PINGRESP:
+      st.pingSent = false;
+      mqttSetState(client, &st);
+      break;
+    case MQTT_PUBREC: // we never publish with QoS 2
+    case MQTT_PUBCOMP:
+      break;
+    default:
+      error = SOCKET_ERR_MQTT_INVALID;
+      break;
+    }
+  }
+  if (pos) {
+    // remove what we have handled, and leave any partial packet
+    JsVar *newReceiveData = (pos<len) ? jsvNewFromStringVar(*receiveData, pos, JSVAPPENDSTRINGVAR_MAXLENGTH) : 0;
+    jsvUnLock(*receiveData);
+    *receiveData = newReceiveData;
+  }
+  return error;
+}
+
+int mqttIdle(JsVar *client) {
+  MqttState st;
+  if (!mqttGetState(client, &st) || !st.connected || !st.keepAlive)
+    return 0;
+  uint32_t now = mqttGetTime();
+  if (st.pingSent) {
+    // no PINGRESP within a whole keepalive period - the connection is dead
+    if (now - st.pingTime > st.keepAlive)
+      return SOCKET_ERR_TIMEOUT;
+  } else if (now - st.lastTx >= st.keepAlive) {
+    mqttSendSimple(client, MQTT_PINGREQ<<4, -1);
+    mqttGetState(client, &st);
+    st.pingSent = true;
+    st.pingTime = now;
+    mqttSetState(client, &st);
+  }
+  return 0;
+}
+
+// -----------------------------
+
+JsVar *mqttNew(JsVar *server, JsVar *options) {
+  JsVar *opts = jsvIsObject(options) ? jsvCopy(options, true) : jsvNewObject();
+  if (!opts) return 0;
+  SocketType socketType = ST_MQTT;
+  int port = MQTT_DEFAULT_PORT;
+#ifdef USE_TLS
+  if (jsvGetBoolAndUnLock(jsvObjectGetChild(opts, "tls", 0))) {
+    socketType |= ST_TLS;
+    port = MQTT_DEFAULT_TLS_PORT;
+  }
+#endif
+  jsvObjectSetChild(opts, "host", server);
+  if (!jsvGetIntegerAndUnLock(jsvObjectGetChild(opts, "port", 0)))
+    jsvObjectSetChildAndUnLock(opts, "port", jsvNewFromInteger(port));
+  // choose a client id now, so we use the same one when we reconnect
+  JsVar *clientId = jsvObjectGetChild(opts, "client_id", 0);
+  if (jsvIsUndefined(clientId))
+    jsvObjectSetChildAndUnLock(opts, "client_id", jsvVarPrintf("espruino_%x", (unsigned int)jshGetRandomNumber()));
+  jsvUnLock(clientId);
+
+  JsVar *client = clientRequestNew(socketType, opts, 0);
+  jsvUnLock(opts);
+  if (client) {
+    MqttState st;
+    memset(&st, 0, sizeof(st));
+    st.nextId = 1;
+    mqttSetState(client, &st);
+  }
+  return client;
+}
+
+void mqttConnect(JsNetwork *net, JsVar *client) {
+  JsVar *options = socketGetOptions(client);
+  JsVar *clientId = jsvAsStringAndUnLock(jsvObjectGetChild(options, "client_id", 0));
+  JsVar *username = jsvObjectGetChild(options, "username", 0);
+  JsVar *password = jsvObjectGetChild(options, "password", 0);
+  JsVar *cleanSession = jsvObjectGetChild(options, "clean_session", 0);
+  JsVar *keepAliveVar = jsvObjectGetChild(options, "keep_alive", 0);
+  int keepAlive = jsvIsUndefined(keepAliveVar) ? MQTT_DEFAULT_KEEPALIVE : (int)jsvGetInteger(keepAliveVar);
+  bool clean = jsvIsUndefined(cleanSession) || jsvGetBool(cleanSession);
+  jsvUnLock3(options, cleanSession, keepAliveVar);
+  username = jsvIsUndefined(username) ? 0 : jsvAsStringAndUnLock(username);
+  password = jsvIsUndefined(password) ? 0 : jsvAsStringAndUnLock(password);
+
+  size_t remaining = 10 + 2 + jsvGetStringLength(clientId);
+  if (username) remaining += 2 + jsvGetStringLength(username);
+  if (password) remaining += 2 + jsvGetStringLength(password);
+  unsigned char hdr[MQTT_MAX_HEADER_LEN+10];
+  size_t hdrLen = mqttEncodeHeader(hdr, MQTT_CONNECT<<4, remaining);
+  memcpy(&hdr[hdrLen], "\0\4MQTT\4", 7); // protocol name and level
+  hdrLen += 7;
+  hdr[hdrLen++] = (unsigned char)((username?0x80:0) | (password?0x40:0) | (clean?0x02:0));
+  hdr[hdrLen++] = (unsigned char)(keepAlive>>8);
+  hdr[hdrLen++] = (unsigned char)keepAlive;
+  JsVar *packet = jsvNewStringOfLength((unsigned int)hdrLen, (char*)hdr);
+  if (packet) {
+    mqttAppendString(packet, clientId);
+    if (username) mqttAppendString(packet, username);
+    if (password) mqttAppendString(packet, password);
+  }
+  jsvUnLock3(clientId, username, password);
+  if (!packet) return;
+
+  clientRequestReopen(client);
+  MqttState st;
+  mqttGetState(client, &st);
+  st.keepAlive = (uint32_t)keepAlive*1000;
+  st.connected = false;
+  st.pingSent = false;
+  mqttSetState(client, &st);
+  mqttSend(client, packet);
+  jsvUnLock(packet);
+  clientRequestConnect(net, client);
+}
+
+void mqttDisconnect(JsNetwork *net, JsVar *client) {
+  MqttState st;
+  mqttGetState(client, &st);
+  if (mqttIsConnected(client, &st))
+    mqttSendSimple(client, MQTT_DISCONNECT<<4, -1);
+  mqttGetState(client, &st);
+  st.connected = false;
+  mqttSetState(client, &st);
+  clientRequestEnd(net, client);
+}
+
+int mqttPublish(JsVar *client, JsVar *topic, JsVar *message, int qos, bool retain) {
+  if (qos<0 || qos>1) {
+    jsExceptionHere(JSET_ERROR, "Only QoS 0 and 1 are supported for publish");
+    return 0;
+  }
+  MqttState st;
+  mqttGetState(client, &st);
+  bool connected = mqttIsConnected(client, &st);
+  topic = jsvAsString(topic);
+  JsVar *payload = (jsvIsArrayBuffer(message) || jsvIsArray(message)) ? jsvLockAgain(message) : jsvAsString(message);
+  int packetId = 0;
+  if (qos && connected) {
+    packetId = mqttGetNextId(&st);
+    mqttSetState(client, &st);
+  }
+  JsVar *packet = mqttNewPublish(topic, payload, qos, retain, packetId);
+  jsvUnLock2(topic, payload);
+  if (!packet) return 0;
+  if (connected) {
+    if (qos) mqttSendInflight(client, packetId, packet);
+    else mqttSend(client, packet);
+  } else if (qos && !mqttOutboxAppend(client, packet)) {
+    jsExceptionHere(JSET_ERROR, "Not connected");
+  } // QoS 0 messages are just dropped while we're offline
+  jsvUnLock(packet);
+  return packetId;
+}
+
+int mqttSubscribe(JsVar *client, JsVar *topic, int qos, JsVar *callback) {
+  if (qos<0 || qos>2) qos = 0;
+  topic = jsvAsString(topic);
+  char buf[MQTT_MAX_TOPIC_LENGTH];
+  JsVar *node = mqttTrieGetNode(client, topic, buf, true);
+  if (!node) {
+    jsvUnLock(topic);
+    return 0;
+  }
+  if (jsvIsFunction(callback))
+    jsvObjectSetChild(node, MQTT_TRIE_HANDLER, callback);
+  jsvUnLock(node);
+  JsVar *filters = jsvObjectGetChild(client, MQTT_NAME_FILTERS, JSV_OBJECT);
+  if (filters) jsvObjectSetChildAndUnLock(filters, buf, jsvNewFromInteger(qos));
+  jsvUnLock(filters);
+  // if not connected, this will be sent when we are
+  MqttState st;
+  mqttGetState(client, &st);
+  int packetId = mqttIsConnected(client, &st) ? mqttSendSubscribe(client, &st, topic, qos) : 0;
+  jsvUnLock(topic);
+  return packetId;
+}
+
+int mqttUnsubscribe(JsVar *client, JsVar *topic) {
+  topic = jsvAsString(topic);
+  char buf[MQTT_MAX_TOPIC_LENGTH];
+  // we don't prune empty trie nodes - filters are normally reused
+  JsVar *node = mqttTrieGetNode(client, topic, buf, false);
+  if (node) jsvObjectRemoveChild(node, MQTT_TRIE_HANDLER);
+  jsvUnLock(node);
+  JsVar *filters = jsvObjectGetChild(client, MQTT_NAME_FILTERS, 0);
+  if (filters) jsvObjectRemoveChild(filters, buf);
+  jsvUnLock(filters);
+  MqttState st;
+  mqttGetState(client, &st);
+  int packetId = 0;
+  if (mqttIsConnected(client, &st)) {
+    packetId = mqttGetNextId(&st);
+    mqttSetState(client, &st);
+    unsigned char hdr[MQTT_MAX_HEADER_LEN+2];
+    size_t hdrLen = mqttEncodeHeader(hdr, (MQTT_UNSUBSCRIBE<<4) | 2, 2+2+jsvGetStringLength(topic));
+    hdr[hdrLen++] = (unsigned char)(packetId>>8);
+    hdr[hdrLen++] = (unsigned char)packetId;
+    JsVar *packet = jsvNewStringOfLength((unsigned int)hdrLen, (char*)hdr);
+    if (packet) {
+      mqttAppendString(packet, topic);
+      mqttSend(client, packet);
+    }
+    jsvUnLock(packet);
+  }
+  jsvUnLock(topic);
+  return packetId;
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Native MQTT 3.1.1 client, running on top of socketserver connections
+ * ----------------------------------------------------------------------------
+ */
+#ifndef MQTT_H
+#define MQTT_H
+
+#include "jsutils.h"
+#include "jsvar.h"
+#include "network.h"
+
+#define MQTT_DEFAULT_PORT 1883
+#define MQTT_DEFAULT_TLS_PORT 8883
+#define MQTT_DEFAULT_KEEPALIVE 60 // seconds
+#define MQTT_MAX_TOPIC_LENGTH 256 // longest topic we'll dispatch to subscription callbacks
+
+typedef enum {
+  MQTT_CONNECT = 1,
+  MQTT_CONNACK = 2,
+  MQTT_PUBLISH = 3,
+  MQTT_PUBACK = 4,
+  MQTT_PUBREC = 5,
+  MQTT_PUBREL = 6,
+  MQTT_PUBCOMP = 7,
+  MQTT_SUBSCRIBE = 8,
+  MQTT_SUBACK = 9,
+  MQTT_UNSUBSCRIBE = 10,
+  MQTT_UNSUBACK = 11,
+  MQTT_PINGREQ = 12,
+  MQTT_PINGRESP = 13,
+  MQTT_DISCONNECT = 14,
+} MqttPacketType;
+
+/// Create a new (unconnected) client for the given server
+JsVar *mqttNew(JsVar *server, JsVar *options);
+/// Send CONNECT and open the connection (also used to reconnect)
+void mqttConnect(JsNetwork *net, JsVar *client);
+/// Send DISCONNECT and close the connection once it has gone
+void mqttDisconnect(JsNetwork *net, JsVar *client);
+/// Publish a message. Returns the packet id for QoS 1, or 0
+int mqttPublish(JsVar *client, JsVar *topic, JsVar *message, int qos, bool retain);
+/// Subscribe to a topic filter, with an optional callback for messages that match it. Returns the packet id, or 0 if not connected yet
+int mqttSubscribe(JsVar *client, JsVar *topic, int qos, JsVar *callback);
+/// Unsubscribe from a topic filter. Returns the packet id, or 0 if not connected
+int mqttUnsubscribe(JsVar *client, JsVar *topic);
+
+/// Handle data received on the connection. Returns a (negative) SocketError if the connection should be closed
+int mqttReceived(JsVar *client, JsVar **receiveData);
+/// Called each time around the idle loop for an open connection. Returns a (negative) SocketError if the connection should be closed
+int mqttIdle(JsVar *client);
+
+#endif // MQTT_H
@@ -12,6 +12,7 @@
  * ----------------------------------------------------------------------------
  */
 #include "network.h"
+#include "dns.h"
 #include "jsparse.h"
 #include "jsinteractive.h"
 #ifdef USE_FILESYSTEM
@@ -180,6 +181,11 @@ void networkGetHostByName(
   // first try and simply parse the IP address as a string
   *out_ip_addr = networkParseIPAddress(hostName);
 
+  // Then see if we looked it up recently
+  if (!*out_ip_addr) {
+    *out_ip_addr = dnsGetCached(hostName);
+  }
+
   // If we did not get an IP address from the string, then try and resolve it by
   // calling the network gethostbyname.
   if (!*out_ip_addr) {
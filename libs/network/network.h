@@ -25,10 +25,11 @@ typedef enum {
   ST_NORMAL = 0, // standard socket client/server
   ST_HTTP   = 1, // HTTP client/server
   ST_UDP    = 2, // UDP socket client/server
-  // WebSockets?
+  ST_WS     = 3, // WebSocket client/server (framed TCP after an HTTP upgrade)
+  ST_MQTT   = 4, // MQTT client
 
-  ST_TYPE_MASK = 3,
-  ST_TLS    = 4, // do the given connection with TLS
+  ST_TYPE_MASK = 7,
+  ST_TLS    = 8, // do the given connection with TLS
 } SocketType;
 
 typedef enum {
@@ -29,6 +29,10 @@ static char *socketErrors[] = {
   "SSL handshake failed",
   "invalid SSL data",
   "no response",
+  "WebSocket handshake failed",
+  "invalid WebSocket frame",
+  "MQTT connection refused",
+  "invalid MQTT packet",
 };
 
 char *socketErrorString(int error) {
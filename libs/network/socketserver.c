@@ -13,6 +13,7 @@
  */
 #include "socketserver.h"
 #include "socketerrors.h"
+#include "dns.h"
 #include "jsparse.h"
 #include "jsinteractive.h"
 #include "jshardware.h"
@@ -20,6 +21,12 @@
 #include "jswrap_stream.h"
 #include "jswrap_string.h"
 #include "jswrap_functions.h"
+#include "jswrap_arraybuffer.h"
+#include "jswrap_dataview.h"
+#include "mbedtls/include/mbedtls/sha1.h"
+#ifdef USE_MQTT
+#include "mqtt/mqtt.h"
+#endif
 
 #define HTTP_NAME_SOCKETTYPE "type" // normal socket or HTTP
 #define HTTP_NAME_PORT "port"
@@ -37,13 +44,36 @@
 #define HTTP_NAME_CLOSENOW "clsNow"  // boolean: gotta close
 #define HTTP_NAME_CONNECTED "conn"     // boolean: we are connected
 #define HTTP_NAME_CLOSE "cls"        // close after sending
+#define HTTP_NAME_PAUSED "paus"      // boolean: don't read or deliver any more data
+#define HTTP_NAME_HIGH_WATER "hwm"   // bytes buffered at which we stop reading
+#define HTTP_NAME_MIN_FREE "minF"    // % of free variables below which we stop reading
+#define HTTP_NAME_RESOLVING "rslv"   // boolean: waiting for DNS before we can connect
 #define HTTP_NAME_ON_CONNECT JS_EVENT_PREFIX"connect"
 #define HTTP_NAME_ON_CLOSE JS_EVENT_PREFIX"close"
 #define HTTP_NAME_ON_END JS_EVENT_PREFIX"end"
 #define HTTP_NAME_ON_DRAIN JS_EVENT_PREFIX"drain"
 #define HTTP_NAME_ON_ERROR JS_EVENT_PREFIX"error"
 
+#define SOCKET_DEFAULT_HIGH_WATER (STREAM_MAX_BUFFER_SIZE*4) // bytes
+
 #define DGRAM_NAME_ON_MESSAGE JS_EVENT_PREFIX"message"
+#define DGRAM_NAME_ON_MESSAGES JS_EVENT_PREFIX"messages"
+#define DGRAM_NAME_RING0 "dgR0"     // ArrayBuffers that batched datagrams are received into, alternately
+#define DGRAM_NAME_RING1 "dgR1"
+#define DGRAM_NAME_RING_HALF "dgH"  // which of the two buffers is filled next
+#define DGRAM_BATCH_MAX 64          // most datagrams delivered in one 'messages' event
+#define DGRAM_SEND_MAX 16           // most datagrams sent each time around the idle loop
+
+#define WS_NAME_MASK "wsMsk"      // boolean: mask the frames we send (client side)
+#define WS_NAME_ACCEPT "wsAcc"    // Sec-WebSocket-Accept we expect back from the server (client side)
+#define WS_NAME_FRAGMENT "wsFrg"  // data of a fragmented message received so far
+#define WS_NAME_FRAGMENT_OP "wsOp" // opcode of the fragmented message
+#define WS_NAME_CLOSING "wsCls"   // boolean: we have sent a close frame
+#define WS_NAME_PENDING "wsPnd"   // boolean: frames received before we opened are waiting in dRcv
+#define WS_NAME_ON_OPEN JS_EVENT_PREFIX"open"
+#define WS_NAME_ON_MESSAGE JS_EVENT_PREFIX"message"
+#define WS_NAME_ON_PING JS_EVENT_PREFIX"ping"
+#define WS_NAME_ON_PONG JS_EVENT_PREFIX"pong"
 
 #define HTTP_ARRAY_HTTP_CLIENT_CONNECTIONS "HttpCC"
 #define HTTP_ARRAY_HTTP_SERVERS "HttpS"
@@ -66,6 +96,8 @@ static char DBG_LIB[] = "socketserver"; // library name
 
 // -----------------------------
 
+static bool fireErrorEvent(int error, JsVar *obj1, JsVar *obj2);
+
 static ALWAYS_INLINE bool compareTransferEncodingAndUnlock(JsVar *encoding, char *value) {
     // RFC 2616: All transfer-coding values are case-insensitive.
     return jsvIsStringIEqualAndUnLock(encoding, value);
@@ -232,6 +264,78 @@ bool _socketConnectionOpen(JsVar *connection) {
            jsvGetBoolAndUnLock(jsvObjectGetChild(connection, HTTP_NAME_CLOSE, false)));
 }
 
+/// Get the buffer of data waiting to be sent on this connection (creating it if needed)
+JsVar *socketGetSendData(JsVar *connection) {
+  JsVar *sendData = jsvObjectGetChild(connection, HTTP_NAME_SEND_DATA, 0);
+  if (!sendData) {
+    sendData = jsvNewFromEmptyString();
+    if (sendData) jsvObjectSetChild(connection, HTTP_NAME_SEND_DATA, sendData);
+  }
+  return sendData;
+}
+
+/// Get the options the connection was created with
+JsVar *socketGetOptions(JsVar *connection) {
+  return jsvObjectGetChild(connection, HTTP_NAME_OPTIONS_VAR, 0);
+}
+
+/// Stop (or restart) reading data for the Socket/httpSRq/httpCRs
+void socketSetPaused(JsVar *reader, bool paused) {
+  if (paused)
+    jsvObjectSetChildAndUnLock(reader, HTTP_NAME_PAUSED, jsvNewFromBool(true));
+  else
+    jsvObjectRemoveChild(reader, HTTP_NAME_PAUSED);
+}
+
+bool socketIsPaused(JsVar *reader) {
+  return jsvGetBoolAndUnLock(jsvObjectGetChild(reader, HTTP_NAME_PAUSED, 0));
+}
+
+/// Set how much data we buffer before we stop reading. 0 uses the default
+void socketSetHighWaterMark(JsVar *reader, int bytes, int minFreePercent) {
+  if (bytes>0) jsvObjectSetChildAndUnLock(reader, HTTP_NAME_HIGH_WATER, jsvNewFromInteger(bytes));
+  else jsvObjectRemoveChild(reader, HTTP_NAME_HIGH_WATER);
+  if (minFreePercent>0) jsvObjectSetChildAndUnLock(reader, HTTP_NAME_MIN_FREE, jsvNewFromInteger(minFreePercent));
+  else jsvObjectRemoveChild(reader, HTTP_NAME_MIN_FREE);
+}
+
+static int socketGetHighWaterMark(JsVar *reader) {
+  int highWater = jsvGetIntegerAndUnLock(jsvObjectGetChild(reader, HTTP_NAME_HIGH_WATER, 0));
+  return highWater>0 ? highWater : SOCKET_DEFAULT_HIGH_WATER;
+}
+
+/// Can more data be written to this connection without going over the high water mark?
+bool socketCanWrite(JsVar *connection) {
+  JsVar *sendData = jsvObjectGetChild(connection, HTTP_NAME_SEND_DATA, 0);
+  size_t len = sendData ? jsvGetStringLength(sendData) : 0;
+  jsvUnLock(sendData);
+  return len < (size_t)socketGetHighWaterMark(connection);
+}
+
+/** Should we read more data from the network for this connection? We don't if
+ * the reader is paused, if too much is already buffered (in 'dRcv' and the
+ * stream's buffer), or if setHighWaterMark asked for a percentage of variables
+ * to stay free and we're below it. 'limitBytes' is false for connections that
+ * must have a whole frame in 'dRcv' before it's handled.
+ *
+ * There's no default free variable limit - if every socket stopped reading
+ * when memory got low, none of them would see the other end close. */
+static bool socketCanReceive(JsVar *connection, JsVar *reader, bool limitBytes) {
+  if (socketIsPaused(reader)) return false;
+  int minFree = jsvGetIntegerAndUnLock(jsvObjectGetChild(reader, HTTP_NAME_MIN_FREE, 0));
+  if (minFree>0) {
+    unsigned int total = jsvGetMemoryTotal();
+    if ((total - jsvGetMemoryUsage())*100 < total*(unsigned int)minFree) return false;
+  }
+  if (!limitBytes) return true;
+  JsVar *receiveData = jsvObjectGetChild(connection, HTTP_NAME_RECEIVE_DATA, 0);
+  JsVar *buffer = jsvObjectGetChild(reader, STREAM_BUFFER_NAME, 0);
+  size_t buffered = (receiveData ? jsvGetStringLength(receiveData) : 0) +
+                    (buffer ? jsvGetStringLength(buffer) : 0);
+  jsvUnLock2(receiveData, buffer);
+  return buffered < (size_t)socketGetHighWaterMark(reader);
+}
+
 // -----------------------------
 
 NO_INLINE static void _socketCloseAllConnectionsFor(JsNetwork *net, char *name) {
@@ -257,27 +361,54 @@ NO_INLINE static void _socketCloseAllConnections(JsNetwork *net) {
   _socketCloseAllConnectionsFor(net, HTTP_ARRAY_HTTP_SERVERS);
 }
 
+/* Send the datagram starting at 'offset' in sendData. This is separate so that
+ * the stack it allocates is freed before the next datagram is sent */
+static NO_INLINE int socketSendUDPPacket(JsNetwork *net, SocketType socketType, int sckt, JsVar *sendData, size_t offset) {
+  JsNetUDPPacketHeader header;
+  if (jsvGetStringChars(sendData, offset, (char*)&header, sizeof(header)) < sizeof(header))
+    return 0; // not enough data for header!
+  size_t len = sizeof(header) + header.length;
+  if (len+1024 > jsuGetFreeStack()) {
+    jsExceptionHere(JSET_ERROR, "Not enough free stack to send this amount of data");
+    return -1;
+  }
+  char *buf = alloca(len); // allocate on stack
+  jsvGetStringChars(sendData, offset, buf, len);
+  return netSend(net, socketType, sckt, buf, len);
+}
+
+// Send as many queued datagrams as we can (up to DGRAM_SEND_MAX). Returns bytes sent or a (negative) error
+static int socketSendUDPData(JsNetwork *net, SocketType socketType, int sckt, JsVar *sendData) {
+  size_t total = jsvGetStringLength(sendData);
+  size_t sent = 0;
+  int packets = 0;
+  while (sent < total && packets++ < DGRAM_SEND_MAX) {
+    int num = socketSendUDPPacket(net, socketType, sckt, sendData, sent);
+    if (num < 0) return sent ? (int)sent : num;
+    if (num == 0) break; // not ready
+    sent += (size_t)num;
+  }
+  return (int)sent;
+}
+
 // returns 0 on success and a (negative) error number on failure
 int socketSendData(JsNetwork *net, JsVar *connection, int sckt, JsVar **sendData) {
   SocketType socketType = socketGetType(connection);
 
   assert(!jsvIsEmptyString(*sendData));
 
-  size_t sndBufLen;
+  int num;
   if ((socketType&ST_TYPE_MASK)==ST_UDP) {
-      sndBufLen = (size_t)jsvGetStringLength(*sendData);
-      if (sndBufLen+1024 > jsuGetFreeStack()) {
-          jsExceptionHere(JSET_ERROR, "Not enough free stack to send this amount of data");
-          return -1;
-      }
+    num = socketSendUDPData(net, socketType, sckt, *sendData);
+    DBG("socketSendData UDP (%d)\n", num);
   } else {
-      sndBufLen = (size_t)net->chunkSize;
-  }
-  char *buf = alloca(sndBufLen); // allocate on stack
+    size_t sndBufLen = (size_t)net->chunkSize;
+    char *buf = alloca(sndBufLen); // allocate on stack
 
-  size_t bufLen = httpStringGet(*sendData, buf, sndBufLen);
-  int num = netSend(net, socketType, sckt, buf, bufLen);
-  DBG("socketSendData %x:%d (%d -> %d)\n", *(uint32_t*)buf, *(unsigned short*)(buf+sizeof(uint32_t)), bufLen, num);
+    size_t bufLen = httpStringGet(*sendData, buf, sndBufLen);
+    num = netSend(net, socketType, sckt, buf, bufLen);
+    DBG("socketSendData %x:%d (%d -> %d)\n", *(uint32_t*)buf, *(unsigned short*)(buf+sizeof(uint32_t)), bufLen, num);
+  }
   if (num < 0) return num; // an error occurred
   // Now cut what we managed to send off the beginning of sendData
   if (num > 0) {
@@ -408,11 +539,450 @@ void socketReceivedUDP(JsVar *connection, JsVar **receiveData) {
   }
 }
 
+/// How many datagrams to deliver in each 'messages' event, or 0 if batching isn't enabled
+static int socketGetUDPBatch(JsVar *connection) {
+  JsVar *options = socketGetOptions(connection);
+  int batch = options ? (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "batch", 0)) : 0;
+  jsvUnLock(options);
+  if (batch > DGRAM_BATCH_MAX) batch = DGRAM_BATCH_MAX;
+  return batch>0 ? batch : 0;
+}
+
+/* Read all waiting datagrams (up to 'batch') into one of two buffers that are
+ * used alternately, and fire a single 'messages' event for them. Each buffer
+ * is [batch headers][batch payloads of chunkSize-header bytes]. Returns the number
+ * of datagrams received, or a (negative) error */
+static int socketReceivedUDPBatch(JsNetwork *net, JsVar *connection, SocketType socketType, int sckt, char *buf, int batch) {
+  size_t slotSize = (size_t)net->chunkSize - sizeof(JsNetUDPPacketHeader);
+  size_t bufSize = (size_t)batch * (sizeof(JsNetUDPPacketHeader) + slotSize);
+  int half = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(connection, DGRAM_NAME_RING_HALF, 0)) & 1;
+  const char *ringName = half ? DGRAM_NAME_RING1 : DGRAM_NAME_RING0;
+  char *ring = 0;
+  JsVar *ringVar = jsvObjectGetChild(connection, ringName, 0);
+  /* The views we handed out for the last batch in this buffer reference it. If
+   * they still do (the 'messages' event hasn't run yet because we've been
+   * polled again first, or JS kept them) we use a new buffer rather than
+   * overwrite data JS hasn't seen. Normally only our own reference is left. */
+  if (ringVar && jsvGetRefs(ringVar)<=1) {
+    size_t len = 0;
+    ring = jsvGetDataPointer(ringVar, &len);
+    if (len != bufSize) ring = 0; // sizes have changed
+  }
+  if (!ring) {
+    jsvUnLock(ringVar);
+    ringVar = jsvNewArrayBufferWithPtr((unsigned int)bufSize, &ring);
+    if (!ringVar) return 0; // out of memory - leave the data in the network stack
+    jsvObjectSetChild(connection, ringName, ringVar);
+  }
+  size_t payloadOffset = (size_t)batch*sizeof(JsNetUDPPacketHeader); // headers come first
+  uint16_t lengths[DGRAM_BATCH_MAX];
+
+  int count = 0;
+  while (count < batch) {
+    int num = netRecv(net, socketType, sckt, buf, (size_t)net->chunkSize);
+    if (num < 0 && !count) {
+      jsvUnLock(ringVar);
+      return num;
+    }
+    if (num < (int)sizeof(JsNetUDPPacketHeader)) break; // nothing more waiting
+    JsNetUDPPacketHeader *header = (JsNetUDPPacketHeader*)buf;
+    if (header->length > slotSize) header->length = (uint16_t)slotSize;
+    memcpy(&ring[(size_t)count*sizeof(JsNetUDPPacketHeader)], header, sizeof(JsNetUDPPacketHeader));
+    memcpy(&ring[payloadOffset + (size_t)count*slotSize], &buf[sizeof(JsNetUDPPacketHeader)], header->length);
+    lengths[count++] = header->length;
+  }
+
+  if (count) {
+    JsVar *msgs = jsvNewEmptyArray();
+    if (msgs) {
+      for (int i=0;i<count;i++)
+        jsvArrayPushAndUnLock(msgs, jswrap_typedarray_constructor(ARRAYBUFFERVIEW_UINT8, ringVar,
+            (JsVarInt)(payloadOffset + (size_t)i*slotSize), lengths[i]));
+      JsVar *info = jswrap_dataview_constructor(ringVar, 0, count*(int)sizeof(JsNetUDPPacketHeader));
+      JsVar *args[2] = { msgs, info };
+      jsiQueueObjectCallbacks(connection, DGRAM_NAME_ON_MESSAGES, args, 2);
+      jsvUnLock2(msgs, info);
+    }
+    jsvObjectSetChildAndUnLock(connection, DGRAM_NAME_RING_HALF, jsvNewFromInteger(!half));
+  }
+  jsvUnLock(ringVar);
+  return count;
+}
+
+// ----------------------------- WebSockets (RFC 6455)
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_MAX_HEADER_LEN 14 // 2 bytes + 8 byte length + 4 byte mask
+#define WS_CHUNK_LEN 64 // bytes we (un)mask on the stack at a time
+#ifndef WS_MAX_MESSAGE_LEN
+#define WS_MAX_MESSAGE_LEN 32768 // longest message (or fragmented message) we'll receive
+#endif
+
+/// Work out the Sec-WebSocket-Accept value for the given Sec-WebSocket-Key
+static JsVar *wsGetAcceptKey(JsVar *key) {
+  char buf[64+sizeof(WS_GUID)];
+  size_t len = jsvGetString(key, buf, 64);
+  memcpy(&buf[len], WS_GUID, sizeof(WS_GUID)-1);
+  len += sizeof(WS_GUID)-1;
+  unsigned char hash[20];
+  mbedtls_sha1((unsigned char *)buf, len, hash);
+  JsVar *hashStr = jsvNewStringOfLength(sizeof(hash), (char*)hash);
+  JsVar *accept = jswrap_btoa(hashStr);
+  jsvUnLock(hashStr);
+  return accept;
+}
+
+/** Append the header of a single (unfragmented) frame with a 'len' byte
+ * payload to the given send buffer. If key is set, the frame is masked
+ * and a random masking key is written to it */
+static void wsAppendFrameHeader(JsVar *sendData, WsOpcode opcode, size_t len, unsigned char *key) {
+  unsigned char hdr[WS_MAX_HEADER_LEN];
+  size_t hdrLen = 2;
+  hdr[0] = (unsigned char)(0x80 | opcode); // FIN - we never fragment what we send
+  if (len < 126) {
+    hdr[1] = (unsigned char)len;
+  } else if (len < 65536) {
+    hdr[1] = 126;
+    hdr[2] = (unsigned char)(len>>8);
+    hdr[3] = (unsigned char)len;
+    hdrLen = 4;
+  } else {
+    hdr[1] = 127;
+    memset(&hdr[2], 0, 4);
+    hdr[6] = (unsigned char)(len>>24);
+    hdr[7] = (unsigned char)(len>>16);
+    hdr[8] = (unsigned char)(len>>8);
+    hdr[9] = (unsigned char)len;
+    hdrLen = 10;
+  }
+  if (key) {
+    uint32_t r = (uint32_t)jshGetRandomNumber();
+    memcpy(key, &r, 4);
+    hdr[1] |= 0x80;
+    memcpy(&hdr[hdrLen], key, 4);
+    hdrLen += 4;
+  }
+  jsvAppendStringBuf(sendData, (const char*)hdr, hdrLen);
+}
+
+typedef struct {
+  JsVar *sendData;
+  const unsigned char *key; ///< masking key, or 0
+  size_t pos; ///< bytes of payload appended so far
+} WsAppendInfo;
+
+/// Append part of a frame's payload, masking it (a chunk at a time on the stack) if needed
+static void wsAppendPayload(unsigned char *data, unsigned int len, void *callbackData) {
+  WsAppendInfo *info = (WsAppendInfo*)callbackData;
+  if (!info->key) {
+    jsvAppendStringBuf(info->sendData, (const char*)data, len);
+    info->pos += len;
+    return;
+  }
+  char buf[WS_CHUNK_LEN];
+  unsigned int i = 0;
+  while (i < len) {
+    unsigned int n = len-i;
+    if (n > WS_CHUNK_LEN) n = WS_CHUNK_LEN;
+    unsigned int j;
+    for (j=0;j<n;j++)
+      buf[j] = (char)(data[i+j] ^ info->key[(info->pos+j)&3]);
+    jsvAppendStringBuf(info->sendData, buf, n);
+    info->pos += n;
+    i += n;
+  }
+}
+
+/// Get the buffer to send frames on this WebSocket into, and whether they need masking
+static JsVar *wsGetSendData(JsVar *ws, bool *mask) {
+  *mask = jsvGetBoolAndUnLock(jsvObjectGetChild(ws, WS_NAME_MASK, 0));
+  return socketGetSendData(ws);
+}
+
+static void wsSendFrame(JsVar *ws, WsOpcode opcode, const char *data, size_t len) {
+  bool mask;
+  JsVar *sendData = wsGetSendData(ws, &mask);
+  if (!sendData) return; // out of memory
+  unsigned char key[4];
+  wsAppendFrameHeader(sendData, opcode, len, mask ? key : 0);
+  WsAppendInfo info = { sendData, mask ? key : 0, 0 };
+  wsAppendPayload((unsigned char*)data, (unsigned int)len, &info);
+  jsvUnLock(sendData);
+}
+
+/// Send a frame containing 'data' (String, ArrayBuffer or array), without copying it all onto the stack first
+static void wsSendFrameVar(JsVar *ws, WsOpcode opcode, JsVar *data) {
+  bool mask;
+  JsVar *sendData = wsGetSendData(ws, &mask);
+  if (!sendData) return; // out of memory
+  unsigned char key[4];
+  wsAppendFrameHeader(sendData, opcode, jsvIterateCallbackCount(data), mask ? key : 0);
+  WsAppendInfo info = { sendData, mask ? key : 0, 0 };
+  jsvIterateBufferCallback(data, wsAppendPayload, &info);
+  jsvUnLock(sendData);
+}
+
+/** Copy len bytes at 'offset' in 'src' into a new string, unmasking with 'key'
+ * (if set). Bigger payloads go into a flat string so they can be used directly
+ * as an ArrayBuffer */
+static JsVar *wsNewPayload(JsVar *src, size_t offset, size_t len, const unsigned char *key) {
+  JsvStringIterator it;
+  size_t i = 0;
+  JsVar *dst = (len > WS_CHUNK_LEN) ? jsvNewFlatStringOfLength((unsigned int)len) : 0;
+  if (dst) {
+    char *ptr = jsvGetFlatStringPointer(dst);
+    jsvStringIteratorNew(&it, src, offset);
+    for (i=0;i<len;i++) {
+      char ch = jsvStringIteratorGetCharAndNext(&it);
+      ptr[i] = key ? (char)(ch ^ key[i&3]) : ch;
+    }
+    jsvStringIteratorFree(&it);
+    return dst;
+  }
+  dst = jsvNewFromEmptyString();
+  if (!dst) return 0; // out of memory
+  char buf[WS_CHUNK_LEN];
+  jsvStringIteratorNew(&it, src, offset);
+  while (i < len) {
+    size_t n = len-i;
+    if (n > WS_CHUNK_LEN) n = WS_CHUNK_LEN;
+    size_t j;
+    for (j=0;j<n;j++) {
+      char ch = jsvStringIteratorGetCharAndNext(&it);
+      buf[j] = key ? (char)(ch ^ key[(i+j)&3]) : ch;
+    }
+    jsvAppendStringBuf(dst, buf, n);
+    i += n;
+  }
+  jsvStringIteratorFree(&it);
+  return dst;
+}
+
+/// Ask for the connection to be closed with the given status code (once the close frame is sent)
+static void wsStartClose(JsVar *ws, int code) {
+  if (!jsvGetBoolAndUnLock(jsvObjectGetChild(ws, WS_NAME_CLOSING, 0))) {
+    char status[2] = { (char)(code>>8), (char)code };
+    wsSendFrame(ws, WS_OPCODE_CLOSE, status, sizeof(status));
+    jsvObjectSetChildAndUnLock(ws, WS_NAME_CLOSING, jsvNewFromBool(true));
+  }
+  jsvObjectSetChildAndUnLock(ws, HTTP_NAME_CLOSE, jsvNewFromBool(true));
+}
+
+/// Handle one complete frame. 'payload' has already been unmasked
+static void wsHandleFrame(JsVar *ws, bool fin, WsOpcode opcode, JsVar *payload) {
+  JsVar *message;
+  switch (opcode) {
+  case WS_OPCODE_CONTINUATION:
+  case WS_OPCODE_TEXT:
+  case WS_OPCODE_BINARY:
+    if (opcode == WS_OPCODE_CONTINUATION) {
+      message = jsvObjectGetChild(ws, WS_NAME_FRAGMENT, 0);
+      if (!message) return; // continuation without a start - ignore it
+      if (jsvGetStringLength(message)+jsvGetStringLength(payload) > WS_MAX_MESSAGE_LEN) {
+        jsvUnLock(message);
+        jsvObjectRemoveChild(ws, WS_NAME_FRAGMENT);
+        jsvObjectRemoveChild(ws, WS_NAME_FRAGMENT_OP);
+        fireErrorEvent(SOCKET_ERR_WS_INVALID, ws, NULL);
+        wsStartClose(ws, 1009); // message too big
+        return;
+      }
+      jsvAppendStringVarComplete(message, payload);
+      if (!fin) {
+        jsvUnLock(message);
+        return;
+      }
+      opcode = (WsOpcode)jsvGetIntegerAndUnLock(jsvObjectGetChild(ws, WS_NAME_FRAGMENT_OP, 0));
+      jsvObjectRemoveChild(ws, WS_NAME_FRAGMENT);
+      jsvObjectRemoveChild(ws, WS_NAME_FRAGMENT_OP);
+    } else if (!fin) {
+      // first part of a fragmented message - copy into a normal string we can append to
+      JsVar *fragment = jsvNewFromEmptyString();
+      if (fragment) {
+        jsvAppendStringVarComplete(fragment, payload);
+        jsvObjectSetChildAndUnLock(ws, WS_NAME_FRAGMENT, fragment);
+        jsvObjectSetChildAndUnLock(ws, WS_NAME_FRAGMENT_OP, jsvNewFromInteger(opcode));
+      }
+      return;
+    } else {
+      message = jsvLockAgain(payload);
+    }
+    if (opcode == WS_OPCODE_BINARY) {
+      JsVar *ab = jsvNewArrayBufferFromString(message, 0);
+      if (ab) {
+        jsvUnLock(message);
+        message = ab;
+      }
+    }
+    jsiQueueObjectCallbacks(ws, WS_NAME_ON_MESSAGE, &message, 1);
+    jsvUnLock(message);
+    break;
+  case WS_OPCODE_PING: {
+    wsSendFrameVar(ws, WS_OPCODE_PONG, payload);
+    jsiQueueObjectCallbacks(ws, WS_NAME_ON_PING, &payload, 1);
+    break;
+  }
+  case WS_OPCODE_PONG:
+    jsiQueueObjectCallbacks(ws, WS_NAME_ON_PONG, &payload, 1);
+    break;
+  case WS_OPCODE_CLOSE: {
+    // echo back the status code we were sent
+    char status[2];
+    int code = 1000;
+    if (jsvGetStringChars(payload, 0, status, sizeof(status))==sizeof(status))
+      code = ((unsigned char)status[0]<<8) | (unsigned char)status[1];
+    wsStartClose(ws, code);
+    break;
+  }
+  default:
+    fireErrorEvent(SOCKET_ERR_WS_INVALID, ws, NULL);
+    wsStartClose(ws, 1002); // protocol error
+    break;
+  }
+}
+
+/// Check the server's response to our upgrade request. Returns true if we're now connected
+static bool wsCheckHandshake(JsVar *ws) {
+  JsVar *status = jsvObjectGetChild(ws, "statusCode", 0);
+  JsVar *headers = jsvObjectGetChild(ws, HTTP_NAME_HEADERS, 0);
+  JsVar *accept = jsvIsObject(headers) ? jsvObjectGetChildI(headers, "Sec-WebSocket-Accept") : 0;
+  JsVar *expected = jsvObjectGetChild(ws, WS_NAME_ACCEPT, 0);
+  bool ok = jsvIsStringEqual(status, "101") && jsvIsString(accept) && jsvIsString(expected) &&
+            jsvCompareString(accept, expected, 0, 0, false)==0;
+  jsvUnLock4(status, headers, accept, expected);
+  return ok;
+}
+
+/// Handle data received on a WebSocket - any handshake response, then all complete frames
+static void wsReceived(JsVar *ws, JsVar **receiveData) {
+  if (!jsvGetBoolAndUnLock(jsvObjectGetChild(ws, HTTP_NAME_HAD_HEADERS, 0))) {
+    // We're a client waiting for '101 Switching Protocols'
+    if (!httpParseHeaders(receiveData, ws, false)) return;
+    if (!wsCheckHandshake(ws)) {
+      fireErrorEvent(SOCKET_ERR_WS_HAND, ws, NULL);
+      jsvObjectSetChildAndUnLock(ws, HTTP_NAME_CLOSENOW, jsvNewFromBool(true));
+      return;
+    }
+    jsvObjectSetChildAndUnLock(ws, HTTP_NAME_HAD_HEADERS, jsvNewFromBool(true));
+    jsvObjectRemoveChild(ws, WS_NAME_ACCEPT);
+    jsiQueueObjectCallbacks(ws, WS_NAME_ON_OPEN, &ws, 1);
+    // parse any frames that came with the response once 'open' has been handled
+    if (*receiveData && !jsvIsEmptyString(*receiveData))
+      jsvObjectSetChildAndUnLock(ws, WS_NAME_PENDING, jsvNewFromBool(true));
+    return;
+  }
+
+  // frames from a client must be masked, and frames from a server must not be
+  bool isClient = jsvGetBoolAndUnLock(jsvObjectGetChild(ws, WS_NAME_MASK, 0));
+  size_t len = jsvGetStringLength(*receiveData);
+  size_t pos = 0;
+  while (len-pos >= 2) {
+    unsigned char hdr[WS_MAX_HEADER_LEN];
+    size_t hdrAvail = jsvGetStringChars(*receiveData, pos, (char*)hdr, sizeof(hdr));
+    bool fin = (hdr[0]&0x80)!=0;
+    WsOpcode opcode = (WsOpcode)(hdr[0]&0x0F);
+    bool masked = (hdr[1]&0x80)!=0;
+    if ((hdr[0]&0x70) || // RSV bits, but we never negotiate extensions
+        masked==isClient ||
+        ((opcode&8) && (!fin || (hdr[1]&0x7F)>125))) { // control frames can't be fragmented or long
+      fireErrorEvent(SOCKET_ERR_WS_INVALID, ws, NULL);
+      wsStartClose(ws, 1002); // protocol error
+      pos = len;
+      break;
+    }
+    size_t hdrLen = 2;
+    size_t payloadLen = hdr[1]&0x7F;
+    if (payloadLen == 126) {
+      hdrLen = 4;
+      if (hdrAvail < hdrLen) break;
+      payloadLen = ((size_t)hdr[2]<<8) | hdr[3];
+    } else if (payloadLen == 127) {
+      hdrLen = 10;
+      if (hdrAvail < hdrLen) break;
+      if (hdr[2] | hdr[3] | hdr[4] | hdr[5]) // >4GB
+        payloadLen = (size_t)-1;
+      else
+        payloadLen = ((size_t)hdr[6]<<24) | ((size_t)hdr[7]<<16) | ((size_t)hdr[8]<<8) | hdr[9];
+    }
+    if (payloadLen > WS_MAX_MESSAGE_LEN) {
+      fireErrorEvent(SOCKET_ERR_WS_INVALID, ws, NULL);
+      wsStartClose(ws, 1009); // message too big
+      pos = len;
+      break;
+    }
+    const unsigned char *key = 0;
+    if (masked) {
+      key = &hdr[hdrLen];
+      hdrLen += 4;
+      if (hdrAvail < hdrLen) break;
+    }
+    if (payloadLen > len-pos-hdrLen) break; // wait for the rest of the frame
+    JsVar *payload = wsNewPayload(*receiveData, pos+hdrLen, payloadLen, key);
+    pos += hdrLen+payloadLen;
+    if (!payload) { // out of memory
+      fireErrorEvent(SOCKET_ERR_MEM, ws, NULL);
+      jsvObjectSetChildAndUnLock(ws, HTTP_NAME_CLOSENOW, jsvNewFromBool(true));
+      pos = len;
+      break;
+    }
+    wsHandleFrame(ws, fin, opcode, payload);
+    jsvUnLock(payload);
+  }
+  if (pos) {
+    // remove what we have handled, and leave any partial frame
+    JsVar *newReceiveData = (pos<len) ? jsvNewFromStringVar(*receiveData, pos, JSVAPPENDSTRINGVAR_MAXLENGTH) : 0;
+    jsvUnLock(*receiveData);
+    *receiveData = newReceiveData;
+  }
+}
+
+/// Parse frames that were received before the WebSocket opened (now the 'open' callbacks have run)
+static void wsReceivedPending(JsVar *ws) {
+  if (!jsvGetBoolAndUnLock(jsvObjectGetChild(ws, WS_NAME_PENDING, 0))) return;
+  jsvObjectRemoveChild(ws, WS_NAME_PENDING);
+  JsVar *receiveData = jsvObjectGetChild(ws, HTTP_NAME_RECEIVE_DATA, 0);
+  if (receiveData) {
+    wsReceived(ws, &receiveData);
+    jsvObjectSetChild(ws, HTTP_NAME_RECEIVE_DATA, receiveData);
+    jsvUnLock(receiveData);
+  }
+}
+
+void webSocketSend(JsVar *wsVar, WsOpcode opcode, JsVar *data) {
+  if (!_socketConnectionOpen(wsVar)) {
+    jsExceptionHere(JSET_ERROR, "This socket is closed.");
+    return;
+  }
+  if (!data) {
+    wsSendFrame(wsVar, opcode, 0, 0);
+    return;
+  }
+  wsSendFrameVar(wsVar, opcode, data);
+}
+
+void webSocketClose(JsVar *wsVar, int code) {
+  if (!_socketConnectionOpen(wsVar)) return;
+  wsStartClose(wsVar, code);
+}
+
 void socketReceived(JsVar *connection, JsVar *socket, SocketType socketType, JsVar **receiveData, bool isServer) {
   if ((socketType&ST_TYPE_MASK)==ST_UDP) {
     socketReceivedUDP(connection, receiveData);
     return;
   }
+  if ((socketType&ST_TYPE_MASK)==ST_WS) {
+    wsReceived(connection, receiveData);
+    return;
+  }
+#ifdef USE_MQTT
+  if ((socketType&ST_TYPE_MASK)==ST_MQTT) {
+    int error = mqttReceived(connection, receiveData);
+    if (error < 0) {
+      fireErrorEvent(error, connection, NULL);
+      jsvObjectSetChildAndUnLock(connection, HTTP_NAME_CLOSENOW, jsvNewFromBool(true));
+    }
+    return;
+  }
+#endif
   JsVar *reader = isServer ? connection : socket;
   bool isHttp = (socketType&ST_TYPE_MASK)==ST_HTTP;
   bool hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(reader,HTTP_NAME_HAD_HEADERS,0));
@@ -434,8 +1004,8 @@ void socketReceived(JsVar *connection, JsVar *socket, SocketType socketType, JsV
     }
     jsvObjectSetChildAndUnLock(reader, HTTP_NAME_HAD_HEADERS, jsvNewFromBool(hadHeaders));
   }
-  if (!hadHeaders) {
-    // no headers yet, no 'data' callback
+  if (!hadHeaders || socketIsPaused(reader)) {
+    // no headers yet (or paused), no 'data' callback
     return;
   }
   socketPushReceiveData(reader, receiveData, isHttp, false);
@@ -456,6 +1026,7 @@ void socketInit() {
 
 void socketKill(JsNetwork *net) {
   _socketCloseAllConnections(net);
+  dnsKill(net);
 #ifdef WIN32
    // Shutdown Winsock
    WSACleanup();
@@ -506,13 +1077,33 @@ bool socketServerConnectionsIdle(JsNetwork *net) {
     int error = 0;
 
     if (!closeConnectionNow) {
-      int num = netRecv(net, socketType, sckt, buf, (size_t)net->chunkSize);
+      bool isUdp = (socketType&ST_TYPE_MASK) == ST_UDP;
+      bool isWs = (socketType&ST_TYPE_MASK) == ST_WS;
+      bool hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_HAD_HEADERS,0));
+      if (hadHeaders && !isUdp && !isWs && !socketIsPaused(connection)) {
+        // deliver anything left over from when we were paused or the stream buffer was full
+        JsVar *receiveData = jsvObjectGetChild(connection,HTTP_NAME_RECEIVE_DATA,0);
+        if (receiveData && !jsvIsEmptyString(receiveData)) {
+          socketPushReceiveData(connection, &receiveData, isHttp, false);
+          jsvObjectSetChild(connection,HTTP_NAME_RECEIVE_DATA,receiveData);
+        }
+        jsvUnLock(receiveData);
+      } else if (isWs) {
+        wsReceivedPending(connection);
+      }
+      // only read if we have space for it - the data waits in the network stack otherwise
+      int udpBatch = isUdp ? socketGetUDPBatch(connection) : 0;
+      int num = 0;
+      if (socketCanReceive(connection, connection, hadHeaders && !isUdp && !isWs)) {
+        if (udpBatch) num = socketReceivedUDPBatch(net, connection, socketType, sckt, buf, udpBatch);
+        else num = netRecv(net, socketType, sckt, buf, (size_t)net->chunkSize);
+      }
       if (num<0) {
         // we probably disconnected so just get rid of this
         closeConnectionNow = true;
         error = num;
       } else {
-        if (num>0) {
+        if (num>0 && !udpBatch) { // batched datagrams have been delivered already
           JsVar *receiveData = jsvObjectGetChild(connection,HTTP_NAME_RECEIVE_DATA,0);
           if (!receiveData) receiveData = jsvNewFromEmptyString();
           if (receiveData) {
@@ -543,7 +1134,7 @@ bool socketServerConnectionsIdle(JsNetwork *net) {
       if ((!sendData || jsvIsEmptyString(sendData)) && num<=0) {
         bool reallyCloseNow = jsvGetBoolAndUnLock(jsvObjectGetChild(socket,HTTP_NAME_CLOSE,0));
         if (isHttp) {
-          bool hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_HAD_HEADERS,0));
+          hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_HAD_HEADERS,0));
           JsVarInt contentToReceive = jsvGetIntegerAndUnLock(jsvObjectGetChild(connection, HTTP_NAME_RECEIVE_COUNT, 0));
           if (contentToReceive > 0 || !hadHeaders) {
             reallyCloseNow = false;
@@ -561,9 +1152,9 @@ bool socketServerConnectionsIdle(JsNetwork *net) {
     if (closeConnectionNow) {
       DBG("CLOSE NOW\n");
 
-      // send out any data that we were POSTed
+      // send out any data that we were POSTed (WebSockets only ever deliver whole frames)
       bool hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_HAD_HEADERS,0));
-      if (hadHeaders) {
+      if (hadHeaders && (socketType&ST_TYPE_MASK)!=ST_WS) {
         // execute 'data' callback or save data
         JsVar *receiveData = jsvObjectGetChild(connection,HTTP_NAME_RECEIVE_DATA,0);
         socketPushReceiveData(connection, &receiveData, isHttp, true);
@@ -615,6 +1206,9 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
     JsVar *connection = jsvObjectIteratorGetValue(&it);
     SocketType socketType = socketGetType(connection);
     bool isHttp = (socketType&ST_TYPE_MASK) == ST_HTTP;
+    bool isWs = (socketType&ST_TYPE_MASK) == ST_WS;
+    // WebSocket and MQTT data is parsed into messages natively, and never pushed out as 'data'
+    bool isFramed = isWs || (socketType&ST_TYPE_MASK) == ST_MQTT;
     JsVar *socket = isHttp ? jsvObjectGetChild(connection,HTTP_NAME_RESPONSE_VAR,0) : jsvLockAgain(connection);
     bool socketClosed = false;
     JsVar *receiveData = 0;
@@ -625,15 +1219,16 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
     bool alreadyConnected = jsvGetBoolAndUnLock(jsvObjectGetChild(connection, HTTP_NAME_CONNECTED, false));
     int sckt = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_SOCKET,0))-1; // so -1 if undefined
     if (sckt>=0) {
-      if (isHttp)
+      if (isHttp || isWs)
         hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(socket,HTTP_NAME_HAD_HEADERS,0));
       else
         hadHeaders = true;
+      if (isWs && hadHeaders) wsReceivedPending(connection);
       receiveData = jsvObjectGetChild(connection,HTTP_NAME_RECEIVE_DATA,0);
 
       /* We do this up here because we want to wait until we have been once
        * around the idle loop (=callbacks have been executed) before we run this */
-      if (hadHeaders)
+      if (hadHeaders && !isFramed && !socketIsPaused(socket))
         socketPushReceiveData(socket, &receiveData, isHttp, false);
 
       if (!closeConnectionNow) {
@@ -645,7 +1240,7 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
           if (error == 0) {
               num = socketSendData(net, connection, sckt, &sendData);
           }
-          if (num > 0 && !alreadyConnected && !isHttp) { // whoa, we sent something, must be connected!
+          if (num > 0 && !alreadyConnected && !isHttp && !isFramed) { // whoa, we sent something, must be connected!
             jsiQueueObjectCallbacks(connection, HTTP_NAME_ON_CONNECT, &connection, 1);
             jsvObjectSetChildAndUnLock(connection, HTTP_NAME_CONNECTED, jsvNewFromBool(true));
             alreadyConnected = true;
@@ -671,7 +1266,15 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
           }
         }
         // Now read data if possible (and we have space for it)
-        int num = netRecv(net, socketType, sckt, buf, (size_t)net->chunkSize);
+        // (plain sockets need to call netRecv to find out when they've connected)
+        bool isUdp = (socketType&ST_TYPE_MASK) == ST_UDP;
+        int udpBatch = isUdp ? socketGetUDPBatch(connection) : 0;
+        int num = 0;
+        if ((!alreadyConnected && !isHttp && !isFramed) ||
+            socketCanReceive(connection, socket, hadHeaders && !isFramed && !isUdp)) {
+          if (udpBatch) num = socketReceivedUDPBatch(net, connection, socketType, sckt, buf, udpBatch);
+          else num = netRecv(net, socketType, sckt, buf, (size_t)net->chunkSize);
+        }
         if (!alreadyConnected && num == SOCKET_ERR_NO_CONN) {
           ; // ignore... it's just telling us we're not connected yet
         } else if (num < 0) {
@@ -679,7 +1282,7 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
           // only error out when the response was not completely received
           if (num == SOCKET_ERR_CLOSED) {
             JsVarInt contentToReceive = jsvGetIntegerAndUnLock(jsvObjectGetChild(socket, HTTP_NAME_RECEIVE_COUNT, 0));
-            if (!isHttp || contentToReceive > 0 || !hadHeaders) {
+            if (isWs ? !hadHeaders : (!isHttp || contentToReceive > 0 || !hadHeaders)) {
               error = num;
               // disconnected without headers? error.
               if (!hadHeaders) error = SOCKET_ERR_NO_RESP;
@@ -689,7 +1292,7 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
           }
         } else {
           // did we just get connected?
-          if (!alreadyConnected && !isHttp) {
+          if (!alreadyConnected && !isHttp && !isFramed) { // these fire their own events once the handshake is done
             jsiQueueObjectCallbacks(connection, HTTP_NAME_ON_CONNECT, &connection, 1);
             jsvObjectSetChildAndUnLock(connection, HTTP_NAME_CONNECTED, jsvNewFromBool(true));
             alreadyConnected = true;
@@ -697,8 +1300,8 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
             if (!sendData || (int)jsvGetStringLength(sendData) == 0)
               jsiQueueObjectCallbacks(connection, HTTP_NAME_ON_DRAIN, &connection, 1);
           }
-          // got data add it to our receive buffer
-          if (num > 0) {
+          // got data add it to our receive buffer (batched datagrams have been delivered already)
+          if (num > 0 && !udpBatch) {
             if (!receiveData)
               receiveData = jsvNewFromEmptyString();
             if (receiveData) { // could be out of memory
@@ -710,12 +1313,34 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
         }
         jsvUnLock(sendData);
       }
+#ifdef USE_MQTT
+      if (!closeConnectionNow && (socketType&ST_TYPE_MASK) == ST_MQTT) {
+        // keepalive pings are sent from here, so the interpreter needn't be involved
+        int mqttError = mqttIdle(connection);
+        if (mqttError < 0) {
+          closeConnectionNow = true;
+          error = mqttError;
+        }
+      }
+#endif
+    } else if (!closeConnectionNow && jsvGetBoolAndUnLock(jsvObjectGetChild(connection, HTTP_NAME_RESOLVING, 0))) {
+      // waiting for DNS - this connects once the address is known
+      clientRequestConnect(net, connection);
+      if (jsvGetBoolAndUnLock(jsvObjectGetChild(connection, HTTP_NAME_CLOSENOW, 0))) {
+        closeConnectionNow = true;
+        error = SOCKET_ERR_NOT_FOUND;
+      }
     }
 
     if (closeConnectionNow) {
       DBG("close now\n");
 
-      socketPushReceiveData(socket, &receiveData, isHttp, true);
+      if (isFramed) {
+        // any partial frame left over can never be completed
+        jsvUnLock(receiveData);
+        receiveData = 0;
+      } else
+        socketPushReceiveData(socket, &receiveData, isHttp, true);
       if (!receiveData || jsvIsEmptyString(receiveData)) {
         // If we had data to send but the socket closed, this is an error
         JsVar *sendData = jsvObjectGetChild(connection,HTTP_NAME_SEND_DATA,0);
@@ -763,9 +1388,10 @@ bool socketIdle(JsNetwork *net) {
   if (networkState != NETWORKSTATE_ONLINE) {
     // clear all clients and servers
     _socketCloseAllConnections(net);
+    dnsKill(net);
     return false;
   }
-  bool hadSockets = false;
+  bool hadSockets = dnsIdle(net);
   JsVar *arr = socketGetArray(HTTP_ARRAY_HTTP_SERVERS,false);
   if (arr) {
     JsvObjectIterator it;
@@ -913,13 +1539,19 @@ JsVar *clientRequestNew(SocketType socketType, JsVar *options, JsVar *callback)
     req = jspNewObject(0, "httpCRq");
   } else if ((socketType&ST_TYPE_MASK)==ST_UDP) {
     req = jspNewObject(0, "dgramSocket");
+  } else if ((socketType&ST_TYPE_MASK)==ST_WS) {
+    req = jspNewObject(0, "WebSocket");
+#ifdef USE_MQTT
+  } else if ((socketType&ST_TYPE_MASK)==ST_MQTT) {
+    req = jspNewObject(0, "MQTTClient");
+#endif
   } else {
     req = jspNewObject(0, "Socket");
   }
   if (req) { // out of memory?
    socketSetType(req, socketType);
    if (callback != NULL)
-     jsvUnLock(jsvAddNamedChild(req, callback, HTTP_NAME_ON_CONNECT));
+     jsvUnLock(jsvAddNamedChild(req, callback, ((socketType&ST_TYPE_MASK)==ST_WS) ? WS_NAME_ON_OPEN : HTTP_NAME_ON_CONNECT));
 
    jsvArrayPush(arr, req);
    if (res)
@@ -930,6 +1562,26 @@ JsVar *clientRequestNew(SocketType socketType, JsVar *options, JsVar *callback)
   return req;
 }
 
+static uint32_t socketGetHostAddr(JsNetwork *net, JsVar *host) {
+  char hostName[128];
+  jsvGetString(host, hostName, sizeof(hostName));
+  uint32_t hostAddr = 0;
+  networkGetHostByName(net, hostName, &hostAddr);
+  return hostAddr;
+}
+
+// Append a datagram (with its header) to the data waiting to be sent. Data is a String or ArrayBuffer
+static void socketAppendUDPPacket(JsVar *sendData, uint32_t hostAddr, unsigned short portNumber, JsVar *data) {
+  JSV_GET_AS_CHAR_ARRAY(dataPtr, dataLen, data);
+  if (!dataPtr && dataLen) return; // out of memory
+  JsNetUDPPacketHeader header;
+  memcpy(header.host, &hostAddr, sizeof(header.host));
+  header.port = portNumber;
+  header.length = (uint16_t)dataLen;
+  jsvAppendStringBuf(sendData, (const char*)&header, sizeof(header));
+  jsvAppendStringBuf(sendData, dataPtr, dataLen);
+}
+
 void clientRequestWrite(JsNetwork *net, JsVar *httpClientReqVar, JsVar *data, JsVar *host, unsigned short portNumber) {
   if (!_socketConnectionOpen(httpClientReqVar)) {
     jsExceptionHere(JSET_ERROR, "This socket is closed.");
@@ -992,16 +1644,10 @@ void clientRequestWrite(JsNetwork *net, JsVar *httpClientReqVar, JsVar *data, Js
         // prefixed with the length
         jsvAppendPrintf(sendData, "%x\r\n%v\r\n", jsvGetStringLength(s), s);
       } else {
-        if ((socketType&ST_TYPE_MASK) == ST_UDP) {
-          char hostName[128];
-          jsvGetString(host, hostName, sizeof(hostName));
-          JsNetUDPPacketHeader header;
-          networkGetHostByName(net, hostName, (uint32_t*)&header.host);
-          header.port = portNumber;
-          header.length = (uint16_t)jsvGetStringLength(s);
-          jsvAppendStringBuf(sendData, (const char*)&header, sizeof(header));
-        }
-        jsvAppendStringVarComplete(sendData,s);
+        if ((socketType&ST_TYPE_MASK) == ST_UDP)
+          socketAppendUDPPacket(sendData, socketGetHostAddr(net, host), portNumber, s);
+        else
+          jsvAppendStringVarComplete(sendData,s);
       }
       jsvUnLock(s);
     }
@@ -1013,6 +1659,47 @@ void clientRequestWrite(JsNetwork *net, JsVar *httpClientReqVar, JsVar *data, Js
   }
 }
 
+/// Queue an array of datagrams to the same destination, only looking up the host once
+void clientRequestWriteUDPMany(JsNetwork *net, JsVar *httpClientReqVar, JsVar *messages, JsVar *host, unsigned short portNumber) {
+  if (!_socketConnectionOpen(httpClientReqVar)) {
+    jsExceptionHere(JSET_ERROR, "This socket is closed.");
+    return;
+  }
+  uint32_t hostAddr = socketGetHostAddr(net, host);
+  JsVar *sendData = socketGetSendData(httpClientReqVar);
+  if (!sendData) return; // out of memory
+  JsvIterator it;
+  jsvIteratorNew(&it, messages, JSIF_EVERY_ARRAY_ELEMENT);
+  while (jsvIteratorHasElement(&it)) {
+    JsVar *msg = jsvIteratorGetValue(&it);
+    if (!jsvIsString(msg) && !jsvIsArrayBuffer(msg))
+      msg = jsvAsStringAndUnLock(msg);
+    if (msg) socketAppendUDPPacket(sendData, hostAddr, portNumber, msg);
+    jsvUnLock(msg);
+    jsvIteratorNext(&it);
+  }
+  jsvIteratorFree(&it);
+  jsvUnLock(sendData);
+  // we connect on-demand with the first send
+  clientRequestConnect(net, httpClientReqVar);
+}
+
+/* Put a client connection that has closed back in the list of connections,
+ * ready to be connected again with clientRequestConnect */
+void clientRequestReopen(JsVar *httpClientReqVar) {
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_CLOSE);
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_CLOSENOW);
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_CONNECTED);
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_ENDED);
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_SEND_DATA);
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_RECEIVE_DATA);
+  JsVar *arr = socketGetArray(HTTP_ARRAY_HTTP_CLIENT_CONNECTIONS, true);
+  if (!arr) return;
+  JsVar *idx = jsvGetIndexOf(arr, httpClientReqVar, true);
+  if (!idx) jsvArrayPush(arr, httpClientReqVar);
+  jsvUnLock2(idx, arr);
+}
+
 // Connect this connection/socket
 void clientRequestConnect(JsNetwork *net, JsVar *httpClientReqVar) {
   DBG("clientRequestConnect\n");
@@ -1021,6 +1708,7 @@ void clientRequestConnect(JsNetwork *net, JsVar *httpClientReqVar) {
     return;
 
   SocketType socketType = socketGetType(httpClientReqVar);
+  bool wasResolving = jsvGetBoolAndUnLock(jsvObjectGetChild(httpClientReqVar, HTTP_NAME_RESOLVING, 0));
 
   JsVar *options = jsvObjectGetChild(httpClientReqVar, HTTP_NAME_OPTIONS_VAR, 0);
   unsigned short port = (unsigned short)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "port", 0));
@@ -1032,15 +1720,21 @@ void clientRequestConnect(JsNetwork *net, JsVar *httpClientReqVar) {
   } else {
     char hostName[128];
     jsvGetString(hostNameVar, hostName, sizeof(hostName));
-    networkGetHostByName(net, hostName, &host_addr);
+    host_addr = dnsResolve(net, hostName);
   }
   jsvUnLock(hostNameVar);
 
-
-
+  if (host_addr == DNS_RESOLVING) {
+    // the idle loop calls us again until the answer arrives
+    jsvObjectSetChildAndUnLock(httpClientReqVar, HTTP_NAME_RESOLVING, jsvNewFromBool(true));
+    jsvUnLock(options);
+    return;
+  }
+  jsvObjectRemoveChild(httpClientReqVar, HTTP_NAME_RESOLVING);
 
   if(!host_addr) {
-    jsExceptionHere(JSET_INTERNALERROR, "Unable to locate host\n");
+    // if we had to wait for DNS, the idle loop fires an 'error' event instead
+    if (!wasResolving) jsExceptionHere(JSET_INTERNALERROR, "Unable to locate host\n");
     // As this is already in the list of connections, an error will be thrown on idle anyway
     jsvObjectSetChildAndUnLock(httpClientReqVar, HTTP_NAME_CLOSENOW, jsvNewFromBool(true));
     jsvUnLock(options);
@@ -1053,7 +1747,7 @@ void clientRequestConnect(JsNetwork *net, JsVar *httpClientReqVar) {
     if (port==0) port = 443;
   }
 #endif
-  if ((socketType&ST_TYPE_MASK) == ST_HTTP) {
+  if ((socketType&ST_TYPE_MASK) == ST_HTTP || (socketType&ST_TYPE_MASK) == ST_WS) {
     if (port==0) port = 80;
   }
 
@@ -1096,6 +1790,91 @@ void clientRequestEnd(JsNetwork *net, JsVar *httpClientReqVar) {
   jsvObjectSetChildAndUnLock(httpClientReqVar, HTTP_NAME_CLOSE, jsvNewFromBool(true));
 }
 
+// Send the upgrade request for a WebSocket created with clientRequestNew, and connect
+void clientRequestWebSocket(JsNetwork *net, JsVar *wsVar) {
+  JsVar *options = jsvObjectGetChild(wsVar, HTTP_NAME_OPTIONS_VAR, 0);
+  // random 16 byte nonce for Sec-WebSocket-Key
+  char nonce[16];
+  unsigned int i;
+  for (i=0;i<sizeof(nonce);i+=4) {
+    uint32_t r = (uint32_t)jshGetRandomNumber();
+    memcpy(&nonce[i], &r, 4);
+  }
+  JsVar *nonceStr = jsvNewStringOfLength(sizeof(nonce), nonce);
+  JsVar *key = jswrap_btoa(nonceStr);
+  jsvUnLock(nonceStr);
+  jsvObjectSetChildAndUnLock(wsVar, WS_NAME_ACCEPT, wsGetAcceptKey(key));
+  jsvObjectSetChildAndUnLock(wsVar, WS_NAME_MASK, jsvNewFromBool(true));
+
+  JsVar *path = jsvObjectGetChild(options, "path", 0);
+  JsVar *host = jsvObjectGetChild(options, "host", 0);
+  int port = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "port", 0));
+  JsVar *sendData = jsvVarPrintf("GET %v HTTP/1.1\r\nUser-Agent: Espruino "JS_VERSION"\r\n", path);
+  if (port>0 && port!=80)
+    jsvAppendPrintf(sendData, "Host: %v:%d\r\n", host, port);
+  else
+    jsvAppendPrintf(sendData, "Host: %v\r\n", host);
+  jsvAppendPrintf(sendData, "Upgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: %v\r\nSec-WebSocket-Version: 13\r\n", key);
+  jsvUnLock3(path, host, key);
+  JsVar *headers = jsvObjectGetChild(options, HTTP_NAME_HEADERS, 0);
+  if (jsvIsObject(headers))
+    httpAppendHeaders(sendData, headers);
+  jsvUnLock(headers);
+  jsvAppendString(sendData, "\r\n");
+  jsvObjectSetChildAndUnLock(wsVar, HTTP_NAME_SEND_DATA, sendData);
+  jsvUnLock(options);
+
+  clientRequestConnect(net, wsVar);
+}
+
+/* Upgrade a server request to a WebSocket. The 101 response is sent from the
+ * WebSocket itself, and the request/response pair are detached from the socket */
+JsVar *serverRequestUpgrade(JsVar *httpServerReqVar) {
+  JsVar *headers = jsvObjectGetChild(httpServerReqVar, HTTP_NAME_HEADERS, 0);
+  JsVar *key = 0;
+  if (jsvIsObject(headers) &&
+      jsvIsStringIEqualAndUnLock(jsvObjectGetChildI(headers, "Upgrade"), "websocket"))
+    key = jsvObjectGetChildI(headers, "Sec-WebSocket-Key");
+  jsvUnLock(headers);
+  if (!jsvIsString(key)) {
+    jsvUnLock(key);
+    jsExceptionHere(JSET_ERROR, "Not a WebSocket upgrade request");
+    return 0;
+  }
+  JsVar *arr = socketGetArray(HTTP_ARRAY_HTTP_SERVER_CONNECTIONS, false);
+  JsVar *idx = arr ? jsvGetIndexOf(arr, httpServerReqVar, true) : 0;
+  JsVar *sckt = jsvObjectGetChild(httpServerReqVar, HTTP_NAME_SOCKET, 0);
+  JsVar *ws = (idx && sckt) ? jspNewObject(0, "WebSocket") : 0;
+  if (!ws) { // already closed, or out of memory
+    jsvUnLock4(key, arr, idx, sckt);
+    return 0;
+  }
+  socketSetType(ws, ST_WS);
+  jsvObjectSetChild(ws, HTTP_NAME_SOCKET, sckt);
+  jsvObjectSetChildAndUnLock(ws, HTTP_NAME_HAD_HEADERS, jsvNewFromBool(true));
+  JsVar *accept = wsGetAcceptKey(key);
+  jsvObjectSetChildAndUnLock(ws, HTTP_NAME_SEND_DATA, jsvVarPrintf(
+      "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: %v\r\n\r\n", accept));
+  jsvUnLock2(accept, key);
+  // anything the client already sent after the headers is the first frames
+  JsVar *receiveData = jsvObjectGetChild(httpServerReqVar, HTTP_NAME_RECEIVE_DATA, 0);
+  if (receiveData && !jsvIsEmptyString(receiveData)) {
+    jsvObjectSetChild(ws, HTTP_NAME_RECEIVE_DATA, receiveData);
+    jsvObjectSetChildAndUnLock(ws, WS_NAME_PENDING, jsvNewFromBool(true));
+  }
+  jsvUnLock(receiveData);
+  // swap the request for the WebSocket in the list of connections
+  jsvSetValueOfName(idx, ws);
+  JsVar *res = jsvObjectGetChild(httpServerReqVar, HTTP_NAME_RESPONSE_VAR, 0);
+  if (res) {
+    jsvObjectRemoveChild(res, HTTP_NAME_SOCKET);
+    jsvObjectSetChildAndUnLock(res, HTTP_NAME_CLOSE, jsvNewFromBool(true));
+  }
+  jsvObjectRemoveChild(httpServerReqVar, HTTP_NAME_SOCKET);
+  jsvUnLock4(res, arr, idx, sckt);
+  return ws;
+}
+
 void serverResponseSetHeader(JsVar *httpServerResponseVar, JsVar *name, JsVar *value) {
   name = jsvAsString(name);
   value = jsvAsString(value);
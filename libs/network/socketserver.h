@@ -34,10 +34,38 @@ JsVar *clientRequestNew(SocketType socketType, JsVar *options, JsVar *callback);
 void clientRequestWrite(JsNetwork *net, JsVar *httpClientReqVar, JsVar *data, JsVar *host, unsigned short port);
 void clientRequestConnect(JsNetwork *net, JsVar *httpClientReqVar);
 void clientRequestEnd(JsNetwork *net, JsVar *httpClientReqVar);
+void clientRequestReopen(JsVar *httpClientReqVar);
+void clientRequestWriteUDPMany(JsNetwork *net, JsVar *httpClientReqVar, JsVar *messages, JsVar *host, unsigned short port);
+
+// for protocols that are handled natively on top of a client connection
+bool _socketConnectionOpen(JsVar *connection);
+JsVar *socketGetSendData(JsVar *connection);
+JsVar *socketGetOptions(JsVar *connection);
+
+// flow control
+void socketSetPaused(JsVar *reader, bool paused);
+bool socketIsPaused(JsVar *reader);
+void socketSetHighWaterMark(JsVar *reader, int bytes, int minFreePercent);
+bool socketCanWrite(JsVar *connection);
 
 void serverResponseSetHeader(JsVar *parent, JsVar *name, JsVar *value); // for HTTP
 void serverResponseWriteHead(JsVar *httpServerResponseVar, int statusCode, JsVar *headers); // for HTTP
 void serverResponseWrite(JsVar *httpServerResponseVar, JsVar *data);
 void serverResponseEnd(JsVar *httpServerResponseVar);
 
+// -----------------------------
+typedef enum {
+  WS_OPCODE_CONTINUATION = 0x0,
+  WS_OPCODE_TEXT = 0x1,
+  WS_OPCODE_BINARY = 0x2,
+  WS_OPCODE_CLOSE = 0x8,
+  WS_OPCODE_PING = 0x9,
+  WS_OPCODE_PONG = 0xA,
+} WsOpcode;
+
+JsVar *serverRequestUpgrade(JsVar *httpServerReqVar); // for WebSockets
+void clientRequestWebSocket(JsNetwork *net, JsVar *wsVar);
+void webSocketSend(JsVar *wsVar, WsOpcode opcode, JsVar *data);
+void webSocketClose(JsVar *wsVar, int code);
+
 #endif // SOCKETSERVER_H
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+# This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+#
+# Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+# ----------------------------------------------------------------------------
+# Builds the perfect hash tables that jswFindBuiltInFunction and
+# jswIsBuiltInObject use to look up builtin symbols, from the symbol name
+# strings already in gen/jswrapper.c, and writes them back into that file.
+#
+# Each table is one seed byte per bucket, followed by one symbol index (or
+# 255 for none) per slot. A name's hash picks its bucket, and that bucket's
+# seed picks the only slot the name can be in - see jswHashSymbol and
+# jswHashGetIndex, which this must match.
+#
+# Run this whenever the symbol tables change. With --check, nothing is written
+# and it exits with an error if any table doesn't find every one of its names.
+#
+#   scripts/build_jswrapper_hash.py [--check] [gen/jswrapper.c]
+# ----------------------------------------------------------------------------
+import os
+import re
+import sys
+
+M32 = 0xFFFFFFFF
+HASH_NONE = 255 # JSW_HASH_NONE
+
+def hashSymbol(name):
+  """ FNV-1a, as jswHashSymbol """
+  h = 2166136261
+  for c in name.encode():
+    h = ((h ^ c) * 16777619) & M32
+  return h
+
+def hashSlot(h, seed, size):
+  """ The slot a hash goes in with the given seed, as jswHashGetIndex """
+  return ((((h ^ ((seed * 0x9E3779B9) & M32)) * 0x85EBCA6B) & M32) >> 16) % size
+
+def hashGetIndex(table, buckets, size, h):
+  return table[buckets + hashSlot(h, table[h % buckets], size)]
+
+def buildHash(names):
+  """ Returns (buckets, size, table) for a perfect hash of names, trying to
+  keep the table as small as possible. Both counts must fit in a byte. """
+  hs = [hashSymbol(n) for n in names]
+  n = len(names)
+  for buckets in range(max(1, (n+3)//4), n+1):
+    for size in range(n, n + n//4 + 2):
+      if buckets>255 or size>255: continue
+      groups = [[] for _ in range(buckets)]
+      for i, h in enumerate(hs): groups[h % buckets].append(i)
+      used = [False]*size
+      seeds = [0]*buckets
+      index = [HASH_NONE]*size
+      # place the biggest buckets first, while there's most room
+      for b in sorted(range(buckets), key=lambda b: -len(groups[b])):
+        for seed in range(256):
+          slots = [hashSlot(hs[i], seed, size) for i in groups[b]]
+          if len(set(slots))==len(slots) and not any(used[s] for s in slots):
+            for i, s in zip(groups[b], slots):
+              used[s] = True
+              index[s] = i
+            seeds[b] = seed
+            break
+        else:
+          break
+      else:
+        return buckets, size, seeds + index
+  raise Exception("Couldn't build a perfect hash for "+",".join(names))
+
+def cArray(name, values):
+  lines = []
+  for i in range(0, len(values), 24):
+    lines.append("  "+",".join(str(v) for v in values[i:i+24]))
+  return "static const unsigned char "+name+"[] FLASH_SECT = {\n"+",\n".join(lines)+"\n};\n"
+
+def parseNames(s):
+  return s.split("\\0")[:-1] if s else []
+
+def parseArray(src, name):
+  m = re.search(r"static const unsigned char "+name+r"\[\] FLASH_SECT = \{(.*?)\};", src, re.S)
+  return [int(x) for x in re.findall(r"\d+", m.group(1))] if m else None
+
+def symbolLists(src):
+  """ Yields (name, symbol names) for each symbol list in jswSymbolTables """
+  strs = dict((m.group(1), parseNames(m.group(2))) for m in
+              re.finditer(r'FLASH_STR\((\w+)_str, "(.*)"\);', src))
+  for m in re.finditer(r"\{jswSymbols_(\w+), jswSymbols_\1_str, \d+(?:, [^}]*)?\},", src):
+    yield m.group(1), strs["jswSymbols_"+m.group(1)]
+
+def builtInObjects(src):
+  return parseNames(re.search(r'FLASH_STR\(jswBuiltInObjects_str, "(.*)"\);', src).group(1))
+
+def regenerate(src):
+  # remove the old tables, and the blank lines they leave before jswSymbolTables
+  src = re.sub(r"static const unsigned char jswSymbols_\w+_hash\[\] FLASH_SECT = \{\n.*?\n\};\n", "", src, flags=re.S)
+  anchor = "\nconst JswSymList jswSymbolTables[] FLASH_SECT = {\n"
+  i = src.index(anchor)
+  j = i
+  while src[j-1]=="\n": j -= 1
+  tables = ""
+  entries = {}
+  for name, names in symbolLists(src):
+    if names:
+      buckets, size, table = buildHash(names)
+      tables += cArray("jswSymbols_"+name+"_hash", table)
+      entries[name] = "jswSymbols_%s_hash, %d, %d" % (name, buckets, size)
+    else:
+      entries[name] = "0, 0, 0"
+  src = src[:j] + "\n\n" + tables + src[i:]
+  src = re.sub(r"\{jswSymbols_(\w+), jswSymbols_\1_str, (\d+)(?:, [^}]*)?\},",
+               lambda m: "{jswSymbols_%s, jswSymbols_%s_str, %s, %s}," % (m.group(1), m.group(1), m.group(2), entries[m.group(1)]),
+               src)
+  # builtin objects, for jswIsBuiltInObject
+  buckets, size, table = buildHash(builtInObjects(src))
+  src = re.sub(r"static const unsigned char jswBuiltInObjects_hash\[\] FLASH_SECT = \{\n.*?\n\};\n",
+               lambda m: cArray("jswBuiltInObjects_hash", table), src, flags=re.S)
+  src = re.sub(r"jswHashGetIndex\(jswBuiltInObjects_hash, \d+, \d+,",
+               "jswHashGetIndex(jswBuiltInObjects_hash, %d, %d," % (buckets, size), src)
+  return src
+
+def checkTable(what, names, table, buckets, size):
+  """ Returns a list of problems with a hash table """
+  if not names: return [] if buckets==0 else [what+": no names but has a hash table"]
+  if table is None: return [what+": missing hash table"]
+  if len(table)!=buckets+size: return [what+": hash table is %d bytes, not %d" % (len(table), buckets+size)]
+  return [what+": can't find '"+n+"'" for i, n in enumerate(names)
+          if hashGetIndex(table, buckets, size, hashSymbol(n))!=i]
+
+def check(src):
+  errors = []
+  strs = dict((m.group(1), parseNames(m.group(2))) for m in
+              re.finditer(r'FLASH_STR\(jswSymbols_(\w+)_str, "(.*)"\);', src))
+  for m in re.finditer(r"\{jswSymbols_(\w+), jswSymbols_\1_str, (\d+), (\w+), (\d+), (\d+)\},", src):
+    name = m.group(1)
+    names = strs[name]
+    if len(names)!=int(m.group(2)):
+      errors.append(name+": has %d names, not %s" % (len(names), m.group(2)))
+    table = parseArray(src, m.group(3)) if m.group(3)!="0" else None
+    errors += checkTable(name, names, table, int(m.group(4)), int(m.group(5)))
+  if len(strs)!=len(re.findall(r"\{jswSymbols_\w+, jswSymbols_\w+_str, ", src)):
+    errors.append("jswSymbolTables has entries without hash tables")
+  m = re.search(r"jswHashGetIndex\(jswBuiltInObjects_hash, (\d+), (\d+),", src)
+  errors += checkTable("jswBuiltInObjects", builtInObjects(src), parseArray(src, "jswBuiltInObjects_hash"),
+                       int(m.group(1)), int(m.group(2)))
+  return errors
+
+if __name__ == "__main__":
+  args = [a for a in sys.argv[1:] if a!="--check"]
+  path = args[0] if args else os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "gen", "jswrapper.c")
+  src = open(path).read()
+  if "--check" in sys.argv:
+    errors = check(src)
+    for e in errors: print(path+": "+e)
+    sys.exit(1 if errors else 0)
+  open(path, "w").write(regenerate(src))
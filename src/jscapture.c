@@ -0,0 +1,278 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Timestamped edge capture and quadrature decoding for setWatch
+ *
+ * Rather than pushing one IO event per edge (and running one JS callback
+ * each time), the watch's IRQ callback writes edges straight into a ring
+ * buffer held in a flat string on the watch object. The idle loop then
+ * hands everything that arrived to JS in one go.
+ * ----------------------------------------------------------------------------
+ */
+#include "jscapture.h"
+#include "jshardware.h"
+#include "jsinteractive.h"
+#include "jsvariterator.h"
+
+#ifndef SAVE_ON_FLASH
+
+typedef struct {
+  volatile uint16_t head;     ///< next entry the IRQ will write
+  volatile uint16_t tail;     ///< next entry the idle loop will read
+  uint16_t size;              ///< entries in 'times' (one more than we can hold), 0 for quadrature
+  volatile uint16_t missed;   ///< edges dropped because the buffer was full
+  signed char edge;           ///< 1=rising, -1=falling, 0=both
+  volatile bool state;        ///< state of the pin after the last edge
+  Pin pinA, pinB;             ///< pinB is only valid when decoding quadrature
+  IOEventFlags channelA;      ///< EXTI channel of pinA
+  volatile uint8_t quadState; ///< (A<<1)|B after the last edge
+  volatile int32_t position;  ///< quadrature count
+  int32_t reported;           ///< quadrature count last passed to JS
+  JsSysTime lastTime;         ///< time of the last edge passed to JS
+  uint32_t times[];           ///< bottom 32 bits of the system time of each edge
+} JsCaptureData;
+
+/// Captures for each EXTI channel (pointers into flat strings, which never move)
+static JsCaptureData *jscaptures[EV_EXTI_MAX+1-EV_EXTI0];
+/// Set from the IRQ when something has been captured
+static volatile bool jscapturePending;
+
+/// Change in position for each (lastState<<2)|state, with A leading B counting up
+static const signed char jscaptureQuadrature[16] = {
+   0, -1,  1,  0,
+   1,  0,  0, -1,
+  -1,  0,  0,  1,
+   0,  1, -1,  0
+};
+
+void CALLED_FROM_INTERRUPT jscaptureEdge(IOEventFlags channel, bool state, JsSysTime time) {
+  channel = IOEVENTFLAGS_GETTYPE(channel);
+  if (channel<EV_EXTI0 || channel>EV_EXTI_MAX) return;
+  JsCaptureData *c = jscaptures[channel-EV_EXTI0];
+  if (!c) return;
+  if (jshIsPinValid(c->pinB)) {
+    // Only one pin has changed, so use the last known state of the other
+    bool isA = channel==c->channelA;
+    uint8_t ab = isA ? (uint8_t)((state?2:0) | (c->quadState&1)) : (uint8_t)((c->quadState&2) | (state?1:0));
+    c->position += jscaptureQuadrature[(c->quadState<<2) | ab];
+    c->quadState = ab;
+    if (isA) c->state = state;
+  } else {
+    c->state = state;
+    if ((c->edge>0 && !state) || (c->edge<0 && state)) return;
+    uint16_t next = (uint16_t)(c->head+1);
+    if (next >= c->size) next = 0;
+    if (next == c->tail) {
+      if (c->missed < 0xFFFF) c->missed++;
+      return;
+    }
+    c->times[c->head] = (uint32_t)time;
+    c->head = next;
+  }
+  jscapturePending = true;
+  jshHadEvent();
+}
+
+static void CALLED_FROM_INTERRUPT jscaptureEventCallback(bool state, IOEventFlags channel) {
+  jscaptureEdge(channel, state, jshGetSystemTime());
+}
+
+/// Point the IRQ callbacks for the given channels at a capture
+static void jscaptureArm(JsCaptureData *c, IOEventFlags exti, IOEventFlags extiB) {
+  // callbacks go last, so the IRQ never sees a half-initialised capture
+  jscaptures[exti-EV_EXTI0] = c;
+  jshSetEventCallback(exti, jscaptureEventCallback);
+  if (extiB) {
+    jscaptures[extiB-EV_EXTI0] = c;
+    jshSetEventCallback(extiB, jscaptureEventCallback);
+  }
+}
+
+static JsCaptureData *jscaptureGetData(JsVar *watchPtr) {
+  JsVar *data = jsvObjectGetChild(watchPtr, JSCAPTURE_NAME, 0);
+  JsCaptureData *c = data ? (JsCaptureData*)jsvGetFlatStringPointer(data) : 0;
+  jsvUnLock(data); // flat strings don't move, so the pointer stays valid while the watch exists
+  return c;
+}
+
+bool jscaptureSetup(JsVar *watchPtr, IOEventFlags exti, Pin pin, int edge, JsVar *buffer, Pin quadraturePin) {
+  unsigned int size = 0;
+  if (buffer) {
+    if (!jsvIsArrayBuffer(buffer) || buffer->varData.arraybuffer.type!=ARRAYBUFFERVIEW_UINT32) {
+      jsExceptionHere(JSET_TYPEERROR, "'buffer' in setWatch should be a Uint32Array");
+      return false;
+    }
+    size = (unsigned int)jsvGetArrayBufferLength(buffer);
+    if (size<1 || size>JSCAPTURE_MAX_EDGES) {
+      jsExceptionHere(JSET_ERROR, "'buffer' in setWatch should have between 1 and %d elements", JSCAPTURE_MAX_EDGES);
+      return false;
+    }
+    size++; // ring buffer needs one spare entry
+  }
+  IOEventFlags extiB = EV_NONE;
+  if (jshIsPinValid(quadraturePin)) {
+    if (jsiIsWatchingPin(quadraturePin) || !jshCanWatch(quadraturePin)) {
+      jsExceptionHere(JSET_ERROR, "Unable to watch quadrature pin %p", quadraturePin);
+      return false;
+    }
+    size = 0; // quadrature only keeps a count
+  }
+  JsVar *data = jsvNewFlatStringOfLength((unsigned int)(sizeof(JsCaptureData) + size*sizeof(uint32_t)));
+  if (!data) {
+    jsExceptionHere(JSET_ERROR, "Not enough memory for capture buffer");
+    return false;
+  }
+  if (jshIsPinValid(quadraturePin)) {
+    extiB = jshPinWatch(quadraturePin, true, JSPW_HIGH_SPEED);
+    if (!extiB) {
+      jsvUnLock(data);
+      jsExceptionHere(JSET_ERROR, "Unable to watch quadrature pin %p", quadraturePin);
+      return false;
+    }
+  }
+  JsCaptureData *c = (JsCaptureData*)jsvGetFlatStringPointer(data);
+  c->size = (uint16_t)size;
+  c->edge = (signed char)edge;
+  c->pinA = pin;
+  c->channelA = exti;
+  c->pinB = extiB ? quadraturePin : PIN_UNDEFINED;
+  c->state = jshPinInput(pin);
+  c->quadState = (uint8_t)((c->state?2:0) | ((extiB && jshPinInput(quadraturePin))?1:0));
+  c->lastTime = jshGetSystemTime();
+  jsvObjectSetChildAndUnLock(watchPtr, JSCAPTURE_NAME, data);
+  if (buffer) jsvObjectSetChild(watchPtr, "buffer", buffer);
+  jscaptureArm(c, exti, extiB);
+  return true;
+}
+
+void jscaptureRemove(JsVar *watchPtr) {
+  JsCaptureData *c = jscaptureGetData(watchPtr);
+  if (!c) return;
+  unsigned int i;
+  for (i=0;i<sizeof(jscaptures)/sizeof(JsCaptureData*);i++) {
+    if (jscaptures[i]==c) {
+      jshSetEventCallback((IOEventFlags)(EV_EXTI0+i), 0);
+      jscaptures[i] = 0;
+    }
+  }
+  if (jshIsPinValid(c->pinB) && !jsiIsWatchingPin(c->pinB))
+    jshPinWatch(c->pinB, false, JSPW_NONE);
+}
+
+/// Copy captured edges into the watch's buffer, and call its callback
+static void jscaptureDispatch(JsVar *watchPtr, JsCaptureData *c) {
+  JsVar *data = 0;
+  if (jshIsPinValid(c->pinB)) {
+    int32_t position = c->position;
+    if (position == c->reported) return;
+    data = jsvNewObject();
+    if (!data) return;
+    jsvObjectSetChildAndUnLock(data, "position", jsvNewFromInteger(position));
+    jsvObjectSetChildAndUnLock(data, "delta", jsvNewFromInteger(position - c->reported));
+    c->reported = position;
+  } else {
+    uint16_t head = c->head;
+    jshInterruptOff();
+    uint16_t missed = c->missed;
+    c->missed = 0;
+    jshInterruptOn();
+    if (head==c->tail && !missed) return;
+    data = jsvNewObject();
+    if (!data) return;
+    // Rebuild full times from the bottom 32 bits, working back from now
+    JsSysTime now = jshGetSystemTime();
+    JsSysTime firstTime = c->lastTime;
+    int count = 0;
+    JsVar *buffer = jsvObjectGetChild(watchPtr, "buffer", 0);
+    JsvArrayBufferIterator it;
+    jsvArrayBufferIteratorNew(&it, buffer, 0);
+    uint16_t tail = c->tail;
+    while (tail != head) {
+      JsSysTime t = now - (JsSysTime)(uint32_t)((uint32_t)now - c->times[tail]);
+      if (!count) firstTime = t;
+      jsvArrayBufferIteratorSetIntegerValue(&it, (JsVarInt)(jshGetMillisecondsFromTime(t-firstTime)*1000));
+      jsvArrayBufferIteratorNext(&it);
+      c->lastTime = t;
+      count++;
+      if (++tail >= c->size) tail = 0;
+    }
+    jsvArrayBufferIteratorFree(&it);
+    c->tail = tail;
+    jsvObjectSetChildAndUnLock(data, "time", jsvNewFromFloat(jshGetMillisecondsFromTime(firstTime)/1000));
+    jsvObjectSetChildAndUnLock(data, "count", jsvNewFromInteger(count));
+    jsvObjectSetChildAndUnLock(data, "missed", jsvNewFromInteger(missed));
+    jsvObjectSetChildAndUnLock(data, "buffer", buffer);
+  }
+  jsvObjectSetChildAndUnLock(data, "state", jsvNewFromBool(c->state));
+  jsvObjectSetChildAndUnLock(data, "pin", jsvNewFromPin(c->pinA));
+  JsVar *callback = jsvObjectGetChild(watchPtr, "callback", 0);
+  jsiExecuteEventCallback(0, callback, 1, &data);
+  jsvUnLock2(callback, data);
+}
+
+bool jscaptureIdle() {
+  if (!jscapturePending) return false;
+  jscapturePending = false;
+  JsVar *watchArrayPtr = jsvLock(watchArray);
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, watchArrayPtr);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+    JsCaptureData *c = jscaptureGetData(watchPtr);
+    if (c) jscaptureDispatch(watchPtr, c);
+    jsvUnLock(watchPtr);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(watchArrayPtr);
+  return true;
+}
+
+void jscaptureInit() {
+  if (!watchArray) return;
+  JsVar *watchArrayPtr = jsvLock(watchArray);
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, watchArrayPtr);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+    JsCaptureData *c = jscaptureGetData(watchPtr);
+    if (c) {
+      // anything captured before a save is stale now
+      c->head = c->tail = c->missed = 0;
+      c->lastTime = jshGetSystemTime();
+      c->channelA = jshPinWatch(c->pinA, true, JSPW_HIGH_SPEED);
+      IOEventFlags extiB = jshIsPinValid(c->pinB) ? jshPinWatch(c->pinB, true, JSPW_HIGH_SPEED) : EV_NONE;
+      if (c->channelA) jscaptureArm(c, c->channelA, extiB);
+    }
+    jsvUnLock(watchPtr);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(watchArrayPtr);
+}
+
+void jscaptureKill() {
+  if (watchArray) {
+    JsVar *watchArrayPtr = jsvLock(watchArray);
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, watchArrayPtr);
+    while (jsvObjectIteratorHasValue(&it)) {
+      JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+      jscaptureRemove(watchPtr);
+      jsvUnLock(watchPtr);
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    jsvUnLock(watchArrayPtr);
+  }
+  jscapturePending = false;
+}
+
+#endif // SAVE_ON_FLASH
@@ -0,0 +1,37 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Timestamped edge capture and quadrature decoding for setWatch
+ * ----------------------------------------------------------------------------
+ */
+#ifndef JSCAPTURE_H
+#define JSCAPTURE_H
+
+#include "jsutils.h"
+#include "jsvar.h"
+#include "jsdevices.h"
+
+#define JSCAPTURE_NAME JS_HIDDEN_CHAR_STR"cap" // flat string of JsCaptureData, on the watch object
+#define JSCAPTURE_MAX_EDGES 0xFFFE             // biggest buffer we can record into
+
+/// Set up a watch to record edges into 'buffer' (if set) or decode a quadrature encoder with B on 'quadraturePin'. Returns false on error
+bool jscaptureSetup(JsVar *watchPtr, IOEventFlags exti, Pin pin, int edge, JsVar *buffer, Pin quadraturePin);
+/// Stop capturing for a watch that is about to be removed
+void jscaptureRemove(JsVar *watchPtr);
+/// Record an edge on the given EXTI channel. Called from the IRQ, but edges can also be injected for testing
+void CALLED_FROM_INTERRUPT jscaptureEdge(IOEventFlags channel, bool state, JsSysTime time);
+/// Call the callbacks of watches that have captured edges. Returns true if it did anything
+bool jscaptureIdle();
+/// Start capturing again for watches that survived a save/load
+void jscaptureInit();
+/// Stop all captures (the watches themselves are removed elsewhere)
+void jscaptureKill();
+
+#endif // JSCAPTURE_H
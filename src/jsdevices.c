@@ -322,6 +322,37 @@ int jshGetCharToTransmit(
   return -1; // no data :(
 }
 
+/**
+ * Get as many characters for transmission as we can (up to maxChars) in one go,
+ * so drivers can hand whole blocks to the hardware.
+ * \return The number of bytes written into 'buf'
+ */
+int jshGetCharsToTransmit(
+    IOEventFlags device, // The device being looked at for a transmission.
+    unsigned char *buf,  // Where to put the data
+    int maxChars         // Size of 'buf'
+  ) {
+  int n = 0;
+  if (maxChars<=0) return 0;
+  // XON/XOFF must go before any data
+  if (DEVICE_HAS_DEVICE_STATE(device) &&
+      (jshSerialDeviceStates[TO_SERIAL_DEVICE_STATE(device)]&(SDS_XOFF_PENDING|SDS_XON_PENDING)))
+    buf[n++] = (unsigned char)jshGetCharToTransmit(device);
+  // Usually all the data at the back of the queue is for one device, so just take it
+  while (n<maxChars && txTail!=txHead &&
+         IOEVENTFLAGS_GETTYPE(txBuffer[txTail].flags) == device) {
+    buf[n++] = txBuffer[txTail].data;
+    txTail = (unsigned char)((txTail+1)&TXBUFFERMASK); // advance the tail
+  }
+  // Otherwise other devices' data is in the way, so pick ours out a character at a time
+  while (n<maxChars) {
+    int c = jshGetCharToTransmit(device);
+    if (c<0) break;
+    buf[n++] = (unsigned char)c;
+  }
+  return n;
+}
+
 void jshTransmitFlush() {
   jsiSetBusy(BUSY_TRANSMIT, true);
   while (jshHasTransmitData()) ; // wait for send to finish
@@ -227,6 +227,8 @@ bool jshHasTransmitData();
 IOEventFlags jshGetDeviceToTransmit();
 /// Try and get a character for transmission - could just return -1 if nothing
 int jshGetCharToTransmit(IOEventFlags device);
+/// Get up to maxChars characters for transmission into buf, returning how many there were
+int jshGetCharsToTransmit(IOEventFlags device, unsigned char *buf, int maxChars);
 
 
 /// Set whether the host should transmit or not
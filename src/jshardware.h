@@ -325,6 +325,11 @@ void jshSPISet16(IOEventFlags device, bool is16);
 void jshSPISetReceive(IOEventFlags device, bool isReceive);
 /** Wait until SPI send is finished, and flush all received data */
 void jshSPIWait(IOEventFlags device);
+/** Call the callbacks of any jshSPISendMany transfers that have finished, without
+ * waiting for the others. Returns how many transfers are still in progress. Hardware
+ * that can have transfers in progress should push an IO event for the SPI device
+ * when each one with a callback completes. A weak version of this function is provided in jshardware_common.c */
+int jshSPIPoll(IOEventFlags device);
 
 /// Settings passed to jshI2CSetup to set I2C up
 typedef struct {
@@ -350,6 +355,31 @@ void jshI2CWrite(IOEventFlags device, unsigned char address, int nBytes, const u
 /** Read a number of bytes from the I2C device. */
 void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned char *data, bool sendStop);
 
+/// One read or write in a jshI2CTransfer
+typedef struct {
+  unsigned char address; ///< 7 bit address
+  bool read; ///< read into data (rather than writing from it)
+  int nBytes;
+  unsigned char *data;
+} JshI2COp;
+
+/// The state of jshI2CTransfer, returned by jshI2CPoll
+typedef enum {
+  JSHI2C_IDLE, ///< Nothing in progress, and the last transfer succeeded
+  JSHI2C_BUSY, ///< An async transfer is still in progress
+  JSHI2C_ERROR, ///< The last async transfer failed
+} JshI2CStatus;
+
+/** Perform a sequence of reads and writes as one transaction, with a (repeated) start
+ * before each and a stop at the end. Returns false on failure. If async is set the
+ * hardware may return before the transfer has finished (all data must stay valid
+ * until then), pushing an IO event for the device once it has, and jshI2CPoll returns
+ * the result. A weak (synchronous) version of this function is provided in jshardware_common.c */
+bool jshI2CTransfer(IOEventFlags device, JshI2COp *ops, int opCount, bool async);
+/** Return whether an async jshI2CTransfer is still in progress, and if not whether it
+ * succeeded. A weak version of this function is provided in jshardware_common.c */
+JshI2CStatus jshI2CPoll(IOEventFlags device);
+
 /** Return start address and size of the flash page the given address resides in. Returns false if
   * the page is outside of the flash address range */
 bool jshFlashGetPage(uint32_t addr, uint32_t *startAddr, uint32_t *pageSize);
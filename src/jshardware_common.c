@@ -116,6 +116,33 @@ __attribute__((weak)) bool jshSPISendMany(IOEventFlags device, unsigned char *tx
   return true;
 }
 
+/** Call the callbacks of any finished jshSPISendMany transfers. Returns how many
+ * are still in progress - the weak jshSPISendMany above always finishes straight away */
+__attribute__((weak)) int jshSPIPoll(IOEventFlags device) {
+  NOT_USED(device);
+  return 0;
+}
+
+/** Perform a sequence of I2C reads and writes, with a stop only at the end. Returns
+ * false on failure. This one is always synchronous */
+__attribute__((weak)) bool jshI2CTransfer(IOEventFlags device, JshI2COp *ops, int opCount, bool async) {
+  NOT_USED(async);
+  for (int i=0;i<opCount && !jspHasError();i++) {
+    bool sendStop = i==opCount-1;
+    if (ops[i].read)
+      jshI2CRead(device, ops[i].address, ops[i].nBytes, ops[i].data, sendStop);
+    else
+      jshI2CWrite(device, ops[i].address, ops[i].nBytes, ops[i].data, sendStop);
+  }
+  return !jspHasError();
+}
+
+/** Return the state of the last jshI2CTransfer - the weak one above always finishes straight away */
+__attribute__((weak)) JshI2CStatus jshI2CPoll(IOEventFlags device) {
+  NOT_USED(device);
+  return JSHI2C_IDLE;
+}
+
 // Only define this if it's not used elsewhere
 __attribute__((weak)) void jshBusyIdle() {
 }
@@ -0,0 +1,158 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Simulated hardware SPI, for testing the async SPI queue (jsspi.c) without
+ * SPI hardware or a logic analyser. Build with SPI_SIMULATED defined in place
+ * of the target's own jshSPI functions.
+ *
+ * Each jshSPISendMany is a transfer that takes SPI_SIMULATED_LATENCY_US plus
+ * 8 bits per byte at the baud rate to complete. Up to SPI_SIMULATED_TRANSFERS
+ * can be queued, and when one with a callback completes an IO event is pushed
+ * for the device, as real hardware would. Every byte sent is recorded by
+ * pushing it to LoopbackB when its transfer completes, so tests can check
+ * what was sent and in what order. MISO is MOSI looped back.
+ * ----------------------------------------------------------------------------
+ */
+#include "jshardware.h"
+#include "jsdevices.h"
+#include "jstimer.h"
+
+#if defined(SPI_SIMULATED) && SPI_COUNT>=1
+
+#ifndef SPI_SIMULATED_LATENCY_US
+#define SPI_SIMULATED_LATENCY_US 500 // time between a transfer being queued and it starting
+#endif
+#define SPI_SIMULATED_TRANSFERS 4 // transfers that can be queued on each device at once
+
+typedef struct {
+  unsigned char *tx;
+  size_t count;
+  JsSysTime done; ///< when the transfer will have finished
+  void (*callback)();
+} SpiSimTransfer;
+
+typedef struct {
+  int baudRate;
+  SpiSimTransfer trans[SPI_SIMULATED_TRANSFERS]; ///< ring of transfers in progress
+  uint8_t transFirst; ///< oldest transfer in the ring
+  uint8_t transCount; ///< number of transfers in progress
+  volatile bool eventPending; ///< we've pushed an IO event that jshSPIPoll hasn't handled yet
+} SpiSimDevice;
+
+static SpiSimDevice spiSim[SPI_COUNT];
+
+void jshSetDeviceInitialised(IOEventFlags device, bool isInit);
+
+/// Called from the utility timer when a transfer should have finished
+static void spiSimTransferDone(JsSysTime time, void *userdata) {
+  NOT_USED(time);
+  IOEventFlags device = (IOEventFlags)(size_t)userdata;
+  SpiSimDevice *d = &spiSim[device - EV_SPI1];
+  if (d->eventPending) return;
+  d->eventPending = true;
+  jshPushIOEvent(device, 0);
+}
+
+/// Finish the oldest transfer if it's done (or wait for it if 'wait'). Returns false if there wasn't one
+static bool spiSimFinishTransfer(IOEventFlags device, bool wait) {
+  SpiSimDevice *d = &spiSim[device - EV_SPI1];
+  if (!d->transCount) return false;
+  SpiSimTransfer *t = &d->trans[d->transFirst];
+  if (wait) {
+    while (jshGetSystemTime() < t->done);
+  } else if (jshGetSystemTime() < t->done)
+    return false;
+  jshPushIOCharEvents(EV_LOOPBACKB, (char*)t->tx, (unsigned int)t->count);
+  void (*callback)() = t->callback;
+  d->transFirst = (uint8_t)((d->transFirst+1) % SPI_SIMULATED_TRANSFERS);
+  d->transCount--;
+  if (callback) callback();
+  return true;
+}
+
+/// How long sending 'count' bytes takes, after the latency
+static JsSysTime spiSimTransferTime(SpiSimDevice *d, size_t count) {
+  return jshGetTimeFromMilliseconds(SPI_SIMULATED_LATENCY_US/1000.0 + count*8*1000.0/d->baudRate);
+}
+
+void jshSPISetup(IOEventFlags device, JshSPIInfo *inf) {
+  jshSPIWait(device);
+  SpiSimDevice *d = &spiSim[device - EV_SPI1];
+  memset(d, 0, sizeof(SpiSimDevice));
+  d->baudRate = inf->baudRate>0 ? inf->baudRate : 100000;
+  jshSetDeviceInitialised(device, true);
+}
+
+int jshSPISend(IOEventFlags device, int data) {
+  jshSPIWait(device); // finish any transfer jshSPISendMany left running
+  if (data<0) return -1;
+  SpiSimDevice *d = &spiSim[device - EV_SPI1];
+  JsSysTime done = jshGetSystemTime() + spiSimTransferTime(d, 1);
+  while (jshGetSystemTime() < done);
+  jshPushIOCharEvent(EV_LOOPBACKB, (char)data);
+  return data;
+}
+
+bool jshSPISendMany(IOEventFlags device, unsigned char *tx, unsigned char *rx, size_t count, void (*callback)()) {
+  if (!jshIsDeviceInitialised(device)) return false;
+  SpiSimDevice *d = &spiSim[device - EV_SPI1];
+  bool async = callback && !rx;
+  if (!async) jshSPIWait(device);
+  else if (d->transCount == SPI_SIMULATED_TRANSFERS)
+    spiSimFinishTransfer(device, true); // make room
+  // transfers go one after the other, so this one starts when the last one finishes
+  JsSysTime start = jshGetSystemTime();
+  if (d->transCount) {
+    JsSysTime last = d->trans[(d->transFirst + d->transCount - 1) % SPI_SIMULATED_TRANSFERS].done;
+    if (last > start) start = last;
+  }
+  SpiSimTransfer *t = &d->trans[(d->transFirst + d->transCount) % SPI_SIMULATED_TRANSFERS];
+  t->tx = tx;
+  t->count = count;
+  t->done = start + spiSimTransferTime(d, count);
+  t->callback = async ? callback : NULL;
+  d->transCount++;
+  if (rx) memcpy(rx, tx, count);
+  if (async) {
+    jstExecuteFn(spiSimTransferDone, (void*)(size_t)device, t->done - jshGetSystemTime(), 0, NULL);
+    return true;
+  }
+  jshSPIWait(device);
+  if (callback) callback();
+  return true;
+}
+
+void jshSPISend16(IOEventFlags device, int data) {
+  jshSPISend(device, data>>8);
+  jshSPISend(device, data&255);
+}
+
+void jshSPISet16(IOEventFlags device, bool is16) {
+  NOT_USED(device);
+  NOT_USED(is16);
+}
+
+void jshSPISetReceive(IOEventFlags device, bool isReceive) {
+  NOT_USED(device);
+  NOT_USED(isReceive);
+}
+
+void jshSPIWait(IOEventFlags device) {
+  while (spiSimFinishTransfer(device, true));
+}
+
+int jshSPIPoll(IOEventFlags device) {
+  SpiSimDevice *d = &spiSim[device - EV_SPI1];
+  d->eventPending = false;
+  while (spiSimFinishTransfer(device, false));
+  return d->transCount;
+}
+
+#endif
@@ -13,6 +13,7 @@
  */
 #include "jsi2c.h"
 #include "jsinteractive.h"
+#include "jswrap_promise.h"
 
 typedef struct {
   Pin pinSCL;
@@ -218,4 +219,212 @@ bool jsi2cRead(JshI2CInfo *inf, unsigned char address, int nBytes, unsigned char
   return true;
 }
 
+/* A compiled transfer is a flat string of an op count, then for each op:
+ * [address | 0x80 if reading][length low][length high][data to write...] */
+
+JsVar *jsi2cCompileTransfer(JsVar *ops, unsigned int *readBytes) {
+  *readBytes = 0;
+  if (!jsvIsArray(ops)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting an array of operations, got %t", ops);
+    return 0;
+  }
+  // Work out how big it'll be
+  unsigned int opCount = 0, size = 1;
+  bool ok = true;
+  JsvIterator it;
+  jsvIteratorNew(&it, ops, JSIF_EVERY_ARRAY_ELEMENT);
+  while (ok && jsvIteratorHasElement(&it)) {
+    JsVar *op = jsvIteratorGetValue(&it);
+    JsVar *write = jsvIsObject(op) ? jsvObjectGetChild(op, "write", 0) : 0;
+    JsVar *read = jsvIsObject(op) ? jsvObjectGetChild(op, "read", 0) : 0;
+    JsVar *addr = jsvIsObject(op) ? jsvObjectGetChild(op, "addr", 0) : 0;
+    unsigned int len = 0;
+    if (!addr || (!write == !read)) {
+      jsExceptionHere(JSET_ERROR, "Expecting {addr, write:data} or {addr, read:length}, got %q", op);
+      ok = false;
+    } else if (write) {
+      len = jsvIterateCallbackCount(write);
+      size += len;
+    } else {
+      JsVarInt n = jsvGetInteger(read);
+      if (n<0) n = 0;
+      len = (unsigned int)n;
+      *readBytes += len;
+    }
+    if (ok && len>0xFFFF) {
+      jsExceptionHere(JSET_ERROR, "Too much data in one I2C operation");
+      ok = false;
+    }
+    size += 3;
+    opCount++;
+    jsvUnLock4(write, read, addr, op);
+    jsvIteratorNext(&it);
+  }
+  jsvIteratorFree(&it);
+  if (ok && (!opCount || opCount>JSI2C_TRANSFER_MAX_OPS)) {
+    jsExceptionHere(JSET_ERROR, "Expecting between 1 and %d operations", JSI2C_TRANSFER_MAX_OPS);
+    ok = false;
+  }
+  if (!ok) return 0;
+  JsVar *transfer = jsvNewFlatStringOfLength(size);
+  if (!transfer) {
+    jsExceptionHere(JSET_ERROR, "Unable to allocate %d bytes for I2C transfer", size);
+    return 0;
+  }
+  // Now fill it in
+  unsigned char *p = (unsigned char*)jsvGetFlatStringPointer(transfer);
+  *(p++) = (unsigned char)opCount;
+  jsvIteratorNew(&it, ops, JSIF_EVERY_ARRAY_ELEMENT);
+  while (jsvIteratorHasElement(&it)) {
+    JsVar *op = jsvIteratorGetValue(&it);
+    JsVar *write = jsvObjectGetChild(op, "write", 0);
+    int addr = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(op, "addr", 0));
+    unsigned int len;
+    if (write) {
+      len = jsvIterateCallbackCount(write);
+      jsvIterateCallbackToBytes(write, p+3, len);
+    } else {
+      JsVarInt n = jsvGetIntegerAndUnLock(jsvObjectGetChild(op, "read", 0));
+      len = n>0 ? (unsigned int)n : 0;
+    }
+    p[0] = (unsigned char)((addr&0x7F) | (write ? 0 : 0x80));
+    p[1] = (unsigned char)len;
+    p[2] = (unsigned char)(len>>8);
+    p += 3 + (write ? len : 0);
+    jsvUnLock2(write, op);
+    jsvIteratorNext(&it);
+  }
+  jsvIteratorFree(&it);
+  return transfer;
+}
+
+bool jsi2cTransfer(JsVar *i2cDevice, JsVar *transfer, unsigned char *readData, bool async) {
+  size_t len = 0;
+  unsigned char *p = (unsigned char*)jsvGetDataPointer(transfer, &len);
+  if (!p || !len) return false;
+  JshI2COp ops[JSI2C_TRANSFER_MAX_OPS];
+  int opCount = *(p++);
+  for (int i=0;i<opCount;i++) {
+    ops[i].address = p[0]&0x7F;
+    ops[i].read = (p[0]&0x80)!=0;
+    ops[i].nBytes = p[1] | (p[2]<<8);
+    p += 3;
+    if (ops[i].read) {
+      ops[i].data = readData;
+      readData += ops[i].nBytes;
+    } else {
+      ops[i].data = p;
+      p += ops[i].nBytes;
+    }
+  }
+  IOEventFlags device = jsiGetDeviceFromClass(i2cDevice);
+  if (DEVICE_IS_I2C(device))
+    return jshI2CTransfer(device, ops, opCount, async);
+  if (device != EV_NONE)
+    return false;
+  // software
+  JshI2CInfo inf;
+  JsVar *options = jsvObjectGetChild(i2cDevice, DEVICE_OPTIONS_NAME, 0);
+  bool ok = jsi2cPopulateI2CInfo(&inf, options);
+  if (ok) {
+    inf.started = jsvGetBoolAndUnLock(jsvObjectGetChild(i2cDevice, "started", 0));
+    for (int i=0;i<opCount && ok;i++) {
+      bool sendStop = i==opCount-1;
+      if (ops[i].read)
+        ok = jsi2cRead(&inf, ops[i].address, ops[i].nBytes, ops[i].data, sendStop);
+      else
+        ok = jsi2cWrite(&inf, ops[i].address, ops[i].nBytes, ops[i].data, sendStop);
+    }
+    jsvUnLock(jsvObjectSetChild(i2cDevice, "started", jsvNewFromBool(inf.started)));
+  }
+  jsvUnLock(options);
+  return ok && !jspHasError();
+}
+
+#ifdef JSI2C_ASYNC
+/* Async transfers are kept in an array on the I2C object of { t : compiled transfer,
+ * r : result, p : promise, s : true once started }. Only the first is ever in progress. */
+
+/// Finish any async transfer that is done and start the next. Returns false once the queue is empty
+static bool jsi2cAsyncProcess(JsVar *i2cDevice, IOEventFlags device) {
+  JsVar *queue = jsvObjectGetChild(i2cDevice, JSI2C_ASYNC_QUEUE_NAME, 0);
+  if (!queue) return false;
+  while (true) {
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, queue);
+    JsVar *entry = jsvObjectIteratorGetValue(&it);
+    jsvObjectIteratorFree(&it);
+    if (!entry) break;
+    bool finished = false, ok = true;
+    if (jsvGetBoolAndUnLock(jsvObjectGetChild(entry, "s", 0))) {
+      JshI2CStatus status = DEVICE_IS_I2C(device) ? jshI2CPoll(device) : JSHI2C_IDLE;
+      if (status == JSHI2C_BUSY) {
+        jsvUnLock(entry);
+        break;
+      }
+      finished = true;
+      ok = status == JSHI2C_IDLE;
+    } else {
+      JsVar *transfer = jsvObjectGetChild(entry, "t", 0);
+      JsVar *result = jsvObjectGetChild(entry, "r", 0);
+      size_t len = 0;
+      unsigned char *readData = (unsigned char*)jsvGetDataPointer(result, &len);
+      ok = jsi2cTransfer(i2cDevice, transfer, readData, true);
+      jsvUnLock2(transfer, result);
+      jsvObjectSetChildAndUnLock(entry, "s", jsvNewFromBool(true));
+      finished = !ok;
+      // if it finished straight away we'll spot it next time around
+    }
+    if (finished) {
+      jsvUnLock(jsvArrayPopFirst(queue));
+      JsVar *promise = jsvObjectGetChild(entry, "p", 0);
+      if (ok) {
+        JsVar *result = jsvObjectGetChild(entry, "r", 0);
+        jspromise_resolve(promise, result);
+        jsvUnLock(result);
+      } else {
+        // turn the error into a rejection rather than an exception
+        JsVar *exception = jspGetException();
+        if (exception) execInfo.execute &= ~EXEC_EXCEPTION;
+        else exception = jsvNewFromString("I2C transfer failed");
+        jspromise_reject(promise, exception);
+        jsvUnLock(exception);
+      }
+      jsvUnLock(promise);
+    }
+    jsvUnLock(entry);
+  }
+  bool empty = !jsvGetChildren(queue);
+  if (empty) jsvObjectRemoveChild(i2cDevice, JSI2C_ASYNC_QUEUE_NAME);
+  jsvUnLock(queue);
+  return !empty;
+}
+
+JsVar *jsi2cTransferAsync(JsVar *i2cDevice, JsVar *transfer, JsVar *result) {
+  JsVar *promise = jspromise_create();
+  JsVar *entry = jsvNewObject();
+  JsVar *queue = jsvObjectGetChild(i2cDevice, JSI2C_ASYNC_QUEUE_NAME, JSV_ARRAY);
+  if (!promise || !entry || !queue) {
+    jsvUnLock3(promise, entry, queue);
+    return 0;
+  }
+  jsvObjectSetChild(entry, "t", transfer);
+  jsvObjectSetChild(entry, "r", result);
+  jsvObjectSetChild(entry, "p", promise);
+  jsvArrayPushAndUnLock(queue, entry);
+  jsvUnLock(queue);
+  jsi2cAsyncProcess(i2cDevice, jsiGetDeviceFromClass(i2cDevice));
+  return promise;
+}
+
+void jsi2cHandleIOEvent(IOEventFlags device) {
+  JsVar *i2cDevice = jsvSkipNameAndUnLock(jsiGetClassNameFromDevice(device));
+  if (jsvIsObject(i2cDevice))
+    jsi2cAsyncProcess(i2cDevice, device);
+  else
+    jshI2CPoll(device);
+  jsvUnLock(i2cDevice);
+}
+#endif
+
 #endif // SAVE_ON_FLASH
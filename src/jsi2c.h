@@ -23,3 +23,24 @@ void jsi2cSetup(JshI2CInfo *inf);
 void jsi2cUnsetup(JshI2CInfo *inf); ///< turn off I2C (remove pullups/sense)
 bool jsi2cWrite(JshI2CInfo *inf, unsigned char address, int nBytes, const unsigned char *data, bool sendStop);
 bool jsi2cRead(JshI2CInfo *inf, unsigned char address, int nBytes, unsigned char *data, bool sendStop);
+
+#ifndef SAVE_ON_FLASH
+#define JSI2C_TRANSFER_MAX_OPS 32 // most reads/writes in one I2C.transfer
+
+/** Compile an array of `{addr,write}`/`{addr,read}` objects into a flat string that
+ * jsi2cTransfer can execute, and set readBytes to the total amount of data that will
+ * be read. Returns 0 (with an exception) on error */
+JsVar *jsi2cCompileTransfer(JsVar *ops, unsigned int *readBytes);
+/// Execute a transfer compiled with jsi2cCompileTransfer, putting all data that is read in readData
+bool jsi2cTransfer(JsVar *i2cDevice, JsVar *transfer, unsigned char *readData, bool async);
+
+#if !defined(ESPR_NO_PROMISES) && !defined(I2C_SLAVE)
+#define JSI2C_ASYNC // I2C.transfer(..., {async:true}) - uses the I2C IO events that slave mode needs
+#define JSI2C_ASYNC_QUEUE_NAME JS_HIDDEN_CHAR_STR"aQ"
+
+/// Queue a compiled transfer to run without waiting for it. Returns a promise that resolves to 'result' once it's done
+JsVar *jsi2cTransferAsync(JsVar *i2cDevice, JsVar *transfer, JsVar *result);
+/// The I2C hardware has finished an async transfer - resolve it and start the next
+void jsi2cHandleIOEvent(IOEventFlags device);
+#endif
+#endif
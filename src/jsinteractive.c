@@ -26,6 +26,9 @@
 #include "jswrap_interactive.h" // jswrap_interactive_setTimeout
 #include "jswrap_object.h" // jswrap_object_keys_or_property_names
 #include "jsnative.h" // jsnSanityTest
+#include "jsserial.h" // jsserialFramingPush
+#include "jsspi.h" // jsspiHandleIOEvent
+#include "jsi2c.h" // jsi2cHandleIOEvent
 #ifdef BLUETOOTH
 #include "bluetooth.h"
 #include "jswrap_bluetooth.h"
@@ -1868,6 +1871,25 @@ static JsVar *jsiExtractIOEventData(IOEvent *event, int *eventsHandled) {
  * grabbed, the number of extra events (not characters) is returned */
 int jsiHandleIOEventForSerial(JsVar *usartClass, IOEvent *event) {
   int eventsHandled = 0;
+#ifndef SAVE_ON_FLASH
+  JsVar *framing = jsserialGetFraming(usartClass);
+  if (framing) {
+    // Framed - feed characters straight into the framer, which emits 'packet' events
+    int chars = IOEVENTFLAGS_GETCHARS(event->flags);
+    while (chars) {
+      jsserialFramingPush(usartClass, framing, event->data.chars, (size_t)chars);
+      // look down the stack and see if there is more data
+      if (jshIsTopEvent(IOEVENTFLAGS_GETTYPE(event->flags))) {
+        jshPopIOEvent(event);
+        eventsHandled++;
+        chars = IOEVENTFLAGS_GETCHARS(event->flags);
+      } else
+        chars = 0;
+    }
+    jsvUnLock(framing);
+    return eventsHandled;
+  }
+#endif
   JsVar *stringData = jsiExtractIOEventData(event,  &eventsHandled);
   if (stringData) {
     // Now run the handler
@@ -1930,6 +1952,16 @@ void jsiIdle() {
     } else if ((eventType == EV_BLUETOOTH_PENDING) || (eventType == EV_BLUETOOTH_PENDING_DATA)) {
       maxEvents -= jsble_exec_pending(&event);
 #endif
+#ifdef JSSPI_ASYNC
+    } else if (DEVICE_IS_SPI(eventType)) {
+      // ------------------------------------------------------------------------ SPI TRANSFER COMPLETE
+      jsspiHandleIOEvent(eventType);
+#endif
+#ifdef JSI2C_ASYNC
+    } else if (DEVICE_IS_I2C(eventType)) {
+      // ------------------------------------------------------------------------ I2C TRANSFER COMPLETE
+      jsi2cHandleIOEvent(eventType);
+#endif
 #ifdef I2C_SLAVE
     } else if (DEVICE_IS_I2C(eventType)) {
       // ------------------------------------------------------------------------ I2C CALLBACK
@@ -2302,6 +2334,16 @@ void jsiIdle() {
     return;
   }
 
+#ifndef SAVE_ON_FLASH
+  /* Similarly, if memory has got fragmented (so big Flat Strings
+   * can't be allocated) then do a short step of compaction. */
+  if (loopsIdling>=1 &&
+      minTimeUntilNext > jshGetTimeFromMilliseconds(10) &&
+      jsvDefragmentIdle()) {
+    return; // go around again (not sleeping) in case there's more to do
+  }
+#endif
+
   // Go to sleep!
   if (loopsIdling>=1 && // once around the idle loop without having done any work already (just in case)
 #if defined(USB) && !defined(EMSCRIPTEN)
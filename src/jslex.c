@@ -95,15 +95,49 @@ static JSLEX_INLINE void jslTokenAppendChar(char ch) {
   }
 }
 
-// Check if a token matches (IGNORING FIRST CHAR)
-static bool jslIsToken(const char *token) {
-  int i;
-  for (i=1;i<lex->tokenl;i++) {
-    if (lex->token[i]!=token[i]) return false;
-    // if token is smaller than lex->token, there will be a null char
-    // which will be different from the token
-  }
-  return token[lex->tokenl] == 0; // only match if token ends now
+/// Is the character one that can be part of an ID (after the first character)?
+static JSLEX_INLINE bool jslIsIDChar(char ch) {
+  return isAlphaInline(ch) || isNumericInline(ch) || ch=='$';
+}
+
+/* A perfect hash of the reserved words. The hash is made from the length of the
+ * word and its first, second and last characters (via jslReservedWordHashValues,
+ * indexed by ch&31), and these were chosen so that no two reserved words have
+ * the same hash - so any ID only ever needs comparing against one reserved word. */
+static const unsigned char jslReservedWordHashValues[32] = {
+  61,37,56,15,32,57,32,38,14,4,25,12,57,42,62,3,
+  28,11,13,55,53,63,52,20,42,21,19,5,35,6,58,32
+};
+static const unsigned char jslReservedWordTokens[64] = {
+  LEX_R_FINALLY, LEX_R_STATIC, LEX_R_IN, LEX_R_FALSE, LEX_R_CLASS, LEX_R_OF, LEX_R_IF, LEX_R_CATCH,
+  LEX_R_SUPER, 0, LEX_R_RETURN, 0, LEX_R_CONST, 0, LEX_R_NEW, 0,
+  0, 0, 0, LEX_R_CONTINUE, 0, LEX_R_DEFAULT, LEX_R_BREAK, 0,
+  LEX_R_DELETE, 0, LEX_R_TRY, LEX_R_VOID, LEX_R_THROW, 0, 0, LEX_R_SWITCH,
+  LEX_R_WHILE, LEX_R_EXTENDS, 0, 0, 0, LEX_R_FUNCTION, LEX_R_UNDEFINED, 0,
+  LEX_R_DO, LEX_R_VAR, LEX_R_LET, 0, LEX_R_INSTANCEOF, 0, LEX_R_DEBUGGER, LEX_R_ELSE,
+  LEX_R_TYPEOF, LEX_R_CASE, 0, LEX_R_FOR, 0, 0, 0, 0,
+  0, 0, LEX_R_NULL, 0, 0, 0, LEX_R_THIS, LEX_R_TRUE
+};
+static const unsigned char jslReservedWordOffsets[64] = {
+  0,8,15,18,24,30,33,36,42,0,48,0,55,0,61,0,
+  0,0,0,65,0,74,82,0,88,0,95,99,104,0,0,110,
+  117,123,0,0,0,131,140,0,150,153,157,0,161,0,172,181,
+  186,193,0,198,0,0,0,0,0,0,202,0,0,0,207,212
+};
+static const char jslReservedWordChars[] = "finally\0static\0in\0false\0class\0of\0if\0catch\0super\0return\0const\0new\0continue\0default\0break\0delete\0try\0void\0throw\0switch\0while\0extends\0function\0undefined\0do\0var\0let\0instanceof\0debugger\0else\0typeof\0case\0for\0null\0this\0true\0";
+
+/// If lex->token is a reserved word, return its token - otherwise return LEX_ID
+static int jslGetReservedWord() {
+  int len = lex->tokenl;
+  if (len<2) return LEX_ID; // there are no single-character reserved words
+  unsigned int hash = (jslReservedWordHashValues[lex->token[0]&31] +
+                       jslReservedWordHashValues[lex->token[1]&31] +
+                       jslReservedWordHashValues[lex->token[len-1]&31] + (unsigned int)len) & 63;
+  int tk = jslReservedWordTokens[hash];
+  if (!tk) return LEX_ID;
+  const char *word = &jslReservedWordChars[jslReservedWordOffsets[hash]];
+  if (strncmp(word, lex->token, (size_t)len)!=0 || word[len]) return LEX_ID;
+  return tk;
 }
 
 typedef enum {
@@ -468,67 +502,24 @@ void jslGetNextToken() {
       if (lex->tk == LEX_R_THIS) lex->hadThisKeyword=true;
       break;
     case JSLJT_ID: {
-      while (isAlphaInline(lex->currCh) || isNumericInline(lex->currCh) || lex->currCh=='$') {
+      while (jslIsIDChar(lex->currCh)) {
         jslTokenAppendChar(lex->currCh);
+        /* Copy any more of the ID straight out of the current block of the
+         * string. We leave the block's last character for jslGetNextCh, as it
+         * is what moves us on to the next block. */
+        size_t idx = lex->it.charIdx;
+        while (idx+1 < lex->it.charsInVar) {
+          char ch = (char)READ_FLASH_UINT8(&lex->it.ptr[idx]);
+          if (!jslIsIDChar(ch)) break;
+          jslTokenAppendChar(ch);
+          idx++;
+        }
+        lex->it.charIdx = idx;
         jslGetNextCh();
       }
-      lex->tk = LEX_ID;
-      if (!lex->token[1]) break; // there are no single-character reserved words - skip the check!
-      // We do fancy stuff here to reduce number of compares (hopefully GCC creates a jump table)
-      switch (lex->token[0]) {
-      case 'b': if (jslIsToken("break")) lex->tk = LEX_R_BREAK;
-      break;
-      case 'c': if (jslIsToken("case")) lex->tk = LEX_R_CASE;
-      else if (jslIsToken("catch")) lex->tk = LEX_R_CATCH;
-      else if (jslIsToken("class")) lex->tk = LEX_R_CLASS;
-      else if (jslIsToken("const")) lex->tk = LEX_R_CONST;
-      else if (jslIsToken("continue")) lex->tk = LEX_R_CONTINUE;
-      break;
-      case 'd': if (jslIsToken("default")) lex->tk = LEX_R_DEFAULT;
-      else if (jslIsToken("delete")) lex->tk = LEX_R_DELETE;
-      else if (jslIsToken("do")) lex->tk = LEX_R_DO;
-      else if (jslIsToken("debugger")) lex->tk = LEX_R_DEBUGGER;
-      break;
-      case 'e': if (jslIsToken("else")) lex->tk = LEX_R_ELSE;
-      else if (jslIsToken("extends")) lex->tk = LEX_R_EXTENDS;
-      break;
-      case 'f': if (jslIsToken("false")) lex->tk = LEX_R_FALSE;
-      else if (jslIsToken("finally")) lex->tk = LEX_R_FINALLY;
-      else if (jslIsToken("for")) lex->tk = LEX_R_FOR;
-      else if (jslIsToken("function")) lex->tk = LEX_R_FUNCTION;
-      break;
-      case 'i': if (jslIsToken("if")) lex->tk = LEX_R_IF;
-      else if (jslIsToken("in")) lex->tk = LEX_R_IN;
-      else if (jslIsToken("instanceof")) lex->tk = LEX_R_INSTANCEOF;
-      break;
-      case 'l': if (jslIsToken("let")) lex->tk = LEX_R_LET;
-      break;
-      case 'n': if (jslIsToken("new")) lex->tk = LEX_R_NEW;
-      else if (jslIsToken("null")) lex->tk = LEX_R_NULL;
-      break;
-      case 'o': if (jslIsToken("of")) lex->tk = LEX_R_OF;
-      break;
-      case 'r': if (jslIsToken("return")) lex->tk = LEX_R_RETURN;
-      break;
-      case 's': if (jslIsToken("static")) lex->tk = LEX_R_STATIC;
-      else if (jslIsToken("super")) lex->tk = LEX_R_SUPER;
-      else if (jslIsToken("switch")) lex->tk = LEX_R_SWITCH;
-      break;
-      case 't': if (jslIsToken("this")) { lex->tk = LEX_R_THIS; lex->hadThisKeyword=true; }
-      else if (jslIsToken("throw")) lex->tk = LEX_R_THROW;
-      else if (jslIsToken("true")) lex->tk = LEX_R_TRUE;
-      else if (jslIsToken("try")) lex->tk = LEX_R_TRY;
-      else if (jslIsToken("typeof")) lex->tk = LEX_R_TYPEOF;
-      break;
-      case 'u': if (jslIsToken("undefined")) lex->tk = LEX_R_UNDEFINED;
-      break;
-      case 'w': if (jslIsToken("while")) lex->tk = LEX_R_WHILE;
-      break;
-      case 'v': if (jslIsToken("var")) lex->tk = LEX_R_VAR;
-      else if (jslIsToken("void")) lex->tk = LEX_R_VOID;
+      lex->tk = (short)jslGetReservedWord();
+      if (lex->tk == LEX_R_THIS) lex->hadThisKeyword=true;
       break;
-      default: break;
-      } break;
       case JSLJT_NUMBER: {
         // TODO: check numbers aren't the wrong format
         bool canBeFloating = true;
@@ -109,20 +109,146 @@ void jspeiRemoveScope() {
   }
 }
 
+#ifndef SAVE_ON_FLASH
+#define JSP_GLOBAL_CACHE_SIZE 32 ///< How many global variable lookups we remember (power of 2)
+/* The names in root that global variable lookups found, indexed by a hash of
+ * the variable's name. Root can have a lot of names in it and searching them
+ * is the slowest part of resolving a global, so we remember where each one was.
+ * This is all forgotten when names are added to or removed from root. */
+static JsVarRef jspGlobalCache[JSP_GLOBAL_CACHE_SIZE];
+static unsigned int jspGlobalCacheVersion; ///< jsvGetRootVersion() when jspGlobalCache was valid
+
+/// Find a name in the root scope, using jspGlobalCache if we can
+static JsVar *jspeiFindInRoot(const char *name) {
+  unsigned int version = jsvGetRootVersion();
+  if (jspGlobalCacheVersion != version) {
+    memset(jspGlobalCache, 0, sizeof(jspGlobalCache));
+    jspGlobalCacheVersion = version;
+  }
+  unsigned int hash = 0;
+  for (const char *c=name;*c;c++)
+    hash = hash*31 + (unsigned char)*c;
+  JsVarRef *cached = &jspGlobalCache[hash & (JSP_GLOBAL_CACHE_SIZE-1)];
+  if (*cached) {
+    JsVar *v = jsvLock(*cached);
+    if (jsvIsStringEqual(v, name)) return v;
+    jsvUnLock(v); // a different name with the same hash
+  }
+  JsVar *v = jsvFindChildFromString(execInfo.root, name, false);
+  if (v) *cached = jsvGetRef(v);
+  return v;
+}
+#endif
+
+/// Search for a name in the scope 'it' (an item in execInfo.scopesVar, which is unlocked) and the ones below it, then root
+static JsVar *jspeiFindInScopesFrom(JsVar *it, const char *name) {
+  while (it) {
+    JsVar *scope = jsvSkipName(it);
+    JsVarRef next = jsvGetPrevSibling(it);
+    JsVar *ref = jsvFindChildFromString(scope, name, false);
+    jsvUnLock2(it, scope);
+    if (ref) return ref;
+    it = jsvLockSafe(next);
+  }
+#ifndef SAVE_ON_FLASH
+  return jspeiFindInRoot(name);
+#else
+  return jsvFindChildFromString(execInfo.root, name, false);
+#endif
+}
+
 JsVar *jspeiFindInScopes(const char *name) {
-  if (execInfo.scopesVar) {
-    JsVar *it = jsvLockSafe(jsvGetLastChild(execInfo.scopesVar));
-    while (it) {
-      JsVar *scope = jsvSkipName(it);
-      JsVarRef next = jsvGetPrevSibling(it);
-      JsVar *ref = jsvFindChildFromString(scope, name, false);
-      jsvUnLock2(it, scope);
-      if (ref) return ref;
-      it = jsvLockSafe(next);
+  return jspeiFindInScopesFrom(execInfo.scopesVar ? jsvLockSafe(jsvGetLastChild(execInfo.scopesVar)) : 0, name);
+}
+
+#ifndef SAVE_ON_FLASH
+#define JSP_FRAME_SLOTS 16 ///< How many of a function's parameters and locals can have slots
+#define JSP_SLOT_CACHE_SIZE 64 ///< How many identifiers in function code we remember the slot of (power of 2)
+/* The frame of a function call that is executing. Slot 'n' is the n-th name
+ * in the function's scope - parameters first (in order), then locals as they
+ * are declared - so it's the same in each call. While the call is running
+ * names are only ever added to the end of the scope, so once a slot is
+ * filled in it can be used for the rest of the call without searching. */
+typedef struct JspFrame {
+  struct JspFrame *prev; ///< The frame of the call that called this one
+  JsVar *scope;          ///< The function's scope
+  JsVar *code;           ///< The function's code (lex->sourceVar while it's executing)
+  JsVar *returnVar;      ///< The function's return value name (or 0)
+  unsigned int version;  ///< jsvGetRootVersion() when slots were valid
+  JsVarRef slots[JSP_FRAME_SLOTS]; ///< Names in the scope, or 0 if not looked up yet
+} JspFrame;
+static JspFrame *jspFrame; ///< The frame of the function whose code is executing (or 0)
+
+/* The slots that identifiers in function code were found in, indexed by
+ * where the identifier is in the code. */
+typedef struct {
+  JsVarRef code;      ///< The function code the identifier was in
+  size_t pos;         ///< Where the identifier was in the code
+  unsigned char slot; ///< The slot it was found in
+} JspSlotCacheEntry;
+static JspSlotCacheEntry jspSlotCache[JSP_SLOT_CACHE_SIZE];
+
+/// Same as jspeiFindInScopes for the identifier at the current position in jspFrame's code, but uses slots where it can
+static JsVar *jspeiFindInFrame(const char *name) {
+  JspFrame *frame = jspFrame;
+  JsVar *it = jsvLockSafe(jsvGetLastChild(execInfo.scopesVar));
+  if (!it || jsvGetFirstChild(it)!=jsvGetRef(frame->scope)) // in a block that has its own scope for let/const
+    return jspeiFindInScopesFrom(it, name);
+  unsigned int version = jsvGetRootVersion();
+  if (frame->version != version) { // vars could have moved
+    memset(frame->slots, 0, sizeof(frame->slots));
+    frame->version = version;
+  }
+  JsVarRef code = jsvGetRef(frame->code);
+  size_t pos = lex->tokenStart;
+  JspSlotCacheEntry *cached = &jspSlotCache[(code*31 + pos) & (JSP_SLOT_CACHE_SIZE-1)];
+  if (cached->code==code && cached->pos==pos) {
+    unsigned char slot = cached->slot;
+    JsVarRef ref = frame->slots[slot];
+    if (!ref) { // first use of this slot in the call - get the name from the scope
+      ref = jsvGetFirstChild(frame->scope);
+      for (unsigned char i=0; i<slot && ref; i++) {
+        JsVar *v = jsvLock(ref);
+        ref = jsvGetNextSibling(v);
+        jsvUnLock(v);
+      }
+    }
+    if (ref) {
+      JsVar *v = jsvLock(ref);
+      if (jsvIsStringEqual(v, name)) { // it may not be declared yet in this call, or the code may have changed
+        frame->slots[slot] = ref;
+        jsvUnLock(it);
+        return v;
+      }
+      jsvUnLock(v);
     }
   }
-  return jsvFindChildFromString(execInfo.root, name, false);
+  JsVar *v = jsvFindChildFromString(frame->scope, name, false);
+  if (v) {
+    // work out which slot it's in, and remember it
+    unsigned char slot = 0;
+    JsVarRef ref = jsvGetFirstChild(frame->scope);
+    while (ref!=jsvGetRef(v) && slot<JSP_FRAME_SLOTS) {
+      JsVar *child = jsvLock(ref);
+      ref = jsvGetNextSibling(child);
+      jsvUnLock(child);
+      slot++;
+    }
+    if (slot<JSP_FRAME_SLOTS) {
+      frame->slots[slot] = ref;
+      cached->code = code;
+      cached->pos = pos;
+      cached->slot = slot;
+    }
+    jsvUnLock(it);
+    return v;
+  }
+  // not a local - look in the scopes the function was defined in
+  JsVarRef next = jsvGetPrevSibling(it);
+  jsvUnLock(it);
+  return jspeiFindInScopesFrom(jsvLockSafe(next), name);
 }
+#endif
 /// Return the topmost scope (and lock it)
 JsVar *jspeiGetTopScope() {
   if (execInfo.scopesVar) {
@@ -818,6 +944,16 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
             jslInit(functionCode);
 #ifndef ESPR_NO_LINE_NUMBERS
             newLex.lineNumberOffset = functionLineNumber;
+#endif
+#ifndef SAVE_ON_FLASH
+            JspFrame frame;
+            frame.prev = jspFrame;
+            frame.scope = functionRoot;
+            frame.code = newLex.sourceVar;
+            frame.returnVar = 0;
+            frame.version = jsvGetRootVersion();
+            memset(frame.slots, 0, sizeof(frame.slots));
+            jspFrame = &frame;
 #endif
             JSP_SAVE_EXECUTE();
             // force execute without any previous state
@@ -840,6 +976,9 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
             } else {
               // setup a return variable
               JsVar *returnVarName = jsvAddNamedChild(functionRoot, 0, JSPARSE_RETURN_VAR);
+#ifndef SAVE_ON_FLASH
+              frame.returnVar = returnVarName;
+#endif
               // parse the whole block
 #ifndef ESPR_NO_LET_SCOPING
               execInfo.blockCount--; // jspeBlockNoBrackets immediately increments the block count
@@ -855,6 +994,9 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
               if (returnVarName) // could have failed with out of memory
                 jsvRemoveChild(functionRoot, returnVarName); // remove return value (helps stops circular references, saves RAM)
             }
+#ifndef SAVE_ON_FLASH
+            jspFrame = frame.prev;
+#endif
             // Store a stack trace if we had an error
             JsExecFlags hasError = execInfo.execute&EXEC_ERROR_MASK;
             JSP_RESTORE_EXECUTE(); // because return will probably have set execute to false
@@ -922,45 +1064,54 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
 }
 
 // Find a variable (or built-in function) based on the current scopes
-JsVar *jspGetNamedVariable(const char *tokenName) {
-  JsVar *a = JSP_SHOULD_EXECUTE ? jspeiFindInScopes(tokenName) : 0;
-  if (JSP_SHOULD_EXECUTE && !a) {
-    /* Special case! We haven't found the variable, so check out
-     * and see if it's one of our builtins...  */
-    if (jswIsBuiltInObject(tokenName)) {
-      // Check if we have a built-in function for it
-      // OPT: Could we instead have jswIsBuiltInObjectWithoutConstructor?
-      JsVar *obj = jswFindBuiltInFunction(0, tokenName);
-      // If not, make one
-      if (!obj)
-        obj = jspNewBuiltin(tokenName);
-      if (obj) { // not out of memory
-        a = jsvAddNamedChild(execInfo.root, obj, tokenName);
-        jsvUnLock(obj);
-      }
-    } else {
-      a = jswFindBuiltInFunction(0, tokenName);
-      if (!a) {
-        /* Variable doesn't exist! JavaScript says we should create it
-         * (we won't add it here. This is done in the assignment operator)*/
-        a = jsvMakeIntoVariableName(jsvNewFromString(tokenName), 0);
-      }
+/// For when a variable wasn't in any scope - get the built-in it refers to, or a name that can be assigned to
+static JsVar *jspGetNamedVariableNotInScope(const char *tokenName) {
+  JsVar *a = 0;
+  /* Special case! We haven't found the variable, so check out
+   * and see if it's one of our builtins...  */
+  if (jswIsBuiltInObject(tokenName)) {
+    // Check if we have a built-in function for it
+    // OPT: Could we instead have jswIsBuiltInObjectWithoutConstructor?
+    JsVar *obj = jswFindBuiltInFunction(0, tokenName);
+    // If not, make one
+    if (!obj)
+      obj = jspNewBuiltin(tokenName);
+    if (obj) { // not out of memory
+      a = jsvAddNamedChild(execInfo.root, obj, tokenName);
+      jsvUnLock(obj);
+    }
+  } else {
+    a = jswFindBuiltInFunction(0, tokenName);
+    if (!a) {
+      /* Variable doesn't exist! JavaScript says we should create it
+       * (we won't add it here. This is done in the assignment operator)*/
+      a = jsvMakeIntoVariableName(jsvNewFromString(tokenName), 0);
     }
   }
   return a;
 }
 
-/// Used by jspGetNamedField / jspGetVarNamedField
-static NO_INLINE JsVar *jspGetNamedFieldInParents(JsVar *object, const char* name, bool returnName) {
-  // Now look in prototypes
-  JsVar * child = jspeiFindChildFromStringInParents(object, name);
+JsVar *jspGetNamedVariable(const char *tokenName) {
+  JsVar *a = JSP_SHOULD_EXECUTE ? jspeiFindInScopes(tokenName) : 0;
+  if (JSP_SHOULD_EXECUTE && !a)
+    a = jspGetNamedVariableNotInScope(tokenName);
+  return a;
+}
 
-  /* Check for builtins via separate function
-   * This way we save on RAM for built-ins because everything comes out of program code */
-  if (!child) {
-    child = jswFindBuiltInFunction(object, name);
-  }
+#ifndef SAVE_ON_FLASH
+/// Same as jspGetNamedVariable for the identifier at the current position in the code, but uses jspFrame's slots if it's in function code
+static JsVar *jspGetNamedVariableAtCodePos(const char *tokenName) {
+  if (!JSP_SHOULD_EXECUTE || !jspFrame || lex->sourceVar!=jspFrame->code)
+    return jspGetNamedVariable(tokenName);
+  JsVar *a = jspeiFindInFrame(tokenName);
+  if (!a) a = jspGetNamedVariableNotInScope(tokenName);
+  return a;
+}
+#endif
 
+/** Given a child that wasn't found in the object itself, return a name for it
+ * that references the object. Unlocks child. */
+static JsVar *jspGetNamedFieldNameInObject(JsVar *object, const char* name, JsVar *child) {
   /* We didn't get here if we found a child in the object itself, so
    * if we're here then we probably have the wrong name - so for example
    * with `a.b = c;` could end up setting `a.prototype.b` (bug #360)
@@ -970,19 +1121,32 @@ static NO_INLINE JsVar *jspGetNamedFieldInParents(JsVar *object, const char* nam
    * a new name that references the object we actually requested the
    * member from..
    */
-  if (child && returnName) {
-    // Get rid of existing name
-    if (jsvIsName(child)) {
-      JsVar *t = jsvGetValueOfName(child);
-      jsvUnLock(child);
-      child = t;
-    }
-    // create a new name
-    JsVar *nameVar = jsvNewFromString(name);
-    JsVar *newChild = jsvCreateNewChild(object, nameVar, child);
-    jsvUnLock2(nameVar, child);
-    child = newChild;
+  // Get rid of existing name
+  if (jsvIsName(child)) {
+    JsVar *t = jsvGetValueOfName(child);
+    jsvUnLock(child);
+    child = t;
   }
+  // create a new name
+  JsVar *nameVar = jsvNewFromString(name);
+  JsVar *newChild = jsvCreateNewChild(object, nameVar, child);
+  jsvUnLock2(nameVar, child);
+  return newChild;
+}
+
+/// Used by jspGetNamedField / jspGetVarNamedField
+static NO_INLINE JsVar *jspGetNamedFieldInParents(JsVar *object, const char* name, bool returnName) {
+  // Now look in prototypes
+  JsVar * child = jspeiFindChildFromStringInParents(object, name);
+
+  /* Check for builtins via separate function
+   * This way we save on RAM for built-ins because everything comes out of program code */
+  if (!child) {
+    child = jswFindBuiltInFunction(object, name);
+  }
+
+  if (child && returnName)
+    child = jspGetNamedFieldNameInObject(object, name, child);
 
   // If not found and is the prototype, create it
   if (!child) {
@@ -1080,6 +1244,96 @@ JsVar *jspGetVarNamedField(JsVar *object, JsVar *nameVar, bool returnName) {
   else return jsvSkipNameAndUnLock(child);
 }
 
+#ifndef SAVE_ON_FLASH
+#define JSP_FIELD_CACHE_SIZE 32 ///< How many `a.b` lookups we remember (power of 2)
+/* Where `a.b` lookups found the field last time, indexed by where `.b` is in
+ * the code. Most places in code keep looking up the same field on the same
+ * object (often a method that's in its prototype), so we can usually skip
+ * searching through the object's names. This is all forgotten when names are
+ * added to or removed from objects we remembered (see jsvWatchNames). */
+typedef struct {
+  JsVarRef code;      ///< The code the lookup was in (lex->sourceVar)
+  size_t pos;         ///< Where the field name was in the code
+  JsVarRef object;    ///< The object the field was looked up on
+  JsVarRef name;      ///< The name that was found - in object, or in its prototype
+  JsVarRef protoName; ///< If it was found in the prototype, object's __proto__ name (else 0)
+  JsVarRef proto;     ///< ... and the prototype that pointed to
+} JspFieldCacheEntry;
+static JspFieldCacheEntry jspFieldCache[JSP_FIELD_CACHE_SIZE];
+static unsigned int jspFieldCacheVersion; ///< jsvGetNamesVersion() when jspFieldCache was valid
+static unsigned int jspFieldCacheHits, jspFieldCacheMisses;
+
+/// Same as jspGetNamedField(object, name, true) for an `object.name` at the current position in the code, but uses jspFieldCache
+static JsVar *jspGetNamedFieldAtCodePos(JsVar *object, const char* name) {
+  if (!jsvHasChildren(object) || jsvIsArray(object) || !lex->sourceVar)
+    return jspGetNamedField(object, name, true);
+  unsigned int version = jsvGetNamesVersion();
+  if (jspFieldCacheVersion != version) {
+    memset(jspFieldCache, 0, sizeof(jspFieldCache));
+    jspFieldCacheVersion = version;
+  }
+  JsVarRef code = jsvGetRef(lex->sourceVar);
+  size_t pos = lex->tokenStart;
+  JspFieldCacheEntry *cached = &jspFieldCache[(code*31 + pos) & (JSP_FIELD_CACHE_SIZE-1)];
+  if (cached->object==jsvGetRef(object) && cached->code==code && cached->pos==pos) {
+    JsVar *child = jsvLock(cached->name);
+    if (jsvIsStringEqual(child, name)) { // the code could have been replaced since
+      if (!cached->protoName) {
+        jspFieldCacheHits++;
+        return child;
+      }
+      JsVar *protoName = jsvLock(cached->protoName);
+      bool sameProto = jsvGetFirstChild(protoName)==cached->proto; // __proto__ could have been set to something else
+      jsvUnLock(protoName);
+      if (sameProto) {
+        jspFieldCacheHits++;
+        return jspGetNamedFieldNameInObject(object, name, child);
+      }
+    }
+    jsvUnLock(child);
+  }
+  jspFieldCacheMisses++;
+  // Look in the object itself
+  JsVar *child = jsvFindChildFromString(object, name, false);
+  if (child) {
+    if (jsvWatchNames(object)) {
+      cached->code = code;
+      cached->pos = pos;
+      cached->object = jsvGetRef(object);
+      cached->name = jsvGetRef(child);
+      cached->protoName = 0;
+      cached->proto = 0;
+    }
+    return child;
+  }
+  // Look in the object's prototype
+  if (jsvIsObject(object)) {
+    JsVar *protoName = jsvFindChildFromString(object, JSPARSE_INHERITS_VAR, false);
+    JsVar *proto = jsvSkipName(protoName);
+    if (proto!=object && jsvHasChildren(proto))
+      child = jsvFindChildFromString(proto, name, false);
+    if (child && jsvWatchNames(object) && jsvWatchNames(proto)) {
+      cached->code = code;
+      cached->pos = pos;
+      cached->object = jsvGetRef(object);
+      cached->name = jsvGetRef(child);
+      cached->protoName = jsvGetRef(protoName);
+      cached->proto = jsvGetRef(proto);
+    }
+    jsvUnLock2(protoName, proto);
+    if (child) return jspGetNamedFieldNameInObject(object, name, child);
+  }
+  // Anything else (further up the prototype chain, built-in, etc)
+  return jspGetNamedFieldInParents(object, name, true);
+}
+
+/// Get how many `a.b` lookups have used jspFieldCache, and how many haven't
+void jspGetFieldCacheStats(unsigned int *hits, unsigned int *misses) {
+  *hits = jspFieldCacheHits;
+  *misses = jspFieldCacheMisses;
+}
+#endif
+
 NO_INLINE JsVar *jspeFactorMember(JsVar *a, JsVar **parentResult) {
   /* The parent if we're executing a method call */
   JsVar *parent = 0;
@@ -1094,8 +1348,13 @@ NO_INLINE JsVar *jspeFactorMember(JsVar *a, JsVar **parentResult) {
 
           JsVar *aVar = jsvSkipNameWithParent(a,true,parent);
           JsVar *child = 0;
-          if (aVar)
+          if (aVar) {
+#ifndef SAVE_ON_FLASH
+            child = jspGetNamedFieldAtCodePos(aVar, name);
+#else
             child = jspGetNamedField(aVar, name, true);
+#endif
+          }
           if (!child) {
             if (!jsvIsNullish(aVar)) {
               // if no child found, create a pointer to where it could be
@@ -1679,7 +1938,11 @@ NO_INLINE JsVar *jspeClassDefinition(bool parseNamedClass) {
 
 NO_INLINE JsVar *jspeFactor() {
   if (lex->tk==LEX_ID) {
+#ifndef SAVE_ON_FLASH
+    JsVar *a = jspGetNamedVariableAtCodePos(jslGetTokenValueAsString());
+#else
     JsVar *a = jspGetNamedVariable(jslGetTokenValueAsString());
+#endif
     JSP_ASSERT_MATCH(LEX_ID);
 #ifndef SAVE_ON_FLASH
     if (lex->tk==LEX_TEMPLATE_LITERAL)
@@ -1848,6 +2111,14 @@ NO_INLINE JsVar *__jspePostfixExpression(JsVar *a) {
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
     if (JSP_SHOULD_EXECUTE) {
+      JsVarInt oldInt;
+      if (jsvGetImmediateInteger(a, &oldInt) &&
+          jsvMathsOpIntegerInPlace(a, 1, op==LEX_PLUSPLUS ? '+' : '-')) {
+        // small integer stored in the name itself - updated in place, so just use the old value
+        jsvUnLock(a);
+        a = jsvNewFromInteger(oldInt);
+        continue;
+      }
       JsVar *one = jsvNewFromInteger(1);
       JsVar *oldValue = jsvAsNumberAndUnLock(jsvSkipName(a)); // keep the old value (but convert to number)
       JsVar *res = jsvMathsOpSkipNames(oldValue, one, op==LEX_PLUSPLUS ? '+' : '-');
@@ -1871,7 +2142,8 @@ NO_INLINE JsVar *jspePostfixExpression() {
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
     a = jspePostfixExpression();
-    if (JSP_SHOULD_EXECUTE) {
+    if (JSP_SHOULD_EXECUTE &&
+        !jsvMathsOpIntegerInPlace(a, 1, op==LEX_PLUSPLUS ? '+' : '-')) {
       JsVar *one = jsvNewFromInteger(1);
       JsVar *res = jsvMathsOpSkipNames(a, one, op==LEX_PLUSPLUS ? '+' : '-');
       jsvUnLock(one);
@@ -2112,24 +2384,33 @@ NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
 
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
+    if (op==LEX_PLUSEQUAL) op='+';
+    else if (op==LEX_MINUSEQUAL) op='-';
+    else if (op==LEX_MULEQUAL) op='*';
+    else if (op==LEX_DIVEQUAL) op='/';
+    else if (op==LEX_MODEQUAL) op='%';
+    else if (op==LEX_ANDEQUAL) op='&';
+    else if (op==LEX_OREQUAL) op='|';
+    else if (op==LEX_XOREQUAL) op='^';
+    else if (op==LEX_RSHIFTEQUAL) op=LEX_RSHIFT;
+    else if (op==LEX_LSHIFTEQUAL) op=LEX_LSHIFT;
+    else if (op==LEX_RSHIFTUNSIGNEDEQUAL) op=LEX_RSHIFTUNSIGNED;
     rhs = jspeAssignmentExpression();
+    JsVarInt rhsInt;
+    if (JSP_SHOULD_EXECUTE && op!='=' &&
+        jsvGetImmediateInteger(rhs, &rhsInt) &&
+        jsvMathsOpIntegerInPlace(lhs, rhsInt, op)) {
+      /* lhs holds a small integer in the name itself, and rhs is an integer
+       * too - so it can be updated in place without allocating anything */
+      jsvUnLock(rhs);
+      return lhs;
+    }
     rhs = jsvSkipNameAndUnLock(rhs); // ensure we get rid of any references on the RHS
 
     if (JSP_SHOULD_EXECUTE && lhs) {
       if (op=='=') {
         jsvReplaceWithOrAddToRoot(lhs, rhs);
       } else {
-        if (op==LEX_PLUSEQUAL) op='+';
-        else if (op==LEX_MINUSEQUAL) op='-';
-        else if (op==LEX_MULEQUAL) op='*';
-        else if (op==LEX_DIVEQUAL) op='/';
-        else if (op==LEX_MODEQUAL) op='%';
-        else if (op==LEX_ANDEQUAL) op='&';
-        else if (op==LEX_OREQUAL) op='|';
-        else if (op==LEX_XOREQUAL) op='^';
-        else if (op==LEX_RSHIFTEQUAL) op=LEX_RSHIFT;
-        else if (op==LEX_LSHIFTEQUAL) op=LEX_LSHIFT;
-        else if (op==LEX_RSHIFTUNSIGNEDEQUAL) op=LEX_RSHIFTUNSIGNED;
         if (op=='+' && jsvIsName(lhs)) {
           JsVar *currentValue = jsvSkipName(lhs);
           if (jsvIsBasicString(currentValue) && jsvGetRefs(currentValue)==1 && rhs!=currentValue) {
@@ -2822,7 +3103,12 @@ NO_INLINE JsVar *jspeStatementReturn() {
     result = jsvSkipNameAndUnLock(jspeExpression());
   }
   if (JSP_SHOULD_EXECUTE) {
+#ifndef SAVE_ON_FLASH
+    JsVar *resultVar = (jspFrame && jspFrame->returnVar && lex->sourceVar==jspFrame->code) ?
+        jsvLockAgain(jspFrame->returnVar) : jspeiFindInScopes(JSPARSE_RETURN_VAR);
+#else
     JsVar *resultVar = jspeiFindInScopes(JSPARSE_RETURN_VAR);
+#endif
     if (resultVar) {
       jsvReplaceWith(resultVar, result);
       jsvUnLock(resultVar);
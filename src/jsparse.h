@@ -197,6 +197,10 @@ JsVar *jspGetNamedVariable(const char *tokenName);
  * a symbol rather than a variable. To handle these use jspGetVarNamedField  */
 JsVar *jspGetNamedField(JsVar *object, const char* name, bool returnName);
 JsVar *jspGetVarNamedField(JsVar *object, JsVar *nameVar, bool returnName);
+#ifndef SAVE_ON_FLASH
+/// Get how many `a.b` lookups have been able to use the last place the field was found, and how many haven't
+void jspGetFieldCacheStats(unsigned int *hits, unsigned int *misses);
+#endif
 
 // These are exported for the Web IDE's compiler. See exportPtrs in jswrap_process.c
 JsVar *jspeiFindInScopes(const char *name);
@@ -113,6 +113,9 @@ bool jsserialPopulateUSARTInfo(
       {"parity", JSV_OBJECT /* a variable */, &parity},
       {"flow", JSV_OBJECT /* a variable */, &flow},
       {"errors", JSV_BOOLEAN, &inf->errorHandling},
+#ifndef SAVE_ON_FLASH
+      {"framing", JSV_OBJECT, 0}, // handled by jsserialFramingSetup
+#endif
   };
 
   if (!jsvIsUndefined(baud)) {
@@ -294,11 +297,18 @@ bool jsserialEventCallbackIdle() {
           busy = true; // waiting for this byte to finish
       }
       if (data->bufLen) {
-        JsVar *stringData = jsvNewStringOfLength(data->bufLen, data->buf);
-        data->bufLen = 0;
-        if (stringData) {
-          jswrap_stream_pushData(parent, stringData, true);
-          jsvUnLock(stringData);
+        JsVar *framing = jsserialGetFraming(parent);
+        if (framing) {
+          jsserialFramingPush(parent, framing, data->buf, data->bufLen);
+          data->bufLen = 0;
+          jsvUnLock(framing);
+        } else {
+          JsVar *stringData = jsvNewStringOfLength(data->bufLen, data->buf);
+          data->bufLen = 0;
+          if (stringData) {
+            jswrap_stream_pushData(parent, stringData, true);
+            jsvUnLock(stringData);
+          }
         }
       }
     }
@@ -341,3 +351,236 @@ void jsserialEventCallback(bool state, IOEventFlags channel) {
 
 }
 #endif
+
+#ifndef SAVE_ON_FLASH
+typedef enum {
+  SERIAL_FRAMING_LINE,      ///< frames end with a newline, '\r' before it is removed
+  SERIAL_FRAMING_DELIMITER, ///< frames end with a single delimiter character
+  SERIAL_FRAMING_LENGTH,    ///< each frame starts with a 1 or 2 byte length
+  SERIAL_FRAMING_SLIP,      ///< RFC1055 SLIP
+  SERIAL_FRAMING_COBS,      ///< Consistent Overhead Byte Stuffing, frames end with 0
+} SerialFramingType;
+
+#define SLIP_END 0xC0
+#define SLIP_ESC 0xDB
+#define SLIP_ESC_END 0xDC
+#define SLIP_ESC_ESC 0xDD
+
+/// Header of the flat string stored in SERIAL_FRAMING_NAME. The frame buffer (maxLength bytes) follows it
+typedef struct {
+  unsigned char type; ///< SerialFramingType
+  unsigned char delimiter; ///< character that ends a frame for line/delimiter
+  unsigned char lengthBytes; ///< 'length' - how many bytes in the length header
+  bool lengthLE; ///< 'length' - is the length header little-endian?
+  bool discard; ///< this frame overflowed or was malformed - drop data until it ends
+  unsigned char state; ///< 'line' - last char was '\r', 'length' - header bytes read, 'slip' - last char was ESC, 'cobs' - code of the current block
+  uint16_t expected; ///< 'length' - payload bytes still to come, 'cobs' - bytes left in the current block
+  uint16_t maxLength; ///< size of the frame buffer
+  uint16_t len; ///< amount of data in the frame buffer
+  uint32_t packets; ///< frames emitted
+  uint32_t overflows; ///< frames dropped because they were bigger than maxLength
+  uint32_t errors; ///< frames dropped because they were malformed
+} PACKED_FLAGS SerialFraming;
+
+bool jsserialFramingSetup(JsVar *parent, JsVar *options) {
+  JsVar *framingOptions = jsvIsObject(options) ? jsvObjectGetChild(options, "framing", 0) : 0;
+  if (jsvIsUndefined(framingOptions) || jsvIsNull(framingOptions)) {
+    jsvUnLock(framingOptions);
+    jsvObjectRemoveChild(parent, SERIAL_FRAMING_NAME);
+    return true;
+  }
+
+  JsVar *type = 0;
+  JsVar *delimiter = 0;
+  JsVarInt maxLength = SERIAL_FRAMING_DEFAULT_LENGTH;
+  JsVarInt lengthBytes = 1;
+  bool lengthLE = false;
+  jsvConfigObject configs[] = {
+      {"type", JSV_STRING_0, &type},
+      {"delimiter", JSV_OBJECT /* a variable */, &delimiter},
+      {"maxLength", JSV_INTEGER, &maxLength},
+      {"bytes", JSV_INTEGER, &lengthBytes},
+      {"le", JSV_BOOLEAN, &lengthLE},
+  };
+  bool ok = jsvReadConfigObject(framingOptions, configs, sizeof(configs) / sizeof(jsvConfigObject));
+  jsvUnLock(framingOptions);
+
+  SerialFraming framing;
+  memset(&framing, 0, sizeof(framing));
+  framing.delimiter = '\n';
+  if (ok) {
+    if (jsvIsStringEqual(type, "line")) framing.type = SERIAL_FRAMING_LINE;
+    else if (jsvIsStringEqual(type, "delimiter")) framing.type = SERIAL_FRAMING_DELIMITER;
+    else if (jsvIsStringEqual(type, "length")) framing.type = SERIAL_FRAMING_LENGTH;
+    else if (jsvIsStringEqual(type, "slip")) framing.type = SERIAL_FRAMING_SLIP;
+    else if (jsvIsStringEqual(type, "cobs")) framing.type = SERIAL_FRAMING_COBS;
+    else {
+      jsExceptionHere(JSET_ERROR, "Invalid framing type %q", type);
+      ok = false;
+    }
+  }
+  if (ok && delimiter) {
+    if (jsvIsString(delimiter) && jsvGetStringLength(delimiter)==1)
+      framing.delimiter = (unsigned char)jsvGetCharInString(delimiter, 0);
+    else if (jsvIsInt(delimiter))
+      framing.delimiter = (unsigned char)jsvGetInteger(delimiter);
+    else {
+      jsExceptionHere(JSET_ERROR, "Framing delimiter should be a single character or integer, got %q", delimiter);
+      ok = false;
+    }
+  } else if (ok && framing.type==SERIAL_FRAMING_DELIMITER) {
+    jsExceptionHere(JSET_ERROR, "Framing type 'delimiter' needs a 'delimiter'");
+    ok = false;
+  }
+  if (ok && (maxLength<1 || maxLength>0xFFFF)) {
+    jsExceptionHere(JSET_ERROR, "Framing maxLength should be between 1 and 65535, got %d", (int)maxLength);
+    ok = false;
+  }
+  if (ok && lengthBytes!=1 && lengthBytes!=2) {
+    jsExceptionHere(JSET_ERROR, "Framing length 'bytes' should be 1 or 2, got %d", (int)lengthBytes);
+    ok = false;
+  }
+  jsvUnLock2(type, delimiter);
+  if (!ok) return false;
+
+  framing.lengthBytes = (unsigned char)lengthBytes;
+  framing.lengthLE = lengthLE;
+  framing.maxLength = (uint16_t)maxLength;
+  JsVar *framingVar = jsvNewFlatStringOfLength((unsigned int)(sizeof(SerialFraming) + framing.maxLength));
+  if (!framingVar) {
+    jsExceptionHere(JSET_ERROR, "Unable to allocate %d bytes for Serial framing", (int)framing.maxLength);
+    return false;
+  }
+  memcpy(jsvGetFlatStringPointer(framingVar), &framing, sizeof(SerialFraming));
+  jsvObjectSetChildAndUnLock(parent, SERIAL_FRAMING_NAME, framingVar);
+  return true;
+}
+
+JsVar *jsserialGetFraming(JsVar *parent) {
+  return jsvObjectGetChild(parent, SERIAL_FRAMING_NAME, 0);
+}
+
+static void jsserialFramingAppend(SerialFraming *f, unsigned char ch) {
+  if (f->discard) return;
+  if (f->len >= f->maxLength) {
+    f->overflows++;
+    f->discard = true;
+    return;
+  }
+  ((unsigned char*)(f+1))[f->len++] = ch;
+}
+
+/// A frame has ended - emit it as a packet event if it's ok, and get ready for the next one
+static void jsserialFramingEnd(JsVar *parent, SerialFraming *f, bool allowEmpty) {
+  JsVar *packet = 0;
+  if (!f->discard && (f->len || allowEmpty)) {
+    packet = jsvNewStringOfLength(f->len, (const char*)(f+1));
+    f->packets++;
+  }
+  f->len = 0;
+  f->discard = false;
+  f->state = 0;
+  f->expected = 0;
+  if (packet) {
+    jsiExecuteObjectCallbacks(parent, JS_EVENT_PREFIX"packet", &packet, 1);
+    jsvUnLock(packet);
+  }
+}
+
+void jsserialFramingPush(JsVar *parent, JsVar *framing, const char *data, size_t len) {
+  SerialFraming *f = (SerialFraming*)jsvGetFlatStringPointer(framing);
+  if (!f) return;
+  for (size_t i=0;i<len;i++) {
+    unsigned char ch = (unsigned char)data[i];
+    switch (f->type) {
+    case SERIAL_FRAMING_LINE:
+    case SERIAL_FRAMING_DELIMITER:
+      if (ch == f->delimiter) {
+        jsserialFramingEnd(parent, f, true); // drops any '\r' we were holding
+      } else if (f->type==SERIAL_FRAMING_LINE && ch=='\r') {
+        // don't store a '\r' until we know it's not before the newline, so it doesn't count towards maxLength
+        if (f->state) jsserialFramingAppend(f, '\r');
+        f->state = 1;
+      } else {
+        if (f->state) jsserialFramingAppend(f, '\r');
+        f->state = 0;
+        jsserialFramingAppend(f, ch);
+      }
+      break;
+    case SERIAL_FRAMING_LENGTH:
+      if (f->state < f->lengthBytes) { // still reading the length header
+        if (f->lengthLE) f->expected |= (uint16_t)(ch << (8*f->state));
+        else f->expected = (uint16_t)((f->expected<<8) | ch);
+        f->state++;
+        if (f->state == f->lengthBytes) {
+          if (!f->expected) {
+            jsserialFramingEnd(parent, f, true);
+          } else if (f->expected > f->maxLength) {
+            // too big - still count through the payload so we stay in sync
+            f->overflows++;
+            f->discard = true;
+          }
+        }
+      } else {
+        jsserialFramingAppend(f, ch);
+        if (!--f->expected)
+          jsserialFramingEnd(parent, f, true);
+      }
+      break;
+    case SERIAL_FRAMING_SLIP:
+      if (ch == SLIP_END) {
+        if (f->state && !f->discard) { // ESC followed by END
+          f->errors++;
+          f->discard = true;
+        }
+        jsserialFramingEnd(parent, f, false); // SLIP senders often start frames with END too
+      } else if (f->state) {
+        f->state = 0;
+        if (ch == SLIP_ESC_END) jsserialFramingAppend(f, SLIP_END);
+        else if (ch == SLIP_ESC_ESC) jsserialFramingAppend(f, SLIP_ESC);
+        else if (!f->discard) {
+          f->errors++;
+          f->discard = true;
+        }
+      } else if (ch == SLIP_ESC) {
+        f->state = 1;
+      } else
+        jsserialFramingAppend(f, ch);
+      break;
+    case SERIAL_FRAMING_COBS:
+      if (!ch) {
+        if (f->expected && !f->discard) { // frame ended part way through a block
+          f->errors++;
+          f->discard = true;
+        }
+        jsserialFramingEnd(parent, f, f->state!=0);
+      } else if (!f->expected) { // start of a new block
+        // each block except the last (or one after a full 254 byte block) was followed by a zero
+        if (f->state && f->state!=0xFF)
+          jsserialFramingAppend(f, 0);
+        f->state = ch;
+        f->expected = (uint16_t)(ch-1);
+      } else {
+        jsserialFramingAppend(f, ch);
+        f->expected--;
+      }
+      break;
+    }
+  }
+}
+
+JsVar *jsserialFramingGetInfo(JsVar *parent) {
+  JsVar *framing = jsserialGetFraming(parent);
+  SerialFraming *f = (SerialFraming*)jsvGetFlatStringPointer(framing);
+  JsVar *info = 0;
+  if (f) info = jsvNewObject();
+  if (info) {
+    jsvObjectSetChildAndUnLock(info, "packets", jsvNewFromInteger((JsVarInt)f->packets));
+    jsvObjectSetChildAndUnLock(info, "overflows", jsvNewFromInteger((JsVarInt)f->overflows));
+    jsvObjectSetChildAndUnLock(info, "errors", jsvNewFromInteger((JsVarInt)f->errors));
+    jsvObjectSetChildAndUnLock(info, "pending", jsvNewFromInteger(f->len));
+  }
+  jsvUnLock(framing);
+  return info;
+}
+#endif
@@ -32,5 +32,17 @@ bool jsserialEventCallbackIdle();
 // This is used with jshSetEventCallback to allow Serial data to be received in software
 void jsserialEventCallback(bool state, IOEventFlags flags);
 
+#define SERIAL_FRAMING_NAME JS_HIDDEN_CHAR_STR"frm"
+#define SERIAL_FRAMING_DEFAULT_LENGTH 256 // default maximum size of one frame
+
+/// Set up packet framing from `options.framing` (or remove it if not specified). Returns false on error
+bool jsserialFramingSetup(JsVar *parent, JsVar *options);
+/// Return the framing data for this Serial device (or 0 if not framed)
+JsVar *jsserialGetFraming(JsVar *parent);
+/// Feed received characters into the framer, emitting a 'packet' event for each complete frame
+void jsserialFramingPush(JsVar *parent, JsVar *framing, const char *data, size_t len);
+/// Return an object containing packet/overflow/error counts for the framer
+JsVar *jsserialFramingGetInfo(JsVar *parent);
+
 
 
@@ -13,6 +13,7 @@
  */
 #include "jsspi.h"
 #include "jsinteractive.h"
+#include "jswrap_promise.h"
 
 /**
  * Dump the internal SPI Info data structure to the console.
@@ -237,3 +238,134 @@ void jsspiSend8bit(IOEventFlags device, unsigned char data, int bit0, int bit1)
   jshSPISend(device, ((((data>>3)&1) ? bit1 : bit0)<<8) | (((data>>2)&1) ? bit1 : bit0));
   jshSPISend(device, ((((data>>1)&1) ? bit1 : bit0)<<8) | (((data>>0)&1) ? bit1 : bit0));
 }
+
+#ifdef JSSPI_ASYNC
+/* Async writes are kept in an array on the SPI object of { b : flat string, p : promise,
+ * n : NSS pin (optional), s : true once handed to the hardware }. Flat strings never
+ * move in memory, so the hardware can DMA straight out of them. */
+
+// Giving jshSPISendMany a callback makes it return as soon as the transfer is queued.
+// We don't need to do anything in it as jshSPIPoll tells us how many are still going.
+static void jsspiAsyncSent() {
+}
+
+/// Resolve async writes that have been sent, then hand more to the hardware. Returns false once the queue is empty
+static bool jsspiAsyncProcess(JsVar *spiDevice, IOEventFlags device) {
+  JsVar *queue = jsvObjectGetChild(spiDevice, JSSPI_ASYNC_QUEUE_NAME, 0);
+  if (!queue) return false;
+  bool busy = true;
+  while (busy) {
+    // Synchronous sends wait for everything in progress, so any transfers still
+    // going must be the newest of the async ones we've handed to the hardware
+    int inFlight = DEVICE_IS_SPI(device) ? jshSPIPoll(device) : 0;
+    int submitted = 0;
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, queue);
+    while (jsvObjectIteratorHasValue(&it)) {
+      JsVar *entry = jsvObjectIteratorGetValue(&it);
+      if (jsvGetBoolAndUnLock(jsvObjectGetChild(entry, "s", 0))) submitted++;
+      jsvUnLock(entry);
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    // Resolve the ones that are finished
+    for (int done = submitted - inFlight; done>0; done--) {
+      JsVar *entry = jsvSkipNameAndUnLock(jsvArrayPopFirst(queue));
+      if (!entry) break;
+      Pin nss = jshGetPinFromVarAndUnLock(jsvObjectGetChild(entry, "n", 0));
+      if (nss != PIN_UNDEFINED) jshPinOutput(nss, true);
+      JsVar *promise = jsvObjectGetChild(entry, "p", 0);
+      jspromise_resolve(promise, 0);
+      jsvUnLock2(promise, entry);
+      submitted--;
+    }
+    // Hand more to the hardware. NSS has to be toggled between writes that use it, so they go on their own
+    int started = 0;
+    jsvObjectIteratorNew(&it, queue);
+    while (jsvObjectIteratorHasValue(&it) && submitted<JSSPI_ASYNC_IN_FLIGHT) {
+      JsVar *entry = jsvObjectIteratorGetValue(&it);
+      JsVar *nssVar = jsvObjectGetChild(entry, "n", 0);
+      bool sent = jsvGetBoolAndUnLock(jsvObjectGetChild(entry, "s", 0));
+      if (!sent && !(nssVar && submitted)) {
+        JsVar *buf = jsvObjectGetChild(entry, "b", 0);
+        size_t len = 0;
+        unsigned char *ptr = (unsigned char*)jsvGetDataPointer(buf, &len);
+        if (nssVar) jshPinOutput(jshGetPinFromVar(nssVar), false);
+        if (DEVICE_IS_SPI(device)) {
+          jshSPISendMany(device, ptr, NULL, len, jsspiAsyncSent);
+        } else {
+          spi_sender spiSend;
+          spi_sender_data spiSendData;
+          if (jsspiGetSendFunction(spiDevice, &spiSend, &spiSendData))
+            spiSend(ptr, NULL, (unsigned int)len, &spiSendData);
+        }
+        jsvUnLock(buf);
+        jsvObjectSetChildAndUnLock(entry, "s", jsvNewFromBool(true));
+        submitted++;
+        started++;
+      }
+      bool stop = nssVar!=0;
+      jsvUnLock2(nssVar, entry);
+      if (stop) break;
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    // If the hardware finished what we started straight away, go round again
+    busy = started>0;
+  }
+  bool empty = !jsvGetChildren(queue);
+  if (empty) jsvObjectRemoveChild(spiDevice, JSSPI_ASYNC_QUEUE_NAME);
+  jsvUnLock(queue);
+  return !empty;
+}
+
+JsVar *jsspiSendAsync(JsVar *spiDevice, JsVar *data, Pin nss) {
+  IOEventFlags device = jsiGetDeviceFromClass(spiDevice);
+  spi_sender spiSend;
+  spi_sender_data spiSendData;
+  if (!jsspiGetSendFunction(spiDevice, &spiSend, &spiSendData))
+    return 0;
+  // All the data goes in one flat buffer, so single bytes get sent as one transfer
+  unsigned int len = (unsigned int)jsvIterateCallbackCount(data);
+  if (!len) return jswrap_promise_resolve(0);
+  JsVar *buf = jsvNewFlatStringOfLength(len);
+  if (!buf) {
+    jsExceptionHere(JSET_ERROR, "Unable to allocate %d bytes for SPI write", len);
+    return 0;
+  }
+  jsvIterateCallbackToBytes(data, (unsigned char*)jsvGetFlatStringPointer(buf), len);
+  JsVar *promise = jspromise_create();
+  JsVar *entry = jsvNewObject();
+  JsVar *queue = jsvObjectGetChild(spiDevice, JSSPI_ASYNC_QUEUE_NAME, JSV_ARRAY);
+  if (!promise || !entry || !queue) {
+    jsvUnLock4(buf, promise, entry, queue);
+    return 0;
+  }
+  jsvObjectSetChildAndUnLock(entry, "b", buf);
+  jsvObjectSetChild(entry, "p", promise);
+  if (nss != PIN_UNDEFINED) jsvObjectSetChildAndUnLock(entry, "n", jsvNewFromPin(nss));
+  jsvArrayPushAndUnLock(queue, entry);
+  jsvUnLock(queue);
+  jsspiAsyncProcess(spiDevice, device);
+  return promise;
+}
+
+void jsspiAsyncFlush(JsVar *spiDevice) {
+  JsVar *queue = jsvObjectGetChild(spiDevice, JSSPI_ASYNC_QUEUE_NAME, 0);
+  jsvUnLock(queue);
+  if (!queue) return; // nothing queued
+  IOEventFlags device = jsiGetDeviceFromClass(spiDevice);
+  do {
+    if (DEVICE_IS_SPI(device)) jshSPIWait(device);
+  } while (jsspiAsyncProcess(spiDevice, device));
+}
+
+void jsspiHandleIOEvent(IOEventFlags device) {
+  JsVar *spiDevice = jsvSkipNameAndUnLock(jsiGetClassNameFromDevice(device));
+  // If nothing is queued (eg. a synchronous write sent it all) we still have to
+  // poll, so the hardware knows to push an event for the next transfer
+  if (!jsvIsObject(spiDevice) || !jsspiAsyncProcess(spiDevice, device))
+    jshSPIPoll(device);
+  jsvUnLock(spiDevice);
+}
+#endif
@@ -41,3 +41,16 @@ void jsspiSend4bit(IOEventFlags device, unsigned char data, int bit0, int bit1);
 
 /// Send 8 bits, but with a byte for each bit - used by jswrap_spi_send8bit. Expects SPI in 16 bit mode
 void jsspiSend8bit(IOEventFlags device, unsigned char data, int bit0, int bit1);
+
+#if !defined(SAVE_ON_FLASH) && !defined(ESPR_NO_PROMISES)
+#define JSSPI_ASYNC // SPI.write(..., {async:true})
+#define JSSPI_ASYNC_QUEUE_NAME JS_HIDDEN_CHAR_STR"aQ"
+#define JSSPI_ASYNC_IN_FLIGHT 3 // how many async writes we hand to the SPI hardware at once
+
+/// Queue data to be sent without waiting for it (NSS is asserted while it's sent if nss is a pin). Returns a promise resolved once it has been sent
+JsVar *jsspiSendAsync(JsVar *spiDevice, JsVar *data, Pin nss);
+/// Wait until all async writes on this SPI have been sent, resolving their promises and raising NSS. Call before sending synchronously
+void jsspiAsyncFlush(JsVar *spiDevice);
+/// The SPI hardware has finished a transfer - resolve any async writes that are done and start more
+void jsspiHandleIOEvent(IOEventFlags device);
+#endif
@@ -21,6 +21,7 @@
 #include "jswrap_object.h" // for jswrap_object_toString
 #include "jswrap_arraybuffer.h" // for jsvNewTypedArray
 #include "jswrap_dataview.h" // for jsvNewDataViewWithData
+#include "jstimer.h" // for jstUtilTimerIsRunning
 #if defined(ESPR_JIT) && defined(LINUX)
 #include <sys/mman.h>
 #endif
@@ -63,6 +64,120 @@ typedef enum {
 volatile bool touchedFreeList = false;
 volatile JsVarRef jsVarFirstEmpty; ///< reference of first unused variable (variables are in a linked list)
 volatile MemBusyType isMemoryBusy; ///< Are we doing garbage collection or similar, so can't access memory?
+unsigned int jsvRootVersion; ///< Changed whenever names are added to or removed from the root scope (or may have moved)
+#ifndef SAVE_ON_FLASH
+unsigned int jsvAllocationCount; ///< How many vars have been allocated since startup (wraps around)
+#endif
+
+/* Where the last block of the string we last appended to is, so that
+ * repeated appends (eg. `s += chunk`) don't have to walk the whole string
+ * each time. Cleared whenever either var might be freed or moved. */
+static JsVarRef appendCacheString; ///< The string we last appended to
+static JsVarRef appendCacheTail;   ///< Its last StringExt when we finished
+static size_t appendCacheIndex;    ///< Index of the first character in appendCacheTail
+
+#ifndef SAVE_ON_FLASH
+#define JSV_NAMES_WATCHED 16 ///< How many vars we can watch for changes to their names
+/* Vars that cached property lookups depend on (see jsvWatchNames). jsvNamesVersion
+ * changes whenever names are added to or removed from any of them, or when any
+ * of them is freed or moved - and then the list is emptied, as the caches will be. */
+static JsVarRef jsvNamesWatched[JSV_NAMES_WATCHED];
+static unsigned char jsvNamesWatchedCount;
+static uint32_t jsvNamesWatchedMask; ///< bit (ref&31) set for each var in jsvNamesWatched, so most vars can be ruled out quickly
+static unsigned int jsvNamesVersion;
+
+/// Something cached lookups depend on has changed
+static void jsvNamesChanged() {
+  jsvNamesVersion++;
+  jsvNamesWatchedCount = 0;
+  jsvNamesWatchedMask = 0;
+}
+
+/// Call jsvNamesChanged if the var with this ref is being watched
+static void jsvNamesCheck(JsVarRef ref) {
+  if (!(jsvNamesWatchedMask & (1u<<(ref&31)))) return;
+  for (int i=0;i<jsvNamesWatchedCount;i++)
+    if (jsvNamesWatched[i]==ref) {
+      jsvNamesChanged();
+      return;
+    }
+}
+
+/// Get how many vars have been allocated since startup (wraps around)
+unsigned int jsvGetAllocationCount() {
+  return jsvAllocationCount;
+}
+
+/// Get a number that changes whenever names are added to or removed from a var passed to jsvWatchNames (or it is freed or moved)
+unsigned int jsvGetNamesVersion() {
+  return jsvNamesVersion;
+}
+
+/// Make jsvGetNamesVersion change if v's names change. Returns false if we're already watching as many vars as we can
+bool jsvWatchNames(JsVar *v) {
+  JsVarRef ref = jsvGetRef(v);
+  for (int i=0;i<jsvNamesWatchedCount;i++)
+    if (jsvNamesWatched[i]==ref) return true;
+  if (jsvNamesWatchedCount>=JSV_NAMES_WATCHED) return false;
+  jsvNamesWatched[jsvNamesWatchedCount++] = ref;
+  jsvNamesWatchedMask |= 1u<<(ref&31);
+  return true;
+}
+#else
+#define jsvNamesChanged()
+#define jsvNamesCheck(REF)
+#endif
+
+static ALWAYS_INLINE void jsvAppendCacheClear() {
+  appendCacheString = 0;
+  appendCacheTail = 0;
+}
+
+/* Hints for jsvNewFlatStringOfLength - for each size class, a run of
+ * blocks that are consecutive both in memory and in the free list. These
+ * are checked before they're used, so it doesn't matter if they go stale. */
+#define JSV_FREE_RUN_CLASSES 8 // 2-3 blocks, 4-7, 8-15, ... 256+
+typedef struct {
+  JsVarRef prev;       ///< free list entry before 'start', or 0 if 'start' was jsVarFirstEmpty
+  JsVarRef start;      ///< first block of the run, or 0 if none
+  unsigned int length; ///< blocks in the run
+} JsvFreeRun;
+static JsvFreeRun jsvFreeRuns[JSV_FREE_RUN_CLASSES];
+
+static ALWAYS_INLINE void jsvFreeRunsClear() {
+  memset(jsvFreeRuns, 0, sizeof(jsvFreeRuns));
+}
+
+static unsigned int jsvFreeRunClass(unsigned int blocks) {
+  unsigned int c = 0;
+  while (blocks>3 && c<JSV_FREE_RUN_CLASSES-1) {
+    blocks >>= 1;
+    c++;
+  }
+  return c;
+}
+
+/// Remember a run of free blocks. Newer runs replace older ones, except in the top size class where we keep the biggest
+static void jsvFreeRunRecord(JsVarRef prev, JsVarRef start, unsigned int length) {
+  if (!start || length<2) return;
+  unsigned int c = jsvFreeRunClass(length);
+  JsvFreeRun *run = &jsvFreeRuns[c];
+  if (c==JSV_FREE_RUN_CLASSES-1 && run->start && run->length>length) return;
+  run->prev = prev;
+  run->start = start;
+  run->length = length;
+}
+
+/// Forget any runs that overlap blocks that have just been used (flat string data looks like free blocks)
+static void jsvFreeRunsRemove(JsVarRef start, unsigned int length) {
+  for (unsigned int c=0;c<JSV_FREE_RUN_CLASSES;c++) {
+    JsvFreeRun *run = &jsvFreeRuns[c];
+    if (run->start &&
+        ((run->prev>=start && run->prev<start+length) ||
+         (run->start<start+length && start<run->start+run->length)))
+      run->start = 0;
+  }
+}
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -246,10 +361,9 @@ void jsvSetMaxVarsUsed(unsigned int size) {
 
 }
 
-// maps the empty variables in...
-void jsvCreateEmptyVarList() {
-  assert(!isMemoryBusy);
-  isMemoryBusy = MEMBUSY_SYSTEM;
+// maps the empty variables in... (isMemoryBusy must already be set)
+static void jsvCreateEmptyVarListInternal() {
+  jsvFreeRunsClear();
   jsVarFirstEmpty = 0;
   JsVar firstVar; // temporary var to simplify code in the loop below
   jsvSetNextSibling(&firstVar, 0);
@@ -268,6 +382,12 @@ void jsvCreateEmptyVarList() {
   }
   jsvSetNextSibling(lastEmpty, 0);
   jsVarFirstEmpty = jsvGetNextSibling(&firstVar);
+}
+
+void jsvCreateEmptyVarList() {
+  assert(!isMemoryBusy);
+  isMemoryBusy = MEMBUSY_SYSTEM;
+  jsvCreateEmptyVarListInternal();
   isMemoryBusy = MEM_NOT_BUSY;
 }
 
@@ -277,6 +397,7 @@ void jsvCreateEmptyVarList() {
 void jsvClearEmptyVarList() {
   assert(!isMemoryBusy);
   isMemoryBusy = MEMBUSY_SYSTEM;
+  jsvFreeRunsClear();
   jsVarFirstEmpty = 0;
   JsVarRef i;
   for (i=1;i<=jsVarsSize;i++) {
@@ -293,10 +414,16 @@ void jsvClearEmptyVarList() {
 }
 
 void jsvSoftInit() {
+  jsvAppendCacheClear();
+  jsvRootVersion++;
+  jsvNamesChanged();
   jsvCreateEmptyVarList();
 }
 
 void jsvSoftKill() {
+  jsvRootVersion++;
+  jsvNamesChanged();
+  jsvAppendCacheClear();
   jsvClearEmptyVarList();
 }
 
@@ -387,11 +514,35 @@ unsigned int jsvGetMemoryUsage() {
   return usage;
 }
 
+/// Get the number of separate runs of free blocks, and the length of the biggest one
+void jsvGetMemoryFragmentation(unsigned int *freeRuns, unsigned int *largestFree) {
+  unsigned int runs = 0, largest = 0, length = 0;
+  for (unsigned int i=1;i<=jsVarsSize;i++) {
+    JsVar *v = jsvGetAddressOf((JsVarRef)i);
+    if ((v->flags&JSV_VARTYPEMASK) == JSV_UNUSED) {
+      if (!length) runs++;
+      length++;
+      if (length>largest) largest=length;
+    } else {
+      length = 0;
+      if (jsvIsFlatString(v))
+        i += (unsigned int)jsvGetFlatStringBlocks(v);
+    }
+  }
+  *freeRuns = runs;
+  *largestFree = largest;
+}
+
 /// Get total amount of memory records
 unsigned int jsvGetMemoryTotal() {
   return jsVarsSize;
 }
 
+/// Get a number that changes whenever names are added to or removed from the root scope
+unsigned int jsvGetRootVersion() {
+  return jsvRootVersion;
+}
+
 /// Try and allocate more memory - only works if RESIZABLE_JSVARS is defined
 void jsvSetMemoryTotal(unsigned int jsNewVarCount) {
 #ifdef RESIZABLE_JSVARS
@@ -561,6 +712,9 @@ JsVar *jsvNewWithFlags(JsVarFlags flags) {
     v = jsvGetAddressOf(jsVarFirstEmpty); // jsvResetVariable will lock
     jsVarFirstEmpty = jsvGetNextSibling(v); // move our reference to the next in the free list
     touchedFreeList = true;
+#ifndef SAVE_ON_FLASH
+    jsvAllocationCount++;
+#endif
   }
   jshInterruptOn();
   if (v) {
@@ -609,6 +763,10 @@ JsVar *jsvNewWithFlags(JsVarFlags flags) {
 
 static void jsvFreePtrInternal(JsVar *var) {
   assert(jsvGetLocks(var)==0);
+  JsVarRef ref = jsvGetRef(var);
+  if (ref==appendCacheString || ref==appendCacheTail)
+    jsvAppendCacheClear();
+  jsvNamesCheck(ref);
   var->flags = JSV_UNUSED;
   // add this to our free list
   jshInterruptOff(); // to allow this to be used from an IRQ
@@ -682,6 +840,9 @@ ALWAYS_INLINE void jsvFreePtr(JsVar *var) {
       insertBefore = jsvGetNextSibling(jsvGetAddressOf(insertBefore));
     }
     // free in reverse, so the free list ends up in kind of the right order
+    // The header goes in too, so all the blocks are one run in the free list
+    unsigned int runLength = (unsigned int)count+1;
+    count++;
     while (count--) {
       JsVar *p = jsvGetAddressOf(i--);
       p->flags = JSV_UNUSED; // set locks to 0 so the assert in jsvFreePtrInternal doesn't get fed up
@@ -694,8 +855,11 @@ ALWAYS_INLINE void jsvFreePtr(JsVar *var) {
       jsvSetNextSibling(jsvGetAddressOf(insertAfter), insertBefore);
     else
       jsVarFirstEmpty = insertBefore;
+    // these blocks are now a run of free blocks, so the next flat string can use them
+    jsvFreeRunRecord(insertAfter, insertBefore, runLength);
     touchedFreeList = true;
     jshInterruptOn();
+    return; // the header has been freed already
   }
 
   /* NO ELSE HERE - because jsvIsNewChild stuff can be for Names, which
@@ -881,6 +1045,43 @@ JsVarRef jsvUnRefRef(JsVarRef ref) {
   return 0;
 }
 
+/** Try and unlink 'blocks' contiguous free blocks using the hints in jsvFreeRuns.
+ * Must be called with interrupts off. Returns the first block, or 0 */
+static JsVar *jsvFreeRunTake(unsigned int blocks) {
+  for (unsigned int c=jsvFreeRunClass(blocks);c<JSV_FREE_RUN_CLASSES;c++) {
+    JsvFreeRun *run = &jsvFreeRuns[c];
+    if (!run->start || run->length<blocks) continue;
+    // the block after the header must be 4 byte aligned - see jsvNewFlatStringOfLength
+    if (run->start>=jsVarsSize || ((size_t)jsvGetAddressOf((JsVarRef)(run->start+1)))&3) {
+      run->start = 0;
+      continue;
+    }
+    // check it's all still free and linked in order
+    bool ok = run->prev ?
+        (jsvGetAddressOf(run->prev)->flags==JSV_UNUSED && jsvGetNextSibling(jsvGetAddressOf(run->prev))==run->start) :
+        (jsVarFirstEmpty==run->start);
+    JsVar *first = jsvGetAddressOf(run->start);
+    for (unsigned int i=0;ok && i<blocks;i++) {
+      JsVarRef ref = (JsVarRef)(run->start+i);
+      JsVar *v = jsvGetAddressOf(ref);
+      ok = v==first+i && v->flags==JSV_UNUSED && (i+1==blocks || jsvGetNextSibling(v)==ref+1);
+    }
+    if (!ok) {
+      run->start = 0;
+      continue;
+    }
+    JsVarRef nextFree = jsvGetNextSibling(first+blocks-1);
+    if (run->prev) jsvSetNextSibling(jsvGetAddressOf(run->prev), nextFree);
+    else jsVarFirstEmpty = nextFree;
+    // whatever is left is still a run, with the same thing before it in the free list
+    JsvFreeRun rest = { run->prev, (JsVarRef)(run->start+blocks), run->length-blocks };
+    jsvFreeRunsRemove(run->start, blocks); // including this one, and any in other size classes
+    if (nextFree==rest.start) jsvFreeRunRecord(rest.prev, rest.start, rest.length);
+    return first;
+  }
+  return 0;
+}
+
 JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
   bool firstRun = true;
   // Work out how many blocks we need. One for the header, plus some for the characters
@@ -891,6 +1092,15 @@ JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
     return 0;
   }
   while (true) {
+    // First, see if we know of a big enough run of free blocks already
+    jshInterruptOff();
+    flatString = jsvFreeRunTake((unsigned int)requiredBlocks);
+    if (flatString) {
+      jsvResetVariable(flatString, JSV_FLAT_STRING);
+      flatString->varData.integer = (JsVarInt)byteLength;
+    }
+    jshInterruptOn();
+    if (flatString) break;
     /* Now try and find a contiguous set of 'requiredBlocks' blocks by
     searching the free list. This can be done as long as nobody's
     messed with the free list in the mean time (which we check for with
@@ -927,13 +1137,15 @@ JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
               // Set up the header block (including one lock)
               jsvResetVariable(flatString, JSV_FLAT_STRING);
               flatString->varData.integer = (JsVarInt)byteLength;
+              jsvFreeRunsRemove(startBlock, (unsigned int)requiredBlocks);
             }
             jshInterruptOn();
             // if success, break out!
             if (flatString) break;
           }
         } else {
-          // this block is not immediately after the last - restart run
+          // this block is not immediately after the last - remember the run we had, and restart
+          jsvFreeRunRecord(beforeStartBlock, startBlock, blockCount);
           beforeStartBlock = curr;
           startBlock = next;
           // Check to see if the next block is aligned on a 4 byte boundary or not
@@ -960,7 +1172,12 @@ JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
     firstRun = false;
     jsvGarbageCollect();
   };
-  if (!flatString) return 0;
+  if (!flatString) {
+#ifndef SAVE_ON_FLASH
+    jsvDefragmentRequest(); // memory may be too fragmented - compact it when we're idle
+#endif
+    return 0;
+  }
   /* We now have the string! All that's left is to clear it */
   // clear data
   memset((char*)&flatString[1], 0, sizeof(JsVar)*(requiredBlocks-1));
@@ -1719,52 +1936,58 @@ size_t jsvGetIndexFromLineAndCol(JsVar *v, size_t line, size_t col) {
   return n;
 }
 
+/// Start an iterator at the end of a string we're about to append to, using the cached tail if we can
+static void jsvAppendIteratorNew(JsvStringIterator *it, JsVar *var) {
+  jsvStringIteratorNew(it, var, 0);
+  if (appendCacheString && appendCacheString==jsvGetRef(var) && jsvGetLastChild(var)) {
+    // the tail may have had more blocks added since, but jsvStringIteratorGotoEnd will handle that
+    jsvUnLock(it->var);
+    it->var = jsvLock(appendCacheTail);
+    it->varIndex = appendCacheIndex;
+    it->charsInVar = jsvGetCharactersInVar(it->var);
+  }
+  jsvStringIteratorGotoEnd(it);
+}
+
+/// Remember where the iterator finished appending to var, and free it
+static void jsvAppendIteratorFree(JsvStringIterator *it, JsVar *var) {
+  if (it->var && it->var!=var) {
+    appendCacheString = jsvGetRef(var);
+    appendCacheTail = jsvGetRef(it->var);
+    appendCacheIndex = it->varIndex;
+  } else if (appendCacheString==jsvGetRef(var))
+    jsvAppendCacheClear();
+  jsvStringIteratorFree(it);
+}
+
 void jsvAppendString(JsVar *var, const char *str) {
-  assert(jsvIsString(var));
-  JsvStringIterator dst;
-  jsvStringIteratorNew(&dst, var, 0);
-  jsvStringIteratorGotoEnd(&dst);
-  // now start appending
-  /* This isn't as fast as something single-purpose, but it's not that bad,
-   * and is less likely to break :) */
-  while (*str)
-    jsvStringIteratorAppend(&dst, *(str++));
-  jsvStringIteratorFree(&dst);
+  jsvAppendStringBuf(var, str, strlen(str));
 }
 
 // Append the given string to this one - but does not use null-terminated strings
 void jsvAppendStringBuf(JsVar *var, const char *str, size_t length) {
   assert(jsvIsString(var));
   JsvStringIterator dst;
-  jsvStringIteratorNew(&dst, var, 0);
-  jsvStringIteratorGotoEnd(&dst);
-  // now start appending
-  /* This isn't as fast as something single-purpose, but it's not that bad,
-   * and is less likely to break :) */
-  while (length) {
-    jsvStringIteratorAppend(&dst, *(str++));
-    length--;
-  }
-  jsvStringIteratorFree(&dst);
+  jsvAppendIteratorNew(&dst, var);
+  jsvStringIteratorAppendBuf(&dst, str, length);
+  jsvAppendIteratorFree(&dst, var);
 }
 
 /// Special version of append designed for use with vcbprintf_callback (See jsvAppendPrintf)
 void jsvStringIteratorPrintfCallback(const char *str, void *user_data) {
-  while (*str)
-    jsvStringIteratorAppend((JsvStringIterator *)user_data, *(str++));
+  jsvStringIteratorAppendBuf((JsvStringIterator *)user_data, str, strlen(str));
 }
 
 void jsvAppendPrintf(JsVar *var, const char *fmt, ...) {
   JsvStringIterator it;
-  jsvStringIteratorNew(&it, var, 0);
-  jsvStringIteratorGotoEnd(&it);
+  jsvAppendIteratorNew(&it, var);
 
   va_list argp;
   va_start(argp, fmt);
   vcbprintf((vcbprintf_callback)jsvStringIteratorPrintfCallback,&it, fmt, argp);
   va_end(argp);
 
-  jsvStringIteratorFree(&it);
+  jsvAppendIteratorFree(&it, var);
 }
 
 JsVar *jsvVarPrintf( const char *fmt, ...) {
@@ -1786,21 +2009,28 @@ JsVar *jsvVarPrintf( const char *fmt, ...) {
 /** Append str to var. Both must be strings. stridx = start char or str, maxLength = max number of characters (can be JSVAPPENDSTRINGVAR_MAXLENGTH) */
 void jsvAppendStringVar(JsVar *var, const JsVar *str, size_t stridx, size_t maxLength) {
   assert(jsvIsString(var));
+  if (var==str) {
+    // don't keep copying the characters we're adding
+    size_t l = jsvGetStringLength(str);
+    if (stridx>l) stridx=l;
+    if (maxLength>l-stridx) maxLength=l-stridx;
+  }
 
   JsvStringIterator dst;
-  jsvStringIteratorNew(&dst, var, 0);
-  jsvStringIteratorGotoEnd(&dst);
-  // now start appending
-  /* This isn't as fast as something single-purpose, but it's not that bad,
-     * and is less likely to break :) */
+  jsvAppendIteratorNew(&dst, var);
+  // now copy a block at a time
   JsvStringIterator it;
   jsvStringIteratorNewConst(&it, str, stridx);
-  while (jsvStringIteratorHasChar(&it) && (maxLength-->0)) {
-    char ch = jsvStringIteratorGetCharAndNext(&it);
-    jsvStringIteratorAppend(&dst, ch);
+  while (maxLength && jsvStringIteratorHasChar(&it)) {
+    size_t len = it.charsInVar - it.charIdx;
+    if (len>maxLength) len=maxLength;
+    jsvStringIteratorAppendBuf(&dst, &it.ptr[it.charIdx], len);
+    maxLength -= len;
+    it.charIdx += len-1; // jsvStringIteratorNext will move past the last one
+    jsvStringIteratorNext(&it);
   }
   jsvStringIteratorFree(&it);
-  jsvStringIteratorFree(&dst);
+  jsvAppendIteratorFree(&dst, var);
 }
 
 /** Create a new variable from a substring. argument must be a string. stridx = start char or str, maxLength = max number of characters (can be JSVAPPENDSTRINGVAR_MAXLENGTH) */
@@ -2637,6 +2867,8 @@ JsVar *jsvCopy(JsVar *src, bool copyChildren) {
 void jsvAddName(JsVar *parent, JsVar *namedChild) {
   namedChild = jsvRef(namedChild); // ref here VERY important as adding to structure!
   assert(jsvIsName(namedChild));
+  if (jsvIsRoot(parent)) jsvRootVersion++; // global variable lookups may now be different
+  jsvNamesCheck(jsvGetRef(parent)); // cached property lookups may now be different
 
   // update array length
   if (jsvIsArray(parent) && jsvIsInt(namedChild)) {
@@ -2868,6 +3100,8 @@ void jsvRemoveChild(JsVar *parent, JsVar *child) {
 #ifdef DEBUG
   assert(!(jsvGetPrevSibling(child) || jsvGetNextSibling(child)) || jsvIsChild(parent, child));
 #endif
+  if (jsvIsRoot(parent)) jsvRootVersion++; // global variable lookups may now be different
+  jsvNamesCheck(jsvGetRef(parent)); // cached property lookups may now be different
   JsVarRef childref = jsvGetRef(child);
   bool wasChild = false;
   // unlink from parent
@@ -3446,10 +3680,90 @@ void jsvArrayInsertBefore(JsVar *arr, JsVar *beforeIndex, JsVar *element) {
     jsvArrayPush(arr, element);
 }
 
+JsVar *jsvMathsOpError(int op, const char *datatype) {
+  char opName[32];
+  jslTokenAsString(op, opName, sizeof(opName));
+  jsError("Operation %s not supported on the %s datatype", opName, datatype);
+  return 0;
+}
+
+/** If 'v' is an integer that can be read without allocating anything - an
+ * integer, or a name that holds its integer value directly (JSV_NAME_INT_INT
+ * or JSV_NAME_STRING_INT) - set '*value' to it and return true */
+bool jsvGetImmediateInteger(JsVar *v, JsVarInt *value) {
+  if (!v) return false;
+  if ((v->flags&JSV_VARTYPEMASK)==JSV_INTEGER) {
+    *value = v->varData.integer;
+    return true;
+  }
+  if (jsvIsNameInt(v)) {
+    *value = (JsVarInt)jsvGetFirstChildSigned(v);
+    return true;
+  }
+  return false;
+}
+
+/** If 'name' holds a small integer directly, do 'name = name op value' by
+ * changing the integer stored in the name (so nothing is allocated) and
+ * return true. Returns false without doing anything if the name isn't like
+ * that, or the result wouldn't fit in it - in which case use jsvMathsOp */
+bool jsvMathsOpIntegerInPlace(JsVar *name, JsVarInt value, int op) {
+  if (!jsvIsNameInt(name) || jsvIsConstant(name)) return false;
+  /* Names that aren't in an object yet (like ones found in a prototype, which
+   * are 'new children' of the object we asked) only get added by jsvReplaceWith,
+   * so they have to go the slow way. Names in an object are always referenced. */
+  if (jsvIsNewChild(name) || !jsvGetRefs(name)) return false;
+  long long a = (long long)jsvGetFirstChildSigned(name);
+  long long r;
+  switch (op) {
+  case '+': r = a + value; break;
+  case '-': r = a - value; break;
+  case '*': r = a * value; break;
+  case '&': r = (JsVarInt)a & value; break;
+  case '|': r = (JsVarInt)a | value; break;
+  case '^': r = (JsVarInt)a ^ value; break;
+  default: return false; // everything else could give a non-integer result
+  }
+  if (r<JSVARREF_MIN || r>JSVARREF_MAX) return false;
+  jsvSetFirstChild(name, (JsVarRef)r);
+  return true;
+}
+
+/// Do a maths operation on two integers
+static JsVar *jsvMathsOpInteger(JsVarInt da, JsVarInt db, int op) {
+  switch (op) {
+  case '+': return jsvNewFromLongInteger((long long)da + (long long)db);
+  case '-': return jsvNewFromLongInteger((long long)da - (long long)db);
+  case '*': return jsvNewFromLongInteger((long long)da * (long long)db);
+  case '/': return jsvNewFromFloat((JsVarFloat)da/(JsVarFloat)db);
+  case '&': return jsvNewFromInteger(da&db);
+  case '|': return jsvNewFromInteger(da|db);
+  case '^': return jsvNewFromInteger(da^db);
+  case '%': if (db<0) db=-db; // fix SIGFPE
+            return db ? jsvNewFromInteger(da%db) : jsvNewFromFloat(NAN);
+  case LEX_LSHIFT: return jsvNewFromInteger(da << db);
+  case LEX_RSHIFT: return jsvNewFromInteger(da >> db);
+  case LEX_RSHIFTUNSIGNED: return jsvNewFromLongInteger(((JsVarIntUnsigned)da) >> db);
+  case LEX_TYPEEQUAL:
+  case LEX_EQUAL:     return jsvNewFromBool(da==db);
+  case LEX_NTYPEEQUAL:
+  case LEX_NEQUAL:    return jsvNewFromBool(da!=db);
+  case '<':           return jsvNewFromBool(da<db);
+  case LEX_LEQUAL:    return jsvNewFromBool(da<=db);
+  case '>':           return jsvNewFromBool(da>db);
+  case LEX_GEQUAL:    return jsvNewFromBool(da>=db);
+  default: return jsvMathsOpError(op, "Integer");
+  }
+}
+
 /** Same as jsvMathsOpPtr, but if a or b are a name, skip them
  * and go to what they point to. Also handle the case where
  * they may be objects with valueOf functions. */
 JsVar *jsvMathsOpSkipNames(JsVar *a, JsVar *b, int op) {
+  JsVarInt da, db;
+  // Small integers can be read directly, without having to allocate a var for each
+  if (jsvGetImmediateInteger(a, &da) && jsvGetImmediateInteger(b, &db))
+    return jsvMathsOpInteger(da, db, op);
   JsVar *pa = jsvSkipName(a);
   JsVar *pb = jsvSkipName(b);
   JsVar *oa = jsvGetValueOf(pa);
@@ -3461,13 +3775,6 @@ JsVar *jsvMathsOpSkipNames(JsVar *a, JsVar *b, int op) {
 }
 
 
-JsVar *jsvMathsOpError(int op, const char *datatype) {
-  char opName[32];
-  jslTokenAsString(op, opName, sizeof(opName));
-  jsError("Operation %s not supported on the %s datatype", opName, datatype);
-  return 0;
-}
-
 bool jsvMathsOpTypeEqual(JsVar *a, JsVar *b) {
   // check type first, then call again to check data
   bool eql = (a==0) == (b==0);
@@ -3529,27 +3836,11 @@ JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op) {
       // use ints
       JsVarInt da = jsvGetInteger(a);
       JsVarInt db = jsvGetInteger(b);
-      switch (op) {
-      case '+': return jsvNewFromLongInteger((long long)da + (long long)db);
-      case '-': return jsvNewFromLongInteger((long long)da - (long long)db);
-      case '*': return jsvNewFromLongInteger((long long)da * (long long)db);
-      case '/': return jsvNewFromFloat((JsVarFloat)da/(JsVarFloat)db);
-      case '&': return jsvNewFromInteger(da&db);
-      case '|': return jsvNewFromInteger(da|db);
-      case '^': return jsvNewFromInteger(da^db);
-      case '%': if (db<0) db=-db; // fix SIGFPE
-                return db ? jsvNewFromInteger(da%db) : jsvNewFromFloat(NAN);
-      case LEX_LSHIFT: return jsvNewFromInteger(da << db);
-      case LEX_RSHIFT: return jsvNewFromInteger(da >> db);
-      case LEX_RSHIFTUNSIGNED: return jsvNewFromLongInteger(((JsVarIntUnsigned)da) >> db);
-      case LEX_EQUAL:     return jsvNewFromBool(da==db && jsvIsNull(a)==jsvIsNull(b));
-      case LEX_NEQUAL:    return jsvNewFromBool(da!=db || jsvIsNull(a)!=jsvIsNull(b));
-      case '<':           return jsvNewFromBool(da<db);
-      case LEX_LEQUAL:    return jsvNewFromBool(da<=db);
-      case '>':           return jsvNewFromBool(da>db);
-      case LEX_GEQUAL:    return jsvNewFromBool(da>=db);
-      default: return jsvMathsOpError(op, "Integer");
+      if (jsvIsNull(a)!=jsvIsNull(b)) {
+        if (op==LEX_EQUAL) return jsvNewFromBool(false);
+        if (op==LEX_NEQUAL) return jsvNewFromBool(true);
       }
+      return jsvMathsOpInteger(da, db, op);
     } else {
       // use doubles
       JsVarFloat da = jsvGetFloat(a);
@@ -3875,9 +4166,25 @@ static bool jsvGarbageCollectMarkUsed(JsVar *var) {
 }
 
 /** Run a garbage collection sweep - return nonzero if things have been freed */
+/// Add a block to the end of the free list the GC is rebuilding, keeping track of runs of consecutive blocks
+static ALWAYS_INLINE void jsvGarbageCollectAddFree(JsVarRef i, JsVar *var, JsVar **lastEmpty, JsvFreeRun *run) {
+  if (*lastEmpty) jsvSetNextSibling(*lastEmpty, i);
+  else jsVarFirstEmpty = i;
+  if (run->start && (JsVarRef)(run->start+run->length)==i && *lastEmpty+1==var) {
+    run->length++;
+  } else {
+    jsvFreeRunRecord(run->prev, run->start, run->length);
+    run->prev = run->start ? (JsVarRef)(run->start+run->length-1) : 0;
+    run->start = i;
+    run->length = 1;
+  }
+  *lastEmpty = var;
+}
+
 int jsvGarbageCollect() {
   if (isMemoryBusy) return 0;
   isMemoryBusy = MEMBUSY_GC;
+  jsvAppendCacheClear(); // we're not going to check what gets freed
   JsVarRef i;
   // Add GC flags to anything that is currently used
   for (i=1;i<=jsVarsSize;i++)  {
@@ -3912,6 +4219,8 @@ int jsvGarbageCollect() {
   unsigned int freedCount = 0;
   jsVarFirstEmpty = 0;
   JsVar *lastEmpty = 0;
+  JsvFreeRun run = { 0, 0, 0 };
+  jsvFreeRunsClear();
   for (i=1;i<=jsVarsSize;i++)  {
     JsVar *var = jsvGetAddressOf(i);
     if (var->flags & JSV_GARBAGE_COLLECT) {
@@ -3922,18 +4231,14 @@ int jsvGarbageCollect() {
         // Free the first block
         var->flags = JSV_UNUSED;
         // add this to our free list
-        if (lastEmpty) jsvSetNextSibling(lastEmpty, i);
-        else jsVarFirstEmpty = i;
-        lastEmpty = var;
+        jsvGarbageCollectAddFree(i, var, &lastEmpty, &run);
         // free subsequent blocks
         while (count-- > 0) {
           i++;
           var = jsvGetAddressOf((JsVarRef)(i));
           var->flags = JSV_UNUSED;
           // add this to our free list
-          if (lastEmpty) jsvSetNextSibling(lastEmpty, i);
-          else jsVarFirstEmpty = i;
-          lastEmpty = var;
+          jsvGarbageCollectAddFree(i, var, &lastEmpty, &run);
         }
       } else {
         // otherwise just free 1 block
@@ -3973,9 +4278,7 @@ int jsvGarbageCollect() {
         // free!
         var->flags = JSV_UNUSED;
         // add this to our free list
-        if (lastEmpty) jsvSetNextSibling(lastEmpty, i);
-        else jsVarFirstEmpty = i;
-        lastEmpty = var;
+        jsvGarbageCollectAddFree(i, var, &lastEmpty, &run);
         freedCount++;
       }
     } else if (jsvIsFlatString(var)) {
@@ -3983,96 +4286,165 @@ int jsvGarbageCollect() {
       i = (JsVarRef)(i+jsvGetFlatStringBlocks(var));
     } else if (var->flags == JSV_UNUSED) {
       // this is already free - add it to the free list
-      if (lastEmpty) jsvSetNextSibling(lastEmpty, i);
-      else jsVarFirstEmpty = i;
-      lastEmpty = var;
+      jsvGarbageCollectAddFree(i, var, &lastEmpty, &run);
     }
   }
   if (lastEmpty) jsvSetNextSibling(lastEmpty, 0);
+  jsvFreeRunRecord(run.prev, run.start, run.length);
+  if (freedCount) jsvNamesChanged(); // we don't check what got freed
   isMemoryBusy = MEM_NOT_BUSY;
   return (int)freedCount;
 }
 
-void jsvDefragment() {
-  // garbage collect - removes cruft
-  // also puts free list in order
-  jsvGarbageCollect();
-  // Fill defragVars with defraggable variables
-  jshInterruptOff();
-  const int DEFRAGVARS = 256; // POWER OF 2
-  JsVarRef defragVars[DEFRAGVARS];
-  memset(defragVars, 0, sizeof(defragVars));
-  int defragVarIdx = 0;
-  for (unsigned int i=0;i<jsvGetMemoryTotal();i++) {
-    JsVarRef vr = (JsVarRef)(i+1);
+#define JSV_DEFRAG_BATCH 32 // how many variables a single step of compaction will move
+#define JSV_DEFRAG_CHECK_INTERVAL 5000 // ms between checks of how fragmented memory is when idle
+#define JSV_DEFRAG_THRESHOLD 4 // compact when the largest free run is less than 1/4 of free memory
+
+/// If `ref` is one of the `count` vars in `from` (sorted ascending), return the ref it was moved to
+static JsVarRef jsvDefragmentRelocate(JsVarRef ref, const JsVarRef *from, const JsVarRef *to, int count) {
+  if (ref<from[0] || ref>from[count-1]) return ref; // most refs are this
+  int lo = 0, hi = count-1;
+  while (lo<=hi) {
+    int mid = (lo+hi)>>1;
+    if (from[mid]==ref) return to[mid];
+    if (from[mid]<ref) lo = mid+1;
+    else hi = mid-1;
+  }
+  return ref;
+}
+
+/** Do one step of compaction. This moves up to JSV_DEFRAG_BATCH of the highest
+ * unlocked variables down into the lowest free blocks, and then updates every
+ * reference to them in a single pass over memory. Returns how many were moved -
+ * 0 if memory is as compact as we can make it, or if we couldn't run right now.
+ *
+ * Like garbage collection this leaves interrupts enabled - anything that
+ * allocates variables from an IRQ checks isMemoryBusy first, and IRQs only
+ * use Flat Strings directly, which never move. */
+int jsvDefragmentStep() {
+  /* Buffer tasks in the utility timer (waveforms) hold references to
+   * variables, so don't move anything until they have finished */
+  if (isMemoryBusy || jstUtilTimerIsRunning()) return 0;
+  isMemoryBusy = MEMBUSY_SYSTEM;
+  JsVarRef freeVars[JSV_DEFRAG_BATCH]; // lowest free blocks, in order
+  JsVarRef usedVars[JSV_DEFRAG_BATCH]; // ring buffer of the highest variables we can move
+  int freeCount = 0, usedCount = 0, usedIdx = 0;
+  for (unsigned int i=1;i<=jsVarsSize;i++) {
+    JsVarRef vr = (JsVarRef)i;
     JsVar *v = _jsvGetAddressOf(vr);
-    if ((v->flags&JSV_VARTYPEMASK)!=JSV_UNUSED) {
-      if (jsvIsFlatString(v)) {
-        i += (unsigned int)jsvGetFlatStringBlocks(v); // skip forward
-      } else if (jsvGetLocks(v)==0) {
-        defragVars[defragVarIdx] = vr;
-        defragVarIdx = (defragVarIdx+1) & (DEFRAGVARS-1);
-      }
+    if ((v->flags&JSV_VARTYPEMASK)==JSV_UNUSED) {
+      if (freeCount<JSV_DEFRAG_BATCH)
+        freeVars[freeCount++] = vr;
+    } else if (jsvIsFlatString(v)) {
+      i += (unsigned int)jsvGetFlatStringBlocks(v); // flat strings can't move - skip forward
+    } else if (freeCount && jsvGetLocks(v)==0) {
+      // locked vars have pointers to them held in C code, so can't move
+      usedVars[usedIdx] = vr;
+      usedIdx = (usedIdx+1) % JSV_DEFRAG_BATCH;
+      if (usedCount<JSV_DEFRAG_BATCH) usedCount++;
     }
   }
-  // Now go through defragVars defragging them
-  defragVarIdx--;
-  if (defragVarIdx<0) defragVarIdx+=DEFRAGVARS;
-  while (defragVars[defragVarIdx]) {
-    JsVarRef defragFromRef = defragVars[defragVarIdx];
-    JsVarRef defragToRef = jsVarFirstEmpty;
-    if (!defragToRef || defragFromRef<defragToRef) {
-      // we're done!
-      break;
+  // Pair the highest variables with the lowest free blocks for as long as that moves them down
+  JsVarRef from[JSV_DEFRAG_BATCH], to[JSV_DEFRAG_BATCH];
+  int count = 0;
+  while (count<freeCount && count<usedCount) {
+    JsVarRef vr = usedVars[(usedIdx+JSV_DEFRAG_BATCH-1-count) % JSV_DEFRAG_BATCH];
+    if (freeVars[count] > vr) break;
+    count++;
+  }
+  // fill in 'from' in ascending order so we can search it
+  for (int j=0;j<count;j++) {
+    from[count-1-j] = usedVars[(usedIdx+JSV_DEFRAG_BATCH-1-j) % JSV_DEFRAG_BATCH];
+    to[count-1-j] = freeVars[j];
+  }
+  if (count) {
+    jsvAppendCacheClear(); // vars are about to move
+    for (int j=0;j<count;j++) {
+      JsVar *v = _jsvGetAddressOf(from[j]);
+      *_jsvGetAddressOf(to[j]) = *v;
+      v->flags = JSV_UNUSED;
     }
-    // relocate!
-    JsVar *defragFrom = _jsvGetAddressOf(defragFromRef);
-    JsVar *defragTo = _jsvGetAddressOf(defragToRef);
-    jsVarFirstEmpty = jsvGetNextSibling(defragTo); // move our reference to the next in the free list
-    // copy data
-    *defragTo = *defragFrom;
-    defragFrom->flags = JSV_UNUSED;
     // find references!
-    for (unsigned int i=0;i<jsvGetMemoryTotal();i++) {
-      JsVarRef vr = (JsVarRef)(i+1);
-      JsVar *v = _jsvGetAddressOf(vr);
-      if ((v->flags&JSV_VARTYPEMASK)!=JSV_UNUSED) {
-        if (jsvIsFlatString(v)) {
-          i += (unsigned int)jsvGetFlatStringBlocks(v); // skip forward
-        } else {
-          if (jsvHasSingleChild(v))
-            if (jsvGetFirstChild(v)==defragFromRef)
-              jsvSetFirstChild(v,defragToRef);
-          if (jsvHasStringExt(v))
-            if (jsvGetLastChild(v)==defragFromRef)
-              jsvSetLastChild(v,defragToRef);
-          if (jsvHasChildren(v)) {
-            if (jsvGetFirstChild(v)==defragFromRef)
-              jsvSetFirstChild(v,defragToRef);
-            if (jsvGetLastChild(v)==defragFromRef)
-              jsvSetLastChild(v,defragToRef);
-          }
-          if (jsvIsName(v)) {
-            if (jsvGetNextSibling(v)==defragFromRef)
-              jsvSetNextSibling(v,defragToRef);
-            if (jsvGetPrevSibling(v)==defragFromRef)
-              jsvSetPrevSibling(v,defragToRef);
-          }
-        }
+    for (unsigned int i=1;i<=jsVarsSize;i++) {
+      JsVar *v = _jsvGetAddressOf((JsVarRef)i);
+      if ((v->flags&JSV_VARTYPEMASK)==JSV_UNUSED) continue;
+      if (jsvIsFlatString(v)) {
+        i += (unsigned int)jsvGetFlatStringBlocks(v); // skip forward
+        continue;
+      }
+      if (jsvHasSingleChild(v) || jsvHasChildren(v))
+        jsvSetFirstChild(v, jsvDefragmentRelocate(jsvGetFirstChild(v), from, to, count));
+      if (jsvHasStringExt(v) || jsvHasChildren(v))
+        jsvSetLastChild(v, jsvDefragmentRelocate(jsvGetLastChild(v), from, to, count));
+      if (jsvIsName(v)) {
+        jsvSetNextSibling(v, jsvDefragmentRelocate(jsvGetNextSibling(v), from, to, count));
+        jsvSetPrevSibling(v, jsvDefragmentRelocate(jsvGetPrevSibling(v), from, to, count));
       }
     }
-    // zero element and move to next...
-    defragVars[defragVarIdx] = 0;
-    defragVarIdx--;
-    if (defragVarIdx<0) defragVarIdx+=DEFRAGVARS;
-    // bump watchdog just in case it took too long
-    jshKickWatchDog();
-  }
-  // rebuild free var list
-  jsvCreateEmptyVarList();
-  jshInterruptOn();
+    jsvRootVersion++; // names in root may have moved
+    jsvNamesChanged();
+    // and the references we hold outside of variables
+    timerArray = jsvDefragmentRelocate(timerArray, from, to, count);
+    watchArray = jsvDefragmentRelocate(watchArray, from, to, count);
+  }
+  // rebuild free var list (also puts it in order) before anything can allocate again
+  if (count) jsvCreateEmptyVarListInternal();
+  isMemoryBusy = MEM_NOT_BUSY;
+  return count;
+}
+
+void jsvDefragment() {
+  // garbage collect - removes cruft
+  jsvGarbageCollect();
+  // now compact until there's nothing left that we can move
+  while (jsvDefragmentStep())
+    jshKickWatchDog(); // bump watchdog just in case it took too long
 }
 
+#ifndef SAVE_ON_FLASH
+static bool defragActive;         ///< Are we part way through compacting memory in the idle loop?
+static JsSysTime defragLastCheck; ///< When did we last check how fragmented memory was?
+static JsSysTime defragMaxPause;  ///< The longest time a single step of idle compaction has taken
+
+/// Ask for memory to be compacted next time we're idle (eg. because a Flat String couldn't be allocated)
+void jsvDefragmentRequest() {
+  defragActive = true;
+}
+
+/** Called from the idle loop. Every JSV_DEFRAG_CHECK_INTERVAL milliseconds this checks
+ * whether the largest run of free blocks has got too small compared to the total
+ * free, and if so it starts compacting memory, one step each time it's called.
+ * Returns true if it did some work */
+bool jsvDefragmentIdle() {
+  JsSysTime time = jshGetSystemTime();
+  if (!defragActive) {
+    if (time < defragLastCheck+jshGetTimeFromMilliseconds(JSV_DEFRAG_CHECK_INTERVAL))
+      return false;
+    defragLastCheck = time;
+    unsigned int freeRuns, largestFree;
+    jsvGetMemoryFragmentation(&freeRuns, &largestFree);
+    unsigned int freeVars = jsVarsSize - jsvGetMemoryUsage();
+    if (freeRuns<2 || largestFree*JSV_DEFRAG_THRESHOLD >= freeVars)
+      return false;
+    defragActive = true;
+  }
+  int moved = jsvDefragmentStep();
+  JsSysTime pause = jshGetSystemTime() - time;
+  if (pause > defragMaxPause) defragMaxPause = pause;
+  if (!moved) {
+    // done, or there's nothing we can move right now - check again later
+    defragActive = false;
+    defragLastCheck = jshGetSystemTime();
+  }
+  return moved!=0;
+}
+
+/// Return the longest time a single step of idle compaction has taken
+JsSysTime jsvGetDefragmentMaxPause() {
+  return defragMaxPause;
+}
+#endif
+
 // Dump any locked variables that aren't referenced from `global` - for debugging memory leaks
 void jsvDumpLockedVars() {
   jsvGarbageCollect();
@@ -279,7 +279,14 @@ void jsvSoftInit(); ///< called when loading from flash
 void jsvSoftKill(); ///< called when saving to flash
 JsVar *jsvFindOrCreateRoot(); ///< Find or create the ROOT variable item - used mainly if recovering from a saved state.
 unsigned int jsvGetMemoryUsage(); ///< Get number of memory records (JsVars) used
+void jsvGetMemoryFragmentation(unsigned int *freeRuns, unsigned int *largestFree); ///< Get the number of separate runs of free blocks, and the length of the biggest one
 unsigned int jsvGetMemoryTotal(); ///< Get total amount of memory records
+unsigned int jsvGetRootVersion(); ///< Get a number that changes whenever names are added to or removed from the root scope
+#ifndef SAVE_ON_FLASH
+unsigned int jsvGetAllocationCount(); ///< Get how many vars have been allocated since startup (wraps around)
+unsigned int jsvGetNamesVersion(); ///< Get a number that changes whenever names are added to or removed from a var passed to jsvWatchNames (or it is freed or moved)
+bool jsvWatchNames(JsVar *v); ///< Make jsvGetNamesVersion change if v's names change. Returns false if we're already watching as many vars as we can
+#endif
 bool jsvIsMemoryFull(); ///< Get whether memory is full or not
 bool jsvMoreFreeVariablesThan(unsigned int vars); ///< Return whether there are more free variables than the parameter (faster than checking no of vars used)
 void jsvShowAllocated(); ///< Show what is still allocated, for debugging memory problems
@@ -610,6 +617,10 @@ JsVar *jsvAsName(JsVar *var);
 
 /// MATHS!
 JsVar *jsvMathsOpSkipNames(JsVar *a, JsVar *b, int op);
+/// If 'v' is an integer or a name holding an integer directly, get its value without allocating anything
+bool jsvGetImmediateInteger(JsVar *v, JsVarInt *value);
+/// If 'name' holds a small integer directly, do 'name = name op value' without allocating. Returns false if we couldn't
+bool jsvMathsOpIntegerInPlace(JsVar *name, JsVarInt value, int op);
 bool jsvMathsOpTypeEqual(JsVar *a, JsVar *b);
 JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op);
 /// Negates an integer/double value
@@ -691,9 +702,22 @@ void jsvTrace(JsVar *var, int indent);
 /** Run a garbage collection sweep - return nonzero if things have been freed */
 int jsvGarbageCollect();
 
-/** Defragement memory - this could take a while with interrupts turned off! */
+/** Move up to JSV_DEFRAG_BATCH unlocked variables into the lowest free blocks, with
+ * isMemoryBusy set. Returns how many were moved (0 when there's nothing left to do) */
+int jsvDefragmentStep();
+
+/** Defragement memory - this could take a while! */
 void jsvDefragment();
 
+#ifndef SAVE_ON_FLASH
+/// Ask for memory to be compacted next time we're idle
+void jsvDefragmentRequest();
+/// Called when idle - compacts memory a step at a time if it has got fragmented. Returns true if it did anything
+bool jsvDefragmentIdle();
+/// Return the longest time a single step of idle compaction has taken
+JsSysTime jsvGetDefragmentMaxPause();
+#endif
+
 // Dump any locked variables that aren't referenced from `global` - for debugging memory leaks
 void jsvDumpLockedVars();
 // Dump the free list - in order
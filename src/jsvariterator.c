@@ -383,6 +383,28 @@ void jsvStringIteratorAppend(JsvStringIterator *it, char ch) {
   jsvSetCharactersInVar(it->var, it->charsInVar);
 }
 
+void jsvStringIteratorAppendBuf(JsvStringIterator *it, const char *data, size_t length) {
+  while (length && it->var) {
+    size_t idx = it->charsInVar; // where the next character goes
+    size_t maxChars = jsvGetMaxCharactersInVar(it->var);
+    if (idx >= maxChars) {
+      // block is full - let jsvStringIteratorAppend allocate the next one
+      if (!jsvHasStringExt(it->var)) return;
+      jsvStringIteratorAppend(it, *(data++));
+      length--;
+      continue;
+    }
+    size_t n = maxChars - idx;
+    if (n>length) n=length;
+    memcpy(&it->ptr[idx], data, n);
+    data += n;
+    length -= n;
+    it->charsInVar = idx+n;
+    it->charIdx = it->charsInVar-1;
+    jsvSetCharactersInVar(it->var, it->charsInVar);
+  }
+}
+
 void jsvStringIteratorAppendString(JsvStringIterator *it, JsVar *str, size_t startIdx, int maxLength) {
   JsvStringIterator sit;
   jsvStringIteratorNew(&sit, str, startIdx);
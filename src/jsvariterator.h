@@ -162,6 +162,9 @@ void jsvStringIteratorGoto(JsvStringIterator *it, JsVar *str, size_t startIdx);
 /// Append a character TO THE END of a string iterator
 void jsvStringIteratorAppend(JsvStringIterator *it, char ch);
 
+/// Append a buffer TO THE END of a string iterator, copying as much as will fit into each block at once
+void jsvStringIteratorAppendBuf(JsvStringIterator *it, const char *data, size_t length);
+
 /// Append an entire JsVar string TO THE END of a string iterator
 void jsvStringIteratorAppendString(JsvStringIterator *it, JsVar *str, size_t startIdx, int maxLength);
 
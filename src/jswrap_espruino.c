@@ -1345,6 +1345,14 @@ void jswrap_e_dumpVariables() {
   "generate" : "jsvDefragment"
 }
 BETA: defragment memory!
+
+This moves variables down into the lowest free areas of memory so that the free
+memory is all in one place, which allows larger Flat Strings (used for
+`ArrayBuffer`s, `E.toString`, etc) to be allocated. Variables that are in use by
+native code and Flat Strings themselves can't be moved.
+
+Memory is also compacted a little at a time automatically when Espruino is idle
+if it becomes fragmented - see `process.memory().largestFree`.
 */
 
 /*TYPESCRIPT
@@ -1458,6 +1466,36 @@ JsVarInt jswrap_espruino_getAddressOf(JsVar *v, bool flatAddress) {
   return (JsVarInt)(size_t)v;
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "E",
+  "name" : "getFieldCacheStats",
+  "generate" : "jswrap_espruino_getFieldCacheStats",
+  "return" : ["JsVar","An object containing `hits` and `misses` fields"],
+  "typescript" : "getFieldCacheStats(): { hits: number, misses: number };"
+}
+Return how many times looking up a field with `a.b` has been able to use where
+that bit of code found the field the last time (`hits`), and how many times it
+had to search the object and its prototype (`misses`).
+
+Hits are only possible when the same code keeps looking up a field on the same
+object, and are all lost when fields are added to or removed from an object
+whose lookups have been remembered, so this can be used to see whether code is
+making good use of this.
+
+See http://www.espruino.com/Internals for more information
+ */
+JsVar *jswrap_espruino_getFieldCacheStats() {
+  unsigned int hits, misses;
+  jspGetFieldCacheStats(&hits, &misses);
+  JsVar *obj = jsvNewObject();
+  if (!obj) return 0;
+  jsvObjectSetChildAndUnLock(obj, "hits", jsvNewFromInteger((JsVarInt)hits));
+  jsvObjectSetChildAndUnLock(obj, "misses", jsvNewFromInteger((JsVarInt)misses));
+  return obj;
+}
+
 /*JSON{
   "type" : "staticmethod",
     "ifndef" : "SAVE_ON_FLASH",
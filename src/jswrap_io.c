@@ -18,6 +18,7 @@
 #include "jswrap_arraybuffer.h" // for jswrap_io_peek
 #include "jswrapper.h" // for JSWAT_VOID
 #include "jstimer.h" // for digitalPulse
+#include "jscapture.h"
 
 #ifdef ESP32
 #include "freertos/FreeRTOS.h"
@@ -680,7 +681,7 @@ void jswrap_io_shiftOut(JsVar *pins, JsVar *options, JsVar *data) {
     ["options", "JsVar","If a boolean or integer, it determines whether to call this once (false = default) or every time a change occurs (true). Can be an object of the form `{ repeat: true/false(default), edge:'rising'/'falling'/'both'(default), debounce:10}` - see below for more information."]
   ],
   "return" : ["JsVar","An ID that can be passed to clearWatch"],
-  "typescript" : "declare function setWatch(func: ((arg: { state: boolean, time: number, lastTime: number }) => void) | string, pin: Pin, options?: boolean | { repeat?: boolean, edge?: \"rising\" | \"falling\" | \"both\", debounce?: number, irq?: boolean, data?: Pin, hispeed?: boolean }): number;"
+  "typescript" : "declare function setWatch(func: ((arg: { state: boolean, time: number, lastTime: number }) => void) | string, pin: Pin, options?: boolean | { repeat?: boolean, edge?: \"rising\" | \"falling\" | \"both\", debounce?: number, irq?: boolean, data?: Pin, hispeed?: boolean, buffer?: Uint32Array, quadrature?: Pin }): number;"
 }
 Call the function specified when the pin changes. Watches set with `setWatch`
 can be removed using `clearWatch`.
@@ -708,6 +709,12 @@ information (all optional):
    // high speed pulses (less than 25us) may not be reliably received. Setting hispeed=true
    // allows for detecting high speed pulses at the expense of higher idle power consumption
    hispeed : true
+   // Advanced: Record the times of edges into a ring buffer from the interrupt, and call
+   // the function with a batch of edges at a time (see below). Implies repeat:true
+   buffer : new Uint32Array(64)
+   // Advanced: Treat this pin as 'A' of a quadrature encoder and the given pin as 'B',
+   // and count steps in the interrupt rather than calling the function for every edge
+   quadrature : pin
 }
 ```
 
@@ -728,6 +735,24 @@ repeat:true, edge:'falling' });`. This will only be called on the falling edge
 of the pulse, but will be able to measure the width of the pulse because
 `e.lastTime` is the time of the rising edge.
 
+For pins that change state quickly, calling a JS function for every edge can be
+too slow. With `buffer:new Uint32Array(n)` the interrupt records the time of each
+edge (respecting `edge`) and the function is called at most once each time around
+the idle loop with `{pin, state, time, count, missed, buffer}`:
+
+ * `time` is the time in seconds of the first edge in this batch
+ * `count` is how many edges were recorded, and `buffer[0..count-1]` holds the time
+   of each one in microseconds after `time`
+ * `missed` is the number of edges that were dropped because the buffer was full
+
+With `quadrature:pinB`, the pin and `pinB` are both watched and decoded as a
+quadrature encoder in the interrupt. The function is then called with
+`{pin, state, position, delta}` whenever the count has changed, where `position`
+is the total count and `delta` the change since the last call.
+
+`buffer` and `quadrature` can't be used with `irq` or `data`, or on a pin that
+already has a watch.
+
 Internally, an interrupt writes the time of the pin's state change into a queue
 with the exact time that it happened, and the function supplied to `setWatch` is
 executed only from the main message loop. However, if the callback is a native
@@ -766,6 +791,10 @@ JsVar *jswrap_interface_setWatch(
   int edge = 0;
   bool isIRQ = false, isHighSpeed = false;
   Pin dataPin = PIN_UNDEFINED;
+#ifndef SAVE_ON_FLASH
+  JsVar *captureBuffer = 0;
+  Pin quadraturePin = PIN_UNDEFINED;
+#endif
   if (IS_PIN_A_BUTTON(pin)) {
     edge = 1;
     debounce = 25;
@@ -799,6 +828,24 @@ JsVar *jswrap_interface_setWatch(
     isIRQ = jsvGetBoolAndUnLock(jsvObjectGetChild(repeatOrObject, "irq", 0));
     isHighSpeed = jsvGetBoolAndUnLock(jsvObjectGetChild(repeatOrObject, "hispeed", 0));
     dataPin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(repeatOrObject, "data", 0));
+#ifndef SAVE_ON_FLASH
+    captureBuffer = jsvObjectGetChild(repeatOrObject, "buffer", 0);
+    quadraturePin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(repeatOrObject, "quadrature", 0));
+    if (captureBuffer || jshIsPinValid(quadraturePin)) {
+      if (isIRQ || jshIsPinValid(dataPin)) {
+        jsExceptionHere(JSET_ERROR, "Can't use buffer or quadrature with irq or data");
+        jsvUnLock(captureBuffer);
+        return 0;
+      }
+      if (jsiIsWatchingPin(pin)) {
+        jsExceptionHere(JSET_ERROR, "Can't use buffer or quadrature on a pin that is already watched");
+        jsvUnLock(captureBuffer);
+        return 0;
+      }
+      repeat = true; // edges are delivered in batches, so the watch has to stay
+      debounce = 0;
+    }
+#endif
   } else
     repeat = jsvGetBool(repeatOrObject);
 
@@ -840,7 +887,17 @@ JsVar *jswrap_interface_setWatch(
       if (isIRQ)
         jsExceptionHere(JSET_ERROR, "irq=true set, but watch is already used");
     }
-
+#ifndef SAVE_ON_FLASH
+    if (captureBuffer || jshIsPinValid(quadraturePin)) {
+      if (!exti) jsExceptionHere(JSET_ERROR, "Unable to watch pin %p", pin);
+      if (!exti || !watchPtr || !jscaptureSetup(watchPtr, exti, pin, edge, captureBuffer, quadraturePin)) {
+        if (exti) jshPinWatch(pin, false, JSPW_NONE);
+        jsvUnLock2(watchPtr, captureBuffer);
+        return 0;
+      }
+      jsvUnLock(captureBuffer);
+    }
+#endif
 
     JsVar *watchArrayPtr = jsvLock(watchArray);
     itemIndex = jsvArrayAddToEnd(watchArrayPtr, watchPtr, 1) - 1;
@@ -871,6 +928,9 @@ void jswrap_interface_clearWatch(JsVar *idVarArr) {
     jsvObjectIteratorNew(&it, watchArrayPtr);
     while (jsvObjectIteratorHasValue(&it)) {
       JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+#ifndef SAVE_ON_FLASH
+      jscaptureRemove(watchPtr);
+#endif
       JsVar *watchPin = jsvObjectGetChild(watchPtr, "pin", 0);
       Pin pin = jshGetPinFromVar(watchPin);
       if (!jshGetPinShouldStayWatched(pin))
@@ -894,6 +954,9 @@ void jswrap_interface_clearWatch(JsVar *idVarArr) {
     if (watchNamePtr) { // child is a 'name'
       JsVar *watchPtr = jsvSkipName(watchNamePtr);
       Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
+#ifndef SAVE_ON_FLASH
+      jscaptureRemove(watchPtr);
+#endif
       jsvUnLock(watchPtr);
 
       JsVar *watchArrayPtr = jsvLock(watchArray);
@@ -927,3 +990,35 @@ void jswrap_interface_clearWatch_int(int watchNumber) {
   jswrap_interface_clearWatch(idArray);
   jsvUnLock2(id, idArray);
 }
+
+/*JSON{
+  "type" : "init",
+  "generate" : "jswrap_io_init"
+}*/
+void jswrap_io_init() {
+#ifndef SAVE_ON_FLASH
+  jscaptureInit();
+#endif
+}
+
+/*JSON{
+  "type" : "kill",
+  "generate" : "jswrap_io_kill"
+}*/
+void jswrap_io_kill() {
+#ifndef SAVE_ON_FLASH
+  jscaptureKill();
+#endif
+}
+
+/*JSON{
+  "type" : "idle",
+  "generate" : "jswrap_io_idle"
+}*/
+bool jswrap_io_idle() {
+#ifndef SAVE_ON_FLASH
+  return jscaptureIdle();
+#else
+  return false;
+#endif
+}
@@ -31,3 +31,7 @@ void jswrap_interface_clearWatch(JsVar *idVarArr);
 int jswrap_interface_setWatch_int(void(*callback)(), Pin pin, bool repeat, int edge);
 /// function for internal use
 void jswrap_interface_clearWatch_int(int watchNumber);
+
+void jswrap_io_init();
+void jswrap_io_kill();
+bool jswrap_io_idle();
@@ -18,7 +18,9 @@
  *    * If this returns "" we just assume that it's waiting for more data
  *    * If it returns some data, 'write' is called with it
  *    * And if 'write' returns the boolean false then we stall the pipe until
- *       the destination emits a 'drain' signal
+ *       the destination emits a 'drain' signal. While stalled, 'pause' is called
+ *       on the source (if it has it) so that it stops reading more data in,
+ *       and 'resume' is called when the pipe starts again
  *    * If the destination emits a 'close' signal we close the pipe
  *    * When the pipe closes, unless 'end=false' on initialisation, we call
  *      'end' on destination, and 'close' on source.
@@ -35,6 +37,17 @@ static JsVar* pipeGetArray(bool create) {
 }
 
 
+/** Call source.pause()/resume() if the source implements them, so a source
+ * like a Socket stops buffering data while the destination can't take it */
+static void pipeSetSourcePaused(JsVar *pipe, bool paused) {
+  JsVar *source = jsvObjectGetChild(pipe,"source",0);
+  if (!source) return;
+  JsVar *func = jspGetNamedField(source, paused ? "pause" : "resume", false);
+  if (jsvIsFunction(func))
+    jsvUnLock(jspExecuteFunction(func, source, 0, 0));
+  jsvUnLock2(func, source);
+}
+
 static void handlePipeClose(JsVar *arr, JsvObjectIterator *it, JsVar* pipe) {
   jsiQueueObjectCallbacks(pipe, JS_EVENT_PREFIX"complete", &pipe, 1);
   // Check the source to see if there was more data... It may not be a stream,
@@ -122,6 +135,7 @@ static bool handlePipe(JsVar *arr, JsvObjectIterator *it, JsVar* pipe) {
           if (jsvIsBoolean(response) && jsvGetBool(response)==false) {
             // If boolean false was returned, wait for drain event (http://nodejs.org/api/stream.html#stream_writable_write_chunk_encoding_callback)
             jsvObjectSetChildAndUnLock(pipe,"drainWait",jsvNewFromBool(true));
+            pipeSetSourcePaused(pipe, true);
           }
           jsvUnLock(response);
           jsvSetInteger(position, jsvGetInteger(position) + bufferSize);
@@ -194,9 +208,11 @@ static void jswrap_pipe_drain_listener(JsVar *destination) {
     while (jsvObjectIteratorHasValue(&it)) {
       JsVar *pipe = jsvObjectIteratorGetValue(&it);
       JsVar *dst = jsvObjectGetChild(pipe,"destination",0);
-      if (dst == destination) {
-        // found it! said wait to false
+      if (dst == destination &&
+          jsvGetBoolAndUnLock(jsvObjectGetChild(pipe,"drainWait",0))) {
+        // found it! said wait to false, and let the source read again
         jsvObjectSetChildAndUnLock(pipe,"drainWait",jsvNewFromBool(false));
+        pipeSetSourcePaused(pipe, false);
       }
       jsvUnLock2(dst, pipe);
       jsvObjectIteratorNext(&it);
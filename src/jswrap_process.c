@@ -186,6 +186,16 @@ memory usage.
 * `gc` : Memory freed during the GC pass
 * `gctime` : Time taken for GC pass (in milliseconds)
 * `blocksize` : Size of a block (variable) in bytes
+* `freeRuns` : How many separate areas of free blocks there are. The more there
+  are, the more fragmented memory is.
+* `largestFree` : The biggest area of consecutive free blocks. This limits the
+  size of Flat Strings (used for `ArrayBuffer`s, `E.toString`, etc)
+* `defragtime` : The longest time (in milliseconds) that a single step of
+  compacting memory has taken. Memory is compacted a little at a time when
+  idle if `largestFree` gets too small compared to `free`
+* `allocs` : How many variables have been allocated since startup. Take the
+  difference between two calls to see how many a piece of code allocates,
+  even if they have since been freed
 * `stackEndAddress` : (on ARM) the address (that can be used with peek/poke/etc)
   of the END of the stack. The stack grows down, so unless you do a lot of
   recursion the bytes above this can be used.
@@ -234,6 +244,14 @@ JsVar *jswrap_process_memory(JsVar *gc) {
       jsvObjectSetChildAndUnLock(obj, "gctime", jsvNewFromFloat(jshGetMillisecondsFromTime(time2-time1)));
     }
     jsvObjectSetChildAndUnLock(obj, "blocksize", jsvNewFromInteger(sizeof(JsVar)));
+#ifndef SAVE_ON_FLASH
+    unsigned int freeRuns, largestFree;
+    jsvGetMemoryFragmentation(&freeRuns, &largestFree);
+    jsvObjectSetChildAndUnLock(obj, "freeRuns", jsvNewFromInteger((JsVarInt)freeRuns));
+    jsvObjectSetChildAndUnLock(obj, "largestFree", jsvNewFromInteger((JsVarInt)largestFree));
+    jsvObjectSetChildAndUnLock(obj, "defragtime", jsvNewFromFloat(jshGetMillisecondsFromTime(jsvGetDefragmentMaxPause())));
+    jsvObjectSetChildAndUnLock(obj, "allocs", jsvNewFromInteger((JsVarInt)jsvGetAllocationCount()));
+#endif
 
 #ifdef ARM
     extern uint32_t LINKER_END_VAR; // end of ram used (variables) - should be 'void', but 'int' avoids warnings
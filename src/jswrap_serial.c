@@ -57,6 +57,20 @@ The `data` event is called when data is received. If a handler is defined with
 will be stored in an internal buffer, where it can be retrieved with `X.read()`
  */
 
+/*JSON{
+  "type" : "event",
+  "class" : "Serial",
+  "name" : "packet",
+  "params" : [
+    ["data","JsVar","A string containing one complete frame of received data"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+The `packet` event is called when a complete frame of data has been received,
+if `framing` was specified in `Serial.setup`. No `data` events are emitted
+while framing is enabled.
+ */
+
 /*JSON{
   "type" : "event",
   "class" : "Serial",
@@ -254,6 +268,13 @@ The second argument can contain:
   flow:null/undefined/'none'/'xon', // (default none) software flow control
   path:null/undefined/string        // Linux Only - the path to the Serial device to use
   errors:false                      // (default false) whether to forward framing/parity errors
+  framing:{                         // (default none) split received data into packets - see below
+    type:'line'/'delimiter'/'length'/'slip'/'cobs',
+    delimiter:'\n',                 // (default '\n') character or char code ending a 'line' or 'delimiter' frame
+    maxLength:256,                  // (default 256) largest frame that can be received
+    bytes:1,                        // (default 1) 'length' only - 1 or 2 byte length header
+    le:false                        // (default false) 'length' only - length header is little-endian
+  }
 }
 ```
 
@@ -292,6 +313,27 @@ s.setup(9600,{rx:a_pin, tx:a_pin});
 
 However software serial doesn't use `ck`, `cts`, `parity`, `flow` or `errors`
 parts of the initialisation object.
+
+If `framing` is specified, received data is split into frames in C and a
+`packet` event is emitted for each complete frame, instead of `data` events
+with arbitrary chunks of data. This avoids building up strings in JS for
+high-rate streams like NMEA or Modbus:
+
+* `line` - frames end with `delimiter` (`\n`), and any `\r` before it is removed
+* `delimiter` - frames end with `delimiter`, which is removed
+* `length` - each frame starts with a 1 or 2 byte (big-endian unless `le:true`)
+length, which is removed
+* `slip` - RFC1055 SLIP frames, which are decoded
+* `cobs` - COBS encoded frames ending in a `0` byte, which are decoded
+
+For example:
+
+```
+Serial1.setup(9600, {rx:D2, framing:{type:'line'}});
+Serial1.on('packet', line => print(line));
+```
+
+Frames bigger than `maxLength` are dropped and counted - see `Serial.getFramingInfo`.
 */
 void jswrap_serial_setup(JsVar *parent, JsVar *baud, JsVar *options) {
   if (!jsvIsObject(parent)) return;
@@ -309,6 +351,11 @@ void jswrap_serial_setup(JsVar *parent, JsVar *baud, JsVar *options) {
     jsvObjectSetChildAndUnLock(parent, "path", jsvObjectGetChild(options, "path", 0));
 #endif
 
+#ifndef SAVE_ON_FLASH
+  if (ok)
+    ok = jsserialFramingSetup(parent, options);
+#endif
+
   if (!ok) {
     jsvUnLock(options);
     return;
@@ -378,6 +425,7 @@ void jswrap_serial_unsetup(JsVar *parent) {
   // Remove stored settings
   jsvObjectRemoveChild(parent, USART_BAUDRATE_NAME);
   jsvObjectRemoveChild(parent, DEVICE_OPTIONS_NAME);
+  jsvObjectRemoveChild(parent, SERIAL_FRAMING_NAME);
 
   if (DEVICE_IS_SERIAL(device)) { // It's hardware
     jshUSARTUnSetup(device);
@@ -387,6 +435,31 @@ void jswrap_serial_unsetup(JsVar *parent) {
 }
 #endif
 
+/*JSON{
+  "type" : "method",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "Serial",
+  "name" : "getFramingInfo",
+  "generate" : "jswrap_serial_getFramingInfo",
+  "return" : ["JsVar","An object containing framing statistics, or `undefined` if framing isn't enabled"]
+}
+If `framing` was specified in `Serial.setup`, return information about it:
+
+```
+{
+  packets : int,   // number of 'packet' events emitted
+  overflows : int, // number of frames dropped because they were bigger than maxLength
+  errors : int,    // number of frames dropped because they were malformed (SLIP/COBS)
+  pending : int,   // number of bytes received for the current, incomplete, frame
+}
+```
+*/
+#ifndef SAVE_ON_FLASH
+JsVar *jswrap_serial_getFramingInfo(JsVar *parent) {
+  if (!jsvIsObject(parent)) return 0;
+  return jsserialFramingGetInfo(parent);
+}
+#endif
 
 /*JSON{
   "type" : "idle",
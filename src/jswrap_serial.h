@@ -17,6 +17,7 @@ JsVar *jswrap_serial_constructor();
 void jswrap_serial_setConsole(JsVar *parent, bool force);
 void jswrap_serial_setup(JsVar *parent, JsVar *baud, JsVar *options);
 void jswrap_serial_unsetup(JsVar *parent);
+JsVar *jswrap_serial_getFramingInfo(JsVar *parent);
 bool jswrap_serial_idle();
 void jswrap_serial_print(JsVar *parent, JsVar *str);
 void jswrap_serial_println(JsVar *parent, JsVar *str);
@@ -142,6 +142,9 @@ void jswrap_spi_setup(
   JshSPIInfo inf;
 
   if (!jsspiPopulateSPIInfo(&inf, options)) return;
+#ifdef JSSPI_ASYNC
+  jsspiAsyncFlush(parent); // finish anything queued with the old settings
+#endif
 
   if (DEVICE_IS_SPI(device)) {
     jshSPISetup(device, &inf);
@@ -239,6 +242,9 @@ JsVar *jswrap_spi_send(
   jswrap_spi_send_data data;
   if (!jsspiGetSendFunction(parent, &data.spiSend, &data.spiSendData))
     return 0;
+#ifdef JSSPI_ASYNC
+  jsspiAsyncFlush(parent); // anything queued with {async:true} must go first
+#endif
 
   JsVar *dst = 0;
 
@@ -293,15 +299,34 @@ JsVar *jswrap_spi_send(
 }
 
 
+#define JSWRAP_SPI_WRITE_BATCH 32 // writes smaller than this are collected up and sent together
+
 typedef struct {
   spi_sender spiSend;          //!< A function to be called to send SPI data.
   spi_sender_data spiSendData; //!< Control information on the nature of the SPI interface.
+  unsigned char buf[JSWRAP_SPI_WRITE_BATCH]; //!< Small writes waiting to be sent
+  unsigned int bufLen;         //!< Amount of data in buf
 } jswrap_spi_write_data;
 
+static void jswrap_spi_write_flush(jswrap_spi_write_data *callbackData) {
+  if (!callbackData->bufLen) return;
+  callbackData->spiSend(callbackData->buf, NULL, callbackData->bufLen, &callbackData->spiSendData);
+  callbackData->bufLen = 0;
+}
+
 void jswrap_spi_write_cb(
     unsigned char *data, unsigned int len,
     jswrap_spi_write_data *callbackData
   ) {
+  // Arrays of numbers arrive a byte at a time, and sending each one on its own is slow
+  if (len < JSWRAP_SPI_WRITE_BATCH) {
+    if (callbackData->bufLen + len > JSWRAP_SPI_WRITE_BATCH)
+      jswrap_spi_write_flush(callbackData);
+    memcpy(&callbackData->buf[callbackData->bufLen], data, len);
+    callbackData->bufLen += len;
+    return;
+  }
+  jswrap_spi_write_flush(callbackData);
   callbackData->spiSend(data, NULL, len, &callbackData->spiSendData);
 }
 
@@ -311,33 +336,64 @@ void jswrap_spi_write_cb(
   "name" : "write",
   "generate" : "jswrap_spi_write",
   "params" : [
-    ["data","JsVarArray",["One or more items to write. May be ints, strings, arrays, or special objects (see `E.toUint8Array` for more info).","If the last argument is a pin, it is taken to be the NSS pin"]]
-  ]
+    ["data","JsVarArray",["One or more items to write. May be ints, strings, arrays, or special objects (see `E.toUint8Array` for more info).","If the last argument is a pin, it is taken to be the NSS pin","If the last argument is an object containing `async`, it's taken to be options (see below)"]]
+  ],
+  "return" : ["JsVar","If `{async:true}` was given, a Promise that resolves once the data has been sent, otherwise `undefined`"]
 }
 Write a character or array of characters to SPI - without reading the result
 back.
 
 For maximum speeds, please pass either Strings or Typed Arrays as arguments.
+
+If the last argument is `{async:true}` the data is copied into a buffer and
+queued to be sent in the background, and a Promise is returned that resolves
+once it has been sent, so sending a lot of data (for instance to a display)
+doesn't block JavaScript execution:
+
+```
+SPI1.write(buffer, D5, {async:true}).then(() => print("Sent!"));
+```
+
+On hardware SPI several async writes can be in progress at once, although
+writes with an NSS pin are sent one at a time so NSS can be toggled between
+them. Synchronous SPI calls (and `SPI.setup`) made while async writes are
+queued first wait for all of them to be sent, so data always goes out in the
+order it was written.
  */
-void jswrap_spi_write(
+JsVar *jswrap_spi_write(
     JsVar *parent, //!<
     JsVar *args    //!<
   ) {
-  if (!jsvIsObject(parent)) return;
+  if (!jsvIsObject(parent)) return 0;
   IOEventFlags device = jsiGetDeviceFromClass(parent);
 
   spi_sender spiSend;
   spi_sender_data spiSendData;
   if (!jsspiGetSendFunction(parent, &spiSend, &spiSendData))
-    return;
+    return 0;
 
   jswrap_spi_write_data spi_write_data;
   spi_write_data.spiSend = spiSend;
   spi_write_data.spiSendData = spiSendData;
+  spi_write_data.bufLen = 0;
 
   Pin nss_pin = PIN_UNDEFINED;
-  // If the last value is a pin, use it as the NSS pin
   JsVarInt len = jsvGetArrayLength(args);
+#ifdef JSSPI_ASYNC
+  bool async = false;
+  // If the last value is an object with 'async' in, it's options
+  if (len > 0) {
+    JsVar *last = jsvGetArrayItem(args, len-1); // look at the last value
+    JsVar *asyncVar = jsvIsObject(last) ? jsvObjectGetChild(last, "async", 0) : 0;
+    if (asyncVar) {
+      async = jsvGetBool(asyncVar);
+      jsvUnLock(jsvArrayPop(args));
+      len--;
+    }
+    jsvUnLock2(asyncVar, last);
+  }
+#endif
+  // If the last value is a pin, use it as the NSS pin
   if (len > 0) {
     JsVar *last = jsvGetArrayItem(args, len-1); // look at the last value
     if (jsvIsPin(last)) {
@@ -350,15 +406,22 @@ void jswrap_spi_write(
   // we're only sending (no receive)
   if (DEVICE_IS_SPI(device)) jshSPISetReceive(device, false);
 
+#ifdef JSSPI_ASYNC
+  if (async)
+    return jsspiSendAsync(parent, args, nss_pin);
+  jsspiAsyncFlush(parent); // anything queued with {async:true} must go first
+#endif
   // assert NSS
   if (nss_pin!=PIN_UNDEFINED) jshPinOutput(nss_pin, false);
   // Write data
   jsvIterateBufferCallback(args, (jsvIterateBufferCallbackFn)jswrap_spi_write_cb, &spi_write_data);
+  jswrap_spi_write_flush(&spi_write_data);
   // Wait until SPI send is finished, and flush data
   if (DEVICE_IS_SPI(device))
     jshSPIWait(device);
   // de-assert NSS
   if (nss_pin!=PIN_UNDEFINED) jshPinOutput(nss_pin, true);
+  return 0;
 }
 
 /*JSON{
@@ -387,6 +450,9 @@ void jswrap_spi_send4bit(JsVar *parent, JsVar *srcdata, int bit0, int bit1, Pin
     jsExceptionHere(JSET_ERROR, "SPI.send4bit only works on hardware SPI");
     return;
   }
+#ifdef JSSPI_ASYNC
+  jsspiAsyncFlush(parent); // anything queued with {async:true} must go first
+#endif
 
   jshSPISet16(device, true); // 16 bit output
 
@@ -460,6 +526,9 @@ void jswrap_spi_send8bit(JsVar *parent, JsVar *srcdata, int bit0, int bit1, Pin
     jsExceptionHere(JSET_ERROR, "SPI.send8bit only works on hardware SPI");
     return;
   }
+#ifdef JSSPI_ASYNC
+  jsspiAsyncFlush(parent); // anything queued with {async:true} must go first
+#endif
   jshSPISet16(device, true); // 16 bit output
 
   if (bit0==0 && bit1==0) {
@@ -737,3 +806,82 @@ JsVar *jswrap_i2c_readFrom(JsVar *parent, JsVar *addressVar, int nBytes) {
   }
   return array;
 }
+
+/*JSON{
+  "type" : "method",
+  "class" : "I2C",
+  "name" : "transfer",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_i2c_transfer",
+  "params" : [
+    ["operations","JsVar","An array of operations, each either `{addr:0x12, write:data}` or `{addr:0x12, read:length}`"],
+    ["options","JsVar","[optional] `{async:true}` to return a Promise rather than waiting for the transfer"]
+  ],
+  "return" : ["JsVar","A Uint8Array containing all the data that was read, or a Promise that resolves to it if `async:true` was set"],
+  "return_object" : "Uint8Array"
+}
+Perform a whole sequence of writes and reads as one I2C transaction, with a
+repeated start before each operation and a STOP only at the end. On hardware
+I2C the sequence is handed to the peripheral in one go, which is much faster
+than calling `writeTo` then `readFrom` for each register.
+
+All the data that was read is returned, one operation after another, in a
+single Uint8Array. For instance to read 6 bytes from register `0x3B` of one
+device and 2 bytes from register `0x00` of another:
+
+```
+var d = I2C1.transfer([
+  {addr:0x68, write:0x3B}, {addr:0x68, read:6},
+  {addr:0x48, write:0x00}, {addr:0x48, read:2}
+]);
+// d[0..5] are from 0x68, d[6..7] are from 0x48
+```
+
+With `{async:true}`, a Promise is returned and JavaScript carries on while the
+transfer happens (transfers on the same I2C device are run one after the other):
+
+```
+I2C1.transfer([{addr:0x68, write:0x3B}, {addr:0x68, read:6}], {async:true}).then(d => print(d));
+```
+ */
+#ifndef SAVE_ON_FLASH
+JsVar *jswrap_i2c_transfer(JsVar *parent, JsVar *operations, JsVar *options) {
+  if (!jsvIsObject(parent)) return 0;
+  bool async = false;
+  jsvConfigObject configs[] = {
+      {"async", JSV_BOOLEAN, &async}
+  };
+  if (!jsvReadConfigObject(options, configs, sizeof(configs) / sizeof(jsvConfigObject)))
+    return 0;
+  unsigned int readBytes;
+  JsVar *transfer = jsi2cCompileTransfer(operations, &readBytes);
+  if (!transfer) return 0;
+  // Everything that's read goes in one (flat) buffer
+  JsVar *result = 0;
+  unsigned char *readData = 0;
+  if (readBytes) {
+    JsVar *buffer = jsvNewArrayBufferWithPtr(readBytes, (char**)&readData);
+    if (buffer) result = jswrap_typedarray_constructor(ARRAYBUFFERVIEW_UINT8, buffer, 0, 0);
+    jsvUnLock(buffer);
+  } else
+    result = jsvNewTypedArray(ARRAYBUFFERVIEW_UINT8, 0);
+  if (!result) {
+    jsvUnLock(transfer);
+    return 0;
+  }
+#ifdef JSI2C_ASYNC
+  if (async) {
+    JsVar *promise = jsi2cTransferAsync(parent, transfer, result);
+    jsvUnLock2(transfer, result);
+    return promise;
+  }
+#endif
+  bool ok = jsi2cTransfer(parent, transfer, readData, false);
+  jsvUnLock(transfer);
+  if (!ok) {
+    jsvUnLock(result);
+    return 0;
+  }
+  return result;
+}
+#endif
@@ -84,11 +84,20 @@ typedef struct {
   const JswSymPtr *symbols;
   const char *symbolChars;
   unsigned char symbolCount;
+  const unsigned char *hashTable; ///< Perfect hash of the symbol names: hashBuckets seeds, then hashSize symbol indices
+  unsigned char hashBuckets; ///< 0 if there are no symbols
+  unsigned char hashSize;
 } PACKED_JSW_SYM JswSymList;
 
 /// Do a binary search of the symbol table list
 JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name);
 
+/// Get the hash of a symbol's name, for jswHashSearch
+unsigned int jswHashSymbol(const char *name);
+
+/// Look a symbol up in the symbol table list's hash table - hash must be jswHashSymbol(name)
+JsVar *jswHashSearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name, unsigned int hash);
+
 /** If 'name' is something that belongs to an internal function, execute it.  */
 JsVar *jswFindBuiltInFunction(JsVar *parent, const char *name);
 
@@ -48,6 +48,7 @@
 #include "jswrap_esp32_network.h"
 
 #include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
 #include "esp_wifi.h"
 #include "esp_system.h"
 #include "esp_spi_flash.h"
@@ -188,10 +189,13 @@ void jshSoftInit() {
 /**
  * Handle whatever needs to be done in the idle loop when there's nothing to do.
  *
- * Nothing is needed on the ESP32.
+ * On the ESP32 we send any UART output that was written from an ISR, as
+ * jshUSARTKick can't hand it to the UART driver there.
  */
 void jshIdle() {
-
+  jshUSARTKick(EV_SERIAL1);
+  jshUSARTKick(EV_SERIAL2);
+  jshUSARTKick(EV_SERIAL3);
 }
 
 // ESP32 chips don't have a serial number but they do have a MAC address
@@ -211,7 +215,7 @@ void jshInterruptOn()  {
 
 /// Are we currently in an interrupt?
 bool jshIsInInterrupt() {
-  return false; // FIXME!
+  return xPortInIsrContext();
 }
 
 /// Enter simple sleep mode (can be woken up by interrupts). Returns true on success
@@ -468,7 +472,7 @@ IOEventFlags jshPinWatch(
             jsError("*** jshPinWatch error");
         }
       }
-      return pin;
+      return pinToEV_EXTI(pin);
 }
 
 
@@ -525,6 +529,20 @@ bool jshIsUSBSERIALConnected() {
 void jshUSARTKick(
     IOEventFlags device //!< The device to be kicked.
 ) {
+  if (device==EV_SERIAL1 || device==EV_SERIAL2 || device==EV_SERIAL3) {
+    // The UART driver can't be used from an ISR, and writing straight to the
+    // hardware would overtake anything still in the driver's TX ring, so leave
+    // the data in our buffer for jshIdle to send.
+    if (xPortInIsrContext()) return;
+    // hand whole blocks to the UART driver rather than a byte at a time
+    unsigned char buf[TXBUFFERMASK+1];
+    int len = jshGetCharsToTransmit(device, buf, sizeof(buf));
+    while (len > 0) {
+      writeSerialBytes(device, buf, len);
+      len = jshGetCharsToTransmit(device, buf, sizeof(buf));
+    }
+    return;
+  }
   int c = jshGetCharToTransmit(device);
   while(c >= 0) {
 	switch(device){
@@ -533,9 +551,6 @@ void jshUSARTKick(
 			gatts_sendNotification(c);
 			break; 
 #endif
-		case EV_SERIAL1:
-			uart_tx_one_char((uint8_t)c);
-			break;
 		default:
 			writeSerial(device,(uint8_t)c);
 			break;
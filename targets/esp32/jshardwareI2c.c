@@ -18,6 +18,9 @@
 #include "jshardware.h"
 #include "jshardwareI2c.h"
 #include "driver/i2c.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
 #include "stdio.h"
 
 #define ACK_CHECK_EN   0x1   /*!< I2C master will check ack from slave*/
@@ -169,3 +172,92 @@ void jshI2CRead(IOEventFlags device,
   i2c_cmd_link_delete(cmd);
   checkError(  "jshI2CRead", ret);  
 }
+
+/// An async jshI2CTransfer, waiting for i2cAsyncTask to execute it
+typedef struct {
+  IOEventFlags device;
+  i2c_cmd_handle_t cmd;
+} I2CAsyncTransfer;
+
+static QueueHandle_t i2cAsyncQueue = NULL;
+static volatile JshI2CStatus i2cAsyncStatus[I2C_NUM_MAX];
+static volatile esp_err_t i2cAsyncError[I2C_NUM_MAX];
+
+/** i2c_master_cmd_begin blocks until the whole command link has been executed, so
+ * async transfers are run from this task, which pushes an IO event for the device
+ * when each one is finished */
+static void i2cAsyncTask(void *param) {
+  NOT_USED(param);
+  I2CAsyncTransfer transfer;
+  while (true) {
+    if (xQueueReceive(i2cAsyncQueue, &transfer, portMAX_DELAY) != pdTRUE) continue;
+    int i2c_master_port = getI2cFromDevice(transfer.device);
+    esp_err_t ret = i2c_master_cmd_begin(i2c_master_port, transfer.cmd, 1000 / portTICK_RATE_MS);
+    i2c_cmd_link_delete(transfer.cmd);
+    i2cAsyncError[i2c_master_port] = ret;
+    i2cAsyncStatus[i2c_master_port] = (ret == ESP_OK) ? JSHI2C_IDLE : JSHI2C_ERROR;
+    jshPushIOEvent(transfer.device, 0);
+  }
+}
+
+/** Build all the operations into one command link (with a repeated start before each)
+ * so the whole sequence is executed by the driver in one go */
+bool jshI2CTransfer(IOEventFlags device, JshI2COp *ops, int opCount, bool async) {
+  int i2c_master_port = getI2cFromDevice(device);
+  if (i2c_master_port == -1) {
+    jsExceptionHere(JSET_ERROR,"Only I2C1 and I2C2 supported"); 
+    return false;
+  }
+  if (i2cAsyncStatus[i2c_master_port] == JSHI2C_BUSY) {
+    if (async) {
+      jsExceptionHere(JSET_ERROR,"jshI2CTransfer: async transfer already in progress");
+      return false;
+    }
+    // otherwise i2c_master_cmd_begin waits for the driver to be free
+  }
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  for (int i=0;i<opCount;i++) {
+    JshI2COp *op = &ops[i];
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (op->address << 1) | (op->read ? I2C_MASTER_READ : I2C_MASTER_WRITE), ACK_CHECK_EN);
+    if (op->nBytes <= 0) continue;
+    if (op->read) {
+      if (op->nBytes > 1)
+        i2c_master_read(cmd, op->data, op->nBytes - 1, ACK_VAL);
+      i2c_master_read_byte(cmd, op->data + op->nBytes - 1, NACK_VAL);
+    } else
+      i2c_master_write(cmd, op->data, op->nBytes, ACK_CHECK_EN);
+  }
+  i2c_master_stop(cmd);
+  if (async) {
+    if (!i2cAsyncQueue) {
+      i2cAsyncQueue = xQueueCreate(I2C_NUM_MAX, sizeof(I2CAsyncTransfer));
+      if (!i2cAsyncQueue || xTaskCreatePinnedToCore(i2cAsyncTask, "i2cAsyncTask", 2048, NULL, 6, NULL, 0) != pdPASS) {
+        // no task - just do it synchronously
+        if (i2cAsyncQueue) vQueueDelete(i2cAsyncQueue);
+        i2cAsyncQueue = NULL;
+        async = false;
+      }
+    }
+  }
+  if (async) {
+    I2CAsyncTransfer transfer = { device, cmd };
+    i2cAsyncStatus[i2c_master_port] = JSHI2C_BUSY;
+    xQueueSend(i2cAsyncQueue, &transfer, portMAX_DELAY);
+    return true;
+  }
+  esp_err_t ret = i2c_master_cmd_begin(i2c_master_port, cmd, 1000 / portTICK_RATE_MS);
+  i2c_cmd_link_delete(cmd);
+  return checkError("jshI2CTransfer", ret) == ESP_OK;
+}
+
+JshI2CStatus jshI2CPoll(IOEventFlags device) {
+  int i2c_master_port = getI2cFromDevice(device);
+  if (i2c_master_port == -1) return JSHI2C_IDLE;
+  JshI2CStatus status = i2cAsyncStatus[i2c_master_port];
+  if (status == JSHI2C_ERROR) {
+    checkError("jshI2CTransfer", i2cAsyncError[i2c_master_port]);
+    i2cAsyncStatus[i2c_master_port] = JSHI2C_IDLE;
+  }
+  return status;
+}
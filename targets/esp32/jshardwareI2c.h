@@ -27,3 +27,5 @@ void I2CReset();
 void jshI2CSetup(IOEventFlags device, JshI2CInfo *info);
 void jshI2CWrite(IOEventFlags device, unsigned char address, int nBytes, const unsigned char *data, bool sendStop);
 void jshI2CRead(IOEventFlags device,  unsigned char address, int nBytes, unsigned char *data, bool sendStop);
+bool jshI2CTransfer(IOEventFlags device, JshI2COp *ops, int opCount, bool async);
+JshI2CStatus jshI2CPoll(IOEventFlags device);
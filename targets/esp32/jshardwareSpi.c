@@ -31,11 +31,15 @@ void SPIChannelsInit(){
     SPIChannels[i].spi = NULL;
     SPIChannels[i].spi_read = false;
 	SPIChannels[i].g_lastSPIRead = (uint32_t)-1;
+    SPIChannels[i].transFirst = 0;
+    SPIChannels[i].transCount = 0;
+    SPIChannels[i].eventPending = false;
   }
   SPIChannels[0].HOST = SPI2_HOST;
   SPIChannels[1].HOST = SPI3_HOST;
 }
 void SPIChannelReset(int channelPnt){
+  jshSPIWait(EV_SPI1 + channelPnt); // the driver won't remove a device with transfers queued
   spi_bus_remove_device(SPIChannels[channelPnt].spi);
   spi_bus_free(SPIChannels[channelPnt].HOST);
   SPIChannels[channelPnt].spi = NULL;
@@ -82,8 +86,38 @@ Espruino supports sendig byte by byte, no mass sending is supported.
 */
   
   
-volatile spi_transaction_t spi_trans;
-volatile bool spi_Sending = false;
+#ifndef SPI_SIMULATED // otherwise src/jshardware_spisim.c provides these
+/** Called from the SPI interrupt when a transfer has been sent. Transfers with a
+ * callback have their device in 'user', and we push an event for it so the idle
+ * loop knows to call jshSPIPoll (only one at a time, so a long stream of
+ * transfers can't fill the event queue) */
+static void IRAM_ATTR spi_post_cb(spi_transaction_t *t) {
+  if (!t->user) return;
+  IOEventFlags device = (IOEventFlags)(size_t)t->user;
+  struct SPIChannel *ch = &SPIChannels[device - EV_SPI1];
+  if (ch->eventPending) return;
+  ch->eventPending = true;
+  jshPushIOEvent(device, 0);
+}
+
+/** Get the result of the oldest transfer queued by jshSPISendMany and call its
+ * callback. Returns false if it hasn't finished within 'wait' ticks */
+static bool SPIChannelFinishTransfer(int channelPnt, TickType_t wait) {
+  struct SPIChannel *ch = &SPIChannels[channelPnt];
+  if (!ch->transCount) return false;
+  spi_transaction_t *t;
+  esp_err_t ret = spi_device_get_trans_result(ch->spi, &t, wait);
+  if (ret == ESP_ERR_TIMEOUT) return false;
+  if (ret != ESP_OK) {
+    jsExceptionHere(JSET_INTERNALERROR, "SPI Send Error %d\n", ret);
+  }
+  // Transfers on one device complete in the order they were queued
+  void (*callback)() = ch->callbacks[ch->transFirst];
+  ch->transFirst = (uint8_t)((ch->transFirst+1) % SPITransfersMax);
+  ch->transCount--;
+  if (callback) callback();
+  return true;
+}
 
 /**
  * Initialize the hardware SPI device.
@@ -127,7 +161,8 @@ void jshSPISetup(
         .mode=inf->spiMode,
         .spics_io_num= -1,               //set CS not used by driver
         .queue_size=7,      //We want to be able to queue 7 transactions at a time
-		.flags=flags
+		.flags=flags,
+        .post_cb=spi_post_cb
     };
   if(SPIChannels[channelPnt].spi){
 	SPIChannelReset(channelPnt);
@@ -150,6 +185,7 @@ int jshSPISend(
 ) {
   int channelPnt = getSPIChannelPnt(device);
   uint8_t byte = (uint8_t)data;
+  jshSPIWait(device); // finish any transfer jshSPISendMany left running
   if (data >=0) {
     esp_err_t ret;
     spi_transaction_t t;
@@ -169,6 +205,9 @@ int jshSPISend(
 
 /** Send data in tx through the given SPI device and return the response in
  * rx (if supplied). Returns true on success.
+ * If there is a callback (and no rx) we return as soon as the transfer is queued
+ * (waiting only if SPITransfersMax are already queued), and the callback is called
+ * when jshSPIWait or jshSPIPoll finds it has completed. tx must stay valid until then.
  */
 bool jshSPISendMany(IOEventFlags device, unsigned char *tx, unsigned char *rx, size_t count, void (*callback)()) {
     if (!jshIsDeviceInitialised(device)) return false;
@@ -178,21 +217,29 @@ bool jshSPISendMany(IOEventFlags device, unsigned char *tx, unsigned char *rx, s
       if(callback)callback();
       return true;
     }
-	jshSPIWait(device);
     int channelPnt = getSPIChannelPnt(device);
+    struct SPIChannel *ch = &SPIChannels[channelPnt];
+    bool async = callback && !rx;
+    if (!async) jshSPIWait(device);
+    else if (ch->transCount == SPITransfersMax)
+      SPIChannelFinishTransfer(channelPnt, portMAX_DELAY); // make room
+    int idx = (ch->transFirst + ch->transCount) % SPITransfersMax;
+    spi_transaction_t *t = &ch->trans[idx];
 	esp_err_t ret;
-    memset(&spi_trans, 0, sizeof(spi_trans));
-    spi_trans.length=count*8;
-    spi_trans.tx_buffer=tx;
-    spi_trans.rx_buffer=rx;
-	spi_Sending = true;
-    ret=spi_device_queue_trans(SPIChannels[channelPnt].spi, &spi_trans, rx?0:portMAX_DELAY);
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length=count*8;
+    t->tx_buffer=tx;
+    t->rx_buffer=rx;
+    t->user=async ? (void*)(size_t)device : NULL;
+    ch->callbacks[idx] = async ? callback : NULL;
+    ret=spi_device_queue_trans(ch->spi, t, portMAX_DELAY);
     
 	if (ret != ESP_OK) {
-	  spi_Sending = false;
       jsExceptionHere(JSET_INTERNALERROR, "SPI Send Error %d\n", ret);
       return false;
     }
+    ch->transCount++;
+	if (async) return true;
 	jshSPIWait(device);
 	if(callback)callback();
   return true;
@@ -229,14 +276,19 @@ void jshSPISet16(
  */
 void jshSPIWait(IOEventFlags device) {
   int channelPnt = getSPIChannelPnt(device);
-  if(!spi_Sending)return;
-  esp_err_t ret;
-  ret=spi_device_get_trans_result(SPIChannels[channelPnt].spi, &spi_trans, portMAX_DELAY);
-  if (ret != ESP_OK) {
-    jsExceptionHere(JSET_INTERNALERROR, "SPI Send Error %d\n", ret);
-  }
-  spi_Sending = false;
-  }
+  while (SPIChannelFinishTransfer(channelPnt, portMAX_DELAY));
+}
+
+/**
+ * Call the callbacks of any transfers that have finished, without waiting.
+ * Returns the number still in progress.
+ */
+int jshSPIPoll(IOEventFlags device) {
+  int channelPnt = getSPIChannelPnt(device);
+  SPIChannels[channelPnt].eventPending = false;
+  while (SPIChannelFinishTransfer(channelPnt, 0));
+  return SPIChannels[channelPnt].transCount;
+}
 
 
 /** Set whether to use the receive interrupt or not */
@@ -244,3 +296,4 @@ void jshSPISetReceive(IOEventFlags device, bool isReceive) {
   int channelPnt = getSPIChannelPnt(device);
   SPIChannels[channelPnt].spi_read = isReceive;  
 }
+#endif
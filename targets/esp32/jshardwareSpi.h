@@ -24,11 +24,17 @@
 gpio_num_t pinToESP32Pin(Pin pin);
 
 #define SPIMax 2
+#define SPITransfersMax 4 // jshSPISendMany transfers that can be queued on each channel at once
 struct SPIChannel{
   spi_device_handle_t spi;
   bool spi_read;
   uint32_t g_lastSPIRead;
   spi_host_device_t HOST;
+  spi_transaction_t trans[SPITransfersMax]; // ring of transfers queued by jshSPISendMany
+  void (*callbacks[SPITransfersMax])();     // called once each transfer has completed
+  uint8_t transFirst;                       // oldest transfer in the ring
+  uint8_t transCount;                       // number of transfers still in progress
+  volatile bool eventPending;               // we've pushed an IO event that jshSPIPoll hasn't handled yet
 };
 struct SPIChannel SPIChannels[SPIMax];
 void SPIChannelsInit();
@@ -41,4 +47,5 @@ bool jshSPISendMany(IOEventFlags device, unsigned char *tx, unsigned char *rx, s
 void jshSPISend16( IOEventFlags device, int data );
 void jshSPISet16( IOEventFlags device, bool is16 );
 void jshSPIWait( IOEventFlags device );
+int jshSPIPoll( IOEventFlags device );
 void jshSPISetReceive(IOEventFlags device, bool isReceive);
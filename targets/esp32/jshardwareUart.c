@@ -107,6 +107,15 @@ void serialToEspruino(){
   }
 }
 
+void writeSerialBytes(IOEventFlags device,const uint8_t *data,int len){
+  int uart_num;
+  if(device == EV_SERIAL1) uart_num = uart_console;
+  else if(device == EV_SERIAL2) uart_num = uart_Serial2;
+  else uart_num = uart_Serial3;
+  // copies into the driver's TX ring buffer, and only blocks if that is full
+  uart_write_bytes(uart_num, (const char*)data, (size_t)len);
+}
+
 void writeSerial(IOEventFlags device,uint8_t c){
   char str[2]; int r;
   str[1] = '\0';
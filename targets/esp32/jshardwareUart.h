@@ -24,5 +24,6 @@ void initConsole();
 void UartReset();
 void initSerial(IOEventFlags device,JshUSARTInfo *inf);
 void writeSerial(IOEventFlags device,uint8_t c); 
+void writeSerialBytes(IOEventFlags device,const uint8_t *data,int len);
 void consoleToEspruino();
 void serialToEspruino();
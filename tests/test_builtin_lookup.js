@@ -0,0 +1,30 @@
+// Builtin functions and objects are found with perfect hash tables. List every
+// builtin name (which walks the symbol tables directly), then make sure each
+// one can be looked up by name - and that near misses aren't found
+var missing = [];
+function checkAll(name, obj) {
+  Object.getOwnPropertyNames(obj).forEach(function(n) {
+    if (n!="undefined" && obj[n]===undefined) missing.push(name+"."+n);
+  });
+}
+checkAll("global", global);
+checkAll("Math", Math);
+checkAll("JSON", JSON);
+checkAll("E", E);
+checkAll("String.prototype", String.prototype);
+checkAll("Array.prototype", Array.prototype);
+checkAll("Object.prototype", Object.prototype);
+checkAll("Function.prototype", Function.prototype);
+checkAll("Uint8Array.prototype", Uint8Array.prototype);
+checkAll("Promise.prototype", Promise.prototype);
+
+// found via the constructor's prototype and then Object.prototype
+var inherited = typeof [].map=="function" && typeof [].hasOwnProperty=="function" &&
+                typeof "x".toUpperCase=="function" && typeof (5).toFixed=="function";
+
+// names that are close to builtins (or hash the same way) shouldn't be found
+var nearMiss = ["Mat", "Mathh", "math", "MATH", "sin2", "Sin", "", "a", "parseInt_", "JSONN"];
+var found = nearMiss.filter(function(n) { return global[n]!==undefined || Math[n]!==undefined; });
+
+result = missing.length==0 && inherited && found.length==0 &&
+         typeof Math=="object" && typeof NotABuiltin=="undefined" && Math.sin(0)==0;
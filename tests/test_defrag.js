@@ -0,0 +1,31 @@
+// E.defrag compacts memory by moving variables and rewriting references to
+// them. Fragment memory, defrag, then check everything still holds the same
+// data - including timers and watches, whose lists are referenced from C
+var keep = [], junk = [];
+for (var i=0;i<200;i++) {
+  keep.push({ i:i, s:"str"+i, a:[i,i+1,i+2] });
+  junk.push({ x:"junk"+i, y:[1,2,3,4,5] });
+}
+junk = undefined; // leaves holes all over memory
+
+var timerFired = false, intervalCount = 0;
+setTimeout(function() { timerFired = true; }, 50);
+var interval = setInterval(function() { intervalCount++; }, 20);
+var watch = setWatch(function() {}, D18, {repeat:true}); // a pin ESP32 can watch
+var obj = { nested : { deeper : { value : "hello" } } };
+var fn = function(a) { return a + obj.nested.deeper.value; };
+
+E.defrag();
+var mem = process.memory();
+
+var ok = true;
+keep.forEach(function(k, i) {
+  if (k.i!=i || k.s!="str"+i || k.a.join()!=[i,i+1,i+2].join()) ok = false;
+});
+ok = ok && fn("say ")=="say hello" && typeof mem.defragtime=="number";
+
+setTimeout(function() {
+  clearInterval(interval);
+  clearWatch(watch);
+  result = ok && timerFired && intervalCount>=3;
+}, 150);
@@ -0,0 +1,27 @@
+// net.lookup should fail (rather than truncate or mangle) names that
+// can't be sent as a DNS query. None of these need a working network.
+var net = require("net");
+
+function repeat(c,n) { var s=""; while (n--) s+=c; return s; }
+
+var names = [
+  repeat("x",127),               // a single 127 character label
+  repeat("x",64)+".com",         // label over 63 characters
+  "www."+repeat("x",200)+".com", // longer than we can store
+  "a..b",                        // empty label
+];
+var errors = 0, ipOk = false;
+
+names.forEach(function(name) {
+  net.lookup(name, function(err, address) {
+    if (err && err.code==-6 && address===undefined) errors++;
+  });
+});
+// IP addresses don't need a query at all
+net.lookup("192.168.1.1", function(err, address, family) {
+  ipOk = err===null && address=="192.168.1.1" && family==4;
+});
+
+setTimeout(function() {
+  result = errors==names.length && ipOk;
+}, 100);
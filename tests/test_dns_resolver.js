@@ -0,0 +1,62 @@
+// The DNS resolver against a fake server on localhost: answers are cached
+// until their TTL runs out, answers that don't come from the server, or
+// don't repeat our question, are ignored, and net.connect to a host name
+// waits for the answer without blocking.
+var net = require("net");
+var dgram = require("dgram");
+
+var queries = {};
+var nextAddr = { "ttl.local":[10,0,0,1], "srv.local":[127,0,0,1] };
+
+function answer(q, name, addr) {
+  var question = q.substr(12); // name, type, class
+  if (name) { // replace the question with a different name
+    question = "";
+    name.split(".").forEach(function(l) { question += String.fromCharCode(l.length)+l; });
+    question += "\0\0\1\0\1";
+  }
+  return q.substr(0,2)+"\x81\x80\0\1\0\1\0\0\0\0"+question+
+         "\xC0\x0C\0\1\0\1\0\0\0\2\0\4"+String.fromCharCode.apply(null,addr); // TTL of 2 seconds
+}
+
+var spoofer = dgram.createSocket('udp4');
+spoofer.bind(5354);
+var server = dgram.createSocket('udp4');
+server.on('message', function(q, rinfo) {
+  var name = "", i = 12;
+  while (q.charCodeAt(i)) { name += (name?".":"")+q.substr(i+1, q.charCodeAt(i)); i += 1+q.charCodeAt(i); }
+  queries[name] = (queries[name]||0)+1;
+  if (name=="spoof.local") {
+    spoofer.send(answer(q, 0, [6,6,6,6]), rinfo.port, rinfo.address); // right id, wrong server
+    server.send(answer(q, "other.local", [7,7,7,7]), rinfo.port, rinfo.address); // wrong question
+    server.send(answer(q, 0, [10,0,0,9]), rinfo.port, rinfo.address);
+  } else {
+    server.send(answer(q, 0, nextAddr[name]), rinfo.port, rinfo.address);
+    if (name=="ttl.local") nextAddr[name] = [10,0,0,2];
+  }
+});
+server.bind(5353);
+net.setDNSServer("127.0.0.1", 5353);
+
+var addrs = [], spoofAddr, connected = false, connectReturned = false;
+net.lookup("ttl.local", function(err, addr) {
+  addrs.push(addr);
+  net.lookup("ttl.local", function(err, addr) { addrs.push(addr); }); // cached
+});
+setTimeout(function() { // after the TTL
+  net.lookup("ttl.local", function(err, addr) { addrs.push(addr); });
+}, 2500);
+net.lookup("spoof.local", function(err, addr) { spoofAddr = addr; });
+
+var tcp = net.createServer(function(c) { c.end(); }).listen(8099);
+var client = net.connect({host:"srv.local", port:8099}, function() { connected = true; });
+connectReturned = !connected; // the callback can't have happened yet
+
+setTimeout(function() {
+  tcp.close();
+  server.close();
+  spoofer.close();
+  net.setDNSServer(undefined);
+  result = addrs.join(",")=="10.0.0.1,10.0.0.1,10.0.0.2" && queries["ttl.local"]==2 &&
+           spoofAddr=="10.0.0.9" && connectReturned && connected && queries["srv.local"]==1;
+}, 3500);
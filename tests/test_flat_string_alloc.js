@@ -0,0 +1,29 @@
+// Typed arrays are stored in flat strings, which are allocated from runs of
+// free blocks. Allocate and free lots of different sizes (with small vars in
+// between to fragment memory) and make sure no two arrays share blocks
+
+var arrays = [];
+var small = [];
+var ok = true;
+
+function check(a, v) {
+  for (var j=0;j<a.length;j++) if (a[j]!=v) return false;
+  return true;
+}
+
+for (var iter=0;iter<2000;iter++) {
+  var i = (iter*37)%50;
+  if (arrays[i]) {
+    if (!check(arrays[i], i)) ok = false;
+    arrays[i] = undefined;
+  } else {
+    var a = new Uint8Array(20+((iter*13)%200));
+    a.fill(i);
+    arrays[i] = a;
+  }
+  var k = (iter*7)%100;
+  small[k] = small[k] ? undefined : {k:k};
+}
+
+arrays.forEach(function(a,i) { if (a && !check(a, i)) ok = false; });
+result = ok;
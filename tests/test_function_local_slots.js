@@ -0,0 +1,39 @@
+// Parameters and locals are looked up through slots in the function call's
+// frame. Check the cases where a slot must not be used, or must be re-found
+
+var results = [];
+
+// locals declared in different orders in different calls
+function br(x) { if (x) { var a1=1; var a2=2; return a2; } else { var a2=3; var a1=4; return a2; } }
+results.push(br(1)==2 && br(0)==3 && br(1)==2);
+// a local isn't used before it's declared
+var q = "glob";
+function k() { var r = q; var q = "loc"; return r+q; }
+results.push(k()=="globloc" && k()=="globloc");
+// let in a block hides a parameter
+function s(a) { var r = a; { let a = 5; r += a; } return r+a; }
+results.push(s(1)==7 && s(2)==9);
+// closures still see the function's scope
+function counter() { var n = 0; return function() { n++; return n; }; }
+var c = counter(); c(); c();
+results.push(c()==3);
+// recursion gets a new frame each time
+function rec(n) { if (n<=0) return 0; var t = n; return t + rec(n-1); }
+results.push(rec(10)==55);
+// more parameters than there are slots
+function many(a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r,s) { return a+q+s; }
+results.push(many(1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19)==37);
+// missing and extra arguments
+function ex(a,b) { return b; }
+results.push(ex(1)===undefined && ex(1,2,3)==2 && ex(4,5)==5);
+// eval can add locals
+function ev() { var z = 1; eval("var y = 2"); return z+y; }
+results.push(ev()==3);
+// in-place updates of parameters
+function upd(a) { a+=1; a++; ++a; return a; }
+results.push(upd(1)==4 && upd(10)==13);
+// arrow functions
+var af = (a,b) => a*b+a;
+results.push(af(2,3)==8 && af(4,5)==24);
+
+result = results.every(function(r) { return r; });
@@ -0,0 +1,56 @@
+// Flat ArrayBuffer Graphics have their own fill/pixel/scroll code for each
+// bit depth and bit order. Check fills at odd offsets (so partly covered
+// bytes at each end) and scrolls against a simple model of the pixels
+var W = 37, H = 16;
+var formats = [
+  {bpp:1}, {bpp:1, msb:true}, {bpp:1, vertical_byte:true},
+  {bpp:2}, {bpp:2, msb:true}, {bpp:4}, {bpp:4, msb:true},
+  {bpp:8}, {bpp:16}, {bpp:16, msb:true}, {bpp:24}
+];
+var rects = [ [0,0,36,15], [1,1,1,1], [3,2,17,9], [5,0,6,15], [9,3,35,3], [30,10,40,20], [-5,-5,2,2] ];
+var failed = [];
+
+formats.forEach(function(f) {
+  var g = Graphics.createArrayBuffer(W, H, f.bpp, f);
+  var model = new Array(W*H).fill(0);
+  var mask = f.bpp==24 ? 0xFFFFFF : (1<<f.bpp)-1;
+  function check(what) {
+    for (var y=0;y<H;y++) for (var x=0;x<W;x++)
+      if (g.getPixel(x,y)!=model[x+y*W]) { failed.push(JSON.stringify(f)+" "+what+" at "+x+","+y); return; }
+  }
+  rects.forEach(function(r, i) {
+    var col = (0x5A3C1F*(i+1)) & mask;
+    g.setColor(col).fillRect(r[0],r[1],r[2],r[3]);
+    for (var y=Math.max(r[1],0);y<=Math.min(r[3],H-1);y++)
+      for (var x=Math.max(r[0],0);x<=Math.min(r[2],W-1);x++)
+        model[x+y*W] = col;
+    check("fillRect "+r);
+  });
+  g.setColor(mask).setPixel(36,15);
+  model[36+15*W] = mask;
+  check("setPixel");
+  [[3,0],[0,-2],[-5,1]].forEach(function(d) {
+    g.scroll(d[0],d[1]);
+    var old = model.slice();
+    for (var y=0;y<H;y++) for (var x=0;x<W;x++) {
+      var sx = x-d[0], sy = y-d[1];
+      model[x+y*W] = (sx>=0 && sy>=0 && sx<W && sy<H) ? old[sx+sy*W] : 0;
+    }
+    check("scroll "+d);
+  });
+});
+
+// and make sure the bit/byte order in the buffer itself is right
+function firstBytes(bpp, opts, x1, x2, col) {
+  var g = Graphics.createArrayBuffer(16, 8, bpp, opts);
+  g.setColor(col).fillRect(x1,0,x2,0);
+  return new Uint8Array(g.buffer,0,3).join(",");
+}
+var layout = firstBytes(1, {}, 0, 2, 1)=="7,0,0" &&
+             firstBytes(1, {msb:true}, 0, 2, 1)=="224,0,0" &&
+             firstBytes(1, {vertical_byte:true}, 1, 2, 1)=="0,1,1" &&
+             firstBytes(4, {msb:true}, 1, 1, 5)=="5,0,0" &&
+             firstBytes(16, {}, 0, 0, 0x1234)=="52,18,0" &&
+             firstBytes(16, {msb:true}, 0, 0, 0x1234)=="18,52,0";
+
+result = failed.length==0 && layout;
@@ -0,0 +1,34 @@
+// Images from asImage("compressed") are decoded a row at a time in drawImage.
+// They must draw exactly like the uncompressed image - at any bit depth,
+// scaled, and partly clipped
+function source(bpp) {
+  var g = Graphics.createArrayBuffer(45, 30, bpp, {msb:true});
+  var max = (1<<Math.min(bpp,16))-1;
+  g.setColor(max).fillRect(0,0,44,29);
+  g.setColor(1).fillRect(3,4,30,12);
+  g.setColor(max>>1).fillCircle(30,20,8);
+  for (var i=0;i<45;i+=3) g.setColor(i*7 & max).setPixel(i, 27); // no runs at all
+  return g;
+}
+
+function draw(img, opts, clip) {
+  var g = Graphics.createArrayBuffer(120, 80, 16);
+  if (clip) g.setClipRect(20, 15, 70, 40);
+  g.drawImage(img, 5, 7, opts);
+  g.drawImage(img, -10, 50, opts); // partly off screen
+  return E.toString(g.buffer);
+}
+
+var ok = true, smaller = true;
+[1,2,4,8,16].forEach(function(bpp) {
+  var g = source(bpp);
+  var img = g.asImage("string"), cimg = g.asImage("compressed");
+  if (cimg.length >= img.length) smaller = false;
+  [undefined, {scale:2}].forEach(function(opts) {
+    [false, true].forEach(function(clip) {
+      if (draw(img, opts, clip) != draw(cimg, opts, clip)) ok = false;
+    });
+  });
+});
+
+result = ok && smaller;
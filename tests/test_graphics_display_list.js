@@ -0,0 +1,56 @@
+// Display lists record what would have been drawn, and drawList replays it
+// (offset and clipped) - which must look exactly like drawing it directly
+function scene(g, x, y) {
+  g.setColor(3).fillRect(x,y,x+40,y+12);
+  g.setColor(1).setFont("6x8").drawString("Hi!", x+4, y+3);
+  g.setColor(2).drawLine(x,y+20,x+30,y+35);
+  g.fillPoly([x+45,y+2, x+60,y+30, x+35,y+25]);
+  g.setColor(1).drawCircle(x+20,y+30,6);
+  g.setPixel(x+50,y+5);
+}
+function gfx() { return Graphics.createArrayBuffer(80, 50, 2, {msb:true}); }
+
+var g = gfx();
+g.getModified(true);
+g.beginList();
+scene(g, 0, 0);
+var list = g.endList();
+var nothingDrawn = E.toString(g.buffer)==E.toString(gfx().buffer) && g.getModified()===undefined;
+
+g.drawList(list, 0, 0);
+var d = gfx(); scene(d, 0, 0);
+var same = E.toString(g.buffer)==E.toString(d.buffer);
+
+g = gfx(); g.drawList(list, 10, 7);
+d = gfx(); scene(d, 10, 7);
+var offset = E.toString(g.buffer)==E.toString(d.buffer);
+
+g = gfx(); g.setClipRect(5, 4, 30, 25).drawList(list, 3, 2);
+d = gfx(); d.setClipRect(5, 4, 30, 25); scene(d, 3, 2);
+var clipped = E.toString(g.buffer)==E.toString(d.buffer);
+
+// lines and polygons are stored once each, not as every pixel they cover
+g = gfx();
+g.beginList();
+g.setColor(1).drawLine(0,0,79,49).fillPoly([0,49, 79,0, 79,49]);
+var compact = g.endList().buffer.length < 40;
+
+// each Graphics keeps its own list, so two can record at once
+var a = gfx(), b = gfx();
+a.beginList(); b.beginList();
+a.setColor(1).fillRect(0,0,9,9);
+b.setColor(2).drawLine(0,0,20,10);
+var la = a.endList(), lb = b.endList();
+g = gfx(); g.drawList(la, 0, 0);
+d = gfx(); d.setColor(1).fillRect(0,0,9,9);
+var separateA = E.toString(g.buffer)==E.toString(d.buffer);
+g = gfx(); g.drawList(lb, 0, 0);
+d = gfx(); d.setColor(2).drawLine(0,0,20,10);
+var separateB = E.toString(g.buffer)==E.toString(d.buffer);
+
+var twice = false;
+g.beginList();
+try { g.beginList(); } catch (e) { twice = true; }
+g.endList();
+
+result = nothingDrawn && same && offset && clipped && compact && separateA && separateB && twice && typeof list.time=="number";
@@ -0,0 +1,38 @@
+// drawImages composites layers a row at a time: check it matches drawImage,
+// then per-layer 'transparent' and 'alpha' (over a lower layer, and over
+// what's already on the screen), and compressed layers
+var b = Graphics.createArrayBuffer(20, 20, 8);
+b.setColor(200).fillRect(0,0,19,19).setColor(3).fillRect(4,4,8,15);
+var bottom = b.asImage();
+var t = Graphics.createArrayBuffer(10, 10, 8);
+t.setColor(100).fillRect(0,0,9,9).setColor(7).fillRect(2,2,4,4); // 7 is a hole
+var top = t.asImage();
+
+function gfx() {
+  var g = Graphics.createArrayBuffer(40, 40, 8);
+  g.setColor(40).fillRect(0,0,39,39);
+  return g;
+}
+
+var g1 = gfx().drawImages([{x:5, y:5, image:bottom}]);
+var g2 = gfx().drawImage(bottom, 5, 5);
+var same = E.toString(g1.buffer)==E.toString(g2.buffer);
+
+var g = gfx().drawImages([{x:5, y:5, image:bottom}, {x:15, y:15, image:top, transparent:7}]);
+var transparent = g.getPixel(15,15)==100 && g.getPixel(18,18)==200 && g.getPixel(24,24)==100 &&
+                  g.getPixel(10,10)==3 && g.getPixel(2,2)==40;
+
+g = gfx().drawImages([{x:5, y:5, image:bottom}, {x:15, y:15, image:top, alpha:0.5}]);
+var blended = g.getPixel(15,15)==150 && g.getPixel(18,18)==(200+7)>>1 && g.getPixel(26,26)==40;
+
+g = gfx().drawImages([{x:0, y:0, image:top, alpha:0.5}]); // over the screen
+var overScreen = g.getPixel(0,0)==70 && g.getPixel(12,12)==40;
+
+g = gfx().drawImages([{x:0, y:0, image:top, alpha:0}]);
+var invisible = g.getPixel(0,0)==40;
+
+g1 = gfx().drawImages([{x:3, y:2, image:b.asImage("compressed")}, {x:-2, y:9, image:t.asImage("compressed"), transparent:7}]);
+g2 = gfx().drawImages([{x:3, y:2, image:bottom}, {x:-2, y:9, image:top, transparent:7}]);
+var compressed = E.toString(g1.buffer)==E.toString(g2.buffer);
+
+result = same && transparent && blended && overScreen && invisible && compressed;
@@ -0,0 +1,28 @@
+// fillPoly used to be limited to 64 points, and silently dropped any edge
+// crossings past 64 on a scanline. Fill a comb with 40 teeth (80 crossings
+// on each scanline through the teeth, and 163 points) and check every tooth,
+// gap and the bar along the bottom
+var g = Graphics.createArrayBuffer(330, 32, 1);
+var poly = [0,30];
+for (var i=0;i<40;i++)
+  poly.push(8*i,0, 8*i+4,0, 8*i+4,20, 8*i+8,20);
+poly.push(320,30);
+g.fillPoly(poly);
+
+var ok = true;
+for (i=0;i<40;i++) {
+  if (!g.getPixel(8*i+2, 10)) ok = false; // tooth
+  if (g.getPixel(8*i+6, 10)) ok = false; // gap
+}
+for (var x=1;x<319;x++)
+  if (!g.getPixel(x, 25)) ok = false; // bar
+if (g.getPixel(325, 10) || g.getPixel(325, 25) || g.getPixel(10, 31)) ok = false;
+
+// two triangles sharing an edge should cover a square exactly once each side
+var h = Graphics.createArrayBuffer(32, 32, 8);
+h.setColor(1).fillPoly([2,2, 29,2, 2,29]);
+h.setColor(2).fillPoly([29,2, 29,29, 2,29]);
+var gaps = 0;
+for (var y=3;y<29;y++) for (x=3;x<29;x++) if (!h.getPixel(x,y)) gaps++;
+
+result = ok && gaps==0;
@@ -0,0 +1,30 @@
+// Graphics.flipSPI only sends the tiles that were modified (up to a 16x16
+// grid - so 4x4 pixel tiles here), merging neighbouring tiles into rects.
+// It's only built for ESP32
+if (!Graphics.prototype.flipSPI) {
+  result = true;
+} else {
+  var spi = new SPI();
+  spi.setup({mosi:D13, sck:D14});
+  var g = Graphics.createArrayBuffer(64, 64, 16);
+
+  g.flipSPI(spi, {dc:D12, all:true});
+  var all = g.getFlipStats(true);
+
+  g.fillRect(0,0,1,1);     // top left tile
+  g.fillRect(62,62,63,63); // bottom right tile
+  g.flipSPI(spi, {dc:D12});
+  var corners = g.getFlipStats(true);
+
+  g.fillRect(8,0,15,7);    // 2x2 tiles, sent as one rect
+  g.flipSPI(spi, {dc:D12});
+  var square = g.getFlipStats(true);
+
+  var nothing = g.flipSPI(spi, {dc:D12}); // nothing changed
+
+  // each rect is 11 bytes of commands, then 2 bytes per pixel
+  result = all.lastRects==1 && all.lastBytes==11+64*64*2 &&
+           corners.lastRects==2 && corners.lastBytes==2*(11+4*4*2) &&
+           square.lastRects==1 && square.lastBytes==11+8*8*2 &&
+           nothing==0;
+}
@@ -0,0 +1,34 @@
+// Vector font characters are rasterised once and then drawn from a cache.
+// Text drawn from the cache must be identical to text drawn without it -
+// including rotated, and when the cache is too small so characters get evicted
+function draw(rotation) {
+  var g = Graphics.createArrayBuffer(128, 64, 1);
+  g.setRotation(rotation).setFont("Vector", 18);
+  g.drawString("HeHe42", 3, 5);
+  g.setFont("Vector", 11).drawString("Wq%j", 20, 30);
+  return E.toString(g.buffer);
+}
+
+Graphics.setVectorFontCache(0);
+var plain = [draw(0), draw(1)];
+
+Graphics.setVectorFontCache(4096);
+var before = Graphics.getVectorFontCache();
+var first = draw(0);
+var mid = Graphics.getVectorFontCache();
+var second = draw(0);
+var after = Graphics.getVectorFontCache();
+var rotated = draw(1);
+
+Graphics.setVectorFontCache(200); // not enough for everything
+var small = Graphics.getVectorFontCache();
+var evicted = draw(0);
+var smallAfter = Graphics.getVectorFontCache();
+
+Graphics.setVectorFontCache(4096);
+
+result = first==plain[0] && second==plain[0] && rotated==plain[1] && evicted==plain[0] &&
+         // 'H','e','4','2' at 18 and 'W','q','%','j' at 11 aren't cached the first time
+         mid.misses-before.misses==8 && mid.hits-before.hits==2 &&
+         after.misses==mid.misses && after.hits-mid.hits==10 &&
+         small.used<=200 && smallAfter.used<=200 && smallAfter.size==200;
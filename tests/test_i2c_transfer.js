@@ -0,0 +1,21 @@
+// I2C.transfer returns everything that was read in one Uint8Array, one
+// operation after another. Nothing is connected, so use software I2C and
+// just check the layout of the result and the argument checks
+
+var i2c = new I2C();
+i2c.setup({scl:D10, sda:D11});
+
+var d = i2c.transfer([
+  {addr:0x68, write:0x3B}, {addr:0x68, read:6},
+  {addr:0x48, write:[0,1]}, {addr:0x48, read:2}
+]);
+var w = i2c.transfer([{addr:0x48, write:[1,2,3]}]);
+
+var errors = 0;
+[ "not an array", [], [{write:1}], [{addr:0x48}], [{addr:0x48, write:1, read:1}] ].forEach(function(ops) {
+  try { i2c.transfer(ops); } catch (e) { errors++; }
+});
+
+result = (d instanceof Uint8Array) && d.length==8 &&
+         (w instanceof Uint8Array) && w.length==0 &&
+         errors==5;
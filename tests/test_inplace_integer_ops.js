@@ -0,0 +1,33 @@
+// Small integer += / ++ / -- are done in place on the variable's name.
+// Make sure that still works for properties inherited from a prototype,
+// which have to become properties of the object itself
+
+function P(){}
+P.prototype.count = 5;
+
+var a = new P();
+a.count += 1;
+var b = new P();
+b.count++;
+var c = new P();
+++c.count;
+var d = new P();
+d.count -= 2;
+var e = new P();
+var eOld = e.count--;
+
+// ordinary variables and properties still work
+var x = 1;
+x += 2; x++; ++x; x -= 1; x *= 3;
+var o = { v : 10 };
+o.v += 5; o.v++;
+// results that don't fit in the name
+var big = 2147483647;
+big += 1;
+
+result = a.count==6 && a.hasOwnProperty("count") &&
+         b.count==6 && b.hasOwnProperty("count") &&
+         c.count==6 && c.hasOwnProperty("count") &&
+         d.count==3 && e.count==4 && eOld==5 &&
+         P.prototype.count==5 && (new P()).count==5 &&
+         x==12 && o.v==16 && big==2147483648;
@@ -0,0 +1,32 @@
+// Reserved words and punctuators are recognised with perfect hashing in the
+// lexer. Check that words next to reserved words (prefixes, suffixes, other
+// case) are still ordinary identifiers, that the reserved words still work,
+// and that every multi-character punctuator is read as one token
+var iff = 1, fo = 2, fora = 3, For = 4, whilex = 5, _var = 6, lets = 7, Do = 8;
+var returns = 9, thiss = 10, newer = 11, functions = 12, cas = 13, instanceofx = 14;
+var o = { if:1, for:2, while:3, var:4, return:5, class:6, new:7, delete:8, typeof:9 };
+var idents = iff+fo+fora+For+whilex+_var+lets+Do+returns+thiss+newer+functions+cas+instanceofx;
+var props = o.if+o.for+o.while+o.var+o.return+o.class+o.new+o.delete+o.typeof;
+
+var kw = [];
+for (var i=0;i<3;i++) { if (i==1) continue; kw.push(i); }
+do { kw.push("do"); } while (false);
+switch (typeof kw) { case "object": kw.push("switch"); break; default: kw.push("bad"); }
+try { throw new Error("x"); } catch (e) { kw.push(e instanceof Error); } finally { kw.push("finally"); }
+kw.push(void 0===undefined, "if" in o, delete o.if, !("if" in o));
+class C { constructor() { this.v = 1; } }
+kw.push(new C().v);
+let l = 1; const c = 2;
+kw.push(l+c);
+
+var a = 5, b = 3, p = [];
+p.push(a>>>1, a>>1, a<<2, a===5, a!==5, a==b, a!=b, a<=b, a>=b, a&&b, a||b);
+var x = 1; x += 2; x -= 1; x *= 6; x /= 2; x %= 5; x <<= 3; x >>= 1; x >>>= 1; x &= 7; x |= 8; x ^= 1;
+p.push(x, a++, a--, ++a, --a, (v => v*2)(4));
+var n = null;
+p.push(n ?? "dflt", o.for ?? 0);
+for (var k of [1]) p.push("of"+k);
+
+result = idents==105 && props==45 &&
+         kw.join()=="0,2,do,switch,true,finally,true,true,true,true,1,3" &&
+         p.join()=="2,2,20,true,false,false,true,false,true,3,5,11,5,6,6,5,8,dflt,2,of1";
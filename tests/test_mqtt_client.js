@@ -0,0 +1,65 @@
+// The native MQTT client: CONNACK, SUBACK, wildcard subscription callbacks
+// and QoS 1 publish/PUBACK. The broker is a minimal net.Server in this file,
+// so nothing external is needed - just a network connection for localhost.
+var net = require("net");
+
+var brokerGot = [], brokerSubs = 0;
+var temps = [], office = [], published = [], subscribed = [];
+var pubId;
+
+function str(s) { return String.fromCharCode(s.length>>8, s.length&255)+s; }
+function pub(topic, msg) {
+  var body = str(topic)+msg;
+  return "\x30"+String.fromCharCode(body.length)+body;
+}
+
+var server = net.createServer(function(c) {
+  var buf = "";
+  c.on('data', function(d) {
+    buf += d;
+    // all our packets are shorter than 128 bytes, so have a 1 byte length
+    while (buf.length>=2 && buf.length>=2+buf.charCodeAt(1)) {
+      var hdr = buf.charCodeAt(0), body = buf.substr(2, buf.charCodeAt(1));
+      buf = buf.substr(2+body.length);
+      switch (hdr>>4) {
+        case 1: // CONNECT
+          c.write("\x20\x02\x00\x00");
+          break;
+        case 8: // SUBSCRIBE - grant QoS 1, then once both are in send some messages
+          c.write("\x90\x03"+body.substr(0,2)+"\x01");
+          if (++brokerSubs==2)
+            c.write(pub("home/kitchen/temperature","21")+pub("home/kitchen/humidity","50")+
+                    pub("home/a/b/temperature","x")+pub("office/a/b","y"));
+          break;
+        case 3: { // PUBLISH
+          var topicLen = (body.charCodeAt(0)<<8) | body.charCodeAt(1);
+          var qos = (hdr>>1)&3;
+          var id = qos ? body.substr(2+topicLen, 2) : "";
+          brokerGot.push(body.substr(2, topicLen)+"="+body.substr(2+topicLen+id.length)+"/"+qos);
+          if (qos) c.write("\x40\x02"+id);
+          break;
+        }
+      }
+    }
+  });
+}).listen(18830);
+
+var mqtt = require("MQTT").create("localhost", {port:18830, client_id:"test", keep_alive:0});
+mqtt.on('connected', function() {
+  mqtt.subscribe("home/+/temperature", {qos:1}, function(msg) { temps.push(msg.topic+"="+msg.message); });
+  mqtt.subscribe("office/#", function(msg) { office.push(msg.topic+"="+msg.message); });
+  pubId = mqtt.publish("home/status", "online", {qos:1});
+});
+mqtt.on('published', function(id) { published.push(id); });
+mqtt.on('subscribed', function(id, qos) { subscribed.push(qos); });
+mqtt.connect();
+
+setTimeout(function() {
+  mqtt.disconnect();
+  server.close();
+  result = subscribed.length==2 && subscribed[0]==1 &&
+           temps.length==1 && temps[0]=="home/kitchen/temperature=21" &&
+           office.length==1 && office[0]=="office/a/b=y" &&
+           brokerGot.length==1 && brokerGot[0]=="home/status=online/1" &&
+           published.length==1 && published[0]==pubId;
+}, 1000);
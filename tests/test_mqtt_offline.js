@@ -0,0 +1,47 @@
+// Publishing while the MQTT client isn't connected: QoS 0 messages are
+// dropped without an exception, and QoS 1 messages go to the Storage outbox
+// (one file each) and are sent, in order, once we connect. The broker is a
+// minimal net.Server in this file.
+var net = require("net");
+
+var brokerGot = [];
+var server = net.createServer(function(c) {
+  var buf = "";
+  c.on('data', function(d) {
+    buf += d;
+    // all our packets are shorter than 128 bytes, so have a 1 byte length
+    while (buf.length>=2 && buf.length>=2+buf.charCodeAt(1)) {
+      var hdr = buf.charCodeAt(0), body = buf.substr(2, buf.charCodeAt(1));
+      buf = buf.substr(2+body.length);
+      if ((hdr>>4)==1) c.write("\x20\x02\x00\x00"); // CONNECT -> CONNACK
+      if ((hdr>>4)==3) { // PUBLISH
+        var topicLen = (body.charCodeAt(0)<<8) | body.charCodeAt(1);
+        var id = body.substr(2+topicLen, 2);
+        brokerGot.push(body.substr(2+topicLen+2));
+        c.write("\x40\x02"+id);
+      }
+    }
+  });
+}).listen(18831);
+
+var mqtt = require("MQTT").create("localhost", {port:18831, client_id:"offline", keep_alive:0, outbox:"mqtest"});
+var published = 0;
+mqtt.on('published', function() { published++; });
+
+var threw = false, qos0Id;
+try {
+  qos0Id = mqtt.publish("t", "dropped");
+  mqtt.publish("t", "one", {qos:1});
+  mqtt.publish("t", "two", {qos:1});
+  mqtt.publish("t", "three", {qos:1});
+} catch (e) {
+  threw = true;
+}
+mqtt.connect();
+
+setTimeout(function() {
+  mqtt.disconnect();
+  server.close();
+  result = !threw && qos0Id==0 && published==3 &&
+           brokerGot.join(",")=="one,two,three";
+}, 1000);
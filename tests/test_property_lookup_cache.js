@@ -0,0 +1,51 @@
+// Each `a.b` remembers where it found 'b' last time, and checks that's still
+// right before using it. Make the same lookups see objects with different
+// layouts, deleted and re-added properties, shadowed prototype properties and
+// replaced methods
+function P() { this.x = 1; }
+P.prototype.get = function() { return "proto"; };
+P.prototype.y = 10;
+
+function getX(o) { return o.x; }
+function getY(o) { return o.y; }
+function call(o) { return o.get(); }
+
+var out = [];
+var objs = [ {x:1}, {a:0, x:2}, {a:0, b:0, c:0, x:3}, new P(), {y:4, x:5} ];
+for (var n=0;n<3;n++)
+  objs.forEach(function(o) { out.push(getX(o)); });
+
+var o = {a:1, x:6, z:2};
+out.push(getX(o));
+delete o.x;
+out.push(getX(o));  // undefined
+o.x = 7;             // added at the end now
+out.push(getX(o));
+delete o.a;          // x moves
+out.push(getX(o));
+
+var p = new P();
+out.push(getY(p));   // from the prototype
+p.y = 11;            // now shadowed
+out.push(getY(p));
+delete p.y;
+out.push(getY(p));
+P.prototype.y = 12;
+out.push(getY(p));
+
+out.push(call(p));
+p.get = function() { return "own"; };
+out.push(call(p));
+delete p.get;
+P.prototype.get = function() { return "proto2"; };
+out.push(call(p));
+
+// the same name on lots of different objects in one loop
+var sum = 0;
+for (var i=0;i<100;i++) {
+  var q = (i%3==0) ? {v:i} : (i%3==1) ? {w:0, v:i} : Object.create({v:i});
+  sum += q.v;
+}
+
+result = out.join(",")=="1,2,3,1,5,1,2,3,1,5,1,2,3,1,5,6,,7,7,10,11,10,12,proto,own,proto2" &&
+         sum==4950;
@@ -0,0 +1,46 @@
+// UART output is handed to the driver a block at a time rather than a byte
+// at a time. Send more than the transmit buffer holds, as one string and as
+// lots of small writes, and check it all arrives in order. Then measure the
+// throughput at 921600 baud, which a byte at a time can't keep up with.
+// Needs a wire from Serial2's TX (D17) to its RX (D16) as a loopback
+var N = 600;
+var sent = "";
+for (var i=0;i<N;i++) sent += String.fromCharCode(32 + (i*7)%95);
+
+var received = "";
+Serial2.setup(115200, {tx:D17, rx:D16});
+Serial2.on('data', function(d) { received += d; });
+
+Serial2.write(sent);
+for (i=0;i<N;i+=3) Serial2.write(sent.substr(i,3));
+Serial2.print(sent.substr(0,100));
+
+// 10 bits per byte, so this is the most the line can carry
+var BAUD = 921600, BULK = 20000;
+var bulk = new Uint8Array(1000);
+for (i=0;i<bulk.length;i++) bulk[i] = i;
+
+function throughput(cb) {
+  var count = 0, start;
+  function done(bytesPerSec) {
+    if (cb) cb(bytesPerSec);
+    cb = undefined;
+  }
+  Serial2.removeAllListeners('data');
+  Serial2.setup(BAUD, {tx:D17, rx:D16});
+  Serial2.on('data', function(d) {
+    count += d.length;
+    if (count>=BULK) done(count/(getTime()-start));
+  });
+  start = getTime();
+  for (var n=0;n<BULK;n+=bulk.length) Serial2.write(bulk);
+  setTimeout(function() { done(0); }, 2000);
+}
+
+setTimeout(function() {
+  var inOrder = received == sent + sent + sent.substr(0,100);
+  throughput(function(bytesPerSec) {
+    console.log("Serial2 TX: "+Math.round(bytesPerSec)+" bytes/sec of "+BAUD/10+" possible");
+    result = inOrder && bytesPerSec > BAUD/10*0.6;
+  });
+}, 500);
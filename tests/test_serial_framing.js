@@ -0,0 +1,37 @@
+// Serial framing splits received data into 'packet' events in C.
+// LoopbackA and LoopbackB are connected together, so use them to check
+// the COBS, SLIP and line framers, including frames that are too big
+
+var cobs = [], slip = [], lines = [];
+
+LoopbackB.setup(9600, {framing:{type:'cobs'}});
+LoopbackB.on('packet', function(d) { cobs.push(d); });
+LoopbackA.setup(9600, {framing:{type:'slip'}});
+LoopbackA.on('packet', function(d) { slip.push(d); });
+
+// COBS: 11 22 00 33, then an empty frame, then a frame with a missing byte
+LoopbackA.write("\x03\x11\x22\x02\x33\x00\x01\x00\x03\x44\x00");
+// SLIP: A B END C ESC, with a leading END, then a bad escape
+LoopbackB.write("\xC0AB\xDB\xDCC\xDB\xDD\xC0\xC0X\xDBY\xC0");
+
+setTimeout(function() {
+  var cobsInfo = LoopbackB.getFramingInfo();
+  var slipInfo = LoopbackA.getFramingInfo();
+  var ok = cobs.length==2 && cobs[0]=="\x11\x22\x00\x33" && cobs[1]=="" &&
+           cobsInfo.packets==2 && cobsInfo.errors==1 &&
+           slip.length==1 && slip[0]=="AB\xC0C\xDB" &&
+           slipInfo.packets==1 && slipInfo.errors==1;
+
+  LoopbackB.setup(9600, {framing:{type:'line', maxLength:8}});
+  LoopbackB.removeAllListeners('packet');
+  LoopbackB.on('packet', function(d) { lines.push(d); });
+  // a line of exactly maxLength fits even with "\r\n" after it, and a '\r' elsewhere is kept
+  LoopbackA.write("hello\r\n12345678\r\na\rb\nthis line is too long\nworld\npart");
+
+  setTimeout(function() {
+    var info = LoopbackB.getFramingInfo();
+    result = ok && lines.length==4 && lines[0]=="hello" && lines[1]=="12345678" &&
+             lines[2]=="a\rb" && lines[3]=="world" &&
+             info.overflows==1 && info.pending==4;
+  }, 10);
+}, 10);
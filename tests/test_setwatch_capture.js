@@ -0,0 +1,30 @@
+// setWatch with a 'buffer' records edge times in the interrupt, and calls the
+// function once per batch. Nothing needs connecting: the pin is left floating
+// and moved up and down by switching between its pull-up and pull-down
+var PIN = D18; // must be a pin we can watch: D0, D12-19, D21 or D22
+var EDGES = 10;
+pinMode(PIN, "input_pulldown");
+
+var count = 0, missed = 0, batches = 0, ordered = true;
+var id = setWatch(function(e) {
+  batches++;
+  count += e.count;
+  missed += e.missed;
+  for (var i=1;i<e.count;i++) if (e.buffer[i]<e.buffer[i-1]) ordered = false;
+}, PIN, {edge:"both", buffer:new Uint32Array(32)});
+
+for (var i=0;i<EDGES;i++) {
+  pinMode(PIN, (i&1) ? "input_pulldown" : "input_pullup");
+  var t = getTime(); while (getTime()<t+0.002); // let the pin settle
+}
+
+// buffer must be a Uint32Array, can't be used with irq, or on a pin that's already watched
+var errors = 0;
+try { setWatch(function(){}, D19, {buffer:new Uint8Array(8)}); } catch (e) { errors++; }
+try { setWatch(function(){}, D19, {irq:true, buffer:new Uint32Array(8)}); } catch (e) { errors++; }
+try { setWatch(function(){}, PIN, {buffer:new Uint32Array(8)}); } catch (e) { errors++; }
+
+setTimeout(function() {
+  clearWatch(id);
+  result = count==EDGES && missed==0 && batches>=1 && ordered && errors==3;
+}, 100);
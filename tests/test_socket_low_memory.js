@@ -0,0 +1,37 @@
+// With less than 10% of variables free, a socket that hasn't set minFree
+// must keep reading - so it still gets its data and sees the other end close.
+// One that has set minFree stops reading until memory is freed.
+var net = require("net");
+
+var server = net.createServer(function(c) {
+  c.write("Hello");
+  c.end();
+}).listen(8096);
+
+// use up memory until only ~5% of variables are free
+var hog = [];
+var m = process.memory();
+while (m.free > m.total*0.05) {
+  hog.push(new Array(50).fill(0));
+  m = process.memory();
+}
+
+var plainData = "", plainEnded = false;
+var plain = net.connect({host:"localhost", port:8096}, function() {});
+plain.on('data', function(d) { plainData += d; });
+plain.on('end', function() { plainEnded = true; });
+
+var limitedData = "", limitedLow;
+var limited = net.connect({host:"localhost", port:8096}, function() {});
+limited.setHighWaterMark(0, 10);
+limited.on('data', function(d) { limitedData += d; });
+
+setTimeout(function() {
+  limitedLow = limitedData;
+  hog = undefined; // free the memory, so 'limited' reads again
+}, 500);
+
+setTimeout(function() {
+  server.close();
+  result = plainData=="Hello" && plainEnded && limitedLow=="" && limitedData=="Hello";
+}, 1000);
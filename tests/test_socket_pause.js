@@ -0,0 +1,33 @@
+// Socket.pause stops 'data' events (leaving data in the network stack)
+// until Socket.resume, and then everything arrives in order. write()
+// returns false once more than the high water mark is waiting to be sent
+var net = require("net");
+
+var sent = "";
+for (var i=0;i<300;i++) sent += String.fromCharCode(48+(i%40));
+var writeFull;
+
+var server = net.createServer(function(c) {
+  c.write(sent);
+  c.end();
+}).listen(8091);
+
+var received = "", duringPause, ended = false;
+var client = net.connect({host:"localhost", port:8091}, function() {
+  client.pause();
+  client.setHighWaterMark(32, 0);
+  var w1 = client.write("short");
+  var big = ""; while (big.length<100) big += "x";
+  writeFull = w1===true && client.write(big)===false;
+  setTimeout(function() {
+    duringPause = received.length;
+    client.resume();
+  }, 300);
+});
+client.on('data', function(d) { received += d; });
+client.on('end', function() { ended = true; });
+
+setTimeout(function() {
+  server.close();
+  result = duringPause===0 && received==sent && ended && writeFull;
+}, 1000);
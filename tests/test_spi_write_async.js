@@ -0,0 +1,37 @@
+// SPI.write(..., {async:true}) on hardware SPI copies the data and returns a
+// Promise that resolves once it has been sent. Needs firmware built with
+// SPI_SIMULATED, where hardware SPI transfers take a while to complete and
+// everything sent comes out of LoopbackB, so we can check what was sent.
+var received = "";
+LoopbackB.on('data', function(d) { received += d; });
+SPI1.setup({mosi:D13, sck:D14, baud:1000000});
+
+var order = [];
+var big = new Uint8Array(100);
+var promises = [
+  SPI1.write([65,66,67], {async:true}),
+  SPI1.write("Hello", D12, {async:true}), // NSS toggled on its own
+  SPI1.write(big, {async:true}),
+  SPI1.write([], {async:true}) // nothing to send
+];
+big.fill(1); // the data was copied, so this doesn't matter
+promises.forEach(function(p, i) { p.then(function() { order.push(i); }); });
+
+// more async writes than the hardware queue holds, then a synchronous write,
+// which has to wait for all of them so the bytes go out in order
+var more = [];
+for (var i=0;i<6;i++) more.push(SPI1.write(String.fromCharCode(97+i), {async:true}));
+var moreDone = 0;
+more.forEach(function(p) { p.then(function() { moreDone++; }); });
+var syncResult = SPI1.write("Z");
+var drained = false;
+Promise.resolve().then(function() { drained = moreDone==more.length; });
+
+setTimeout(function() {
+  var zeros = "";
+  while (zeros.length<100) zeros += "\0";
+  result = promises.every(function(p) { return p instanceof Promise; }) &&
+           syncResult===undefined && drained && order.length==4 &&
+           order.filter(function(i) { return i<3; }).join()=="0,1,2" && // the empty one resolves straight away
+           received == "ABCHello"+zeros+"abcdefZ";
+}, 100);
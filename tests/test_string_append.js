@@ -0,0 +1,30 @@
+// Appending to a string remembers where the string ended, so repeated +=
+// doesn't walk the whole string each time. Check appends of every size
+// (across block boundaries), appending to a copy, to a different string in
+// between, and appending a string to itself
+var s = "", t = "", u = "x";
+var expected = "", tExpected = "";
+for (var i=0;i<300;i++) {
+  var piece = "abcdefghijklmnopqrstuvwxyz0123456789".substr(0, i%37);
+  s += piece;
+  if (i%7==0) { // interleave appends to another string
+    t += s.substr(-3);
+    tExpected = tExpected.concat(s.substr(-3));
+  }
+  if (i%50==0) u = s; // u and s are the same string now
+  expected = expected.concat(piece);
+}
+var uLength = u.length;
+u += "!";
+
+var self = "0123456789";
+for (i=0;i<5;i++) self += self;
+
+var parts = [];
+for (i=0;i<300;i++) parts.push("abcdefghijklmnopqrstuvwxyz0123456789".substr(0, i%37));
+
+result = s==expected && s==parts.join("") &&
+         t==tExpected &&
+         uLength<s.length && u.length==uLength+1 && u[uLength]=="!" &&
+         u.substr(0,uLength)==s.substr(0,uLength) &&
+         self.length==320 && self.substr(310)=="0123456789";
@@ -0,0 +1,29 @@
+// dgramSocket.sendMany sends each payload as its own datagram, and a socket
+// created with 'batch' delivers everything waiting in one 'messages' event,
+// with the sender's address, port and size for each in a DataView
+var dgram = require('dgram');
+
+var got = [], infoOk = true, single = 0;
+var rx = dgram.createSocket({type:'udp4', batch:8});
+rx.on('message', function() { single++; });
+rx.on('messages', function(msgs, info) {
+  msgs.forEach(function(m, i) {
+    got.push(E.toString(m));
+    if (info.getUint8(i*8)!=127 || info.getUint8(i*8+3)!=1 ||
+        info.getUint16(i*8+4, true)!=8094 || info.getUint16(i*8+6, true)!=m.length)
+      infoOk = false;
+  });
+});
+rx.bind(8093);
+
+var tx = dgram.createSocket('udp4');
+tx.bind(8094);
+setTimeout(function() {
+  tx.sendMany([new Uint8Array([65,66,67]), "Hello", new Uint8Array([68,69]).buffer], 8093, "127.0.0.1");
+}, 100);
+
+setTimeout(function() {
+  rx.close();
+  tx.close();
+  result = got.join(",")=="ABC,Hello,DE" && infoOk && single==0;
+}, 500);
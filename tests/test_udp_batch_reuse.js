@@ -0,0 +1,29 @@
+// Batched UDP receive must never overwrite a batch that JS still references.
+// Here every batch is kept, and more batches than there are receive buffers
+// arrive before any of them is looked at.
+var dgram = require('dgram');
+
+var batches = [];
+var rx = dgram.createSocket({type:'udp4', batch:4});
+rx.on('messages', function(msgs, info) { batches.push(msgs); });
+rx.bind(8097);
+
+var tx = dgram.createSocket('udp4');
+tx.bind(8098);
+var sent = [];
+for (var i=0;i<5;i++) sent.push("batch"+i);
+var n = 0;
+var interval = setInterval(function() {
+  tx.send(sent[n], 8097, "127.0.0.1");
+  if (++n==sent.length) clearInterval(interval);
+}, 50);
+
+setTimeout(function() {
+  rx.close();
+  tx.close();
+  var got = [];
+  batches.forEach(function(msgs) {
+    msgs.forEach(function(m) { got.push(E.toString(m)); });
+  });
+  result = got.join(",")==sent.join(",");
+}, 800);
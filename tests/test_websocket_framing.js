@@ -0,0 +1,52 @@
+// WebSocket frame parsing: frames split across packets, the 16 bit length
+// form, and a 64 bit length that's far too big (which must close the
+// connection with 1009 rather than trying to buffer it)
+var http = require("http");
+var net = require("net");
+
+var messages = [];
+var errors = 0;
+var closeStatus;
+
+function frame(opcode, data, mask) {
+  var hdr = String.fromCharCode(0x80|opcode);
+  var m = mask ? 0x80 : 0;
+  if (data.length<126) hdr += String.fromCharCode(m|data.length);
+  else hdr += String.fromCharCode(m|126, data.length>>8, data.length&255);
+  if (!mask) return hdr+data;
+  var key = [1,2,3,4], out = "";
+  for (var i=0;i<data.length;i++) out += String.fromCharCode(data.charCodeAt(i)^key[i&3]);
+  return hdr+String.fromCharCode.apply(null,key)+out;
+}
+
+var server = http.createServer(function (req, res) {
+  var ws = req.upgrade();
+  ws.on('message', function(msg) { messages.push(msg); });
+  ws.on('error', function() { errors++; });
+}).listen(8090);
+
+var big = "";
+while (big.length<200) big += "0123456789";
+
+var client = net.connect({host:"localhost", port:8090}, function() {
+  client.write("GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"+
+               "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+  var hi = frame(1, "Hello", true);
+  setTimeout(function() { client.write(hi.substr(0,4)); }, 50); // partial frame
+  setTimeout(function() { client.write(hi.substr(4)+frame(1, big, true)); }, 100);
+  // 64 bit length of 0xFFFFFFF0 bytes
+  setTimeout(function() { client.write("\x82\xFF\0\0\0\0\xFF\xFF\xFF\xF0\1\2\3\4"); }, 150);
+});
+var received = "";
+client.on('data', function(d) {
+  received += d;
+  var i = received.indexOf("\x88\x02");
+  if (i>=0 && received.length>=i+4)
+    closeStatus = (received.charCodeAt(i+2)<<8) | received.charCodeAt(i+3);
+});
+
+setTimeout(function() {
+  server.close();
+  result = messages.length==2 && messages[0]=="Hello" && messages[1]==big &&
+           errors==1 && closeStatus==1009;
+}, 1000);
@@ -0,0 +1,77 @@
+// WebSocket protocol checks on the server side. Frames from a client must be
+// masked, have no RSV bits set, and control frames must be short and not
+// fragmented - anything else closes with 1002. A frame sent in the same packet
+// as the upgrade request must be delivered without waiting for more data.
+var http = require("http");
+var net = require("net");
+
+var UPGRADE = "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"+
+              "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+
+var messages = [];
+var errors = 0;
+var big = new Uint8Array(3000);
+for (var i=0;i<big.length;i++) big[i] = i*7;
+
+function frame(b0, data, mask) {
+  var hdr = String.fromCharCode(b0);
+  var m = mask ? 0x80 : 0;
+  if (data.length<126) hdr += String.fromCharCode(m|data.length);
+  else hdr += String.fromCharCode(m|126, data.length>>8, data.length&255);
+  if (!mask) return hdr+data;
+  var key = [1,2,3,4], out = "";
+  for (var i=0;i<data.length;i++) out += String.fromCharCode(data.charCodeAt(i)^key[i&3]);
+  return hdr+String.fromCharCode.apply(null,key)+out;
+}
+
+var server = http.createServer(function (req, res) {
+  var ws = req.upgrade();
+  ws.on('message', function(msg) {
+    messages.push(msg);
+    if (msg=="big") ws.send(big.buffer); // sent a chunk at a time, not copied to the stack
+  });
+  ws.on('error', function() { errors++; });
+}).listen(8095);
+
+// Send 'frames' straight after the upgrade request, and return the close status the server sends
+function check(frames, cb) {
+  var received = "";
+  var client = net.connect({host:"localhost", port:8095}, function() {
+    client.write(UPGRADE+frames);
+  });
+  client.on('data', function(d) { received += d; });
+  setTimeout(function() {
+    client.end();
+    var i = received.indexOf("\x88\x02");
+    cb(i<0 ? 0 : (received.charCodeAt(i+2)<<8) | received.charCodeAt(i+3), received);
+  }, 300);
+}
+
+var status = [];
+var bigOk = false;
+check(frame(0x81, "first", true)+frame(0x81, "big", true), function(s, received) {
+  status.push(s);
+  // 3000 byte binary frame: FIN|binary, 16 bit length, unmasked
+  var i = received.indexOf("\x82\x7E\x0B\xB8");
+  bigOk = i>=0 && received.length>=i+4+3000;
+  for (var j=0;bigOk && j<3000;j++)
+    if (received.charCodeAt(i+4+j) != ((j*7)&255)) bigOk = false;
+  check(frame(0x81, "unmasked", false), function(s) {
+    status.push(s);
+    check(frame(0xC1, "rsv1", true), function(s) {
+      status.push(s);
+      var long = "";
+      while (long.length<126) long += "x";
+      check(frame(0x89, long, true), function(s) { // ping with 126 bytes
+        status.push(s);
+        check(frame(0x09, "frag", true), function(s) { // ping without FIN
+          status.push(s);
+          server.close();
+          result = messages.length==2 && messages[0]=="first" && bigOk &&
+                   status[0]==0 && status[1]==1002 && status[2]==1002 &&
+                   status[3]==1002 && status[4]==1002 && errors==4;
+        });
+      });
+    });
+  });
+});